@@ -49,6 +49,7 @@ import seutil as su
 from prism.interface.coq.goals import GoalLocation, Goals, GoalsDiff
 from prism.interface.coq.ident import Identifier
 from prism.language.gallina.analyze import SexpInfo
+from prism.language.gallina.locations import LocArray, LocIndex
 from prism.language.heuristic.parser import CoqComment, CoqSentence
 from prism.language.sexp.node import SexpNode
 from prism.util.io import Fmt
@@ -375,8 +376,12 @@ class VernacSentence:
         Sorting is done purely based on character numbers, so sentences
         from different documents can still be sorted together (although
         the significance of the results may be suspect).
+        The sentences' locations are packed and sorted with
+        `LocArray.argsort` rather than compared pairwise.
         """
-        return sorted(sentences)
+        sentences = list(sentences)
+        order = LocArray.from_locs(s.location for s in sentences).argsort()
+        return [sentences[i] for i in order.tolist()]
 
 
 @dataclass
@@ -721,6 +726,7 @@ class VernacCommandDataList:
 
     def __delitem__(self, item: SupportsIndex) -> None:  # noqa: D105
         del self.commands[item]
+        self.invalidate_location_index()
 
     def __getattribute__(self, name: str) -> Any:
         """
@@ -731,6 +737,15 @@ class VernacCommandDataList:
         except AttributeError:
             return getattr(super().__getattribute__('commands'), name)
 
+    def __getstate__(self) -> Dict[str, Any]:
+        """
+        Get the state of the list for pickling without its caches.
+        """
+        state = dict(self.__dict__)
+        state.pop('_spanning_locations', None)
+        state.pop('_location_index', None)
+        return state
+
     @overload
     def __getitem__(  # noqa: D105
             self,
@@ -765,6 +780,7 @@ class VernacCommandDataList:
             raise TypeError(
                 'VernacCommandDataList may only contain VernacCommandData')
         self.commands[idx] = item
+        self.invalidate_location_index()
 
     def __mul__(  # noqa: D105
             self,
@@ -776,6 +792,11 @@ class VernacCommandDataList:
             raise TypeError(
                 'VernacCommandDataList may only contain VernacCommandData')
         self.commands.append(item)
+        self.invalidate_location_index()
+
+    def clear(self) -> None:  # noqa: D102
+        self.commands.clear()
+        self.invalidate_location_index()
 
     def copy(self) -> 'VernacCommandDataList':  # noqa: D102
         return self.__class__(self.commands.copy())
@@ -817,6 +838,7 @@ class VernacCommandDataList:
             raise TypeError(
                 'VernacCommandDataList may only contain VernacCommandData')
         self.commands.extend(items)
+        self.invalidate_location_index()
 
     def get_covering(
         self,
@@ -849,21 +871,52 @@ class VernacCommandDataList:
             If any of the indices in `subset` are outside the indexable
             range of this list.
         """
-        covered = set()
         if not isinstance(subset, Iterable):
             subset = [subset]
-        subset_command_locations = [
-            i.spanning_location()
-            if isinstance(i,
-                          VernacCommandData) else self[i].spanning_location()
-            for i in subset
-        ]
-        for i, candidate in enumerate(self):
-            for location in subset_command_locations:
-                if candidate.spanning_location() in location:
-                    covered.add(i)
-                    break
-        return covered
+        subset_command_locations = LocArray.from_locs(
+            i.spanning_location() if isinstance(i,
+                                                VernacCommandData) else self[i]
+            .spanning_location() for i in subset)
+        _, covered = self.location_index().contained_in(
+            subset_command_locations.data['beg_charno'],
+            subset_command_locations.data['end_charno'])
+        return set(covered.tolist())
+
+    def get_containing(
+            self,
+            locations: Iterable[Union[SexpInfo.Loc,
+                                      int]]) -> List[List[int]]:
+        """
+        Get indices of commands that contain each of many locations.
+
+        Parameters
+        ----------
+        locations : Iterable[Union[SexpInfo.Loc, int]]
+            A batch of locations or character numbers.
+
+        Returns
+        -------
+        List[List[int]]
+            For each given location, the ascending indices of commands
+            whose spanning locations contain it.
+            Filenames are ignored.
+        """
+        begs = []
+        ends = []
+        for location in locations:
+            if isinstance(location, SexpInfo.Loc):
+                begs.append(location.beg_charno)
+                ends.append(location.end_charno)
+            else:
+                begs.append(location)
+                ends.append(location)
+        result: List[List[int]] = [[] for _ in begs]
+        query_indices, command_indices = self.location_index().containing(
+            begs, ends)
+        for query_index, command_index in zip(query_indices.tolist(),
+                                              command_indices.tolist()):
+            result[query_index].append(command_index)
+        return result
 
     def index(self, item: object) -> int:
         """
@@ -893,6 +946,64 @@ class VernacCommandDataList:
                 return index
         raise ValueError(f"{item} is not in list")
 
+    def insert(self, idx: SupportsIndex, item: Any) -> None:  # noqa: D102
+        if not isinstance(item, VernacCommandData):
+            raise TypeError(
+                'VernacCommandDataList may only contain VernacCommandData')
+        self.commands.insert(idx, item)
+        self.invalidate_location_index()
+
+    def invalidate_location_index(self) -> None:
+        """
+        Discard the cached spanning locations of the commands and index.
+
+        This must be called after relocating any command in the list in
+        place, e.g., with `VernacCommandData.relocate`.
+        Methods of this list that add, remove, replace, or reorder
+        commands call it automatically.
+        """
+        self.__dict__.pop('_spanning_locations', None)
+        self.__dict__.pop('_location_index', None)
+
+    def spanning_locations(self) -> LocArray:
+        """
+        Get the spanning locations of the commands.
+
+        The locations are packed lazily and cached along with
+        `location_index` until invalidated by
+        `invalidate_location_index`.
+
+        Returns
+        -------
+        LocArray
+            The spanning locations in the order of this list.
+        """
+        locations = self.__dict__.get('_spanning_locations')
+        if locations is None:
+            locations = LocArray.from_locs(
+                c.spanning_location() for c in self.commands)
+            self._spanning_locations = locations
+        return locations
+
+    def location_index(self) -> LocIndex:
+        """
+        Get an index of the spanning locations of the commands.
+
+        The index is built lazily and cached until it is invalidated by
+        `invalidate_location_index`.
+        The cached index is not pickled.
+
+        Returns
+        -------
+        LocIndex
+            An index whose location indices match those of this list.
+        """
+        index = self.__dict__.get('_location_index')
+        if index is None:
+            index = LocIndex(self.spanning_locations())
+            self._location_index = index
+        return index
+
     def indexed_sentences_iter(self) -> Iterator[Tuple[int, VernacSentence]]:
         """
         Get an iterator over sentences indexed by commands.
@@ -950,7 +1061,17 @@ class VernacCommandDataList:
         """
         Remove and return the last command from the list.
         """
-        return self.commands.pop()
+        command = self.commands.pop()
+        self.invalidate_location_index()
+        return command
+
+    def remove(self, item: Any) -> None:  # noqa: D102
+        self.commands.remove(item)
+        self.invalidate_location_index()
+
+    def reverse(self) -> None:  # noqa: D102
+        self.commands.reverse()
+        self.invalidate_location_index()
 
     def serialize(self, fmt: Optional[Fmt] = None) -> List[object]:
         """
@@ -967,8 +1088,15 @@ class VernacCommandDataList:
     def sort(self) -> None:
         """
         Sort the list of commands in place.
+
+        Commands are sorted by their cached spanning locations (see
+        `spanning_locations`) rather than compared pairwise.
         """
-        self.commands.sort()
+        locations = self.spanning_locations()
+        order = locations.argsort()
+        self.commands[:] = [self.commands[i] for i in order.tolist()]
+        self.invalidate_location_index()
+        self._spanning_locations = locations[order]
 
     def sorted_sentences(self) -> List[VernacSentence]:
         """
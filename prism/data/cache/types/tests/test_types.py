@@ -21,6 +21,7 @@
 """
 Test suite for `prism.data.cache.types`.
 """
+import pickle
 import typing
 import unittest
 from copy import deepcopy
@@ -31,11 +32,13 @@ from typing import List, Optional, Tuple, Union
 import seutil.io as io
 
 from prism.data.cache.types.command import VernacSentence
+from prism.data.cache.types.project import ProjectCommitData
 from prism.interface.coq.goals import Goals, GoalsDiff
 from prism.interface.coq.ident import Identifier, IdentType, get_all_idents
 from prism.interface.coq.serapi import SerAPI
 from prism.language.gallina.analyze import SexpInfo
 from prism.language.sexp.node import SexpNode
+from prism.tests import _DATA_PATH
 from prism.util.io import Fmt
 
 TEST_DIR = Path(__file__).parent
@@ -124,3 +127,66 @@ class TestVernacSentence(unittest.TestCase):
             with self.subTest("deserialize"):
                 loaded = io.load(f.name, Fmt.yaml, clz=List[VernacSentence])
                 self.assertEqual(loaded, sentences)
+
+
+class TestVernacCommandDataList(unittest.TestCase):
+    """
+    Test suite for `VernacCommandDataList`.
+    """
+
+    def test_location_queries(self) -> None:
+        """
+        Verify indexed location queries against exhaustive searches.
+        """
+        for commands in self.data.command_data.values():
+            spans = [c.spanning_location() for c in commands]
+            with self.subTest("get_covering"):
+                for i, span in enumerate(spans):
+                    self.assertEqual(
+                        commands.get_covering(i),
+                        {j for j, other in enumerate(spans) if other in span})
+            with self.subTest("get_containing"):
+                positions = list(range(spans[-1].end_charno + 2))
+                self.assertEqual(
+                    commands.get_containing(positions),
+                    [
+                        [j
+                         for j, span in enumerate(spans)
+                         if position in span]
+                        for position in positions
+                    ])
+            with self.subTest("sort"):
+                commands.reverse()
+                commands.sort()
+                # the packed locations are reordered along with the list
+                self.assertEqual(
+                    list(commands.spanning_locations()),
+                    [c.spanning_location() for c in commands])
+                self.assertEqual(
+                    [c.spanning_location() for c in commands],
+                    spans)
+            with self.subTest("invalidation"):
+                index = commands.location_index()
+                self.assertIs(commands.location_index(), index)
+                self.assertNotIn(
+                    '_location_index',
+                    pickle.loads(pickle.dumps(commands)).__dict__)
+                commands.append(commands.pop())
+                self.assertIsNot(commands.location_index(), index)
+                index = commands.location_index()
+                commands[0].relocate(spans[0].shift(1))
+                commands.invalidate_location_index()
+                self.assertIsNot(commands.location_index(), index)
+                self.assertNotIn(
+                    0,
+                    commands.get_containing([spans[0].beg_charno])[0])
+
+    def setUp(self) -> None:
+        """
+        Load realistic sample cached data.
+        """
+        self.data = ProjectCommitData.load(_DATA_PATH / "initial_state.json")
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -27,12 +27,17 @@ import random
 import typing
 from typing import Dict, Generator, Iterable, Optional, Tuple, Type
 
+import numpy as np
 from git import InvalidGitRepositoryError
 
 from prism.data.document import CoqDocument
+from prism.data.sentence_offsets import SentenceOffset, SentenceOffsetIndex
+from prism.language.gallina.parser import CoqParser
+from prism.language.heuristic.lexer import sentence_text
 from prism.language.heuristic.parser import CoqSentence
 from prism.project import DirHasNoCoqFiles, Project, ProjectRepo
 from prism.project.metadata.storage import MetadataStorage
+from prism.util.path import get_relative_path
 from prism.util.radpytools import PathLike
 
 ProjectDict = Dict[str, Project]
@@ -106,9 +111,15 @@ class CoqProjectBaseDataset:
         The dictionary of Coq projects to draw data from
     weights : Dict[str, float]
         Weights for each project for sampling
+    sentence_offsets : Optional[SentenceOffsetIndex]
+        An index of sentence locations for sampling, if built or loaded
 
     Methods
     -------
+    build_sentence_offsets(path, commit_names)
+        Builds an index of sentence locations for fast sampling.
+    load_sentence_offsets(path)
+        Loads an index of sentence locations for fast sampling.
     files(commit_names)
         Returns a generator that yields Coq files from the object.
     get_random_file(project_name, commit_name)
@@ -211,6 +222,7 @@ class CoqProjectBaseDataset:
         }
         self.sentence_extraction_method = next(
             iter(self.projects.values())).sentence_extraction_method
+        self.sentence_offsets: Optional[SentenceOffsetIndex] = None
 
     def _init_projects_base_dir(
             self,
@@ -294,6 +306,147 @@ class CoqProjectBaseDataset:
         chosen_proj = random.choices(project_names, weights, k=1)[0]
         return chosen_proj
 
+    def _read_sentence(self, offset: SentenceOffset) -> str:
+        """
+        Read an indexed sentence without parsing its file.
+        """
+        project = self.projects[offset.project]
+        if (isinstance(project,
+                       ProjectRepo) and offset.commit != project.commit_sha):
+            source_code = CoqParser.decode_byte_string(
+                project.objects.read_file(offset.commit,
+                                          offset.file))
+        else:
+            source_code = CoqParser.parse_source(project.path / offset.file)
+        return sentence_text(source_code, offset.start, offset.end)
+
+    def _use_sentence_offsets(
+            self,
+            filename: Optional[str],
+            glom_proofs: bool,
+            commit_name: Optional[str]) -> bool:
+        """
+        Determine whether a sentence may be sampled from the index.
+
+        Indexed sentences are not glommed and span all indexed commits.
+        """
+        return (
+            self.sentence_offsets is not None and filename is None
+            and not glom_proofs and commit_name is None)
+
+    def build_sentence_offsets(
+        self,
+        path: PathLike,
+        commit_names: Optional[Dict[str,
+                                    Iterable[str]]] = None
+    ) -> SentenceOffsetIndex:
+        """
+        Build an index of the locations of sentences for sampling.
+
+        The built index is used by `get_random_sentence` and
+        `get_random_sentence_pair_adjacent` to sample unglommed
+        sentences without parsing files.
+
+        Parameters
+        ----------
+        path : PathLike
+            The directory in which to save the index.
+        commit_names : Optional[Dict[str, Iterable[str]]], optional
+            The commits (named by branch, hash, or tag) to index for
+            each project, by default only the working tree.
+            Files of each commit are read without checking it out.
+
+        Returns
+        -------
+        SentenceOffsetIndex
+            The built index.
+
+        Raises
+        ------
+        ValueError
+            If commits are given for a project that is not a Git
+            repository.
+        OSError
+            If a file of a working tree cannot be read.
+        UnicodeDecodeError
+            If a file of a working tree cannot be decoded.
+
+        Notes
+        -----
+        Sentences are located heuristically (see `lex_sentences`) and
+        sampled such that each project's total probability is
+        proportional to its weight in `weights`.
+        """
+        if commit_names is None:
+            commit_names = {}
+
+        def _offsets() -> Generator[Tuple[str,
+                                          str,
+                                          str,
+                                          np.ndarray],
+                                    None,
+                                    None]:
+            for project_name, project in self.projects.items():
+                commits = commit_names.get(project_name)
+                if commits is None:
+                    # index the working tree
+                    commit_sha = (
+                        project.commit_sha if isinstance(project,
+                                                         ProjectRepo) else "")
+                    # use the lexed documents directly since the
+                    # project's sentence index may not hold them all
+                    for file, _, lexed in project.sentence_index.lex_files_iter(
+                            project.get_file_list(),
+                            project.num_cores):
+                        yield (
+                            project_name,
+                            commit_sha,
+                            str(get_relative_path(file,
+                                                  project.path)),
+                            lexed.sentence_spans)
+                    continue
+                if not isinstance(project, ProjectRepo):
+                    raise ValueError(
+                        f"Cannot checkout commit from non-Git project {project_name}"
+                    )
+                for commit_name in commits:
+                    # read files from the object store without checkouts
+                    commit_sha = project.commit(commit_name).hexsha
+                    for file in project.get_file_list(relative=True,
+                                                      commit_name=commit_sha):
+                        document = project.get_file(
+                            project.path / file,
+                            commit_sha)
+                        lexed = project.sentence_index.lex(document.source_code)
+                        yield (
+                            project_name,
+                            commit_sha,
+                            file,
+                            lexed.sentence_spans)
+
+        self.sentence_offsets = SentenceOffsetIndex.build(
+            path,
+            _offsets(),
+            self.weights)
+        return self.sentence_offsets
+
+    def load_sentence_offsets(self, path: PathLike) -> SentenceOffsetIndex:
+        """
+        Load an index built by `build_sentence_offsets`.
+
+        Parameters
+        ----------
+        path : PathLike
+            The directory in which the index was saved.
+
+        Returns
+        -------
+        SentenceOffsetIndex
+            The loaded index.
+        """
+        self.sentence_offsets = SentenceOffsetIndex.load(path)
+        return self.sentence_offsets
+
     def files(
         self,
         commit_names: Optional[Dict[str,
@@ -420,7 +573,17 @@ class CoqProjectBaseDataset:
         -------
         str
             A random sentence from the group of projects
+
+        Notes
+        -----
+        If the dataset has `sentence_offsets`, `glom_proofs` is False,
+        and neither `filename` nor `commit_name` is given, then the
+        sentence is sampled from the index across all indexed commits.
         """
+        if self._use_sentence_offsets(filename, glom_proofs, commit_name):
+            assert self.sentence_offsets is not None
+            return self._read_sentence(
+                self.sentence_offsets.sample(project=project_name))
         if project_name is None:
             project_name = self._get_random_project()
         return self.projects[project_name].get_random_sentence(
@@ -458,7 +621,18 @@ class CoqProjectBaseDataset:
         List[str]
             A list of two adjacent sentences from the projects, with the
             first sentence chosen at random
-        """
+
+        Notes
+        -----
+        If the dataset has `sentence_offsets`, `glom_proofs` is False,
+        and neither `filename` nor `commit_name` is given, then the
+        pair is sampled from the index across all indexed commits.
+        """
+        if self._use_sentence_offsets(filename, glom_proofs, commit_name):
+            assert self.sentence_offsets is not None
+            first, second = self.sentence_offsets.sample_adjacent(
+                project=project_name)
+            return self._read_sentence(first), self._read_sentence(second)
         if project_name is None:
             project_name = self._get_random_project()
         return self.projects[project_name].get_random_sentence_pair_adjacent(
@@ -499,6 +673,12 @@ class CoqProjectBaseDataset:
             A single sentence, which might be a glommed proof if
             `glom_proofs` is True, from a Coq file within the group of
             projects in the dataset
+
+        Notes
+        -----
+        If sentences are extracted heuristically, then each file is
+        lexed through its project's `sentence_index`, which also serves
+        subsequent iterations over files that it still holds.
         """
         for project in self.projects.values():
             for filename in project.get_file_list():
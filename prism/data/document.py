@@ -33,7 +33,7 @@ from typing import List, Optional
 
 from prism.data.vernac_sentence import VernacularSentence
 from prism.interface.coq.options import SerAPIOptions
-from prism.language.gallina.util import ParserUtils
+from prism.language.gallina.util import ParserUtils, UnicodeOffsetMap
 from prism.language.sexp import SexpNode
 from prism.language.token import Token
 from prism.util.radpytools import PathLike
@@ -179,6 +179,18 @@ class CoqDocument:
         """
         return ParserUtils.get_unicode_offsets(self.source_code)
 
+    @cached_property
+    def unicode_offset_map(self) -> UnicodeOffsetMap:
+        """
+        Get a map between byte and character offsets of the file.
+
+        Returns
+        -------
+        UnicodeOffsetMap
+            A map equivalent to but faster than `unicode_offsets`.
+        """
+        return UnicodeOffsetMap(self.source_code)
+
     def get_all_tokens(self) -> List[Token]:
         """
         Get a list of all tokens in the Coq document.
@@ -43,6 +43,7 @@ from prism.data.repair.diff import commands_in_diff
 from prism.util.alignment import Alignment, lazy_align
 from prism.util.diff import GitDiff
 from prism.util.iterable import fast_contains
+from prism.util.telemetry import timed
 
 T = TypeVar('T')
 
@@ -602,6 +603,7 @@ def _compute_diff_alignment(
     return diff_alignment
 
 
+@timed("align_commits")
 def align_commits(
         a: ProjectCommitData,
         b: ProjectCommitData,
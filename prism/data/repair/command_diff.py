@@ -0,0 +1,452 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Typed, field-level diffs between extracted commands.
+"""
+import base64
+from dataclasses import dataclass, fields
+from itertools import chain
+from typing import Any, Dict, List, Optional, Type, Union
+
+import seutil as su
+
+from prism.data.cache.types.command import (
+    ProofSentence,
+    VernacCommandData,
+    VernacSentence,
+)
+from prism.interface.coq.goals import Goals, GoalsDiff
+from prism.language.gallina.analyze import SexpInfo
+from prism.util.delta import (
+    apply_str_delta,
+    compute_str_delta,
+    pack_value,
+    unpack_value,
+)
+from prism.util.io import Fmt
+from prism.util.radpytools.dataclasses import default_field
+from prism.util.serialize import SerializableDataDiff
+
+_LOC_FIELDS = (
+    'lineno',
+    'bol_pos',
+    'lineno_last',
+    'bol_pos_last',
+    'beg_charno',
+    'end_charno')
+"""
+The numeric fields of a location, which are stored as differences.
+"""
+
+_SENTENCE_FIELDS = {
+    f.name: f for f in fields(VernacSentence)
+}
+"""
+The fields of a sentence by name.
+"""
+
+_REPLACED_SENTENCE_FIELDS = [
+    name for name in _SENTENCE_FIELDS
+    if name not in {'text', 'ast', 'location', 'goals', 'command_index'}
+]
+"""
+Sentence fields whose changed values are stored whole.
+
+The text, AST, location, and goals are instead stored as deltas, and
+the non-serialized command index is not stored.
+"""
+
+
+def _diff_goals(
+        a: Optional[Union[Goals,
+                          GoalsDiff]],
+        b: Optional[Union[Goals,
+                          GoalsDiff]]) -> List[Any]:
+    """
+    Get a delta between two sentences' goals.
+    """
+    if isinstance(a, Goals) and isinstance(b, Goals):
+        goals_diff = GoalsDiff.compute_diff(a, b)
+        # goal diffs do not necessarily preserve background goals
+        if goals_diff.patch(a) == b:
+            return ['diff', su.io.serialize(goals_diff)]
+    return ['value', su.io.serialize(b)]
+
+
+def _patch_goals(a: Optional[Union[Goals,
+                                   GoalsDiff]],
+                 delta: List[Any]) -> Optional[Union[Goals,
+                                                     GoalsDiff]]:
+    """
+    Apply a delta computed by `_diff_goals`.
+    """
+    kind, value = delta
+    if kind == 'diff':
+        assert isinstance(a, Goals)
+        return su.io.deserialize(value, clz=GoalsDiff, error='raise').patch(a)
+    elif value is None:
+        return None
+    elif 'added_goals' in value:
+        return su.io.deserialize(value, clz=GoalsDiff, error='raise')
+    else:
+        return su.io.deserialize(value, clz=Goals, error='raise')
+
+
+def _diff_sentence(a: VernacSentence,
+                   b: VernacSentence) -> Optional[Dict[str,
+                                                       Any]]:
+    """
+    Get field-level deltas between two sentences, if they differ.
+    """
+    delta: Dict[str,
+                Any] = {}
+    if a.text != b.text:
+        delta['text'] = compute_str_delta(a.text, b.text)
+    if a.ast != b.ast:
+        delta['ast'] = compute_str_delta(a.ast, b.ast)
+    if a.location != b.location:
+        delta['location'] = [
+            b.location.filename
+            if b.location.filename != a.location.filename else None
+        ] + [
+            getattr(b.location,
+                    name) - getattr(a.location,
+                                    name) for name in _LOC_FIELDS
+        ]
+    if a.goals != b.goals:
+        delta['goals'] = _diff_goals(a.goals, b.goals)
+    for name in _REPLACED_SENTENCE_FIELDS:
+        value = getattr(b, name)
+        if getattr(a, name) != value:
+            delta[name] = su.io.serialize(value)
+    return delta if delta else None
+
+
+def _copy_sentence(sentence: VernacSentence) -> VernacSentence:
+    """
+    Copy a sentence without its non-serialized indices.
+    """
+    result = sentence.shallow_copy()
+    result.command_index = None
+    if isinstance(result, ProofSentence):
+        result.proof_index = None
+        result.proof_step_index = None
+    return result
+
+
+def _patch_sentence(a: VernacSentence, delta: Dict[str, Any]) -> VernacSentence:
+    """
+    Apply deltas computed by `_diff_sentence` to a copy of a sentence.
+    """
+    result = _copy_sentence(a)
+    for name, value in delta.items():
+        if name == 'text':
+            result.text = apply_str_delta(a.text, value)
+        elif name == 'ast':
+            result.ast = apply_str_delta(a.ast, value)
+        elif name == 'location':
+            filename, *offsets = value
+            loc = a.location
+            result.location = SexpInfo.Loc(
+                loc.filename if filename is None else filename,
+                *[
+                    getattr(loc,
+                            field_name) + offset
+                    for field_name, offset in zip(_LOC_FIELDS, offsets)
+                ])
+        elif name == 'goals':
+            result.goals = _patch_goals(a.goals, value)
+        elif name in VernacSentence._primitive_fields or value is None:
+            setattr(result, name, value)
+        else:
+            setattr(
+                result,
+                name,
+                su.io.deserialize(
+                    value,
+                    clz=_SENTENCE_FIELDS[name].type,
+                    error='raise'))
+    return result
+
+
+@dataclass(frozen=True)
+class VernacCommandDataDiff:
+    """
+    A typed, field-level diff between two commands.
+
+    In contrast to a `SerializableDataDiff`, which is a text patch over
+    a YAML dump of a whole command, this diff records deltas of each
+    changed field of each changed sentence (text, AST, location, goals,
+    etc.) in a compact binary form.
+    Patching applies the deltas directly to a copy of the original
+    command without any intermediate serialization, so its cost scales
+    with the size of the change rather than the size of the command.
+    """
+
+    delta: bytes
+    """
+    The encoded deltas.
+    """
+
+    def patch(
+            self,
+            a: VernacCommandData,
+            clz: Optional[Type[VernacCommandData]] = None) -> VernacCommandData:
+        """
+        Apply the diff to a given command to obtain a changed one.
+
+        Parameters
+        ----------
+        a : VernacCommandData
+            A command.
+        clz : Optional[Type[VernacCommandData]], optional
+            Ignored, but accepted for compatibility with
+            `SerializableDataDiff.patch`.
+
+        Returns
+        -------
+        VernacCommandData
+            The command resulting from applying this diff to `a`.
+            If `self` equals ``VernacCommandDataDiff.compute_diff(a,b)``
+            for some `b`, then ``self.patch(a) == b`` up to the
+            non-serialized indices of each sentence.
+            The given command is not modified.
+        """
+        payload = unpack_value(self.delta)
+        a_sentences = [a.command]
+        a_sentences.extend(chain.from_iterable(a.proofs))
+        sentence_deltas = payload.get('sentences',
+                                      {})
+        proof_lengths = payload.get('proofs', [len(p) for p in a.proofs])
+        sentences = []
+        for i in range(1 + sum(proof_lengths)):
+            delta = sentence_deltas.get(i, None)
+            if delta is None:
+                sentence = _copy_sentence(a_sentences[i])
+            elif 'new' in delta:
+                sentence_clz = ProofSentence if delta[
+                    'proof'] else VernacSentence
+                sentence = sentence_clz.deserialize(delta['new'])
+            else:
+                sentence = _patch_sentence(a_sentences[i], delta)
+            sentences.append(sentence)
+        proofs = []
+        start = 1
+        for proof_length in proof_lengths:
+            proofs.append(sentences[start : start + proof_length])
+            start += proof_length
+        proxy_location = a.proxy_location
+        if 'proxy_location' in payload:
+            proxy_location = su.io.deserialize(
+                payload['proxy_location'],
+                clz=Optional[SexpInfo.Loc],
+                error='raise')
+        return VernacCommandData(
+            payload.get('identifier',
+                        list(a.identifier)),
+            payload.get('command_error',
+                        a.command_error),
+            sentences[0],
+            proofs,
+            proxy_location)
+
+    def serialize(self, fmt: Optional[Fmt] = None) -> Dict[str, str]:
+        """
+        Serialize the diff with its deltas encoded as text.
+        """
+        return {
+            'delta': base64.b64encode(self.delta).decode('ascii')
+        }
+
+    @classmethod
+    def compute_diff(
+            cls,
+            a: VernacCommandData,
+            b: VernacCommandData) -> 'VernacCommandDataDiff':
+        """
+        Get a diff between two commands.
+
+        Parameters
+        ----------
+        a, b : VernacCommandData
+            Two commands.
+
+        Returns
+        -------
+        VernacCommandDataDiff
+            The diff between `a` and `b`.
+        """
+        payload: Dict[str,
+                      Any] = {}
+        if a.identifier != b.identifier:
+            payload['identifier'] = list(b.identifier)
+        if a.command_error != b.command_error:
+            payload['command_error'] = b.command_error
+        if a.proxy_location != b.proxy_location:
+            payload['proxy_location'] = su.io.serialize(b.proxy_location)
+        proof_lengths = [len(p) for p in b.proofs]
+        if [len(p) for p in a.proofs] != proof_lengths:
+            payload['proofs'] = proof_lengths
+        a_sentences = [a.command]
+        a_sentences.extend(chain.from_iterable(a.proofs))
+        b_sentences = [b.command]
+        b_sentences.extend(chain.from_iterable(b.proofs))
+        sentence_deltas: Dict[int,
+                              Dict[str,
+                                   Any]] = {}
+        for i, b_sentence in enumerate(b_sentences):
+            if i < len(a_sentences) and type(
+                    a_sentences[i]) is type(b_sentence):
+                delta = _diff_sentence(a_sentences[i], b_sentence)
+            else:
+                delta = {
+                    'new': b_sentence.serialize(),
+                    'proof': isinstance(b_sentence,
+                                        ProofSentence)
+                }
+            if delta is not None:
+                sentence_deltas[i] = delta
+        if sentence_deltas:
+            payload['sentences'] = sentence_deltas
+        return cls(pack_value(payload))
+
+    @classmethod
+    def deserialize(cls, data: Dict[str, str]) -> 'VernacCommandDataDiff':
+        """
+        Deserialize a diff serialized with `serialize`.
+        """
+        return cls(base64.b64decode(data['delta']))
+
+
+@dataclass(frozen=True)
+class FileDependenciesDiff:
+    """
+    A diff between two precomputed dependency graphs between files.
+    """
+
+    updated: Dict[str,
+                  List[str]] = default_field({})
+    """
+    The dependencies of each file whose dependencies were added or
+    changed.
+    """
+    removed: List[str] = default_field([])
+    """
+    Files whose dependencies were removed.
+    """
+    to_none: bool = False
+    """
+    Whether the dependency graph was removed entirely.
+    """
+
+    def patch(
+            self,
+            a: Optional[Dict[str,
+                             List[str]]],
+            clz: Optional[type] = None) -> Optional[Dict[str,
+                                                         List[str]]]:
+        """
+        Apply the diff to a given dependency graph.
+
+        Parameters
+        ----------
+        a : Optional[Dict[str, List[str]]]
+            A map from files to their dependencies, if any.
+        clz : Optional[type], optional
+            Ignored, but accepted for compatibility with
+            `SerializableDataDiff.patch`.
+
+        Returns
+        -------
+        Optional[Dict[str, List[str]]]
+            A new dependency graph resulting from applying this diff.
+        """
+        if self.to_none:
+            return None
+        result = {} if a is None else {
+            k: list(v) for k, v in a.items()
+        }
+        for filename in self.removed:
+            result.pop(filename, None)
+        for filename, dependencies in self.updated.items():
+            result[filename] = list(dependencies)
+        return result
+
+    @classmethod
+    def compute_diff(
+            cls,
+            a: Optional[Dict[str,
+                             List[str]]],
+            b: Optional[Dict[str,
+                             List[str]]]) -> 'FileDependenciesDiff':
+        """
+        Get a diff between two dependency graphs.
+        """
+        if b is None:
+            return cls(to_none=True)
+        if a is None:
+            a = {}
+        return cls(
+            {
+                k: list(v) for k, v in b.items() if a.get(k, None) != v
+            },
+            [k for k in a if k not in b])
+
+
+CommandDiff = Union[VernacCommandDataDiff,
+                    SerializableDataDiff[VernacCommandData]]
+"""
+A diff between two commands.
+
+Diffs are computed as `VernacCommandDataDiff`, but `SerializableDataDiff`
+may be encountered in data serialized by prior versions.
+"""
+
+FileDependenciesDiffLike = Union[FileDependenciesDiff,
+                                 SerializableDataDiff[Optional[Dict[
+                                     str,
+                                     List[str]]]]]
+"""
+A diff between two dependency graphs.
+
+Diffs are computed as `FileDependenciesDiff`, but `SerializableDataDiff`
+may be encountered in data serialized by prior versions.
+"""
+
+
+def deserialize_command_diff(data: Dict[str, str]) -> CommandDiff:
+    """
+    Deserialize a command diff in either its current or legacy form.
+    """
+    if 'diff' in data:
+        return su.io.deserialize(data, clz=SerializableDataDiff, error='raise')
+    return VernacCommandDataDiff.deserialize(data)
+
+
+def deserialize_file_dependencies_diff(
+        data: Dict[str,
+                   Any]) -> FileDependenciesDiffLike:
+    """
+    Deserialize a dependency graph diff in its current or legacy form.
+    """
+    if 'diff' in data:
+        return su.io.deserialize(data, clz=SerializableDataDiff, error='raise')
+    return su.io.deserialize(data, clz=FileDependenciesDiff, error='raise')
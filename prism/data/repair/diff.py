@@ -33,6 +33,7 @@ from prism.data.cache.types.command import VernacCommandData
 from prism.data.cache.types.project import ProjectCommitData
 from prism.language.gallina.analyze import SexpInfo
 from prism.util.diff import Change, GitDiff
+from prism.util.telemetry import timed
 
 
 def is_location_in_change(
@@ -232,6 +233,7 @@ def _compute_git_diff_file_sub(m: re.Match) -> str:
         return ""
 
 
+@timed("compute_git_diff")
 def compute_git_diff(a: ProjectCommitData, b: ProjectCommitData) -> GitDiff:
     """
     Compute a diff between extracted commits.
@@ -61,19 +61,24 @@ from prism.data.repair.align import (
     order_preserving_masked_alignment,
     right_file_offsets_from_aligned_commands,
 )
+from prism.data.repair.command_diff import (
+    CommandDiff,
+    FileDependenciesDiff,
+    FileDependenciesDiffLike,
+    VernacCommandDataDiff,
+    deserialize_command_diff,
+    deserialize_file_dependencies_diff,
+)
 from prism.data.repair.diff import compute_git_diff
 from prism.interface.coq.options import CoqWarningState, SerAPIOptions
 from prism.language.gallina.analyze import SexpInfo
+from prism.language.gallina.locations import LocArray
 from prism.project.metadata import ProjectMetadata
 from prism.util.alignment import Alignment
 from prism.util.diff import GitDiff
 from prism.util.opam import OpamSwitch, PackageFormula
 from prism.util.radpytools.dataclasses import Dataclass, default_field
-from prism.util.serialize import (
-    Serializable,
-    SerializableDataDiff,
-    deserialize_generic_dataclass,
-)
+from prism.util.serialize import Serializable, deserialize_generic_dataclass
 
 
 @dataclass
@@ -134,6 +139,33 @@ class LocDiff:
             loc.beg_charno + self.beg_charno_diff,
             loc.end_charno + self.end_charno_diff)
 
+    def patch_array(self, locs: LocArray) -> LocArray:
+        """
+        Apply the change to each of an array of locations.
+
+        Parameters
+        ----------
+        locs : LocArray
+            An array of locations.
+
+        Returns
+        -------
+        LocArray
+            A new array of locations resulting from applying this diff
+            to each location in `locs`.
+        """
+        return locs.translate(
+            self.after_filename,
+            np.array(
+                [
+                    self.lineno_diff,
+                    self.bol_pos_diff,
+                    self.lineno_last_diff,
+                    self.bol_pos_last_diff,
+                    self.beg_charno_diff,
+                    self.end_charno_diff
+                ]))
+
     @classmethod
     def compute_diff(cls, a: SexpInfo.Loc, b: SexpInfo.Loc) -> 'LocDiff':
         """
@@ -220,9 +252,8 @@ class VernacCommandDataListDiff:
     These new commands are presumed to be completely novel and not arise
     from relocating commands from other files.
     """
-    affected_commands: Dict[
-        int,
-        SerializableDataDiff[VernacCommandData]] = default_field({})
+    affected_commands: Dict[int,
+                            CommandDiff] = default_field({})
     """
     A map from command indices in the original file to diffs that can be
     used to obtain commands that should replace the indexed commands.
@@ -231,9 +262,8 @@ class VernacCommandDataListDiff:
     be modified in content (AST/goals/hypotheses) as a side-effect of
     other changes.
     """
-    changed_commands: Dict[
-        int,
-        SerializableDataDiff[VernacCommandData]] = default_field({})
+    changed_commands: Dict[int,
+                           CommandDiff] = default_field({})
     """
     A map from command indices in the original file to diffs that can be
     used to obtain commands that should replace the indexed commands.
@@ -305,6 +335,8 @@ class VernacCommandDataListDiff:
         """
         # TODO: refactor to reduce complexity
         initial_command = initial_file[changed_command_idx]
+        # only the copy is relocated, so the location indices of
+        # `initial_file` and `final_state` remain valid
         broken_command = initial_command.shallow_copy()
         repair = self.changed_commands.pop(changed_command_idx)
         repaired_command = repair.patch(broken_command)
@@ -553,7 +585,7 @@ class VernacCommandDataListDiff:
             "The order of broken commands should not be changed after relocation"
         # recreate diff
         broken_command.proxy_location = repaired_command.spanning_location()
-        repair = SerializableDataDiff[VernacCommandData].compute_diff(
+        repair = VernacCommandDataDiff.compute_diff(
             initial_command,
             broken_command)
         self.affected_commands[changed_command_idx] = repair
@@ -583,20 +615,12 @@ class VernacCommandDataListDiff:
             clz=VernacCommandDataList,
             error='raise')
         affected_commands = {
-            int(k): v for k,
-            v in io.deserialize(
-                data['affected_commands'],
-                clz=Dict[str,
-                         SerializableDataDiff],
-                error='raise').items()
+            int(k): deserialize_command_diff(v)
+            for k, v in data['affected_commands'].items()
         }
         changed_commands = {
-            int(k): v for k,
-            v in io.deserialize(
-                data['changed_commands'],
-                clz=Dict[str,
-                         SerializableDataDiff],
-                error='raise').items()
+            int(k): deserialize_command_diff(v)
+            for k, v in data['changed_commands'].items()
         }
         dropped_commands = io.deserialize(
             data['dropped_commands'],
@@ -631,9 +655,8 @@ class ProjectCommitDataDiff:
     """
     A map containing per-file changes.
     """
-    file_dependencies_diff: SerializableDataDiff[Optional[Dict[
-        str,
-        List[str]]]] = default_field(SerializableDataDiff(""))
+    file_dependencies_diff: FileDependenciesDiffLike = default_field(
+        FileDependenciesDiff())
     """
     Any changes to the precomputed dependency graph between the files.
     """
@@ -655,10 +678,7 @@ class ProjectCommitDataDiff:
                 yield filename, command
 
     @property
-    def affected_commands(
-        self) -> Iterator[Tuple[str,
-                                int,
-                                SerializableDataDiff[VernacCommandData]]]:
+    def affected_commands(self) -> Iterator[Tuple[str, int, CommandDiff]]:
         """
         Get an iterator over commands indirectly affected in each file.
 
@@ -673,7 +693,7 @@ class ProjectCommitDataDiff:
         int
             The index of the affected command in the original state's
             list of commands for the file.
-        SerializableDataDiff[VernacCommandData]]
+        CommandDiff
             A diff that when applied to the original command yields the
             affected version.
         """
@@ -682,10 +702,7 @@ class ProjectCommitDataDiff:
                 yield filename, command_index, command_diff
 
     @property
-    def changed_commands(
-        self) -> Iterator[Tuple[str,
-                                int,
-                                SerializableDataDiff[VernacCommandData]]]:
+    def changed_commands(self) -> Iterator[Tuple[str, int, CommandDiff]]:
         """
         Get an iterator over commands changed in each file.
 
@@ -696,7 +713,7 @@ class ProjectCommitDataDiff:
         int
             The index of the changed command in the original state's
             list of commands for the file.
-        SerializableDataDiff[VernacCommandData]]
+        CommandDiff
             A diff that when applied to the original command yields the
             changed version.
         """
@@ -733,51 +750,55 @@ class ProjectCommitDataDiff:
         Apply offsets in the patch to locations of commands.
 
         The given `patched_command_data` is presumed to already be
-        repaired but for the offsets and sorted in canonical order (such
-        that nested commands appear before the commands that surround
-        them).
+        repaired but for the offsets.
+        The locations of each file are packed into a `LocArray` such
+        that the shifts induced by all offsets are computed at once, and
+        new locations are only created for shifted sentences.
         """
         for filename, change in self.command_changes.items():
-            # iterate in reverse order so that we can correctly detect
-            # nested commands and not need to offset the offsets
-            offsets = sorted(
-                change.offsets,
-                key=lambda p: p.beg_charno,
-                reverse=True)
+            offsets = change.offsets
             if not offsets:
                 continue
             commands = patched_command_data[filename]
-            for (command_index,
-                 sentence) in reversed(sorted(commands.indexed_sentences_iter(),
-                                              key=lambda p: p[1])):
-                sentence_loc = sentence.location
-                for offset in offsets:
-                    is_already_offset = command_index == offset.command_index
-                    if is_already_offset:
-                        continue
-                    if sentence_loc.beg_charno >= offset.end_charno:
-                        # starts after offset region
-                        sentence.location = sentence.location.shift(
-                            offset.excess_charno,
-                            offset.excess_lineno)
-                        continue
-                    overlaps_right = (
-                        sentence_loc.beg_charno >= offset.beg_charno
-                        and sentence_loc.end_charno > offset.end_charno)
-                    overlaps_left = (
-                        sentence_loc.beg_charno < offset.beg_charno
-                        and sentence_loc.end_charno > offset.beg_charno)
-                    is_subinterval = (
-                        sentence_loc.beg_charno >= offset.beg_charno
-                        and sentence_loc.end_charno <= offset.end_charno)
-                    if overlaps_right or overlaps_left or is_subinterval:
-                        raise RuntimeError(
-                            "Sentences cannot overlap with offset region."
-                            f" Offset: {offset}."
-                            f" Sentence: {sentence}")
+            command_indices, sentences = zip(*commands.indexed_sentences_iter())
+            command_indices = np.array(command_indices)
+            locs = LocArray.from_locs(s.location for s in sentences)
+            beg_charnos = locs.data['beg_charno']
+            end_charnos = locs.data['end_charno']
+            # accumulate the shift of each sentence relative to its
+            # original location
+            char_shifts = np.zeros(len(locs), dtype=np.int64)
+            line_shifts = np.zeros(len(locs), dtype=np.int64)
+            for offset in offsets:
+                is_not_already_offset = command_indices != offset.command_index
+                # starts after offset region
+                is_after = beg_charnos >= offset.end_charno
+                is_shifted = is_not_already_offset & is_after
+                char_shifts[is_shifted] += offset.excess_charno
+                line_shifts[is_shifted] += offset.excess_lineno
+                # overlaps right, overlaps left, or is a subinterval
+                is_overlapping = (
+                    is_not_already_offset & ~is_after & (
+                        (beg_charnos >= offset.beg_charno)
+                        | (end_charnos > offset.beg_charno)))
+                if is_overlapping.any():
+                    sentence = sentences[np.flatnonzero(is_overlapping)[0]]
+                    raise RuntimeError(
+                        "Sentences cannot overlap with offset region."
+                        f" Offset: {offset}."
+                        f" Sentence: {sentence}")
+            # only materialize locations that changed
+            is_shifted = (char_shifts != 0) | (line_shifts != 0)
+            shifted_indices = np.flatnonzero(is_shifted)
+            shifted_locs = locs[shifted_indices].shift(
+                char_shifts[shifted_indices],
+                line_shifts[shifted_indices])
+            for i, loc in zip(shifted_indices.tolist(), shifted_locs):
+                sentences[i].location = loc
             # drop proxy locations
             for offset in offsets:
                 commands[offset.command_index].proxy_location = None
+            commands.invalidate_location_index()
 
     def patch(self, data: ProjectCommitData) -> ProjectCommitData:
         """
@@ -898,10 +919,7 @@ class ProjectCommitDataDiff:
                 clz=Dict[str,
                          VernacCommandDataListDiff],
                 error='raise'),
-            io.deserialize(
-                data['file_dependencies_diff'],
-                clz=SerializableDataDiff,
-                error='raise'))
+            deserialize_file_dependencies_diff(data['file_dependencies_diff']))
 
     @classmethod
     def from_aligned_commands(
@@ -957,9 +975,9 @@ class ProjectCommitDataDiff:
                     filename,
                     VernacCommandDataListDiff())
                 if acmd != bcmd:
-                    command_diff = SerializableDataDiff[
-                        VernacCommandData].compute_diff(acmd,
-                                                        bcmd)
+                    command_diff = VernacCommandDataDiff.compute_diff(
+                        acmd,
+                        bcmd)
                     if acmd.all_text() != bcmd.all_text():
                         # changed command
                         container = file_diff.changed_commands
@@ -1020,7 +1038,7 @@ class ProjectCommitDataDiff:
         b.sort_commands()
         aligned_commands = get_aligned_commands(a, b, alignment)
         diff = cls.from_aligned_commands(aligned_commands)
-        diff.file_dependencies_diff = SerializableDataDiff.compute_diff(
+        diff.file_dependencies_diff = FileDependenciesDiff.compute_diff(
             a.file_dependencies,
             b.file_dependencies)
         if return_aligned_commands:
@@ -2207,8 +2225,7 @@ class ProjectCommitDataErrorInstance(ErrorInstance[ProjectCommitData,
                         commit_diff.command_changes[filename]
                         .added_commands[added_idx].shallow_copy())
             for filename, changed_idx in changeset.affected_commands:
-                # no need to copy since SerializableDataDiff is
-                # immutable
+                # no need to copy since command diffs are immutable
                 broken_state_diff.command_changes[filename].affected_commands[
                     changed_idx] = commit_diff.command_changes[
                         filename].affected_commands[changed_idx]
@@ -2237,7 +2254,7 @@ class ProjectCommitDataErrorInstance(ErrorInstance[ProjectCommitData,
         #   If it spans more lines/characters, then shift all commands
         #   that appear after the changed version by the difference.
         # Note that the shifting occurs at patch time to avoid needing
-        # to reconstruct all of the SerializableDataDiffs.
+        # to reconstruct all of the command diffs.
         # Nested commands introduce a significant complication.
         # The following possibilities are considered for nested
         # commands in two commits A and B where the former command x in
@@ -2385,7 +2402,7 @@ class ProjectCommitDataErrorInstance(ErrorInstance[ProjectCommitData,
 
 RepairAnnotator = Callable[[
     VernacCommandData,
-    SerializableDataDiff[VernacCommandData],
+    CommandDiff,
     ProjectCommitData,
     ProjectCommitData
 ],
@@ -2571,7 +2588,7 @@ class ProjectCommitDataRepairInstance(RepairInstance[ProjectCommitData,
         repaired_state_diff: ProjectCommitDataDiff,
         repaired_state: ProjectCommitData,
         broken_command: VernacCommandData,
-        repair: SerializableDataDiff[VernacCommandData],
+        repair: CommandDiff,
         get_tags: RepairAnnotator,
     ) -> 'ProjectCommitDataRepairInstance':
         """
@@ -2693,7 +2710,7 @@ class ProjectCommitDataRepairInstance(RepairInstance[ProjectCommitData,
     def default_get_repair_tags(
             cls,
             broken_command: VernacCommandData,
-            repair: SerializableDataDiff[VernacCommandData],
+            repair: CommandDiff,
             initial_state: ProjectCommitData,
             repaired_state: ProjectCommitData) -> Set[str]:
         """
@@ -2709,7 +2726,7 @@ class ProjectCommitDataRepairInstance(RepairInstance[ProjectCommitData,
         ----------
         broken_command : VernacCommandData
             The command in need of repair
-        repair : SerializableDataDiff[VernacCommandData]
+        repair : CommandDiff
             A diff that can be applied to the command to retrieve its
             repaired version via ``repair.patch(broken_command)``.
         initial_state : ProjectCommitData
@@ -24,16 +24,20 @@ Mine repair instances by looping over existing project build cache.
 import atexit
 import enum
 import faulthandler
+import functools
+import gzip
+import hashlib
 import logging
 import multiprocessing
 import multiprocessing.queues as mpq
 import os
 import select
-import shutil
 import sqlite3
+import threading
+import time
 import types
 import typing
-from dataclasses import asdict, dataclass
+from dataclasses import asdict, dataclass, replace
 from multiprocessing import Process, Queue
 from multiprocessing.synchronize import SemLock
 from pathlib import Path
@@ -65,6 +69,7 @@ from prism.data.commit_map import Except
 from prism.data.repair.instance import (
     ChangeSelection,
     ChangeSetMiner,
+    GitRepairInstance,
     ProjectCommitDataDiff,
     ProjectCommitDataErrorInstance,
     ProjectCommitDataRepairInstance,
@@ -74,10 +79,13 @@ from prism.project.metadata import ProjectMetadata
 from prism.project.metadata.storage import MetadataStorage
 from prism.project.repo import ProjectRepo
 from prism.util.debug import Debug
-from prism.util.io import Fmt, atomic_write
+from prism.util.io import Fmt, dumps, loads
 from prism.util.manager import ManagedServer, _override_multiprocessing_pickler
+from prism.util.pack import PackLocation, SegmentedPack
 from prism.util.path import append_suffix, with_suffixes
 from prism.util.radpytools.path import PathLike
+from prism.util.shared_memory import Shareable, SharedObjectStore, resolve
+from prism.util.telemetry import Telemetry, telemetry
 
 # HACK: allow multiprocessing Queue to be subscriptable
 type.__setattr__(
@@ -117,11 +125,12 @@ Dictionary labeling a cache object (project name, commit sha,
 Coq version).
 """
 AugmentedErrorInstance = Tuple[ProjectCommitDataErrorInstance,
-                               ProjectCommitData,
+                               Shareable[ProjectCommitData],
                                ChangeSelection]
 """
-A tuple containing an error instance, with the repaired state used to
-produce it, and the corresponding change selection.
+A tuple containing an error instance, with the repaired state (or a
+handle to it in shared memory) used to produce it, and the corresponding
+change selection.
 """
 AugmentedChangeSelectionList = Tuple[ProjectCommitData,
                                      ProjectCommitData,
@@ -177,18 +186,19 @@ class ErrorInstanceJob:
     Job for creating error instances.
     """
 
-    initial_state: ProjectCommitData
+    initial_state: Shareable[ProjectCommitData]
     """
-    A state of the project.
+    A state of the project or a handle to it in shared memory.
     """
-    repaired_state: ProjectCommitData
+    repaired_state: Shareable[ProjectCommitData]
     """
     A state based on the `initial_state` that contains at least one
-    change to a command.
+    change to a command or a handle to it in shared memory.
     """
-    diff: ProjectCommitDataDiff
+    diff: Shareable[ProjectCommitDataDiff]
     """
-    A precomputed diff between `initial_state` and `final_state`.
+    A precomputed diff between `initial_state` and `final_state` or a
+    handle to it in shared memory.
     """
     change_selection: ChangeSelection
     """
@@ -212,10 +222,10 @@ class RepairInstanceJob:
     """
     A preconstructed example of an error.
     """
-    repaired_state: ProjectCommitData
+    repaired_state: Shareable[ProjectCommitData]
     """
     A state based on that of `error_instance` that is presumed to be
-    repaired.
+    repaired or a handle to it in shared memory.
     """
     change_selection: ChangeSelection
     """
@@ -322,16 +332,16 @@ class JobID:
         elif isinstance(job, ErrorInstanceJob):
             job_id = JobID(
                 CacheObjectStatus.from_metadata(
-                    job.initial_state.project_metadata),
+                    resolve(job.initial_state).project_metadata),
                 CacheObjectStatus.from_metadata(
-                    job.repaired_state.project_metadata),
+                    resolve(job.repaired_state).project_metadata),
                 JobType.ERROR_INSTANCE)
         else:
             job_id = JobID(
                 CacheObjectStatus.from_metadata(
                     job.error_instance.project_metadata),
                 CacheObjectStatus.from_metadata(
-                    job.repaired_state.project_metadata),
+                    resolve(job.repaired_state).project_metadata),
                 JobType.REPAIR_INSTANCE)
         return job_id
 
@@ -359,6 +369,31 @@ class JobStatusMessage:
         return JobStatusMessage(JobID.from_job(job), size, status)
 
 
+class MiningOutcome(enum.Enum):
+    """
+    The recorded outcome of mining a commit pair or change selection.
+    """
+
+    REPAIRED = enum.auto()
+    """
+    A repair instance was mined and recorded.
+    """
+    NO_REPAIR = enum.auto()
+    """
+    Mining concluded without yielding a repair instance.
+    """
+    COMPLETED = enum.auto()
+    """
+    The outcome of each change selection of a commit pair is recorded.
+    """
+    FAILED = enum.auto()
+    """
+    Mining raised an exception.
+
+    Failed change selections are not retried when mining is resumed.
+    """
+
+
 class LoopControl(enum.Enum):
     """
     Control-flow enums for managing the main mining loop.
@@ -455,6 +490,116 @@ class CommitPairDBRecord(NamedTuple):
         """
         return cls(*record[: 5])
 
+    @classmethod
+    def from_cache_labels(
+            cls,
+            label_a: CacheObjectStatus,
+            label_b: CacheObjectStatus) -> 'CommitPairDBRecord':
+        """
+        Create a commit pair record from a pair of cache labels.
+        """
+        return cls(
+            label_a.project,
+            label_a.commit_hash,
+            label_b.commit_hash,
+            label_a.coq_version,
+            label_b.coq_version)
+
+
+class MiningFingerprint(NamedTuple):
+    """
+    A unique ID for a unit of repair mining work.
+
+    A fingerprint identifies either a commit pair as a whole or a single
+    change selection of a commit pair as mined with a particular
+    configuration of miners.
+    """
+
+    commit_pair: CommitPairDBRecord
+    """
+    The mined commit pair.
+    """
+    miner_config: str
+    """
+    A hash of the mining configuration as given by
+    `get_miner_config_hash`.
+    """
+    change_selection: str = ""
+    """
+    A hash of the mined change selection or an empty string if the
+    fingerprint identifies the commit pair as a whole.
+    """
+
+    def asdict(self) -> Dict[str, str]:
+        """
+        Get the fingerprint as a flat dictionary.
+        """
+        result = self.commit_pair.asdict()
+        result['miner_config'] = self.miner_config
+        result['change_selection'] = self.change_selection
+        return result
+
+    @classmethod
+    def from_change_selection(
+            cls,
+            commit_pair: CommitPairDBRecord,
+            miner_config: str,
+            change_selection: ChangeSelection) -> 'MiningFingerprint':
+        """
+        Get the fingerprint of a change selection of a commit pair.
+        """
+        joined = change_selection.as_joined_dict()
+        digest = hashlib.sha1(
+            "\n".join(f"{k}={joined[k]}"
+                      for k in sorted(joined)).encode("utf-8")).hexdigest()
+        return cls(commit_pair, miner_config, digest)
+
+
+def get_miner_config_hash(*config: Any) -> str:
+    """
+    Get a hash that identifies a configuration of repair mining.
+
+    Parameters
+    ----------
+    config : tuple of Any
+        Objects that affect the outcome of mining, e.g., the changeset
+        and repair miners.
+        Functions are identified by their qualified names, partial
+        applications by their functions and arguments, and other
+        objects by their representations.
+
+    Returns
+    -------
+    str
+        The hex digest of the configuration.
+    """
+    digest = hashlib.sha1()
+    for item in config:
+        digest.update(_get_miner_config_key(item).encode("utf-8"))
+        digest.update(b"\0")
+    return digest.hexdigest()
+
+
+def _get_miner_config_key(item: Any) -> str:
+    """
+    Get a string that identifies an item of a mining configuration.
+
+    Unlike the item's representation, the key does not depend on the
+    memory addresses of any functions that it contains.
+    """
+    if isinstance(item, functools.partial):
+        args = ", ".join(_get_miner_config_key(arg) for arg in item.args)
+        keywords = ", ".join(
+            f"{k}={_get_miner_config_key(v)}"
+            for k, v in sorted(item.keywords.items()))
+        return (
+            f"partial({_get_miner_config_key(item.func)}, ({args}), "
+            f"{{{keywords}}})")
+    elif callable(item) and hasattr(item, "__qualname__"):
+        return f"{item.__module__}.{item.__qualname__}"
+    else:
+        return repr(item)
+
 
 class RepairInstanceDBRecord(NamedTuple):
     """
@@ -569,9 +714,23 @@ class RepairInstanceDB:
     """
     Database for storing information about saved repair instances.
 
-    This is a single-table database. Each row in the table maps a set of
-    identifying details of a repair instance to the filename that stores
-    the serialized, saved repair instance.
+    Each row in the ``records`` table maps a set of identifying details
+    of a repair instance to the filename that stores the serialized,
+    saved repair instance.
+
+    Rather than being written as separate files, repair instances are
+    appended to a `SegmentedPack` within the database directory, and
+    the ``packed_files`` table maps each filename to its location in the
+    pack.
+    Files that are not in the pack (e.g., in databases created before
+    packing was introduced) are read from the database directory.
+
+    The ``fingerprints`` table records the outcome of mining each commit
+    pair and change selection (see `MiningFingerprint`), including those
+    that did not yield a repair, so that they need not be mined again.
+    The ``change_selection_counts`` table records the number of change
+    selections mined from each commit pair so that a completely mined
+    commit pair can be recognized without loading it.
     """
 
     # TODO: Normalize database using CommitPairDBRecord and
@@ -667,6 +826,135 @@ class RepairInstanceDB:
         FROM records
         ORDER BY id;
         """
+    _sql_create_packed_files_table = """
+        CREATE TABLE IF NOT EXISTS packed_files (
+            file_name text PRIMARY KEY,
+            segment integer NOT NULL,
+            byte_offset integer NOT NULL,
+            byte_length integer NOT NULL,
+            compressed integer NOT NULL
+        );"""
+    _sql_insert_packed_file = """
+        INSERT OR REPLACE INTO packed_files (
+            file_name,
+            segment,
+            byte_offset,
+            byte_length,
+            compressed)
+        VALUES(
+            :file_name,
+            :segment,
+            :byte_offset,
+            :byte_length,
+            :compressed);"""
+    _sql_get_packed_file = """
+        SELECT segment, byte_offset, byte_length, compressed
+        FROM packed_files
+        WHERE file_name = :file_name;"""
+    _sql_create_fingerprints_table = """
+        CREATE TABLE IF NOT EXISTS fingerprints (
+            project_name text NOT NULL,
+            initial_commit_sha text NOT NULL,
+            repaired_commit_sha text NOT NULL,
+            initial_coq_version text NOT NULL,
+            repaired_coq_version text NOT NULL,
+            miner_config text NOT NULL,
+            change_selection text NOT NULL,
+            outcome text NOT NULL,
+            PRIMARY KEY (
+                project_name,
+                initial_commit_sha,
+                repaired_commit_sha,
+                initial_coq_version,
+                repaired_coq_version,
+                miner_config,
+                change_selection)
+        );"""
+    _sql_insert_fingerprint = """
+        INSERT OR REPLACE INTO fingerprints (
+            project_name,
+            initial_commit_sha,
+            repaired_commit_sha,
+            initial_coq_version,
+            repaired_coq_version,
+            miner_config,
+            change_selection,
+            outcome)
+        VALUES(
+            :project_name,
+            :initial_commit_sha,
+            :repaired_commit_sha,
+            :initial_coq_version,
+            :repaired_coq_version,
+            :miner_config,
+            :change_selection,
+            :outcome);"""
+    _sql_get_fingerprint_outcome = """
+        SELECT outcome
+        FROM fingerprints
+        WHERE
+            project_name = :project_name
+            AND initial_commit_sha = :initial_commit_sha
+            AND repaired_commit_sha = :repaired_commit_sha
+            AND initial_coq_version = :initial_coq_version
+            AND repaired_coq_version = :repaired_coq_version
+            AND miner_config = :miner_config
+            AND change_selection = :change_selection;"""
+    _sql_create_change_selection_counts_table = """
+        CREATE TABLE IF NOT EXISTS change_selection_counts (
+            project_name text NOT NULL,
+            initial_commit_sha text NOT NULL,
+            repaired_commit_sha text NOT NULL,
+            initial_coq_version text NOT NULL,
+            repaired_coq_version text NOT NULL,
+            miner_config text NOT NULL,
+            num_change_selections integer NOT NULL,
+            PRIMARY KEY (
+                project_name,
+                initial_commit_sha,
+                repaired_commit_sha,
+                initial_coq_version,
+                repaired_coq_version,
+                miner_config)
+        );"""
+    _sql_insert_change_selection_count = """
+        INSERT OR REPLACE INTO change_selection_counts (
+            project_name,
+            initial_commit_sha,
+            repaired_commit_sha,
+            initial_coq_version,
+            repaired_coq_version,
+            miner_config,
+            num_change_selections)
+        VALUES(
+            :project_name,
+            :initial_commit_sha,
+            :repaired_commit_sha,
+            :initial_coq_version,
+            :repaired_coq_version,
+            :miner_config,
+            :num_change_selections);"""
+    _sql_get_change_selection_count = """
+        SELECT num_change_selections
+        FROM change_selection_counts
+        WHERE
+            project_name = :project_name
+            AND initial_commit_sha = :initial_commit_sha
+            AND repaired_commit_sha = :repaired_commit_sha
+            AND initial_coq_version = :initial_coq_version
+            AND repaired_coq_version = :repaired_coq_version
+            AND miner_config = :miner_config;"""
+    _sql_count_change_selection_fingerprints = """
+        SELECT COUNT(*)
+        FROM fingerprints
+        WHERE
+            project_name = :project_name
+            AND initial_commit_sha = :initial_commit_sha
+            AND repaired_commit_sha = :repaired_commit_sha
+            AND initial_coq_version = :initial_coq_version
+            AND repaired_coq_version = :repaired_coq_version
+            AND miner_config = :miner_config
+            AND change_selection != '';"""
     _fmt: Fmt = Fmt.json
     """
     The serialization format to use for saving/loading repair examples.
@@ -692,6 +980,12 @@ class RepairInstanceDB:
         self.db_directory.mkdir(parents=True, exist_ok=True)
         self.connection = sqlite3.connect(str(self.db_location), timeout=30)
         self.cursor = self.connection.cursor()
+        # Write-ahead logging lets readers (e.g., workers checking for
+        # existing records) proceed concurrently with the writer.
+        self.cursor.execute("PRAGMA journal_mode=WAL;")
+        self.cursor.execute("PRAGMA synchronous=NORMAL;")
+        self._pack: Optional[SegmentedPack] = None
+        self._pack_mark: Optional[PackLocation] = None
         self.create_table()
 
     def __contains__(self, record: object) -> bool:
@@ -742,12 +1036,9 @@ class RepairInstanceDB:
         traceback : Optional[TracebackType]
             Exception traceback, if an exception is raised
         """
-        self.cursor.close()
         if isinstance(exc_value, Exception):
-            self.connection.rollback()
-        else:
-            self.connection.commit()
-        self.connection.close()
+            self.rollback()
+        self.close()
 
     @property
     def db_location(self) -> Path:
@@ -756,12 +1047,57 @@ class RepairInstanceDB:
         """
         return self.db_directory / ".sqlite3"
 
+    @property
+    def pack(self) -> SegmentedPack:
+        """
+        Get the pack containing the database's repair instances.
+        """
+        if self._pack is None:
+            self._pack = SegmentedPack(self.db_directory / ".pack")
+        return self._pack
+
+    def commit(self) -> None:
+        """
+        Commit any pending insertions.
+
+        Files written to the pack are flushed before their index
+        entries are committed.
+        """
+        if self._pack is not None:
+            self._pack.flush()
+        self.connection.commit()
+        self._pack_mark = None
+
+    def rollback(self) -> None:
+        """
+        Roll back any pending insertions.
+
+        Files written to the pack since the last commit are discarded.
+        """
+        self.connection.rollback()
+        if self._pack_mark is not None:
+            self.pack.truncate(self._pack_mark)
+            self._pack_mark = None
+
+    def close(self) -> None:
+        """
+        Commit any pending insertions and close the database.
+        """
+        self.commit()
+        self.cursor.close()
+        self.connection.close()
+        if self._pack is not None:
+            self._pack.close()
+
     def create_table(self):
         """
-        Create the one table this database requires.
+        Create the tables this database requires.
         """
         self.cursor.execute(self._sql_create_records_table)
         self.cursor.execute(self._sql_create_natural_primary_key)
+        self.cursor.execute(self._sql_create_packed_files_table)
+        self.cursor.execute(self._sql_create_fingerprints_table)
+        self.cursor.execute(self._sql_create_change_selection_counts_table)
         self.connection.commit()
 
     def get(self, record: RepairInstanceDBRecord) -> RepairInstanceDBRecord:
@@ -794,10 +1130,24 @@ class RepairInstanceDB:
         records = {RepairInstanceDBRecord.from_row(row) for row in rows}
         return records
 
-    def insert(self, record: RepairInstanceDBRecord) -> int:
+    def insert(
+            self,
+            record: RepairInstanceDBRecord,
+            commit: bool = True) -> int:
         """
         Insert a new record into the database.
 
+        Parameters
+        ----------
+        record : RepairInstanceDBRecord
+            The record to insert.
+        commit : bool, optional
+            Whether to commit the transaction after the insertion, by
+            default True.
+            If False, then the caller is responsible for committing,
+            which allows one to batch many insertions into a single
+            transaction.
+
         Raises
         ------
         sqlite3.IntegrityError
@@ -806,7 +1156,8 @@ class RepairInstanceDB:
         record_dict = record.asdict()
         record_dict.pop("id")
         self.cursor.execute(self._sql_insert_record, record_dict)
-        self.connection.commit()
+        if commit:
+            self.commit()
         inserted_row = self.get(record)
         assert inserted_row.id is not None, \
             "No id was returned after the last record insertion."
@@ -816,7 +1167,8 @@ class RepairInstanceDB:
             self,
             record: Union[CommitPairDBRecord,
                           RepairInstanceDBRecord],
-            change_selection: Optional[ChangeSelection] = None) -> Path:
+            change_selection: Optional[ChangeSelection] = None,
+            commit: bool = True) -> Path:
         """
         Insert a repair instance record into the database.
 
@@ -828,6 +1180,9 @@ class RepairInstanceDB:
         change_selection : Optional[ChangeSelection], optional
             The selected changes that further identify the record,
             by default None.
+        commit : bool, optional
+            Whether to commit the transaction after the insertion, by
+            default True.
 
         Returns
         -------
@@ -869,7 +1224,7 @@ class RepairInstanceDB:
                 raise ValueError(
                     "An additional change selection must not be specified for the"
                     f" record from commit pair {record.commit_pair}")
-        recent_id = self.insert(record)
+        recent_id = self.insert(record, commit=False)
         associated_repairs = self.get_repairs(commit_pair)
         change_index = len(associated_repairs) - 1
         new_file_name = self.get_file_name(commit_pair, change_index)
@@ -879,9 +1234,308 @@ class RepairInstanceDB:
                 'file_name': str(new_file_name),
                 'row_id': recent_id
             })
-        self.connection.commit()
+        if commit:
+            self.commit()
         return self.db_directory / new_file_name
 
+    def record_outcome(
+            self,
+            fingerprint: MiningFingerprint,
+            outcome: MiningOutcome,
+            commit: bool = True) -> None:
+        """
+        Record the outcome of mining a commit pair or change selection.
+
+        Any previously recorded outcome for the same fingerprint is
+        replaced.
+
+        Parameters
+        ----------
+        fingerprint : MiningFingerprint
+            The fingerprint of the mined commit pair or change
+            selection.
+        outcome : MiningOutcome
+            The outcome of mining.
+        commit : bool, optional
+            Whether to commit the transaction after the insertion, by
+            default True.
+        """
+        values = fingerprint.asdict()
+        values['outcome'] = outcome.name
+        self.cursor.execute(self._sql_insert_fingerprint, values)
+        if commit:
+            self.commit()
+
+    def get_outcome(self,
+                    fingerprint: MiningFingerprint) -> Optional[MiningOutcome]:
+        """
+        Get the recorded outcome of mining, if any.
+
+        Parameters
+        ----------
+        fingerprint : MiningFingerprint
+            The fingerprint of a commit pair or change selection.
+
+        Returns
+        -------
+        Optional[MiningOutcome]
+            The recorded outcome or None if the identified commit pair
+            or change selection has not been mined.
+        """
+        self.cursor.execute(
+            self._sql_get_fingerprint_outcome,
+            fingerprint.asdict())
+        row = self.cursor.fetchone()
+        if row is None:
+            return None
+        return MiningOutcome[row[0]]
+
+    def count_mined_change_selections(
+            self,
+            commit_pair: CommitPairDBRecord,
+            miner_config: str) -> int:
+        """
+        Count the change selections of a commit pair with outcomes.
+
+        Parameters
+        ----------
+        commit_pair : CommitPairDBRecord
+            A commit pair.
+        miner_config : str
+            A hash of the mining configuration.
+
+        Returns
+        -------
+        int
+            The number of change selections of the commit pair whose
+            outcomes have been recorded for the given configuration.
+        """
+        self.cursor.execute(
+            self._sql_count_change_selection_fingerprints,
+            MiningFingerprint(commit_pair,
+                              miner_config).asdict())
+        return self.cursor.fetchone()[0]
+
+    def record_num_change_selections(
+            self,
+            commit_pair: CommitPairDBRecord,
+            miner_config: str,
+            num_change_selections: int,
+            commit: bool = True) -> None:
+        """
+        Record the number of change selections mined from a commit pair.
+
+        Parameters
+        ----------
+        commit_pair : CommitPairDBRecord
+            A commit pair.
+        miner_config : str
+            A hash of the mining configuration.
+        num_change_selections : int
+            The number of change selections mined from the commit pair.
+        commit : bool, optional
+            Whether to commit the transaction after the insertion, by
+            default True.
+        """
+        values = MiningFingerprint(commit_pair, miner_config).asdict()
+        values['num_change_selections'] = num_change_selections
+        self.cursor.execute(self._sql_insert_change_selection_count, values)
+        if commit:
+            self.commit()
+
+    def get_num_change_selections(
+            self,
+            commit_pair: CommitPairDBRecord,
+            miner_config: str) -> Optional[int]:
+        """
+        Get the number of change selections mined from a commit pair.
+
+        Parameters
+        ----------
+        commit_pair : CommitPairDBRecord
+            A commit pair.
+        miner_config : str
+            A hash of the mining configuration.
+
+        Returns
+        -------
+        Optional[int]
+            The recorded number of change selections or None if the
+            commit pair's change selections have not been mined.
+        """
+        self.cursor.execute(
+            self._sql_get_change_selection_count,
+            MiningFingerprint(commit_pair,
+                              miner_config).asdict())
+        row = self.cursor.fetchone()
+        if row is None:
+            return None
+        return row[0]
+
+    def is_mined(
+            self,
+            commit_pair: CommitPairDBRecord,
+            miner_config: str) -> bool:
+        """
+        Determine whether a commit pair has been completely mined.
+
+        A commit pair is completely mined if its outcome is recorded or
+        if the outcome of each of its change selections is recorded.
+
+        Parameters
+        ----------
+        commit_pair : CommitPairDBRecord
+            A commit pair.
+        miner_config : str
+            A hash of the mining configuration.
+
+        Returns
+        -------
+        bool
+            Whether the commit pair need not be mined again.
+        """
+        if self.get_outcome(MiningFingerprint(commit_pair,
+                                              miner_config)) is not None:
+            return True
+        num_change_selections = self.get_num_change_selections(
+            commit_pair,
+            miner_config)
+        return num_change_selections is not None and (
+            self.count_mined_change_selections(commit_pair,
+                                               miner_config)
+            >= num_change_selections)
+
+    def write_file(
+            self,
+            file_name: PathLike,
+            data: bytes,
+            compressed: bool = False,
+            commit: bool = True) -> None:
+        """
+        Write a file to the database's pack.
+
+        Parameters
+        ----------
+        file_name : PathLike
+            The path of the file relative to the root of the database,
+            e.g., as given by `get_file_name`.
+        data : bytes
+            The contents of the file.
+        compressed : bool, optional
+            Whether `data` is compressed with gzip, by default False.
+            Compressed files are transparently decompressed by
+            `read_file`.
+        commit : bool, optional
+            Whether to commit the transaction after the insertion, by
+            default True.
+        """
+        if self._pack_mark is None:
+            self._pack_mark = self.pack.tell()
+        location = self.pack.append(data)
+        self.cursor.execute(
+            self._sql_insert_packed_file,
+            {
+                'file_name': str(file_name),
+                'segment': location.segment,
+                'byte_offset': location.offset,
+                'byte_length': location.length,
+                'compressed': int(compressed)
+            })
+        if commit:
+            self.commit()
+
+    def _read_raw_file(self, file_name: PathLike) -> Tuple[bytes, bool]:
+        """
+        Read a file as stored and whether it is compressed.
+        """
+        self.cursor.execute(
+            self._sql_get_packed_file,
+            {
+                'file_name': str(file_name)
+            })
+        row = self.cursor.fetchone()
+        if row is None:
+            return (self.db_directory / file_name).read_bytes(), False
+        segment, offset, length, compressed = row
+        location = PackLocation(segment, offset, length)
+        return self.pack.read(location), bool(compressed)
+
+    def read_file(self, file_name: PathLike) -> bytes:
+        """
+        Read a file from the database's pack or directory.
+
+        Parameters
+        ----------
+        file_name : PathLike
+            The path of the file relative to the root of the database.
+
+        Returns
+        -------
+        bytes
+            The contents of the file.
+
+        Raises
+        ------
+        FileNotFoundError
+            If the file is neither in the pack nor the directory.
+        """
+        data, compressed = self._read_raw_file(file_name)
+        if compressed:
+            data = gzip.decompress(data)
+        return data
+
+    def load_repair_instance(
+        self,
+        record: RepairInstanceDBRecord,
+        compressed: bool = False
+    ) -> Union[ProjectCommitDataRepairInstance,
+               GitRepairInstance]:
+        """
+        Load the repair instance identified by a record.
+
+        Parameters
+        ----------
+        record : RepairInstanceDBRecord
+            A record in this database.
+        compressed : bool, optional
+            If True, then load the diff-compressed `GitRepairInstance`.
+            Otherwise, load the full `ProjectCommitDataRepairInstance`.
+            By default False.
+
+        Returns
+        -------
+        Union[ProjectCommitDataRepairInstance, GitRepairInstance]
+            The loaded repair instance.
+
+        Raises
+        ------
+        FileNotFoundError
+            If the repair instance cannot be found.
+        """
+        assert record.file_name is not None, \
+            "The record's file name must be defined"
+        clz: type
+        if compressed:
+            candidates = [self.get_compressed_file_name(record.file_name)]
+            clz = GitRepairInstance
+        else:
+            # databases packed before files were named by their
+            # uncompressed contents store the full instance as .gz
+            candidates = [
+                Path(record.file_name),
+                append_suffix(record.file_name,
+                              '.gz')
+            ]
+            clz = ProjectCommitDataRepairInstance
+        for candidate in candidates:
+            try:
+                data = self.read_file(candidate)
+            except FileNotFoundError:
+                continue
+            return loads(data, clz, self._fmt)
+        raise FileNotFoundError(
+            f"No repair instance found for {record.file_name}")
+
     def get_record(
             self,
             commit_pair: CommitPairDBRecord,
@@ -961,23 +1615,41 @@ class RepairInstanceDB:
         records = self.cursor.fetchall()
         yield from (RepairInstanceDBRecord.from_row(row) for row in records)
 
-    def merge(self,
-              other: 'RepairInstanceDB',
-              copy: bool = True) -> List[Tuple[Path,
-                                               Path]]:
+    def get_repair_instances_iter(
+        self,
+        compressed: bool = False
+    ) -> Iterator[Tuple[RepairInstanceDBRecord,
+                        Union[ProjectCommitDataRepairInstance,
+                              GitRepairInstance]]]:
+        """
+        Get an iterator over the database's records and instances.
+
+        Records are ordered as in `get_records_iter`, which matches the
+        order in which repair instances were appended to the pack.
+
+        Parameters
+        ----------
+        compressed : bool, optional
+            Whether to load diff-compressed `GitRepairInstance` objects
+            instead of full `ProjectCommitDataRepairInstance` objects,
+            by default False.
+        """
+        for record in self.get_records_iter():
+            yield record, self.load_repair_instance(record, compressed)
+
+    def merge(self, other: 'RepairInstanceDB') -> List[Tuple[Path, Path]]:
         """
         Add all non-duplicate records in another database to this one.
 
-        Repair instance files will also be copied to their appropriate
-        location in this database.
+        Repair instance files, whether packed or loose in `other`, are
+        copied into this database's pack under their new names along
+        with their compression flags.
+        All records are merged within a single transaction.
 
         Parameters
         ----------
         other : RepairInstanceDB
             Another repair instance database.
-        copy : bool, optional
-            If True, then go ahead and copy repair instance files from
-            the `other` database to this one.
 
         Returns
         -------
@@ -985,18 +1657,12 @@ class RepairInstanceDB:
             A list of pairs of paths mapping repair instance files
             indexed by `other` to their new locations indexed in `self`
             after the merge.
-
-        Raises
-        ------
-        FileNotFoundError
-            If `copy` is True but one of the repair instance files could
-            not be found.
         """
         path_map: List[Tuple[Path, Path]] = []
         for record in other.get_records_iter():
             if record not in self:
                 try:
-                    new_path = self.insert_record_get_path(record)
+                    new_path = self.insert_record_get_path(record, commit=False)
                 except sqlite3.IntegrityError:
                     # the record already exists in the database
                     pass
@@ -1004,18 +1670,22 @@ class RepairInstanceDB:
                     assert record.file_name is not None, \
                         "The old file path must be defined"
                     old_path = other.db_directory / record.file_name
-                    if copy:
-                        new_path.parent.mkdir(parents=True, exist_ok=True)
-                        for suffixes in self._exts:
-                            try:
-                                shutil.copy2(
-                                    with_suffixes(old_path,
-                                                  suffixes),
-                                    with_suffixes(new_path,
-                                                  suffixes))
-                            except FileNotFoundError:
-                                pass
+                    new_file_name = new_path.relative_to(self.db_directory)
+                    for suffixes in self._exts:
+                        try:
+                            data, compressed = other._read_raw_file(
+                                with_suffixes(record.file_name,
+                                              suffixes))
+                        except FileNotFoundError:
+                            continue
+                        self.write_file(
+                            with_suffixes(new_file_name,
+                                          suffixes),
+                            data,
+                            compressed,
+                            commit=False)
                     path_map.append((old_path, new_path))
+        self.commit()
         return path_map
 
     @classmethod
@@ -1133,88 +1803,543 @@ class RepairMiningLogger:
     @property
     def directory(self) -> Path:
         """
-        The directory in which the log is written.
+        The directory in which the log is written.
+        """
+        return self._directory
+
+    @property
+    def level(self) -> int:
+        """
+        The logging level.
+        """
+        return self.logger.level
+
+    @property
+    def logname(self) -> str:
+        """
+        The name of the log file, not including parent directories.
+        """
+        return self._logname
+
+    def write_debug_log(self, message: str):
+        """
+        Write a debug message.
+
+        Parameters
+        ----------
+        message : str
+            Message to write as a debug message to the logger.
+        """
+        self.logger.debug(message)
+
+    def write_exception_log(self, exception: Except[None]):
+        """
+        Write a log entry for the given exception.
+
+        Parameters
+        ----------
+        exception : Except[None]
+            Exception to write a log entry for
+        """
+        self.logger.exception(exception.exception)
+        self.logger.error(f"Traceback: {exception.trace}")
+
+    @classmethod
+    def safe_write_debug_log(
+            cls,
+            lock: SemLock,
+            logger: 'RepairMiningLogger',
+            message: str):
+        """
+        Write a debug message in a thread-safe manner.
+
+        Notes
+        -----
+        This is a workaround to a bug in Python's multiprocessing
+        implementation that causes a race condition:
+        https://github.com/python/cpython/issues/84582.
+        The workaround was suggested in
+        https://stackoverflow.com/a/75466266.
+        The workaround did not observably work due to memory issues,
+        but it might work with a small enough number of workers.
+        """
+        with lock:
+            logger.write_debug_log(message)
+
+    @classmethod
+    def safe_write_exception_log(
+            cls,
+            lock: SemLock,
+            logger: 'RepairMiningLogger',
+            exception: Except[None]):
+        """
+        Write a log entry for the given exception.
+        """
+        with lock:
+            logger.write_exception_log(exception)
+
+
+class RepairMiningLoggerServer(ManagedServer[RepairMiningLogger]):
+    """
+    A BaseManager-derived server for managing repair mining logs.
+    """
+
+    pass
+
+
+@dataclass(frozen=True)
+class RepairInstanceWriteRequest:
+    """
+    A request to record a serialized repair instance in a database.
+    """
+
+    commit_pair: CommitPairDBRecord
+    """
+    The commit pair from which the repair instance was mined.
+    """
+    change_selection: ChangeSelection
+    """
+    The change selection that identifies the repair instance.
+    """
+    repair_instance: bytes
+    """
+    The gzip-compressed serialization of a
+    `ProjectCommitDataRepairInstance`.
+    """
+    compressed_repair_instance: bytes
+    """
+    The gzip-compressed serialization of the corresponding
+    `GitRepairInstance`.
+    """
+    fingerprint: Optional[MiningFingerprint] = None
+    """
+    The fingerprint of the change selection, if any, whose outcome
+    should be recorded along with the repair instance.
+    """
+
+    @classmethod
+    def from_repair_instance(
+        cls,
+        repair_instance: ProjectCommitDataRepairInstance,
+        change_selection: ChangeSelection,
+        repaired_state_metadata: ProjectMetadata,
+        fingerprint: Optional[MiningFingerprint] = None
+    ) -> 'RepairInstanceWriteRequest':
+        """
+        Serialize a repair instance for recording in a database.
+
+        Parameters
+        ----------
+        repair_instance : ProjectCommitDataRepairInstance
+            A mined repair instance.
+        change_selection : ChangeSelection
+            Change selection that corresponds to this repair instance.
+        repaired_state_metadata : ProjectMetadata
+            Metadata for the repaired state.
+        fingerprint : Optional[MiningFingerprint], optional
+            The fingerprint of the change selection, by default None.
+
+        Returns
+        -------
+        RepairInstanceWriteRequest
+            The request to write the serialized repair instance.
+        """
+        initial_metadata = \
+            repair_instance.error.initial_state.project_state.project_metadata
+        assert initial_metadata.commit_sha is not None
+        assert initial_metadata.coq_version is not None
+        assert repaired_state_metadata.commit_sha is not None
+        assert repaired_state_metadata.coq_version is not None
+        with telemetry.span("compression") as span:
+            serialized = dumps(
+                repair_instance,
+                RepairInstanceDB._fmt,
+                use_gzip_compression=True)
+            compressed = dumps(
+                repair_instance.compress(),
+                RepairInstanceDB._fmt,
+                use_gzip_compression=True)
+            span.nbytes = len(serialized) + len(compressed)
+        return cls(
+            CommitPairDBRecord.from_metadata(
+                initial_metadata,
+                repaired_state_metadata),
+            change_selection,
+            serialized,
+            compressed,
+            fingerprint)
+
+    def write(self, db: RepairInstanceDB, commit: bool = True) -> Path:
+        """
+        Record the repair instance in the given database.
+
+        Parameters
+        ----------
+        db : RepairInstanceDB
+            The database in which to record the repair instance.
+        commit : bool, optional
+            Whether to commit the inserted record, by default True.
+
+        Returns
+        -------
+        Path
+            The path by which the full repair instance is identified.
+
+        Raises
+        ------
+        sqlite3.IntegrityError
+            If the repair instance has already been recorded.
+        """
+        file_path = db.insert_record_get_path(
+            self.commit_pair,
+            self.change_selection,
+            commit=False)
+        file_name = file_path.relative_to(db.db_directory)
+        if self.fingerprint is not None:
+            db.record_outcome(
+                self.fingerprint,
+                MiningOutcome.REPAIRED,
+                commit=False)
+        db.write_file(
+            file_name,
+            self.repair_instance,
+            compressed=True,
+            commit=False)
+        db.write_file(
+            db.get_compressed_file_name(file_name),
+            self.compressed_repair_instance,
+            compressed=True,
+            commit=commit)
+        return file_path
+
+
+@dataclass(frozen=True)
+class MiningOutcomeWriteRequest:
+    """
+    A request to record the outcome of mining in a database.
+    """
+
+    fingerprint: MiningFingerprint
+    """
+    The fingerprint of the mined commit pair or change selection.
+    """
+    outcome: MiningOutcome
+    """
+    The outcome of mining.
+    """
+
+    @property
+    def commit_pair(self) -> CommitPairDBRecord:
+        """
+        Get the mined commit pair.
+        """
+        return self.fingerprint.commit_pair
+
+    def write(self, db: RepairInstanceDB, commit: bool = True) -> None:
+        """
+        Record the outcome in the given database.
+        """
+        db.record_outcome(self.fingerprint, self.outcome, commit)
+
+
+@dataclass(frozen=True)
+class CommitPairCompletionRequest:
+    """
+    A request to record that a commit pair has been completely mined.
+
+    The commit pair is only recorded as `MiningOutcome.COMPLETED` if the
+    outcome of each of its change selections has been recorded.
+    The number of change selections is recorded regardless so that
+    mining can be resumed without loading a completely mined pair.
+    """
+
+    commit_pair: CommitPairDBRecord
+    """
+    The mined commit pair.
+    """
+    miner_config: str
+    """
+    A hash of the mining configuration.
+    """
+    num_change_selections: int
+    """
+    The number of change selections mined from the commit pair.
+    """
+
+    def write(self, db: RepairInstanceDB, commit: bool = True) -> None:
+        """
+        Record the commit pair's completion in the given database.
+        """
+        db.record_num_change_selections(
+            self.commit_pair,
+            self.miner_config,
+            self.num_change_selections,
+            commit=False)
+        num_mined = db.count_mined_change_selections(
+            self.commit_pair,
+            self.miner_config)
+        if num_mined >= self.num_change_selections:
+            db.record_outcome(
+                MiningFingerprint(self.commit_pair,
+                                  self.miner_config),
+                MiningOutcome.COMPLETED,
+                commit=False)
+        if commit:
+            db.commit()
+
+
+DBWriteRequest = Union[RepairInstanceWriteRequest,
+                       MiningOutcomeWriteRequest,
+                       CommitPairCompletionRequest]
+"""
+A request that may be submitted to a `RepairInstanceDBWriter`.
+"""
+
+
+class RepairInstanceDBWriter:
+    """
+    A single writer that records repair instances in batches.
+
+    Mining workers serialize repair instances themselves and submit
+    them through `queue` as `RepairInstanceWriteRequest` objects along
+    with the outcomes of mining (see `DBWriteRequest`).
+    The writer runs in a thread of the parent process and inserts each
+    batch of received requests within one transaction, which avoids
+    contention between workers for the database's lock and the
+    overhead of committing each record separately.
+    """
+
+    def __init__(
+            self,
+            db_directory: PathLike,
+            repair_mining_logger: RepairMiningLogger,
+            batch_size: int = 64,
+            flush_interval: float = 1.0):
+        self.db_directory = Path(db_directory)
+        """
+        The directory containing the database.
+        """
+        self.repair_mining_logger = repair_mining_logger
         """
-        return self._directory
-
-    @property
-    def level(self) -> int:
+        The object used to log errors and debug messages.
         """
-        The logging level.
+        self.batch_size = batch_size
         """
-        return self.logger.level
+        The maximum number of records to insert per transaction.
+        """
+        self.flush_interval = flush_interval
+        """
+        The maximum number of seconds to wait for a batch to fill
+        before writing it.
+        """
+        self.queue: mpq.Queue[Union[DBWriteRequest, StopWorkSentinel]] = Queue()
+        """
+        The queue through which requests are submitted.
+        """
+        self.num_written = 0
+        """
+        The number of requests written so far.
+        """
+        self.failed: List[DBWriteRequest] = []
+        """
+        The requests that could not be written, even on their own.
+        """
+        self._thread = threading.Thread(
+            target=self._run,
+            name="RepairInstanceDBWriter",
+            daemon=True)
 
-    @property
-    def logname(self) -> str:
+    def __enter__(self) -> 'RepairInstanceDBWriter':
         """
-        The name of the log file, not including parent directories.
+        Start the writer.
         """
-        return self._logname
+        self.start()
+        return self
 
-    def write_debug_log(self, message: str):
+    def __exit__(
+            self,
+            ext_type: Optional[Type[BaseException]],
+            exc_value: Optional[BaseException],
+            traceback: Optional[TracebackType]):
         """
-        Write a debug message.
+        Stop the writer after writing any outstanding requests.
+        """
+        self.stop()
 
-        Parameters
-        ----------
-        message : str
-            Message to write as a debug message to the logger.
+    def _get_batch(self) -> Tuple[List[DBWriteRequest], bool]:
         """
-        self.logger.debug(message)
+        Get the next batch of requests and whether to stop afterwards.
+        """
+        batch: List[DBWriteRequest] = []
+        try:
+            request = self.queue.get(timeout=self.flush_interval)
+            while True:
+                if isinstance(request, StopWorkSentinel):
+                    return batch, True
+                batch.append(request)
+                if len(batch) >= self.batch_size:
+                    break
+                request = self.queue.get(timeout=0.01)
+        except Empty:
+            pass
+        return batch, False
+
+    def _run(self) -> None:
+        stop = False
+        with RepairInstanceDB(self.db_directory) as db:
+            while not stop:
+                batch, stop = self._get_batch()
+                if batch:
+                    try:
+                        self.write_batch(db, batch)
+                    except Exception:
+                        # already logged and kept in self.failed
+                        pass
+
+    def start(self) -> None:
+        """
+        Start writing submitted requests.
+        """
+        self._thread.start()
 
-    def write_exception_log(self, exception: Except[None]):
+    def stop(self) -> None:
         """
-        Write a log entry for the given exception.
+        Write any outstanding requests and stop the writer.
 
-        Parameters
-        ----------
-        exception : Except[None]
-            Exception to write a log entry for
+        Raises
+        ------
+        RuntimeError
+            If any request could not be written.
         """
-        self.logger.exception(exception.exception)
-        self.logger.error(f"Traceback: {exception.trace}")
+        if self._thread.is_alive():
+            self.queue.put(StopWorkSentinel())
+            self._thread.join()
+        _close_process_local_dbs()
+        if self.failed:
+            raise RuntimeError(
+                f"Failed to write {len(self.failed)} requests to "
+                f"{self.db_directory}; see the exception log for details")
 
-    @classmethod
-    def safe_write_debug_log(
-            cls,
-            lock: SemLock,
-            logger: 'RepairMiningLogger',
-            message: str):
+    def _write_requests(
+            self,
+            db: RepairInstanceDB,
+            requests: List[DBWriteRequest]) -> int:
         """
-        Write a debug message in a thread-safe manner.
+        Record requests in a single transaction.
 
-        Notes
-        -----
-        This is a workaround to a bug in Python's multiprocessing
-        implementation that causes a race condition:
-        https://github.com/python/cpython/issues/84582.
-        The workaround was suggested in
-        https://stackoverflow.com/a/75466266.
-        The workaround did not observably work due to memory issues,
-        but it might work with a small enough number of workers.
+        Returns
+        -------
+        int
+            The number of requests written.
         """
-        with lock:
-            logger.write_debug_log(message)
+        num_written = 0
+        with telemetry.span("db_write") as span:
+            for request in requests:
+                try:
+                    request.write(db, commit=False)
+                except sqlite3.IntegrityError:
+                    self.repair_mining_logger.write_debug_log(
+                        "[Writer] Skipping duplicate "
+                        f"{type(request).__name__} for "
+                        f"{request.commit_pair}")
+                else:
+                    num_written += 1
+                    if isinstance(request, RepairInstanceWriteRequest):
+                        span.nbytes += len(request.repair_instance) + len(
+                            request.compressed_repair_instance)
+            db.commit()
+        return num_written
+
+    def write_batch(
+            self,
+            db: RepairInstanceDB,
+            batch: List[DBWriteRequest]) -> int:
+        """
+        Record a batch of requests in a single transaction.
 
-    @classmethod
-    def safe_write_exception_log(
-            cls,
-            lock: SemLock,
-            logger: 'RepairMiningLogger',
-            exception: Except[None]):
+        Requests for repair instances that have already been recorded
+        are skipped.
+        If any error occurs while writing the batch, then the batch is
+        rolled back, including the files it wrote, and its requests are
+        retried one at a time so that one bad request does not cost the
+        others.
+        Requests that fail on their own are logged and kept in
+        `failed`.
+
+        Returns
+        -------
+        int
+            The number of requests written.
+
+        Raises
+        ------
+        Exception
+            The last error raised by a request that failed on its own,
+            once every other request in the batch has been written.
         """
-        Write a log entry for the given exception.
+        try:
+            num_written = self._write_requests(db, batch)
+        except Exception as e:
+            db.rollback()
+            if len(batch) == 1:
+                self._fail(batch[0], e)
+                raise
+            num_written = 0
+            error = None
+            for request in batch:
+                try:
+                    num_written += self._write_requests(db, [request])
+                except Exception as request_error:
+                    db.rollback()
+                    self._fail(request, request_error)
+                    error = request_error
+            self.num_written += num_written
+            if error is not None:
+                raise error
+            return num_written
+        self.num_written += num_written
+        return num_written
+
+    def _fail(self, request: DBWriteRequest, error: Exception) -> None:
         """
-        with lock:
-            logger.write_exception_log(exception)
+        Log and keep a request that could not be written.
+        """
+        self.failed.append(request)
+        self.repair_mining_logger.write_exception_log(
+            Except(None,
+                   error,
+                   format_exc(error)))
 
 
-class RepairMiningLoggerServer(ManagedServer[RepairMiningLogger]):
+_process_local_dbs: Dict[Tuple[Path,
+                               int],
+                         RepairInstanceDB] = {}
+"""
+Database connections reused within each process.
+"""
+
+
+def _get_process_local_db(db_directory: Path, pid: int) -> RepairInstanceDB:
     """
-    A BaseManager-derived server for managing repair mining logs.
+    Get a database connection that is reused within a process.
+
+    The process ID is part of the key so that forked processes do not
+    share connections.
     """
+    key = (db_directory, pid)
+    db = _process_local_dbs.get(key)
+    if db is None:
+        db = _process_local_dbs[key] = RepairInstanceDB(db_directory)
+    return db
 
-    pass
+
+def _close_process_local_dbs() -> None:
+    """
+    Close the connections opened by the current process, if any.
+    """
+    pid = os.getpid()
+    for key in [k for k in _process_local_dbs if k[1] == pid]:
+        _process_local_dbs.pop(key).close()
 
 
 def build_repair_instance(
@@ -1223,7 +2348,9 @@ def build_repair_instance(
         change_selection: ChangeSelection,
         repair_instance_db_directory: Path,
         miner: RepairMiner,
-        repair_mining_logger: RepairMiningLogger) -> BuildRepairInstanceOutput:
+        repair_mining_logger: RepairMiningLogger,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None) -> BuildRepairInstanceOutput:
     """
     Construct build repair instance from pairs of cache items.
 
@@ -1245,6 +2372,15 @@ def build_repair_instance(
     repair_mining_logger : RepairMiningLogger
         Object used to log errors and other debug messages during repair
         instance building
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter` through which to record
+        the mined repair instance, if any.
+        If None, then the repair instance is recorded directly.
+    miner_config : Optional[str], optional
+        A hash of the mining configuration, by default None.
+        If given, then the outcome of mining is recorded in the
+        database's fingerprint index, even if no repair is found or
+        mining fails.
 
     Returns
     -------
@@ -1255,20 +2391,34 @@ def build_repair_instance(
         return None
     """
     result = None
+    fingerprint = None
+    outcome = None
     try:
-        with RepairInstanceDB(repair_instance_db_directory) as db_instance:
-            initial_metadata = error_instance.project_metadata
-            repaired_metadata = repaired_state.project_metadata
-            commit_pair = CommitPairDBRecord.from_metadata(
-                initial_metadata,
-                repaired_metadata)
-            if db_instance.get_record(commit_pair, change_selection).id is None:
+        db_instance = _get_process_local_db(
+            repair_instance_db_directory,
+            os.getpid())
+        initial_metadata = error_instance.project_metadata
+        repaired_metadata = repaired_state.project_metadata
+        commit_pair = CommitPairDBRecord.from_metadata(
+            initial_metadata,
+            repaired_metadata)
+        if miner_config is not None:
+            fingerprint = MiningFingerprint.from_change_selection(
+                commit_pair,
+                miner_config,
+                change_selection)
+        if db_instance.get_record(commit_pair, change_selection).id is None:
+            with telemetry.span("make_repair_instance"):
                 result = miner(error_instance, repaired_state)
-            else:
-                result = None
+            if result is None:
+                outcome = MiningOutcome.NO_REPAIR
+        else:
+            result = None
+            outcome = MiningOutcome.REPAIRED
     except Exception as e:
         result = Except(None, e, format_exc(e))
         repair_mining_logger.write_exception_log(result)
+        outcome = MiningOutcome.FAILED
     finally:
         if result is not None:
             write_repair_instance(
@@ -1276,12 +2426,24 @@ def build_repair_instance(
                 change_selection,
                 repair_instance_db_directory,
                 repair_mining_logger,
-                repaired_state.project_metadata)
+                repaired_state.project_metadata,
+                writer_queue,
+                fingerprint)
+        if (not isinstance(result,
+                           ProjectCommitDataRepairInstance)
+                and fingerprint is not None and outcome is not None):
+            write_mining_outcome(
+                MiningOutcomeWriteRequest(fingerprint,
+                                          outcome),
+                repair_instance_db_directory,
+                writer_queue)
     return result
 
 
 def build_repair_instance_star(
-        args: RepairInstanceJob) -> BuildRepairInstanceOutput:
+        args: RepairInstanceJob,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None) -> BuildRepairInstanceOutput:
     """
     Split arguments and call build_repair_instance.
 
@@ -1289,6 +2451,12 @@ def build_repair_instance_star(
     ----------
     args : RepairInstanceJob
         Bundled arguments for build_repair_instance
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter` through which to record
+        the mined repair instance, if any.
+    miner_config : Optional[str], optional
+        A hash of the mining configuration with which to fingerprint
+        the outcome of mining, if any.
 
     Returns
     -------
@@ -1300,11 +2468,13 @@ def build_repair_instance_star(
     """
     return build_repair_instance(
         args.error_instance,
-        args.repaired_state,
+        resolve(args.repaired_state),
         args.change_selection,
         args.repair_instance_db_directory,
         args.miner,
-        args.repair_mining_logger)
+        args.repair_mining_logger,
+        writer_queue,
+        miner_config)
 
 
 def build_error_instance(
@@ -1339,12 +2509,13 @@ def build_error_instance(
         error was encountered.
     """
     try:
-        error_instance = ProjectCommitDataErrorInstance.make_error_instance(
-            initial_state,
-            repaired_state,
-            diff,
-            changeset,
-            ProjectCommitDataErrorInstance.default_get_error_tags)
+        with telemetry.span("make_error_instance"):
+            error_instance = ProjectCommitDataErrorInstance.make_error_instance(
+                initial_state,
+                repaired_state,
+                diff,
+                changeset,
+                ProjectCommitDataErrorInstance.default_get_error_tags)
     except Exception as e:
         result = Except(None, e, format_exc(e))
         repair_mining_logger.write_exception_log(result)
@@ -1366,18 +2537,23 @@ def build_error_instance_star(
 
     Returns
     -------
-    BuildRepairInstanceOutput
-        If repair mining was successful, return the output
-        If repair mining raise an error, return an Except[None]
-        If there was no error but no repair instance was produced,
-        return None
+    AugmentedErrorInstance | Except[None]
+        An augmented error instance if successful or Except[None] if an
+        error was encountered.
+        The repaired state of the augmented error instance is the same
+        object (or shared memory handle) given in `args`.
     """
-    return build_error_instance(
-        args.initial_state,
-        args.repaired_state,
-        args.diff,
+    result = build_error_instance(
+        resolve(args.initial_state),
+        resolve(args.repaired_state),
+        resolve(args.diff),
         args.change_selection,
         args.repair_mining_logger)
+    if not isinstance(result, Except):
+        # pass along the handle (if any) rather than the repaired state
+        error_instance, _, changeset = result
+        result = (error_instance, args.repaired_state, changeset)
+    return result
 
 
 def mine_changesets_from_label_pair(
@@ -1425,17 +2601,27 @@ def mine_changesets_from_label_pair(
     """
     try:
         cache = CoqProjectBuildCache(cache_root, cache_fmt_extension)
-        initial_state = cache.get(
-            label_a.project,
-            label_a.commit_hash,
-            label_a.coq_version)
+        with telemetry.span("cache_load") as span:
+            initial_state = cache.get(
+                label_a.project,
+                label_a.commit_hash,
+                label_a.coq_version)
+            span.nbytes = cache.get_path_from_fields(
+                label_a.project,
+                label_a.commit_hash,
+                label_a.coq_version).stat().st_size
         repair_mining_logger.write_debug_log(
             "mine_changesets_from_label_pair: Finished loading cache for"
             f" label a: {label_a}.")
-        repaired_state = cache.get(
-            label_b.project,
-            label_b.commit_hash,
-            label_b.coq_version)
+        with telemetry.span("cache_load") as span:
+            repaired_state = cache.get(
+                label_b.project,
+                label_b.commit_hash,
+                label_b.coq_version)
+            span.nbytes = cache.get_path_from_fields(
+                label_b.project,
+                label_b.commit_hash,
+                label_b.coq_version).stat().st_size
         repair_mining_logger.write_debug_log(
             "mine_changesets_from_label_pair: Finished loading cache for"
             f" label b: {label_b}.")
@@ -1496,7 +2682,9 @@ def write_repair_instance(
         change_selection: ChangeSelection,
         repair_instance_db_directory: Path,
         repair_mining_logger: RepairMiningLogger,
-        repaired_state_metadata: ProjectMetadata):
+        repaired_state_metadata: ProjectMetadata,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        fingerprint: Optional[MiningFingerprint] = None):
     """
     Write a repair instance to disk, or log an exception.
 
@@ -1517,6 +2705,13 @@ def write_repair_instance(
     repaired_state_metadata : ProjectMetadata
         Metadata for the repaired state, used to determine the
         information to record for this instance.
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter`, if any.
+        If given, then the repair instance is serialized and submitted
+        to the writer instead of being written directly.
+    fingerprint : Optional[MiningFingerprint], optional
+        The fingerprint of the change selection to be recorded as
+        repaired along with the repair instance, if any.
 
     Raises
     ------
@@ -1525,30 +2720,17 @@ def write_repair_instance(
         nor of Except[None].
     """
     if isinstance(potential_diff, ProjectCommitDataRepairInstance):
-        with RepairInstanceDB(
-                repair_instance_db_directory) as repair_instance_db:
-            initial_metadata = \
-                potential_diff.error.initial_state.project_state.project_metadata
-            assert initial_metadata.commit_sha is not None
-            assert initial_metadata.coq_version is not None
-            assert repaired_state_metadata.commit_sha is not None
-            assert repaired_state_metadata.coq_version is not None
-
-            file_path = repair_instance_db.insert_record_get_path(
-                CommitPairDBRecord.from_metadata(
-                    initial_metadata,
-                    repaired_state_metadata),
-                change_selection)
-            atomic_write(
-                file_path,
-                potential_diff,
-                use_gzip_compression_for_serializable=True)
-            compressed_file_path = repair_instance_db.get_compressed_file_name(
-                file_path)
-            atomic_write(
-                compressed_file_path,
-                potential_diff.compress(),
-                use_gzip_compression_for_serializable=False)
+        request = RepairInstanceWriteRequest.from_repair_instance(
+            potential_diff,
+            change_selection,
+            repaired_state_metadata,
+            fingerprint)
+        if writer_queue is not None:
+            writer_queue.put(request)
+        else:
+            with RepairInstanceDB(
+                    repair_instance_db_directory) as repair_instance_db:
+                request.write(repair_instance_db)
     elif isinstance(potential_diff, Except):
         repair_mining_logger.write_exception_log(potential_diff)
     else:
@@ -1557,6 +2739,165 @@ def write_repair_instance(
             "written.")
 
 
+def write_mining_outcome(
+        request: Union[MiningOutcomeWriteRequest,
+                       CommitPairCompletionRequest],
+        repair_instance_db_directory: Path,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None) -> None:
+    """
+    Record the outcome of mining in the fingerprint index.
+
+    Parameters
+    ----------
+    request : Union[MiningOutcomeWriteRequest, \
+                    CommitPairCompletionRequest]
+        The outcome to record.
+    repair_instance_db_directory : Path
+        Path to the repair instance database.
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter`, if any.
+        If given, then the request is submitted to the writer instead
+        of being written directly.
+    """
+    if writer_queue is not None:
+        writer_queue.put(request)
+    else:
+        with RepairInstanceDB(repair_instance_db_directory) as db:
+            request.write(db)
+
+
+def write_mining_failure(
+        initial_state: ProjectCommitData,
+        repaired_state: ProjectCommitData,
+        change_selection: ChangeSelection,
+        repair_instance_db_directory: Path,
+        miner_config: str,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None) -> None:
+    """
+    Record that mining a change selection failed.
+
+    Parameters
+    ----------
+    initial_state : ProjectCommitData
+        The initial state of the mined commit pair.
+    repaired_state : ProjectCommitData
+        The repaired state of the mined commit pair.
+    change_selection : ChangeSelection
+        The change selection for which mining failed.
+    repair_instance_db_directory : Path
+        Path to the repair instance database.
+    miner_config : str
+        A hash of the mining configuration.
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter`, if any.
+    """
+    write_mining_outcome(
+        MiningOutcomeWriteRequest(
+            MiningFingerprint.from_change_selection(
+                CommitPairDBRecord.from_metadata(
+                    initial_state.project_metadata,
+                    repaired_state.project_metadata),
+                miner_config,
+                change_selection),
+            MiningOutcome.FAILED),
+        repair_instance_db_directory,
+        writer_queue)
+
+
+def skip_mined_change_selections(
+    changeset_mining_results: AugmentedChangeSelectionList,
+    repair_instance_db_directory: Path,
+    miner_config: str,
+    writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None
+) -> AugmentedChangeSelectionList:
+    """
+    Drop change selections whose outcomes have already been recorded.
+
+    If no change selections remain, then the commit pair as a whole is
+    recorded as mined.
+
+    Parameters
+    ----------
+    changeset_mining_results : AugmentedChangeSelectionList
+        The output of the changeset miner.
+    repair_instance_db_directory : Path
+        Path to the repair instance database.
+    miner_config : str
+        A hash of the mining configuration.
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter`, if any.
+
+    Returns
+    -------
+    AugmentedChangeSelectionList
+        The given results sans previously mined change selections.
+    """
+    initial_state, repaired_state, diff, change_selections = changeset_mining_results
+    commit_pair = CommitPairDBRecord.from_metadata(
+        initial_state.project_metadata,
+        repaired_state.project_metadata)
+    db = _get_process_local_db(repair_instance_db_directory, os.getpid())
+    unmined_change_selections = [
+        change_selection for change_selection in change_selections
+        if db.get_outcome(
+            MiningFingerprint.from_change_selection(
+                commit_pair, miner_config, change_selection)) is None
+    ]
+    request: Union[MiningOutcomeWriteRequest, CommitPairCompletionRequest]
+    if change_selections:
+        # record the number of change selections (and the pair's
+        # completion if each has been mined) so that a resumed run can
+        # skip the pair before loading it
+        request = CommitPairCompletionRequest(
+            commit_pair,
+            miner_config,
+            len(change_selections))
+    else:
+        request = MiningOutcomeWriteRequest(
+            MiningFingerprint(commit_pair,
+                              miner_config),
+            MiningOutcome.NO_REPAIR)
+    write_mining_outcome(request, repair_instance_db_directory, writer_queue)
+    return (initial_state, repaired_state, diff, unmined_change_selections)
+
+
+def skip_mined_label_pairs(
+        cache_label_pairs: PreparePairsReturn,
+        repair_instance_db_directory: Path,
+        miner_config: str) -> PreparePairsReturn:
+    """
+    Drop commit pairs that have already been completely mined.
+
+    This check precedes the loading and alignment of any commit pair,
+    whereas previously mined change selections of partially mined
+    commit pairs can only be identified after alignment (see
+    `skip_mined_change_selections`).
+
+    Parameters
+    ----------
+    cache_label_pairs : PreparePairsReturn
+        Pairs of cache labels identifying commit pairs to mine.
+    repair_instance_db_directory : Path
+        Path to the repair instance database.
+    miner_config : str
+        A hash of the mining configuration.
+
+    Returns
+    -------
+    PreparePairsReturn
+        The pairs that have not been completely mined.
+    """
+    with RepairInstanceDB(repair_instance_db_directory) as db:
+        return [
+            (label_a,
+             label_b)
+            for label_a, label_b in cache_label_pairs
+            if not db.is_mined(
+                CommitPairDBRecord.from_cache_labels(label_a, label_b),
+                miner_config)
+        ]
+
+
 def _get_consecutive_commit_hashes(
         metadata_storage: MetadataStorage,
         project: str,
@@ -1584,10 +2925,28 @@ def _get_consecutive_commit_hashes(
     ]
 
 
+def _shared_state_keys(label_a: CacheObjectStatus,
+                       label_b: CacheObjectStatus) -> Tuple[str,
+                                                            str,
+                                                            str]:
+    """
+    Get keys for the states and diff of a commit pair in shared memory.
+
+    The keys identify the initial state, repaired state, and diff,
+    respectively, in a `SharedObjectStore`.
+    """
+    pair = (
+        f"{label_a.project}@{label_a.commit_hash}({label_a.coq_version})"
+        f"..{label_b.commit_hash}({label_b.coq_version})")
+    return (f"{pair}:initial", f"{pair}:repaired", f"{pair}:diff")
+
+
 def build_error_instance_creation_inputs(
         changeset_mining_results: Union[AugmentedChangeSelectionList,
                                         Except[None]],
-        repair_mining_logger: RepairMiningLogger) -> List[ErrorInstanceJob]:
+        repair_mining_logger: RepairMiningLogger,
+        object_store: Optional[SharedObjectStore] = None
+) -> List[ErrorInstanceJob]:
     """
     Build a repair instance job from error instance results.
 
@@ -1599,6 +2958,10 @@ def build_error_instance_creation_inputs(
     repair_mining_logger : RepairMiningLogger
         The object used to log errors and debug messages during repair
         mining
+    object_store : Optional[SharedObjectStore], optional
+        If given, then the states and diff are placed once in this
+        store and each job carries handles to them rather than copies.
+        By default None.
 
     Returns
     -------
@@ -1610,11 +2973,21 @@ def build_error_instance_creation_inputs(
     if isinstance(changeset_mining_results, Except):
         return []
     initial_state, repaired_state, diff, change_selections = changeset_mining_results
+    shared_initial_state: Shareable[ProjectCommitData] = initial_state
+    shared_repaired_state: Shareable[ProjectCommitData] = repaired_state
+    shared_diff: Shareable[ProjectCommitDataDiff] = diff
+    if object_store is not None and change_selections:
+        initial_key, repaired_key, diff_key = _shared_state_keys(
+            CacheObjectStatus.from_metadata(initial_state.project_metadata),
+            CacheObjectStatus.from_metadata(repaired_state.project_metadata))
+        shared_initial_state = object_store.put(initial_key, initial_state)
+        shared_repaired_state = object_store.put(repaired_key, repaired_state)
+        shared_diff = object_store.put(diff_key, diff)
     for change_selection in change_selections:
         error_instance_job = ErrorInstanceJob(
-            initial_state,
-            repaired_state,
-            diff,
+            shared_initial_state,
+            shared_repaired_state,
+            shared_diff,
             change_selection,
             repair_mining_logger)
         error_instance_jobs.append(error_instance_job)
@@ -1680,6 +3053,11 @@ def _worker_debug_file_prefix(worker_id: int, job_name: str) -> str:
 
 _WORKER_DEBUG_FILE_EXT = '.debug'
 
+_TELEMETRY_INTERVAL = 10.0
+"""
+The minimum number of seconds between reports of worker telemetry.
+"""
+
 
 def enqueue_or_shelve(
     worker_id: int,
@@ -1726,7 +3104,9 @@ def _mine_repairs(
         skip_errors: bool,
         worker_id: int,
         pending_messages: List[JobStatusMessage],
-        repair_mining_logger: RepairMiningLogger) -> LoopControl:
+        repair_mining_logger: RepairMiningLogger,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None) -> LoopControl:
     """
     Mine repairs from mined errors.
     """
@@ -1755,7 +3135,10 @@ def _mine_repairs(
                                     "mine_repairs"),
                                 suffix=_WORKER_DEBUG_FILE_EXT):
             if isinstance(repair_job, RepairInstanceJob):
-                result = build_repair_instance_star(repair_job)
+                result = build_repair_instance_star(
+                    repair_job,
+                    writer_queue,
+                    miner_config)
                 if not skip_errors and isinstance(result, Except):
                     worker_to_parent_queue.put(result)
                     return LoopControl.BREAK
@@ -1789,9 +3172,14 @@ def _mine_errors(
         worker_id: int,
         pending_messages: List[JobStatusMessage],
         pending_repair_jobs: List[RepairInstanceJob],
-        repair_mining_logger: RepairMiningLogger) -> LoopControl:
+        repair_mining_logger: RepairMiningLogger,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None) -> LoopControl:
     """
     Mine errors from mined changesets.
+
+    If a mining configuration hash is given, then change selections for
+    which error instances cannot be built are recorded as failed.
     """
     # Flush pending repair jobs first
     pending_repair_jobs = [
@@ -1818,6 +3206,14 @@ def _mine_errors(
                                 suffix=_WORKER_DEBUG_FILE_EXT):
             if isinstance(error_instance_job, ErrorInstanceJob):
                 result = build_error_instance_star(error_instance_job)
+                if isinstance(result, Except) and miner_config is not None:
+                    write_mining_failure(
+                        resolve(error_instance_job.initial_state),
+                        resolve(error_instance_job.repaired_state),
+                        error_instance_job.change_selection,
+                        repair_instance_db_directory,
+                        miner_config,
+                        writer_queue)
                 if not skip_errors and isinstance(result, Except):
                     worker_to_parent_queue.put(result)
                     return LoopControl.BREAK
@@ -1840,16 +3236,28 @@ def _mine_errors(
                             repair_instance_job_queue,
                             repair_instance_job,
                             repair_mining_logger)) is not None)
-                pending_message = enqueue_or_shelve(
-                    worker_id,
-                    worker_to_parent_queue,
+                progress = [
                     JobStatusMessage.from_job(
                         error_instance_job,
                         1,
-                        JobStatus.PROGRESSED),
-                    repair_mining_logger)
-                if pending_message is not None:
-                    pending_messages.append(pending_message)
+                        JobStatus.PROGRESSED)
+                ]
+                if not repair_instance_jobs:
+                    # count the missing repair as done so that the
+                    # pair's repair stage (and shared states) can finish
+                    progress.append(
+                        replace(
+                            progress[0],
+                            job_id=replace(
+                                progress[0].job_id,
+                                job_type=JobType.REPAIR_INSTANCE)))
+                pending_messages.extend(
+                    pending_message for message in progress if (
+                        pending_message := enqueue_or_shelve(
+                            worker_id,
+                            worker_to_parent_queue,
+                            message,
+                            repair_mining_logger)) is not None)
             elif isinstance(error_instance_job, JobStatusMessage):
                 pending_message = enqueue_or_shelve(
                     worker_id,
@@ -1877,9 +3285,16 @@ def _mine_changesets(
         worker_id: int,
         pending_messages: List[JobStatusMessage],
         pending_error_jobs: List[ErrorInstanceJob],
-        repair_mining_logger: RepairMiningLogger) -> LoopControl:
+        repair_mining_logger: RepairMiningLogger,
+        object_store: Optional[SharedObjectStore] = None,
+        repair_instance_db_directory: Optional[Path] = None,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None) -> LoopControl:
     """
     Mine changesets for inducing (presumed) errors.
+
+    If a mining configuration hash and database are given, then change
+    selections that have already been mined are skipped.
     """
     # Flush pending error jobs first
     pending_error_jobs = [
@@ -1909,11 +3324,23 @@ def _mine_changesets(
             if not skip_errors and isinstance(result, Except):
                 worker_to_parent_queue.put(result)
                 return LoopControl.BREAK
+            num_skipped = 0
+            if (not isinstance(result,
+                               Except) and miner_config is not None
+                    and repair_instance_db_directory is not None):
+                num_change_selections = len(result[3])
+                result = skip_mined_change_selections(
+                    result,
+                    repair_instance_db_directory,
+                    miner_config,
+                    writer_queue)
+                num_skipped = num_change_selections - len(result[3])
             # If skip_errors is true and result is an Except, the
             # following will immediately return an empty list.
             error_instance_jobs = build_error_instance_creation_inputs(
                 result,
-                changeset_mining_job.repair_mining_logger)
+                changeset_mining_job.repair_mining_logger,
+                object_store)
             repair_mining_logger.write_debug_log(
                 f"[Worker {worker_id}]"
                 f" Mined {len(error_instance_jobs)} changesets"
@@ -1940,11 +3367,31 @@ def _mine_changesets(
                         changeset_mining_job.label_a,
                         changeset_mining_job.label_b,
                         JobType.REPAIR_INSTANCE),
-                    len(error_instance_jobs),
+                    len(error_instance_jobs) + num_skipped,
                     JobStatus.QUEUED),
                 repair_mining_logger)
             if pending_message is not None:
                 pending_messages.append(pending_message)
+            if num_skipped:
+                # count previously mined change selections as repaired
+                skipped_message = JobStatusMessage(
+                    JobID(
+                        changeset_mining_job.label_a,
+                        changeset_mining_job.label_b,
+                        JobType.REPAIR_INSTANCE),
+                    num_skipped,
+                    JobStatus.PROGRESSED)
+                if pending_message is not None:
+                    # preserve order after the shelved queued message
+                    pending_messages.append(skipped_message)
+                else:
+                    pending_message = enqueue_or_shelve(
+                        worker_id,
+                        worker_to_parent_queue,
+                        skipped_message,
+                        repair_mining_logger)
+                    if pending_message is not None:
+                        pending_messages.append(pending_message)
             pending_error_jobs.extend(
                 pending_job for error_instance_job in error_instance_jobs if (
                     pending_job := enqueue_or_shelve(
@@ -1968,6 +3415,22 @@ def _mine_changesets(
     return LoopControl.PASS
 
 
+def _report_telemetry(
+    worker_to_parent_queue: mpq.Queue[Union[Except[None],
+                                            JobStatusMessage,
+                                            Telemetry]]
+) -> None:
+    """
+    Send the telemetry gathered by the current process to the parent.
+
+    Sent statistics are removed from the process's telemetry so that
+    each span is reported once.
+    """
+    drained = telemetry.drain()
+    if drained:
+        worker_to_parent_queue.put(drained)
+
+
 def mining_loop_worker(
     control_queue: mpq.Queue[StopWorkSentinel],
     changeset_mining_job_queue: mpq.Queue[ChangeSetMiningJob],
@@ -1975,11 +3438,15 @@ def mining_loop_worker(
                                               JobStatusMessage]],
     repair_instance_job_queue: mpq.Queue[RepairInstanceJob],
     worker_to_parent_queue: mpq.Queue[Union[Except[None],
-                                            JobStatusMessage]],
+                                            JobStatusMessage,
+                                            Telemetry]],
     repair_instance_db_directory: Path,
     repair_miner: RepairMiner,
     skip_errors: bool,
     repair_mining_logger: RepairMiningLogger,
+    object_store: Optional[SharedObjectStore],
+    writer_queue: Optional[mpq.Queue[DBWriteRequest]],
+    miner_config: Optional[str],
     worker_id: int,
 ) -> None:
     """
@@ -1997,7 +3464,7 @@ def mining_loop_worker(
         Queue from which to retrieve repair instance creation jobs
     worker_to_parent_queue : Queue
         Queue for messages that need to be communicated back to the
-        parent
+        parent, including periodic reports of the worker's telemetry
     repair_instance_db_directory : Path
         Path to database file containing repair instance records
     repair_miner : RepairMiner
@@ -2010,6 +3477,15 @@ def mining_loop_worker(
     repair_mining_logger : RepairMiningLogger
         The object used to log errors and debug messages during repair
         mining
+    object_store : Optional[SharedObjectStore]
+        A store in which to share mined states and diffs with other
+        workers, if any.
+    writer_queue : Optional[Queue]
+        The queue of a `RepairInstanceDBWriter` through which to record
+        mined repair instances, if any.
+    miner_config : Optional[str]
+        A hash of the mining configuration with which to fingerprint
+        mined commit pairs and change selections, if any.
     worker_id : int
         A unique ID for the worker process invoking this function.
     """
@@ -2035,6 +3511,9 @@ def mining_loop_worker(
                 except RuntimeError as e:
                     f.write(format_exc(e))
 
+    # do not report statistics inherited from the parent
+    telemetry.reset()
+    next_telemetry_report = time.monotonic() + _TELEMETRY_INTERVAL
     # items pending enqueuement
     pending_messages: List[JobStatusMessage] = []
     pending_repair_jobs: List[RepairInstanceJob] = []
@@ -2061,6 +3540,10 @@ def mining_loop_worker(
                 [],
                 30)
 
+            if time.monotonic() >= next_telemetry_report:
+                _report_telemetry(worker_to_parent_queue)
+                next_telemetry_report = time.monotonic() + _TELEMETRY_INTERVAL
+
             # #######################
             # Handle control messages
             # #######################
@@ -2082,7 +3565,9 @@ def mining_loop_worker(
                                 skip_errors,
                                 worker_id,
                                 pending_messages,
-                                repair_mining_logger):
+                                repair_mining_logger,
+                                writer_queue,
+                                miner_config):
                 case LoopControl.BREAK:
                     repair_mining_logger.write_debug_log(
                         f"[Worker {worker_id}] Breaking out of repair mining")
@@ -2103,7 +3588,9 @@ def mining_loop_worker(
                                worker_id,
                                pending_messages,
                                pending_repair_jobs,
-                               repair_mining_logger):
+                               repair_mining_logger,
+                               writer_queue,
+                               miner_config):
                 case LoopControl.BREAK:
                     repair_mining_logger.write_debug_log(
                         f"[Worker {worker_id}] Breaking out of error mining")
@@ -2122,7 +3609,11 @@ def mining_loop_worker(
                                    worker_id,
                                    pending_messages,
                                    pending_error_jobs,
-                                   repair_mining_logger):
+                                   repair_mining_logger,
+                                   object_store,
+                                   repair_instance_db_directory,
+                                   writer_queue,
+                                   miner_config):
                 case LoopControl.BREAK:
                     repair_mining_logger.write_debug_log(
                         f"[Worker {worker_id}] Breaking out of changeset mining"
@@ -2141,6 +3632,8 @@ def mining_loop_worker(
         worker_to_parent_queue.put(result)
         repair_mining_logger.write_exception_log(result)
     finally:
+        _report_telemetry(worker_to_parent_queue)
+        _close_process_local_dbs()
         repair_mining_logger.write_debug_log(f"[Worker {worker_id}] Exiting")
         repair_instance_job_queue.cancel_join_thread()
         error_instance_job_queue.cancel_join_thread()
@@ -2333,7 +3826,8 @@ def _serial_work(
         db_directory: Path,
         repair_miner: RepairMiner,
         skip_errors: bool,
-        fast: bool):
+        fast: bool,
+        miner_config: Optional[str] = None):
     for label_a, label_b in tqdm(cache_label_pairs, desc="Mining commit pair"):
         changesets = mine_changesets_from_label_pair(
             label_a,
@@ -2346,6 +3840,12 @@ def _serial_work(
             raise RuntimeError(
                 f"Exception: {changesets.exception}. "
                 f"{changesets.trace}")
+        num_change_selections = len(changesets[3])
+        if miner_config is not None:
+            changesets = skip_mined_change_selections(
+                changesets,
+                db_directory,
+                miner_config)
         (initial_state, repaired_state, commit_diff, changesets) = changesets
         for changeset in tqdm(changesets, desc="Repair instance mining"):
             result = build_error_instance(
@@ -2355,6 +3855,13 @@ def _serial_work(
                 changeset,
                 repair_mining_logger)
             if isinstance(result, Except):
+                if miner_config is not None:
+                    write_mining_failure(
+                        initial_state,
+                        repaired_state,
+                        changeset,
+                        db_directory,
+                        miner_config)
                 if not skip_errors:
                     raise RuntimeError(
                         f"Exception: {result.exception}. {result.trace}")
@@ -2366,18 +3873,32 @@ def _serial_work(
                 change_selection,
                 db_directory,
                 repair_miner,
-                repair_mining_logger)
+                repair_mining_logger,
+                miner_config=miner_config)
             if isinstance(result, Except) and not skip_errors:
                 raise RuntimeError(
                     f"Exception: {result.exception}. {result.trace}")
+        if miner_config is not None and changesets:
+            write_mining_outcome(
+                CommitPairCompletionRequest(
+                    CommitPairDBRecord.from_cache_labels(label_a,
+                                                         label_b),
+                    miner_config,
+                    num_change_selections),
+                db_directory)
 
 
 def _process_parallel_worker_message(
-    progress_bars: Dict[JobID,
-                        tqdm],
-    worker_msg: Union[JobStatusMessage,
-                      Except[None]]) -> Union[bool,
-                                              Except[None]]:
+        progress_bars: Dict[JobID,
+                            tqdm],
+        worker_msg: Union[JobStatusMessage,
+                          Except[None],
+                          Telemetry],
+        object_store: Optional[SharedObjectStore] = None,
+        writer_queue: Optional[mpq.Queue[DBWriteRequest]] = None,
+        miner_config: Optional[str] = None,
+        telemetry_bar: Optional[tqdm] = None) -> Union[bool,
+                                                       Except[None]]:
     """
     Process messages received from workers.
 
@@ -2385,8 +3906,23 @@ def _process_parallel_worker_message(
     ----------
     progress_bars : Dict[JobID, tqdm]
         A map from job IDs to progress bars.
-    worker_msg : Union[JobStatusMessage, Except[None]]
-        A message from a worker or a captured exception.
+    worker_msg : Union[JobStatusMessage, Except[None], Telemetry]
+        A message from a worker, a captured exception, or a report of
+        a worker's telemetry to be merged into the parent's telemetry.
+    object_store : Optional[SharedObjectStore], optional
+        A store of states and diffs shared with workers.
+        Objects for a commit pair are removed once all of the pair's
+        repair instance jobs have completed.
+    writer_queue : Optional[Queue], optional
+        The queue of a `RepairInstanceDBWriter`, if any.
+    miner_config : Optional[str], optional
+        A hash of the mining configuration, if any.
+        If given along with `writer_queue`, then a commit pair is
+        recorded as completely mined once all of its repair instance
+        jobs have completed.
+    telemetry_bar : Optional[tqdm], optional
+        A bar placed above the progress bars in which to display a
+        summary of the aggregated telemetry, if any.
 
     Returns
     -------
@@ -2400,6 +3936,10 @@ def _process_parallel_worker_message(
     try:
         if isinstance(worker_msg, Except):
             return worker_msg
+        elif isinstance(worker_msg, Telemetry):
+            telemetry.merge(worker_msg)
+            if telemetry_bar is not None:
+                telemetry_bar.set_description_str(telemetry.summary())
         elif worker_msg.status == JobStatus.COMPLETED:
             # a completion may arrive before each subtask
             return True
@@ -2409,7 +3949,7 @@ def _process_parallel_worker_message(
             progress_bars[worker_msg.job_id] = tqdm(
                 total=worker_msg.job_size,
                 desc=str(worker_msg.job_id),
-                position=len(progress_bars))
+                position=len(progress_bars) + int(telemetry_bar is not None))
         elif worker_msg.status == JobStatus.PROGRESSED:
             assert worker_msg.job_id in progress_bars, \
                 f"This job has not been queued: {worker_msg.job_id}"
@@ -2417,6 +3957,20 @@ def _process_parallel_worker_message(
             pbar.update(worker_msg.job_size)
             if pbar.n == pbar.total:
                 pbar.close()
+                job_id = worker_msg.job_id
+                if job_id.job_type == JobType.REPAIR_INSTANCE:
+                    if object_store is not None:
+                        for key in _shared_state_keys(job_id.label_a,
+                                                      job_id.label_b):
+                            object_store.remove(key)
+                    if writer_queue is not None and miner_config is not None:
+                        writer_queue.put(
+                            CommitPairCompletionRequest(
+                                CommitPairDBRecord.from_cache_labels(
+                                    job_id.label_a,
+                                    job_id.label_b),
+                                miner_config,
+                                pbar.total))
     except Exception as e:
         return Except(None, e, format_exc(e))
     return False
@@ -2432,9 +3986,12 @@ def _join_workers(
         for q in queues:
             while not q.empty():
                 try:
-                    q.get()
+                    item = q.get()
                 except Empty:
                     break
+                if isinstance(item, Telemetry):
+                    # keep the final reports of exiting workers
+                    telemetry.merge(item)
         repair_mining_logger.write_debug_log("[Main] Joining subprocesses...")
         for worker_process in worker_processes:
             worker_process.join(timeout)
@@ -2451,7 +4008,9 @@ def _parallel_work(
         repair_miner: RepairMiner,
         max_workers: int,
         skip_errors: bool,
-        fast: bool):
+        fast: bool,
+        miner_config: Optional[str] = None,
+        telemetry_file: Optional[Path] = None):
     changeset_mining_jobs = [
         ChangeSetMiningJob(
             label_a,
@@ -2468,7 +4027,18 @@ def _parallel_work(
                                               JobStatusMessage]] = Queue()
     repair_instance_job_queue: mpq.Queue[RepairInstanceJob] = Queue()
     worker_to_parent_queue: mpq.Queue[Union[Except[None],
-                                            JobStatusMessage]] = Queue()
+                                            JobStatusMessage,
+                                            Telemetry]] = Queue()
+    # share states and diffs between workers instead of pickling them
+    # into each job
+    object_store: Optional[SharedObjectStore] = None
+    if SharedObjectStore.is_supported():
+        object_store = SharedObjectStore(f"prism-mining-{os.getpid()}")
+    # funnel mined repair instances to a single batched writer
+    db_writer = RepairInstanceDBWriter(
+        repair_instance_db_directory,
+        repair_mining_logger)
+    db_writer.start()
     proc_args = [
         control_queue,
         changeset_mining_job_queue,
@@ -2478,7 +4048,10 @@ def _parallel_work(
         repair_instance_db_directory,
         repair_miner,
         skip_errors,
-        repair_mining_logger
+        repair_mining_logger,
+        object_store,
+        db_writer.queue,
+        miner_config
     ]
     worker_processes: List[Process] = []
     # Load initial job queue
@@ -2497,6 +4070,9 @@ def _parallel_work(
     delayed_exception = None
     progress_bars: Dict[JobID,
                         tqdm] = {}
+    # show a live summary of the workers' telemetry above the job bars
+    telemetry_bar = tqdm(bar_format="{desc}", position=0)
+    next_telemetry_export = time.monotonic() + _TELEMETRY_INTERVAL
     repair_mining_logger.write_debug_log("Switching to per-process logging")
     repair_mining_logger = RepairMiningLogger(
         repair_mining_logger.directory,
@@ -2522,7 +4098,11 @@ def _parallel_work(
             else:
                 job_completed = _process_parallel_worker_message(
                     progress_bars,
-                    worker_msg)
+                    worker_msg,
+                    object_store,
+                    db_writer.queue,
+                    miner_config,
+                    telemetry_bar)
                 if isinstance(job_completed, bool) and job_completed:
                     observed_sentinels += 1
                 elif not isinstance(job_completed, bool):
@@ -2532,23 +4112,35 @@ def _parallel_work(
                         "[Main] Exception received. Aborting")
                     repair_mining_logger.write_exception_log(delayed_exception)
                     break
+            if (telemetry_file is not None
+                    and time.monotonic() >= next_telemetry_export):
+                telemetry.dump(telemetry_file)
+                next_telemetry_export = time.monotonic() + _TELEMETRY_INTERVAL
     except KeyboardInterrupt:
         pass
-    # ...then stop the workers and their processes
-    repair_mining_logger.write_debug_log("[Main] Telling workers to stop")
-    for _ in range(len(multiprocessing.active_children()) - 1):
-        control_queue.put(StopWorkSentinel())
-    # and clear out the other queues and join the worker processes
-    _join_workers(
-        worker_processes,
-        [
-            changeset_mining_job_queue,
-            error_instance_job_queue,
-            repair_instance_job_queue,
-            worker_to_parent_queue
-        ],
-        repair_mining_logger,
-        5)
+    finally:
+        # ...then stop the workers and their processes
+        repair_mining_logger.write_debug_log("[Main] Telling workers to stop")
+        for _ in range(len(multiprocessing.active_children()) - 1):
+            control_queue.put(StopWorkSentinel())
+        # and clear out the other queues and join the worker processes
+        _join_workers(
+            worker_processes,
+            [
+                changeset_mining_job_queue,
+                error_instance_job_queue,
+                repair_instance_job_queue,
+                worker_to_parent_queue
+            ],
+            repair_mining_logger,
+            5)
+        # remove the shared states of any pairs left unfinished
+        if object_store is not None:
+            object_store.clear()
+        repair_mining_logger.write_debug_log(
+            "[Main] Waiting for outstanding repair instances to be written")
+        db_writer.stop()
+        telemetry_bar.close()
     if delayed_exception is not None:
         raise RuntimeError(
             f"Delayed exception: {delayed_exception.exception}."
@@ -2569,7 +4161,9 @@ def repair_mining_loop(
                                                Optional[List[str]]]] = None,
         logging_level: int = logging.DEBUG,
         skip_errors: bool = True,
-        fast: bool = False):
+        fast: bool = False,
+        skip_mined: bool = True,
+        telemetry_file: Optional[Path] = None):
     """
     Mine repair instances from the given build cache.
 
@@ -2621,8 +4215,22 @@ def repair_mining_loop(
         Otherwise, keep all data and yield commit-data-based repair
         instances as well.
         By default, False.
+    skip_mined : bool, optional
+        If True, then skip commit pairs and change selections whose
+        outcomes were recorded by a previous run with the same miners
+        and `fast` setting, and record the outcomes of this run.
+        By default, True.
+    telemetry_file : Optional[Path], optional
+        Path to a file to which timing and throughput statistics of
+        each stage of mining are periodically exported, by default
+        ``telemetry.json`` in `repair_instance_db_directory`.
+        Statistics are exported in the Prometheus text format if the
+        file has a ``.prom`` suffix and as JSON otherwise.
     """
     os.makedirs(str(repair_instance_db_directory), exist_ok=True)
+    if telemetry_file is None:
+        telemetry_file = repair_instance_db_directory / "telemetry.json"
+    telemetry.reset()
     if prepare_pairs is None:
         prepare_pairs = prepare_label_pairs
     if repair_miner is None:
@@ -2640,6 +4248,20 @@ def repair_mining_loop(
             *cache_args,
             metadata_storage,
             project_commit_hash_map)
+        miner_config = None
+        if skip_mined:
+            miner_config = get_miner_config_hash(
+                changeset_miner,
+                repair_miner,
+                fast)
+            num_pairs = len(cache_label_pairs)
+            cache_label_pairs = skip_mined_label_pairs(
+                cache_label_pairs,
+                repair_instance_db_directory,
+                miner_config)
+            repair_mining_logger.write_debug_log(
+                f"Skipping {num_pairs - len(cache_label_pairs)} of {num_pairs}"
+                " previously mined commit pairs")
         # ##############################################################
         # Serial processing
         # ##############################################################
@@ -2652,7 +4274,8 @@ def repair_mining_loop(
                 repair_instance_db_directory,
                 repair_miner,
                 skip_errors,
-                fast)
+                fast,
+                miner_config)
         # ##############################################################
         # Parallel processing
         # ##############################################################
@@ -2666,4 +4289,9 @@ def repair_mining_loop(
                 repair_miner,
                 max_workers,
                 skip_errors,
-                fast)
+                fast,
+                miner_config,
+                telemetry_file)
+        telemetry.dump(telemetry_file)
+        # release connections reused by this process, e.g., when serial
+        _close_process_local_dbs()
@@ -0,0 +1,122 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the prism.data.repair.command_diff module.
+"""
+import unittest
+
+import seutil as su
+
+from prism.data.cache.types.command import VernacCommandData
+from prism.data.cache.types.project import ProjectCommitData
+from prism.data.repair.command_diff import (
+    FileDependenciesDiff,
+    VernacCommandDataDiff,
+    deserialize_command_diff,
+    deserialize_file_dependencies_diff,
+)
+from prism.tests import _DATA_PATH
+from prism.util.serialize import SerializableDataDiff
+
+
+class TestCommandDiff(unittest.TestCase):
+    """
+    Tests for typed command diffs.
+    """
+
+    def test_VernacCommandDataDiff(self) -> None:
+        """
+        Verify that command diffs round-trip between sample commands.
+        """
+        for filename, a_commands in self.initial_state.command_data.items():
+            b_commands = self.repaired_state.command_data[filename]
+            for a, b in zip(a_commands, b_commands):
+                for x, y in [(a, b), (b, a), (a, a)]:
+                    diff = VernacCommandDataDiff.compute_diff(x, y)
+                    self.assertEqual(diff.patch(x), y)
+                    serialized = su.io.serialize(diff)
+                    self.assertEqual(deserialize_command_diff(serialized), diff)
+            # structurally different commands
+            a = a_commands[0]
+            b = max(b_commands, key=lambda c: len(c.sorted_sentences()))
+            self.assertEqual(
+                VernacCommandDataDiff.compute_diff(a,
+                                                   b).patch(a),
+                b)
+            self.assertEqual(
+                VernacCommandDataDiff.compute_diff(b,
+                                                   a).patch(b),
+                a)
+
+    def test_legacy(self) -> None:
+        """
+        Verify that diffs serialized by prior versions can be read.
+        """
+        a = next(iter(self.initial_state.command_data.values()))[0]
+        b = next(iter(self.repaired_state.command_data.values()))[1]
+        legacy = SerializableDataDiff[VernacCommandData].compute_diff(a, b)
+        diff = deserialize_command_diff(su.io.serialize(legacy))
+        self.assertIsInstance(diff, SerializableDataDiff)
+        self.assertEqual(diff.patch(a, VernacCommandData), b)
+        legacy = SerializableDataDiff.compute_diff({
+            'A.v': []
+        },
+                                                   None)
+        diff = deserialize_file_dependencies_diff(su.io.serialize(legacy))
+        self.assertIsInstance(diff, SerializableDataDiff)
+
+    def test_FileDependenciesDiff(self) -> None:
+        """
+        Verify that dependency graph diffs round-trip.
+        """
+        graphs = [
+            None,
+            {},
+            {
+                'A.v': [],
+                'B.v': ['A.v']
+            },
+            {
+                'B.v': ['A.v',
+                        'C.v'],
+                'C.v': []
+            }
+        ]
+        for a in graphs:
+            for b in graphs:
+                diff = FileDependenciesDiff.compute_diff(a, b)
+                self.assertEqual(diff.patch(a), b)
+                diff = deserialize_file_dependencies_diff(su.io.serialize(diff))
+                self.assertEqual(diff.patch(a), b)
+
+    @classmethod
+    def setUpClass(cls) -> None:
+        """
+        Load realistic sample cached data.
+        """
+        cls.initial_state = ProjectCommitData.load(
+            _DATA_PATH / "initial_state.json")
+        cls.repaired_state = ProjectCommitData.load(
+            _DATA_PATH / "repaired_state.json")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -33,6 +33,7 @@ from prism.data.cache.types.project import ProjectCommitData
 from prism.data.repair.align import default_align
 from prism.data.repair.diff import compute_git_diff
 from prism.data.repair.instance import (
+    ChangeSelection,
     GitRepairInstance,
     ProjectCommitDataDiff,
     ProjectCommitDataErrorInstance,
@@ -187,6 +188,52 @@ class TestRepairInstance(unittest.TestCase):
                 compressed_repair_instance,
                 self.compressed_repair_instance)
 
+    def test_drop_change_twice(self) -> None:
+        """
+        Verify that location indices stay current as changes are dropped.
+
+        Both changed commands of one file are left out of the broken
+        state, so `VernacCommandDataListDiff.drop_change` relocates
+        commands of the same file twice.
+        """
+        initial_state = ProjectCommitData.load(
+            _DATA_PATH / "initial_state.json")
+        initial_file = initial_state.command_data["exgcd.v"]
+        # build the cached index before any change is dropped
+        initial_file.location_index()
+        diff = typing.cast(
+            ProjectCommitDataDiff,
+            ProjectCommitDataDiff.from_commit_data(
+                initial_state,
+                self.repaired_state,
+                default_align))
+        self.assertEqual(
+            sorted(diff.command_changes["exgcd.v"].changed_commands),
+            [34,
+             35])
+        error_instance = ProjectCommitDataErrorInstance.make_error_instance(
+            initial_state,
+            self.repaired_state,
+            diff,
+            ChangeSelection(
+                dropped_commands=[("exgcd.v",
+                                   3),
+                                  ("totalhoarelogic.v",
+                                   3)]),
+            ProjectCommitDataErrorInstance.default_get_error_tags)
+        broken_state = error_instance.change.diff.patch(initial_state)
+        for commands in [initial_file, broken_state.command_data["exgcd.v"]]:
+            spans = [c.spanning_location() for c in commands]
+            self.assertEqual(list(commands.spanning_locations()), spans)
+            self.assertEqual(
+                [commands.get_covering(i) for i in range(len(commands))],
+                [
+                    {j
+                     for j, other in enumerate(spans)
+                     if other in span}
+                    for span in spans
+                ])
+
     @classmethod
     def setUpClass(cls) -> None:
         """
@@ -22,20 +22,50 @@
 Tests for the mining module.
 """
 
+import functools
+import gzip
+import logging
 import shutil
 import unittest
+from dataclasses import dataclass
 from pathlib import Path
 
+from prism.data.cache.server import CacheObjectStatus, CacheStatus
 from prism.data.repair.instance import ChangeSelection
 from prism.data.repair.mining import (
+    CommitPairCompletionRequest,
     CommitPairDBRecord,
+    MiningFingerprint,
+    MiningOutcome,
+    MiningOutcomeWriteRequest,
     RepairInstanceDB,
     RepairInstanceDBRecord,
+    RepairInstanceDBWriter,
+    RepairInstanceWriteRequest,
+    RepairMiningLogger,
+    get_miner_config_hash,
+    skip_mined_label_pairs,
 )
 
 TEST_DIR = Path(__file__).parent
 
 
+@dataclass(frozen=True)
+class _FailingWriteRequest:
+    """
+    A request that fails after writing a file.
+    """
+
+    commit_pair: CommitPairDBRecord
+
+    def write(self, db: RepairInstanceDB, commit: bool = True) -> None:
+        """
+        Write a file and then fail.
+        """
+        db.write_file("orphan", b"x" * 100, commit=False)
+        raise ValueError("bad request")
+
+
 class TestRepairInstanceDB(unittest.TestCase):
     """
     Class for testing RepairInstanceDB.
@@ -185,7 +215,7 @@ class TestRepairInstanceDB(unittest.TestCase):
                 old_path = alt_db.insert_record_get_path(
                     self._commit_pair,
                     change_selection=self._alt_change_selection)
-                db.merge(alt_db, copy=False)
+                db.merge(alt_db)
             records = list(db.get_records_iter())
         new_path = db.db_directory / db.get_file_name(self._commit_pair, 1)
         self.assertEqual(len(records), 2)
@@ -205,6 +235,167 @@ class TestRepairInstanceDB(unittest.TestCase):
         ]
         self.assertEqual(records, expected_records)
 
+    def test_merge_packed(self):
+        """
+        Verify that packed and loose files are copied when merging.
+        """
+        with RepairInstanceDB(self._alt_test_db_path) as alt_db:
+            packed_path = alt_db.insert_record_get_path(
+                self._commit_pair,
+                change_selection=self._change_selection)
+            alt_db.write_file(
+                alt_db.get_compressed_file_name(
+                    packed_path.relative_to(alt_db.db_directory)),
+                gzip.compress(b"packed"),
+                compressed=True)
+            loose_path = alt_db.insert_record_get_path(
+                self._commit_pair,
+                change_selection=self._alt_change_selection)
+            alt_db.get_compressed_file_name(loose_path).parent.mkdir(
+                parents=True,
+                exist_ok=True)
+            alt_db.get_compressed_file_name(loose_path).write_bytes(b"loose")
+            with RepairInstanceDB(self._test_db_path) as db:
+                path_map = db.merge(alt_db)
+                self.assertEqual(len(path_map), 2)
+                contents = [
+                    db.read_file(
+                        db.get_compressed_file_name(
+                            new_path.relative_to(db.db_directory)))
+                    for _,
+                    new_path in path_map
+                ]
+        self.assertEqual(contents, [b"packed", b"loose"])
+
+    def test_fingerprints(self):
+        """
+        Verify that mining outcomes are recorded and consulted.
+        """
+        miner_config = get_miner_config_hash(get_miner_config_hash, False)
+        self.assertNotEqual(
+            miner_config,
+            get_miner_config_hash(get_miner_config_hash,
+                                  True))
+        pair_fingerprint = MiningFingerprint(self._commit_pair, miner_config)
+        fingerprints = [
+            MiningFingerprint.from_change_selection(
+                self._commit_pair,
+                miner_config,
+                change_selection) for change_selection in
+            [self._change_selection, self._alt_change_selection]
+        ]
+        self.assertNotEqual(fingerprints[0], fingerprints[1])
+        completion = CommitPairCompletionRequest(
+            self._commit_pair,
+            miner_config,
+            2)
+        label_a = CacheObjectStatus(
+            "test_project",
+            "abcde",
+            "8.10.2",
+            CacheStatus.SUCCESS)
+        label_b = CacheObjectStatus(
+            "test_project",
+            "12345",
+            "8.10.2",
+            CacheStatus.SUCCESS)
+        with RepairInstanceDB(self._test_db_path) as db:
+            self.assertIsNone(db.get_outcome(fingerprints[0]))
+            MiningOutcomeWriteRequest(fingerprints[0],
+                                      MiningOutcome.NO_REPAIR).write(db)
+            self.assertEqual(
+                db.get_outcome(fingerprints[0]),
+                MiningOutcome.NO_REPAIR)
+            # the commit pair is incomplete until each selection is mined
+            completion.write(db)
+            self.assertIsNone(db.get_outcome(pair_fingerprint))
+            self.assertEqual(
+                db.get_num_change_selections(self._commit_pair,
+                                             miner_config),
+                2)
+            self.assertFalse(db.is_mined(self._commit_pair, miner_config))
+            db.record_outcome(fingerprints[1], MiningOutcome.REPAIRED)
+            self.assertEqual(
+                db.count_mined_change_selections(
+                    self._commit_pair,
+                    miner_config),
+                2)
+            completion.write(db)
+            self.assertEqual(
+                db.get_outcome(pair_fingerprint),
+                MiningOutcome.COMPLETED)
+        self.assertEqual(
+            skip_mined_label_pairs(
+                [(label_a,
+                  label_b),
+                 (label_b,
+                  label_a)],
+                self._test_db_path,
+                miner_config),
+            [(label_b,
+              label_a)])
+
+    def test_failed_change_selections(self):
+        """
+        Verify that failures complete a commit pair without loading it.
+        """
+        miner_config = get_miner_config_hash(get_miner_config_hash)
+        fingerprint = MiningFingerprint.from_change_selection(
+            self._commit_pair,
+            miner_config,
+            self._change_selection)
+        label_a = CacheObjectStatus(
+            "test_project",
+            "abcde",
+            "8.10.2",
+            CacheStatus.SUCCESS)
+        label_b = CacheObjectStatus(
+            "test_project",
+            "12345",
+            "8.10.2",
+            CacheStatus.SUCCESS)
+        with RepairInstanceDB(self._test_db_path) as db:
+            db.record_num_change_selections(self._commit_pair, miner_config, 1)
+            self.assertFalse(db.is_mined(self._commit_pair, miner_config))
+            MiningOutcomeWriteRequest(fingerprint,
+                                      MiningOutcome.FAILED).write(db)
+            self.assertTrue(db.is_mined(self._commit_pair, miner_config))
+        # the pair's own outcome was never recorded
+        self.assertEqual(
+            skip_mined_label_pairs(
+                [(label_a,
+                  label_b)],
+                self._test_db_path,
+                miner_config),
+            [])
+
+    def test_miner_config_hash(self):
+        """
+        Verify that partial applications are hashed consistently.
+        """
+
+        def make_miner(*args, **kwargs) -> functools.partial:
+
+            def miner(*args, **kwargs):
+                pass
+
+            return functools.partial(miner, *args, **kwargs)
+
+        # each partial wraps a distinct function object
+        self.assertEqual(
+            get_miner_config_hash(make_miner(1,
+                                             x=2)),
+            get_miner_config_hash(make_miner(1,
+                                             x=2)))
+        self.assertNotEqual(
+            get_miner_config_hash(make_miner(1,
+                                             x=2)),
+            get_miner_config_hash(make_miner(1,
+                                             x=3)))
+        self.assertNotEqual(
+            get_miner_config_hash(make_miner(1)),
+            get_miner_config_hash(make_miner(2)))
+
     def tearDown(self):
         """
         Remove the test database once each test is finished.
@@ -213,5 +404,104 @@ class TestRepairInstanceDB(unittest.TestCase):
         shutil.rmtree(self._alt_test_db_path, ignore_errors=True)
 
 
+class TestRepairInstanceDBWriter(unittest.TestCase):
+    """
+    Class for testing RepairInstanceDBWriter.
+    """
+
+    _test_db_path = TEST_DIR / "test_writer_db"
+
+    def setUp(self):
+        """
+        Create a logger in the test database directory.
+        """
+        self._test_db_path.mkdir(parents=True, exist_ok=True)
+        self.logger = RepairMiningLogger(self._test_db_path, logging.DEBUG)
+
+    def test_write(self):
+        """
+        Verify that submitted requests are written in batches.
+        """
+        commit_pair = TestRepairInstanceDB._commit_pair
+        selections = [
+            TestRepairInstanceDB._change_selection,
+            TestRepairInstanceDB._alt_change_selection
+        ]
+        with RepairInstanceDBWriter(self._test_db_path,
+                                    self.logger,
+                                    batch_size=2) as writer:
+            for i, selection in enumerate(selections):
+                writer.queue.put(
+                    RepairInstanceWriteRequest(
+                        commit_pair,
+                        selection,
+                        gzip.compress(f"full-{i}".encode()),
+                        gzip.compress(f"git-{i}".encode())))
+            # duplicates are skipped
+            writer.queue.put(
+                RepairInstanceWriteRequest(
+                    commit_pair,
+                    selections[0],
+                    gzip.compress(b"duplicate"),
+                    gzip.compress(b"duplicate")))
+        self.assertEqual(writer.num_written, 2)
+        with RepairInstanceDB(self._test_db_path) as db:
+            records = list(db.get_records_iter())
+            self.assertEqual(len(records), 2)
+            for i, record in enumerate(records):
+                assert record.file_name is not None
+                # instances are packed rather than written to files
+                self.assertFalse(
+                    (self._test_db_path / record.file_name).exists())
+                self.assertEqual(
+                    db.read_file(record.file_name),
+                    f"full-{i}".encode())
+                self.assertEqual(
+                    db.read_file(db.get_compressed_file_name(record.file_name)),
+                    f"git-{i}".encode())
+
+    def test_write_failure(self):
+        """
+        Verify that a failing request does not cost the rest of a batch.
+        """
+        commit_pair = TestRepairInstanceDB._commit_pair
+        selections = [
+            TestRepairInstanceDB._change_selection,
+            TestRepairInstanceDB._alt_change_selection
+        ]
+        failing = _FailingWriteRequest(commit_pair)
+        with self.assertRaises(RuntimeError):
+            with RepairInstanceDBWriter(self._test_db_path,
+                                        self.logger,
+                                        batch_size=3) as writer:
+                for i, selection in enumerate(selections):
+                    writer.queue.put(
+                        RepairInstanceWriteRequest(
+                            commit_pair,
+                            selection,
+                            gzip.compress(f"full-{i}".encode()),
+                            gzip.compress(f"git-{i}".encode())))
+                    if i == 0:
+                        writer.queue.put(failing)
+        self.assertEqual(writer.num_written, 2)
+        self.assertEqual(writer.failed, [failing])
+        with RepairInstanceDB(self._test_db_path) as db:
+            self.assertEqual(len(list(db.get_records_iter())), 2)
+            with self.assertRaises(FileNotFoundError):
+                db.read_file("orphan")
+            # the failed request's file is not left in the pack
+            size = sum(
+                len(gzip.compress(f"{kind}-{i}".encode()))
+                for i in range(2)
+                for kind in ["full", "git"])
+            self.assertEqual(db.pack.tell().offset, size)
+
+    def tearDown(self):
+        """
+        Remove the test database once each test is finished.
+        """
+        shutil.rmtree(self._test_db_path, ignore_errors=True)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,388 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+A memory-mapped index of sentence offsets for random sampling.
+"""
+import json
+import random
+from pathlib import Path
+from typing import Dict, Iterable, List, NamedTuple, Optional, Tuple
+
+import numpy as np
+
+from prism.util.radpytools import PathLike
+
+__all__ = ['SentenceOffset', 'SentenceOffsetIndex']
+
+_ROW_DTYPE = np.dtype(
+    [
+        ('project',
+         '<u4'),
+        ('commit',
+         '<u4'),
+        ('file',
+         '<u4'),
+        ('start',
+         '<i8'),
+        ('end',
+         '<i8'),
+    ])
+"""
+The layout of a row of the index.
+
+Projects, commits, and files are given as indices into the index's
+tables of names.
+"""
+
+
+class SentenceOffset(NamedTuple):
+    """
+    The location of a sentence in a dataset.
+    """
+
+    project: str
+    """
+    The name of the project containing the sentence.
+    """
+    commit: str
+    """
+    The commit SHA at which the sentence was indexed or an empty string
+    if the project is not a repository.
+    """
+    file: str
+    """
+    The path of the file containing the sentence relative to the root
+    of the project.
+    """
+    start: int
+    """
+    The offset of the sentence's first character in the file.
+    """
+    end: int
+    """
+    The offset one past the sentence's last character in the file.
+    """
+
+
+def _default_rng() -> np.random.Generator:
+    """
+    Get a generator seeded from the state of the `random` module.
+    """
+    return np.random.default_rng(random.getrandbits(64))
+
+
+class SentenceOffsetIndex:
+    """
+    A table of the locations of every sentence in a dataset.
+
+    The index is stored in a directory as a fixed-width binary array of
+    rows, an array of cumulative sampling weights for the rows, and a
+    JSON table of project, commit, and file names.
+    The arrays are memory-mapped when loaded, so opening an index is
+    cheap regardless of its size.
+
+    Rows are grouped by project, commit, and file, in that order, and
+    the rows of a file are ordered by their location in the file.
+    """
+
+    _ROWS = "rows.npy"
+    _WEIGHTS = "weights.npy"
+    _TABLES = "tables.json"
+
+    def __init__(
+            self,
+            rows: np.ndarray,
+            cumulative_weights: np.ndarray,
+            projects: List[str],
+            commits: List[str],
+            files: List[str],
+            uniform: bool) -> None:
+        self.rows = rows
+        """
+        The rows of the index.
+        """
+        self.cumulative_weights = cumulative_weights
+        """
+        The cumulative sum of each row's sampling weight.
+        """
+        self.projects = projects
+        """
+        The names of the indexed projects.
+        """
+        self.commits = commits
+        """
+        The names of the indexed commits.
+        """
+        self.files = files
+        """
+        The relative paths of the indexed files.
+        """
+        self.uniform = uniform
+        """
+        Whether each row has the same sampling weight.
+        """
+        self._project_ranges: Dict[str,
+                                   Tuple[int,
+                                         int]] = {}
+        project_ids = np.asarray(rows['project'])
+        for i, project in enumerate(projects):
+            self._project_ranges[project] = (
+                int(np.searchsorted(project_ids,
+                                    i,
+                                    'left')),
+                int(np.searchsorted(project_ids,
+                                    i,
+                                    'right')))
+
+    def __getitem__(self, i: int) -> SentenceOffset:  # noqa: D105
+        project, commit, file, start, end = self.rows[i].tolist()
+        return SentenceOffset(
+            self.projects[project],
+            self.commits[commit],
+            self.files[file],
+            start,
+            end)
+
+    def __len__(self) -> int:  # noqa: D105
+        return len(self.rows)
+
+    def _sample_index(
+            self,
+            rng: np.random.Generator,
+            project: Optional[str]) -> int:
+        if project is None:
+            lo, hi = 0, len(self.rows)
+        else:
+            lo, hi = self._project_ranges.get(project, (0, 0))
+        if lo == hi:
+            raise ValueError("Cannot sample from an empty index")
+        if self.uniform:
+            return int(rng.integers(lo, hi))
+        # sample by inverting the cumulative distribution
+        cdf_lo = self.cumulative_weights[lo - 1] if lo > 0 else 0.0
+        cdf_hi = self.cumulative_weights[hi - 1]
+        target = cdf_lo + rng.random() * (cdf_hi - cdf_lo)
+        i = int(
+            np.searchsorted(self.cumulative_weights[lo : hi],
+                            target,
+                            'right'))
+        return lo + min(i, hi - lo - 1)
+
+    def _same_file(self, i: int, j: int) -> bool:
+        a = self.rows[i]
+        b = self.rows[j]
+        return (
+            a['project'] == b['project'] and a['commit'] == b['commit']
+            and a['file'] == b['file'])
+
+    def sample(
+            self,
+            rng: Optional[np.random.Generator] = None,
+            project: Optional[str] = None) -> SentenceOffset:
+        """
+        Sample the location of a sentence.
+
+        Parameters
+        ----------
+        rng : Optional[np.random.Generator], optional
+            A source of randomness, by default a generator seeded from
+            the state of the `random` module so that seeding `random`
+            makes sampling reproducible.
+        project : Optional[str], optional
+            If given, sample only from sentences of this project.
+
+        Returns
+        -------
+        SentenceOffset
+            The location of a sentence chosen in proportion to its
+            weight.
+
+        Raises
+        ------
+        ValueError
+            If there are no sentences to sample from.
+        """
+        if rng is None:
+            rng = _default_rng()
+        return self[self._sample_index(rng, project)]
+
+    def sample_adjacent(
+            self,
+            rng: Optional[np.random.Generator] = None,
+            project: Optional[str] = None,
+            max_attempts: int = 100) -> Tuple[SentenceOffset,
+                                              SentenceOffset]:
+        """
+        Sample the locations of two adjacent sentences in a file.
+
+        Parameters
+        ----------
+        rng : Optional[np.random.Generator], optional
+            A source of randomness, by default a generator seeded from
+            the state of the `random` module so that seeding `random`
+            makes sampling reproducible.
+        project : Optional[str], optional
+            If given, sample only from sentences of this project.
+        max_attempts : int, optional
+            The maximum number of times to sample the first sentence
+            before giving up, by default 100.
+
+        Returns
+        -------
+        SentenceOffset
+            The location of a sentence chosen in proportion to its
+            weight among those that are not the last in their file.
+        SentenceOffset
+            The location of the following sentence.
+
+        Raises
+        ------
+        RuntimeError
+            If no pair is found after `max_attempts` samples.
+        """
+        if rng is None:
+            rng = _default_rng()
+        for _ in range(max_attempts):
+            i = self._sample_index(rng, project)
+            if i + 1 < len(self.rows) and self._same_file(i, i + 1):
+                return self[i], self[i + 1]
+        raise RuntimeError(
+            f"Can't find a sentence pair after {max_attempts} attempts.")
+
+    @classmethod
+    def build(
+        cls,
+        path: PathLike,
+        offsets: Iterable[Tuple[str,
+                                str,
+                                str,
+                                np.ndarray]],
+        project_weights: Optional[Dict[str,
+                                       float]] = None
+    ) -> 'SentenceOffsetIndex':
+        """
+        Build and save an index.
+
+        Parameters
+        ----------
+        path : PathLike
+            The directory in which to save the index.
+        offsets : Iterable[Tuple[str, str, str, np.ndarray]]
+            For each indexed file, the name of its project, the name of
+            its commit, its path relative to the project root, and an
+            ``(N, 2)`` array of the spans of its sentences such as
+            `LexedDocument.sentence_spans`.
+        project_weights : Optional[Dict[str, float]], optional
+            If given, the total sampling weight of each project, which
+            is split evenly between the project's sentences.
+            Otherwise, each sentence has equal weight.
+
+        Returns
+        -------
+        SentenceOffsetIndex
+            The loaded index.
+        """
+        tables: Dict[str,
+                     Dict[str,
+                          int]] = {
+                              'projects': {},
+                              'commits': {},
+                              'files': {},
+                          }
+
+        def _intern(table: str, name: str) -> int:
+            return tables[table].setdefault(name, len(tables[table]))
+
+        keys = []
+        chunks = []
+        for project, commit, file, spans in offsets:
+            spans = np.asarray(spans, dtype=np.int64).reshape(-1, 2)
+            chunk = np.empty(len(spans), dtype=_ROW_DTYPE)
+            chunk['project'] = _intern('projects', project)
+            chunk['commit'] = _intern('commits', commit)
+            chunk['file'] = _intern('files', file)
+            chunk['start'] = spans[:, 0]
+            chunk['end'] = spans[:, 1]
+            keys.append((project, commit, file))
+            chunks.append(chunk)
+        # group rows by project, commit, and file
+        order = sorted(range(len(chunks)), key=keys.__getitem__)
+        projects = sorted(tables['projects'])
+        remap = np.array(
+            [projects.index(p) for p in tables['projects']],
+            dtype=np.uint32)
+        rows = (
+            np.concatenate([chunks[i] for i in order]) if chunks else np.empty(
+                0,
+                dtype=_ROW_DTYPE))
+        rows['project'] = remap[rows['project']]
+        if project_weights is None:
+            weights = np.ones(len(rows))
+        else:
+            project_ids, counts = np.unique(rows['project'], return_counts=True)
+            per_row = np.zeros(len(projects))
+            for project_id, count in zip(project_ids, counts):
+                per_row[project_id] = (
+                    project_weights[projects[project_id]] / count)
+            weights = per_row[rows['project']]
+        uniform = bool(len(weights) == 0 or np.all(weights == weights[0]))
+        path = Path(path)
+        path.mkdir(parents=True, exist_ok=True)
+        np.save(path / cls._ROWS, rows)
+        np.save(path / cls._WEIGHTS, np.cumsum(weights))
+        with open(path / cls._TABLES, "w") as f:
+            json.dump(
+                {
+                    'projects': projects,
+                    'commits': list(tables['commits']),
+                    'files': list(tables['files']),
+                    'uniform': uniform
+                },
+                f)
+        return cls.load(path)
+
+    @classmethod
+    def load(cls, path: PathLike) -> 'SentenceOffsetIndex':
+        """
+        Load a saved index, memory-mapping its arrays.
+
+        Parameters
+        ----------
+        path : PathLike
+            The directory in which the index was saved.
+
+        Returns
+        -------
+        SentenceOffsetIndex
+            The loaded index.
+        """
+        path = Path(path)
+        with open(path / cls._TABLES, "r") as f:
+            tables = json.load(f)
+        return cls(
+            np.load(path / cls._ROWS,
+                    mmap_mode='r'),
+            np.load(path / cls._WEIGHTS,
+                    mmap_mode='r'),
+            tables['projects'],
+            tables['commits'],
+            tables['files'],
+            tables['uniform'])
@@ -0,0 +1,131 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the sentence_offsets module.
+"""
+import random
+import tempfile
+import unittest
+from collections import Counter
+
+import numpy as np
+
+from prism.data.sentence_offsets import SentenceOffset, SentenceOffsetIndex
+
+
+class TestSentenceOffsetIndex(unittest.TestCase):
+    """
+    Tests for `SentenceOffsetIndex`.
+    """
+
+    offsets = [
+        ("b",
+         "c1",
+         "f.v",
+         np.array([[0,
+                    3],
+                   [4,
+                    8]])),
+        ("a",
+         "",
+         "g.v",
+         np.array([[0,
+                    1]])),
+        ("b",
+         "c0",
+         "f.v",
+         np.array([[0,
+                    2]])),
+    ]
+
+    def test_build_load(self):
+        """
+        Verify that rows are grouped and survive a round trip.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            index = SentenceOffsetIndex.build(tmpdir, self.offsets)
+            expected = [
+                SentenceOffset("a",
+                               "",
+                               "g.v",
+                               0,
+                               1),
+                SentenceOffset("b",
+                               "c0",
+                               "f.v",
+                               0,
+                               2),
+                SentenceOffset("b",
+                               "c1",
+                               "f.v",
+                               0,
+                               3),
+                SentenceOffset("b",
+                               "c1",
+                               "f.v",
+                               4,
+                               8),
+            ]
+            self.assertEqual([index[i] for i in range(len(index))], expected)
+            self.assertTrue(index.uniform)
+            loaded = SentenceOffsetIndex.load(tmpdir)
+            self.assertIsInstance(loaded.rows, np.memmap)
+            self.assertEqual([loaded[i] for i in range(len(loaded))], expected)
+            empty = SentenceOffsetIndex.build(f"{tmpdir}/empty", [])
+            self.assertEqual(len(empty), 0)
+            with self.assertRaises(ValueError):
+                empty.sample()
+
+    def test_sample(self):
+        """
+        Verify that sentences are sampled in proportion to weights.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            index = SentenceOffsetIndex.build(
+                tmpdir,
+                self.offsets,
+                {
+                    "a": 3.0,
+                    "b": 1.0
+                })
+            self.assertFalse(index.uniform)
+            rng = np.random.default_rng(0)
+            counts = Counter(index.sample(rng).project for _ in range(4000))
+            self.assertAlmostEqual(counts["a"] / 4000, 0.75, delta=0.05)
+            for _ in range(100):
+                self.assertEqual(index.sample(rng, "b").project, "b")
+                first, second = index.sample_adjacent(rng)
+                self.assertEqual(first, SentenceOffset("b", "c1", "f.v", 0, 3))
+                self.assertEqual(second, SentenceOffset("b", "c1", "f.v", 4, 8))
+            with self.assertRaises(RuntimeError):
+                index.sample_adjacent(rng, "a")
+            # seeding the random module makes default sampling repeatable
+            samples = []
+            for _ in range(2):
+                random.seed(0)
+                samples.append(
+                    [index.sample() for _ in range(20)]
+                    + [index.sample_adjacent() for _ in range(5)])
+            self.assertEqual(samples[0], samples[1])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <vector>
+
+/* Identifier types (see `IdentType` in prism/interface/coq/ident.py) */
+const long type_cpatatom   = 1;
+const long type_cref       = 2;
+const long type_ser_qualid = 3;
+const long type_lident     = 4;
+const long type_lname      = 5;
+
+struct Ident
+{
+    long                 type;
+    std::vector<Py_UCS4> text;
+    Py_ssize_t           beg;
+    Py_ssize_t           end;
+};
+
+/*
+ * Test whether a character is whitespace in the sense of `str.isspace`.
+ */
+static inline bool is_space(Py_UCS4 c)
+{
+    if (c < 0x80)
+    {
+        return (c >= 0x09 and c <= 0x0D) or (c >= 0x1C and c <= 0x20);
+    }
+    return c == 0x85 or c == 0xA0 or c == 0x1680 or (c >= 0x2000 and c <= 0x200A)
+        or c == 0x2028 or c == 0x2029 or c == 0x202F or c == 0x205F or c == 0x3000;
+}
+
+/*
+ * A matcher equivalent to `ident_re` in prism/interface/coq/ident.py.
+ *
+ * Each pattern of `ident_re` is deterministic, i.e., backtracking
+ * never finds a match that the greedy parse did not, so the patterns
+ * are matched by simple recursive descent. Each method returns
+ * whether the pattern matches at `pos`, advancing it past the match
+ * if so.
+ */
+class Scanner
+{
+  public:
+    std::vector<Ident> idents;
+
+    Scanner(const Py_UCS4* text, Py_ssize_t size) : text(text), size(size)
+    {
+    }
+
+    void scan()
+    {
+        Py_ssize_t pos = 0;
+        while (pos < size)
+        {
+            if (text[pos] != '(')
+            {
+                pos++;
+                continue;
+            }
+            Ident      ident;
+            Py_ssize_t end = pos;
+            if (match_ident(end, ident))
+            {
+                ident.beg = pos;
+                ident.end = end;
+                idents.push_back(std::move(ident));
+                pos = end;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+    }
+
+  private:
+    const Py_UCS4* text;
+    Py_ssize_t     size;
+
+    /* \s* */
+    void spaces(Py_ssize_t& pos)
+    {
+        while (pos < size and is_space(text[pos]))
+        {
+            pos++;
+        }
+    }
+
+    /* \s+ */
+    bool spaces1(Py_ssize_t& pos)
+    {
+        Py_ssize_t start = pos;
+        spaces(pos);
+        return pos > start;
+    }
+
+    bool literal(Py_ssize_t& pos, const char* s)
+    {
+        Py_ssize_t i = pos;
+        for (; *s; s++, i++)
+        {
+            if (i >= size or text[i] != (Py_UCS4)(unsigned char)*s)
+            {
+                return false;
+            }
+        }
+        pos = i;
+        return true;
+    }
+
+    /* \(\s*<name> */
+    bool open(Py_ssize_t& pos, const char* name)
+    {
+        Py_ssize_t i = pos;
+        if (!literal(i, "("))
+        {
+            return false;
+        }
+        spaces(i);
+        if (!literal(i, name))
+        {
+            return false;
+        }
+        pos = i;
+        return true;
+    }
+
+    /* \s*\) */
+    bool close(Py_ssize_t& pos)
+    {
+        Py_ssize_t i = pos;
+        spaces(i);
+        if (!literal(i, ")"))
+        {
+            return false;
+        }
+        pos = i;
+        return true;
+    }
+
+    /* \d+ */
+    bool digits(Py_ssize_t& pos)
+    {
+        Py_ssize_t start = pos;
+        while (pos < size and text[pos] >= '0' and text[pos] <= '9')
+        {
+            pos++;
+        }
+        return pos > start;
+    }
+
+    /*
+     * Match `id_re`, appending the unquoted ID to `out`.
+     */
+    bool match_id(Py_ssize_t& pos, std::vector<Py_UCS4>& out)
+    {
+        Py_ssize_t i = pos;
+        if (!open(i, "Id") or !spaces1(i))
+        {
+            return false;
+        }
+        Py_ssize_t beg = i;
+        while (i < size and text[i] != ')' and !is_space(text[i]))
+        {
+            i++;
+        }
+        Py_ssize_t end = i;
+        if (end == beg or !close(i))
+        {
+            return false;
+        }
+        if (text[beg] == '"' and text[end - 1] == '"')
+        {
+            // equivalent to `unquote`, including for a lone quote
+            beg++;
+            end = end > beg ? end - 1 : beg;
+        }
+        out.insert(out.end(), text + beg, text + end);
+        pos = i;
+        return true;
+    }
+
+    /*
+     * Match `dirpath_re`, appending each dot-terminated ID to `out`.
+     */
+    bool match_dirpath(Py_ssize_t& pos, std::vector<Py_UCS4>& out)
+    {
+        Py_ssize_t i = pos;
+        if (!open(i, "DirPath"))
+        {
+            return false;
+        }
+        spaces(i);
+        if (!literal(i, "("))
+        {
+            return false;
+        }
+        while (true)
+        {
+            Py_ssize_t j = i;
+            spaces(j);
+            if (!match_id(j, out))
+            {
+                break;
+            }
+            out.push_back('.');
+            i = j;
+        }
+        if (!literal(i, ")") or !close(i))
+        {
+            return false;
+        }
+        pos = i;
+        return true;
+    }
+
+    /* `serqualid_re` without its optional context */
+    bool match_serqualid(Py_ssize_t& pos, Ident& ident)
+    {
+        Py_ssize_t i = pos;
+        if (!open(i, "Ser_Qualid"))
+        {
+            return false;
+        }
+        spaces(i);
+        std::vector<Py_UCS4> qualid;
+        if (!match_dirpath(i, qualid))
+        {
+            return false;
+        }
+        spaces(i);
+        if (!match_id(i, qualid) or !close(i))
+        {
+            return false;
+        }
+        ident.text = std::move(qualid);
+        pos        = i;
+        return true;
+    }
+
+    /* \(\s*(?:\(\s*)*v\s* with the given number of inner parentheses */
+    bool context(Py_ssize_t& pos, const char* name, int depth)
+    {
+        Py_ssize_t i = pos;
+        if (!open(i, name))
+        {
+            return false;
+        }
+        for (int k = 0; k < depth; k++)
+        {
+            spaces(i);
+            if (!literal(i, "("))
+            {
+                return false;
+            }
+        }
+        spaces(i);
+        if (!literal(i, "v"))
+        {
+            return false;
+        }
+        spaces(i);
+        pos = i;
+        return true;
+    }
+
+    /* \s*(?=loc_re) */
+    bool followed_by_loc(Py_ssize_t& pos)
+    {
+        Py_ssize_t i = pos;
+        spaces(i);
+        Py_ssize_t j = i;
+        if (!open(j, "loc"))
+        {
+            return false;
+        }
+        spaces(j);
+        if (!literal(j, "((("))
+        {
+            return false;
+        }
+        spaces(j);
+        if (!literal(j, "fname") or !spaces1(j) or !literal(j, "ToplevelInput)"))
+        {
+            return false;
+        }
+        static const char* const fields[]
+            = {"line_nb", "bol_pos", "line_nb_last", "bol_pos_last", "bp", "ep"};
+        for (const char* field : fields)
+        {
+            spaces(j);
+            if (!open(j, field) or !spaces1(j) or !digits(j) or !literal(j, ")"))
+            {
+                return false;
+            }
+        }
+        if (!literal(j, ")))"))
+        {
+            return false;
+        }
+        pos = i;
+        return true;
+    }
+
+    bool match_ident(Py_ssize_t& pos, Ident& ident)
+    {
+        Py_ssize_t i = pos;
+        if (context(i, "CPatAtom", 3) and match_serqualid(i, ident))
+        {
+            ident.type = type_cpatatom;
+            pos        = i;
+            return true;
+        }
+        i = pos;
+        if (context(i, "CRef", 2) and match_serqualid(i, ident))
+        {
+            ident.type = type_cref;
+            pos        = i;
+            return true;
+        }
+        i = pos;
+        if (match_serqualid(i, ident))
+        {
+            ident.type = type_ser_qualid;
+            pos        = i;
+            return true;
+        }
+        i = pos;
+        if (open(i, "v"))
+        {
+            spaces(i);
+            Py_ssize_t j = i;
+            if (match_id(j, ident.text) and close(j) and followed_by_loc(j))
+            {
+                ident.type = type_lident;
+                pos        = j;
+                return true;
+            }
+            ident.text.clear();
+            j = i;
+            if (open(j, "Name"))
+            {
+                spaces(j);
+                if (match_id(j, ident.text) and close(j) and close(j)
+                    and followed_by_loc(j))
+                {
+                    ident.type = type_lname;
+                    pos        = j;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+static PyObject* scan_idents(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    Scanner scanner(data, size);
+    /* The scanner only touches its own copy of the text. */
+    Py_BEGIN_ALLOW_THREADS
+    scanner.scan();
+    Py_END_ALLOW_THREADS
+    PyMem_Free(data);
+    PyObject* result = PyList_New((Py_ssize_t)scanner.idents.size());
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    int byteorder = PY_LITTLE_ENDIAN ? -1 : 1;
+    for (size_t k = 0; k < scanner.idents.size(); k++)
+    {
+        const Ident& ident = scanner.idents[k];
+        PyObject*    ident_text
+            = PyUnicode_DecodeUTF32((const char*)ident.text.data(),
+                                    (Py_ssize_t)(ident.text.size() * sizeof(Py_UCS4)),
+                                    "surrogatepass",
+                                    &byteorder);
+        PyObject* item = ident_text == NULL ? NULL
+                                            : Py_BuildValue("(lOnn)",
+                                                            ident.type,
+                                                            ident_text,
+                                                            ident.beg,
+                                                            ident.end);
+        Py_DecRef(ident_text);
+        if (item == NULL)
+        {
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyList_SetItem(result, (Py_ssize_t)k, item);
+    }
+    return result;
+};
+
+static PyMethodDef IdentMethods[] = {
+    {"scan_idents",
+     scan_idents, METH_VARARGS,
+     "Find the identifiers in a serialized AST."},
+    {NULL,          NULL,        0,            NULL}
+};
+
+static struct PyModuleDef ident_module = {PyModuleDef_HEAD_INIT,
+                                          "prism.interface.coq._ident",
+                                          "Library for scanning Coq identifiers",
+                                          -1,
+                                          IdentMethods};
+
+PyMODINIT_FUNC            PyInit__ident(void)
+{
+    return PyModule_Create(&ident_module);
+};
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <vector>
+
+#include "_unicode_table.h"
+
+/* The number of code points covered by the table */
+const Py_UCS4 ident_class_limit
+    = sizeof(ident_class_index) / sizeof(ident_class_index[0]) * ident_class_block_size;
+
+/*
+ * Get the bitmask of identifier classes containing a code point (see
+ * prism/interface/coq/unicode.py).
+ */
+static inline unsigned ident_class(Py_UCS4 c)
+{
+    if (c >= ident_class_limit)
+    {
+        return 0;
+    }
+    return ident_class_blocks[ident_class_index[c / ident_class_block_size]]
+                             [c % ident_class_block_size];
+}
+
+static inline bool ident_start(Py_UCS4 c)
+{
+    return ident_class(c) & (ident_class_letter | ident_class_identsep);
+}
+
+static inline bool ident_part(Py_UCS4 c)
+{
+    return ident_class(c) != 0;
+}
+
+/*
+ * Get the end of the identifier starting at `pos` or `pos` if there is
+ * none.
+ */
+static Py_ssize_t ident_end(const Py_UCS4* text, Py_ssize_t size, Py_ssize_t pos)
+{
+    if (pos >= size or !ident_start(text[pos]))
+    {
+        return pos;
+    }
+    pos++;
+    while (pos < size and ident_part(text[pos]))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+/*
+ * Get the end of the qualified identifier starting at `pos` or `pos`
+ * if there is none.
+ */
+static Py_ssize_t qualid_end(const Py_UCS4* text, Py_ssize_t size, Py_ssize_t pos)
+{
+    Py_ssize_t end = ident_end(text, size, pos);
+    while (end > pos and end < size and text[end] == '.')
+    {
+        Py_ssize_t next = ident_end(text, size, end + 1);
+        if (next == end + 1)
+        {
+            break;
+        }
+        end = next;
+    }
+    return end;
+}
+
+static PyObject* class_ranges(PyObject* self, PyObject* args)
+{
+    unsigned int mask = 0;
+    if (!PyArg_ParseTuple(args, "I", &mask))
+    {
+        return NULL;
+    }
+    PyObject* result = PyList_New(0);
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    Py_UCS4 c = 0;
+    while (c < ident_class_limit)
+    {
+        if (!(ident_class(c) & mask))
+        {
+            c++;
+            continue;
+        }
+        Py_UCS4 lb = c;
+        while (c < ident_class_limit and (ident_class(c) & mask))
+        {
+            c++;
+        }
+        PyObject* range
+            = Py_BuildValue("(kk)", (unsigned long)lb, (unsigned long)(c - 1));
+        if (range == NULL or PyList_Append(result, range) < 0)
+        {
+            Py_DecRef(range);
+            Py_DecRef(result);
+            return NULL;
+        }
+        Py_DecRef(range);
+    }
+    return result;
+}
+
+static PyObject* is_ident_start(PyObject* self, PyObject* args)
+{
+    unsigned long c = 0;
+    if (!PyArg_ParseTuple(args, "k", &c))
+    {
+        return NULL;
+    }
+    return PyBool_FromLong(c <= 0x10FFFF and ident_start((Py_UCS4)c));
+}
+
+static PyObject* is_ident_part(PyObject* self, PyObject* args)
+{
+    unsigned long c = 0;
+    if (!PyArg_ParseTuple(args, "k", &c))
+    {
+        return NULL;
+    }
+    return PyBool_FromLong(c <= 0x10FFFF and ident_part((Py_UCS4)c));
+}
+
+/*
+ * Apply `end_of` to a substring of `text` starting at `pos`.
+ */
+typedef Py_ssize_t (*EndOf)(const Py_UCS4*, Py_ssize_t, Py_ssize_t);
+
+static PyObject* match_length(PyObject* args, EndOf end_of)
+{
+    PyObject*  text = NULL;
+    Py_ssize_t pos  = 0;
+    if (!PyArg_ParseTuple(args, "U|n", &text, &pos))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    if (pos < 0 or pos > size)
+    {
+        PyErr_SetString(PyExc_IndexError, "position out of range");
+        return NULL;
+    }
+    /* Copy the text incrementally since matches are usually short. */
+    std::vector<Py_UCS4> buffer;
+    Py_ssize_t           i = pos;
+    Py_ssize_t           end;
+    while (true)
+    {
+        Py_ssize_t stop = i + 64 < size ? i + 64 : size;
+        for (; i < stop; i++)
+        {
+            buffer.push_back(PyUnicode_ReadChar(text, i));
+        }
+        end = end_of(buffer.data(), (Py_ssize_t)buffer.size(), 0);
+        /* A match is final unless it may continue past the buffer. */
+        if (end + 1 < (Py_ssize_t)buffer.size() or i == size)
+        {
+            break;
+        }
+    }
+    return PyLong_FromSsize_t(end);
+}
+
+static PyObject* ident_length(PyObject* self, PyObject* args)
+{
+    return match_length(args, ident_end);
+}
+
+static PyObject* qualid_length(PyObject* self, PyObject* args)
+{
+    return match_length(args, qualid_end);
+}
+
+static PyObject* ident_spans(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    std::vector<Py_ssize_t> spans;
+    Py_BEGIN_ALLOW_THREADS
+    Py_ssize_t pos = 0;
+    while (pos < size)
+    {
+        Py_ssize_t end = ident_end(data, size, pos);
+        if (end > pos)
+        {
+            spans.push_back(pos);
+            spans.push_back(end);
+            pos = end;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+    Py_END_ALLOW_THREADS
+    PyMem_Free(data);
+    PyObject* result = PyList_New((Py_ssize_t)(spans.size() / 2));
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    for (size_t k = 0; k < spans.size(); k += 2)
+    {
+        PyObject* span = Py_BuildValue("(nn)", spans[k], spans[k + 1]);
+        if (span == NULL)
+        {
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyList_SetItem(result, (Py_ssize_t)(k / 2), span);
+    }
+    return result;
+};
+
+static PyMethodDef UnicodeMethods[] = {
+    {"class_ranges",
+     class_ranges, METH_VARARGS,
+     "Get the ranges of code points in any of the given identifier classes."},
+    {"is_ident_start",
+     is_ident_start, METH_VARARGS,
+     "Test whether a code point may begin a Coq identifier."},
+    {"is_ident_part",
+     is_ident_part, METH_VARARGS,
+     "Test whether a code point may continue a Coq identifier."},
+    {"ident_length",
+     ident_length, METH_VARARGS,
+     "Get the length of the identifier at a position of a string."},
+    {"qualid_length",
+     qualid_length, METH_VARARGS,
+     "Get the length of the qualified identifier at a position of a string."},
+    {"ident_spans",
+     ident_spans, METH_VARARGS,
+     "Get the spans of the identifiers in a string."},
+    {NULL,             NULL,           0,            NULL}
+};
+
+static struct PyModuleDef unicode_module = {
+    PyModuleDef_HEAD_INIT,
+    "prism.interface.coq._unicode",
+    "Library for classifying Coq identifier characters",
+    -1,
+    UnicodeMethods};
+
+PyMODINIT_FUNC            PyInit__unicode(void)
+{
+    return PyModule_Create(&unicode_module);
+};
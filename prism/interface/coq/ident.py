@@ -32,13 +32,14 @@ from typing import (
     Optional,
     Sequence,
     Set,
+    Tuple,
     Type,
     Union,
 )
 
+from prism.interface.coq._ident import scan_idents
 from prism.interface.coq.serapi import SerAPI
 from prism.util.identity import identity
-from prism.util.iterable import CallableIterator
 from prism.util.re import regex_from_options
 from prism.util.string import quote_escape, unquote
 
@@ -202,6 +203,45 @@ def ident_of_match(ident: re.Match) -> Identifier:
     return Identifier(ident_type, ident_str)
 
 
+def find_idents(ast: str) -> List[Tuple[Identifier, int, int]]:
+    """
+    Find each match of `ident_re` in the given serialized AST.
+
+    The AST is scanned in a single pass by a native matcher.
+
+    Parameters
+    ----------
+    ast : str
+        A serialized AST.
+
+    Returns
+    -------
+    List[Tuple[Identifier, int, int]]
+        The identifier corresponding to each match (see
+        `ident_of_match`) and the start and end of the match in order of
+        appearance.
+    """
+    return [
+        (Identifier(IdentType(ident_type),
+                    ident_str),
+         start,
+         end) for ident_type, ident_str, start, end in scan_idents(ast)
+    ]
+
+
+def _py_find_idents(ast: str) -> List[Tuple[Identifier, int, int]]:
+    """
+    Find each match of `ident_re` in the given serialized AST.
+
+    This is the reference implementation of `find_idents`.
+    """
+    return [
+        (ident_of_match(m),
+         m.start(),
+         m.end()) for m in re.finditer(ident_re, ast)
+    ]
+
+
 def id_of_str(txt: str) -> str:
     """
     Embed a string into a serialized ``Id`` s-expression.
@@ -382,13 +422,13 @@ def _get_all_idents(
             toppath=toppath)
     else:
         qualify = identity
-    matches = re.finditer(ident_re, ast)
+    matches = find_idents(ast)
     container: Union[Type[List[Any]], Type[Set[Any]]]
     if ordered:
         container = list
     else:
         container = set
-    return container(qualify(ident_of_match(m)) for m in matches)
+    return container(qualify(ident) for ident, _, _ in matches)
 
 
 get_all_idents = partial(
@@ -487,8 +527,15 @@ def replace_idents(sexp: str, replacements: Sequence[str]) -> str:
     str
         The given serialized AST albeit with replaced identifiers.
     """
-    repl_it = CallableIterator(replacements)
-    return re.sub(ident_re, repl_it, sexp)
+    repl_it = iter(replacements)
+    pieces = []
+    pos = 0
+    for _, start, end in find_idents(sexp):
+        pieces.append(sexp[pos : start])
+        pieces.append(next(repl_it))
+        pos = end
+    pieces.append(sexp[pos :])
+    return ''.join(pieces)
 
 
 def expand_idents(
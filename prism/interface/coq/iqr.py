@@ -31,10 +31,7 @@ from itertools import chain
 from pathlib import Path
 from typing import ClassVar, Iterator, List, Optional, Set, Tuple, Union
 
-from prism.interface.coq.re_patterns import (
-    IDENT_PATTERN,
-    QUALIFIED_IDENT_PATTERN,
-)
+from prism.interface.coq.unicode import ident_length, qualid_length
 from prism.util.path import get_relative_path
 from prism.util.radpytools import PathLike
 
@@ -136,7 +133,7 @@ class IQR:
             bound_path = root / path
             for subdir, _, filenames in os.walk(bound_path):
                 subpath = get_relative_path(subdir, bound_path)
-                if all(IDENT_PATTERN.match(part) for part in subpath.parts):
+                if all(ident_length(part) for part in subpath.parts):
                     suffix = '.'.join(subpath.parts)
                     if suffix:
                         lib = '.'.join([prefix, suffix])
@@ -147,8 +144,7 @@ class IQR:
                     for filename in filenames:
                         filepath = subpath / filename
                         libname = filepath.stem
-                        if (filepath.suffix == '.v'
-                                and QUALIFIED_IDENT_PATTERN.match(libname)):
+                        if (filepath.suffix == '.v' and qualid_length(libname)):
                             yield filepath, '.'.join([lib, libname])
 
     @property
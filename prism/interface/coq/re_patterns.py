@@ -27,7 +27,7 @@ https://github.com/princeton-vl/CoqGym/blob/master/re_patterns.py
 
 import re
 
-from prism.interface.coq.unicode import IDENTPART, IDENTSEP, LETTER
+from prism.interface.coq.unicode import IDENT_INIT, IDENT_TRAILING
 from prism.util.re import regex_from_options
 
 PWD_PATTERN = re.compile(r"\(\*\*PWD\*\* (?P<pwd>.*?) \*\*\)")
@@ -63,7 +63,7 @@ TYPE_PATTERN = re.compile(
     r'\(Pp_tag constr.type\(Pp_string (?P<type>"(?:\\"|[^"])*?"|[^\(\)\s"]*)\)\)'
 )
 
-IDENT_INIT_PATTERN = re.compile(f"(?:{LETTER.pattern}|{IDENTSEP.pattern})")
+IDENT_INIT_PATTERN = IDENT_INIT
 """
 A valid initial character for a Coq identifier.
 
@@ -73,8 +73,7 @@ See `is_valid_ident_initial` in
 https://github.com/coq/coq/blob/master/clib/unicode.ml for more
 information.
 """
-IDENT_TRAILING_PATTERN = re.compile(
-    f"(?:{IDENT_INIT_PATTERN.pattern}|{IDENTPART.pattern})")
+IDENT_TRAILING_PATTERN = IDENT_TRAILING
 """
 A valid non-initial character for a Coq identifier.
 
@@ -69,13 +69,12 @@ from prism.interface.coq.options import (
 )
 from prism.interface.coq.re_patterns import (
     ADDED_STATE_PATTERN,
-    IDENT_INIT_PATTERN,
-    IDENT_TRAILING_PATTERN,
     LOCATE_QUALID_PATTERN,
     NAMED_DEF_ASSUM_PATTERN,
     NEW_IDENT_PATTERN,
     PRINT_ALL_IDENT_PATTERN,
 )
+from prism.interface.coq.unicode import is_ident_part, is_ident_start
 from prism.language.sexp import SexpNode
 from prism.language.sexp.exception import IllegalSexpOperationException
 from prism.language.sexp.list import SexpList
@@ -200,8 +199,8 @@ class SerAPI:
             self._top_physical = Path(topfile)
             self._top_logical = self._top_physical.stem
             for idx, char in enumerate(self._top_logical):
-                if (idx == 0 and IDENT_INIT_PATTERN.match(char) is None) or (
-                        idx > 0 and IDENT_TRAILING_PATTERN.match(char) is None):
+                if (idx == 0 and not is_ident_start(ord(char))) or (
+                        idx > 0 and not is_ident_part(ord(char))):
                     raise ValueError(
                         f"Invalid character '{char}' in topfile '{topfile}'.")
             topfile_arg = f"--topfile {topfile}"
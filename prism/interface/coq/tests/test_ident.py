@@ -0,0 +1,118 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.interface.coq.ident.
+"""
+import re
+import unittest
+
+from prism.interface.coq.ident import (
+    Identifier,
+    IdentType,
+    _py_find_idents,
+    find_idents,
+    get_all_idents,
+    ident_re,
+    replace_idents,
+)
+
+_LOC = (
+    "(loc (((fname ToplevelInput) (line_nb 1) (bol_pos 0) (line_nb_last 1)"
+    " (bol_pos_last 0) (bp {}) (ep {}))))")
+
+_QUOTED = '"x\'"'
+
+
+def _loc(bp: int) -> str:
+    return _LOC.format(bp, bp + 1)
+
+
+class TestIdent(unittest.TestCase):
+    """
+    Test suite for identifier extraction from serialized ASTs.
+    """
+
+    ast = (
+        "(VernacExpr () (VernacDefinition (NoDischarge Definition) "
+        f"(((v (Name (Id Var))) {_loc(11)}) ()) (DefineBody () () "
+        "((v (CRef ((v (Ser_Qualid (DirPath ((Id Nat) (Id Init))) (Id S))) "
+        f"{_loc(20)}) ())) {_loc(20)}) ((v (CPatAtom (((v (Ser_Qualid "
+        f"(DirPath ()) (Id {_QUOTED})))  {_loc(30)})))) {_loc(30)}) "
+        f"(VernacDefineModule () ((v (Id Example)) \n {_loc(40)}) "
+        "(Ser_Qualid (DirPath ()) (Id unlocated)) "
+        "(Ser_Qualid (DirPath ((Id a) )) (Id not_matched)) "
+        f"((v (Id no_loc)) (loc ()))))")
+
+    def test_find_idents(self) -> None:
+        """
+        Verify that each kind of identifier is found with its span.
+        """
+        idents = find_idents(self.ast)
+        self.assertEqual(
+            [i for i, _, _ in idents],
+            [
+                Identifier(IdentType.lname,
+                           "Var"),
+                Identifier(IdentType.CRef,
+                           "Nat.Init.S"),
+                Identifier(IdentType.CPatAtom,
+                           "x'"),
+                Identifier(IdentType.lident,
+                           "Example"),
+                Identifier(IdentType.Ser_Qualid,
+                           "unlocated"),
+            ])
+        for _, start, end in idents:
+            self.assertEqual(ident_re.match(self.ast, start).end(), end)
+        self.assertEqual(idents, _py_find_idents(self.ast))
+        self.assertEqual(find_idents(""), [])
+
+    def test_reference(self) -> None:
+        """
+        Verify that the native scanner agrees with `ident_re`.
+        """
+        # truncate or corrupt the AST at every position
+        for i in range(len(self.ast)):
+            for text in [self.ast[: i],
+                         self.ast[: i] + " " + self.ast[i + 1 :],
+                         self.ast[: i] + "(" + self.ast[i :]]:
+                self.assertEqual(find_idents(text), _py_find_idents(text))
+        unicode_ast = self.ast.replace("Example", "Ex\u00e9mple\u3000")
+        self.assertEqual(find_idents(unicode_ast), _py_find_idents(unicode_ast))
+
+    def test_replace_idents(self) -> None:
+        """
+        Verify that identifiers are replaced in order.
+        """
+        idents = get_all_idents(self.ast, ordered=True)
+        replacements = [f"(Id r{k})" for k in range(len(idents))]
+        replaced = replace_idents(self.ast, replacements)
+        repl_it = iter(replacements)
+        self.assertEqual(
+            replaced,
+            re.sub(ident_re, lambda _: next(repl_it),
+                   self.ast))
+        with self.assertRaises(StopIteration):
+            replace_idents(self.ast, replacements[:-1])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,107 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.interface.coq.unicode.
+"""
+import re
+import tempfile
+import unittest
+from pathlib import Path
+
+import prism.interface.coq.unicode as U
+from prism.interface.coq.re_patterns import (
+    IDENT_PATTERN,
+    QUALIFIED_IDENT_PATTERN,
+)
+
+
+class TestUnicode(unittest.TestCase):
+    """
+    Test suite for the native identifier character classes.
+    """
+
+    texts = [
+        "",
+        "x",
+        "foo_bar'1 + 2baz",
+        "Coq.Init.Nat.add x.y. z..w .v",
+        "αβγ.δ x y _ 'a ℕ₁",
+        "a" * 100 + "." + "b" * 100 + ". ",
+        "1" * 70 + "x",
+        "a" * 63 + ".b",
+    ]
+
+    def test_class_ranges(self) -> None:
+        """
+        Verify that the compiled table matches the Unicode tables.
+        """
+        letter, identsep, identpart = U._ident_class_tables()
+        for bit, tables in [(U._LETTER, letter),
+                            (U._IDENTSEP, identsep),
+                            (U._IDENTPART, identpart)]:
+            self.assertEqual(
+                U.class_ranges(bit),
+                U._merge_ranges(r for table in tables for r in table))
+        for c in ["a", "Z", "_", " ", "α", "ℕ"]:
+            self.assertTrue(U.is_ident_start(ord(c)))
+            self.assertTrue(U.is_ident_part(ord(c)))
+        for c in ["0", "'", "₁"]:
+            self.assertFalse(U.is_ident_start(ord(c)))
+            self.assertTrue(U.is_ident_part(ord(c)))
+        for c in [" ", ".", "-", "(", "+"]:
+            self.assertFalse(U.is_ident_start(ord(c)))
+            self.assertFalse(U.is_ident_part(ord(c)))
+        self.assertFalse(U.is_ident_part(0x110000))
+
+    def test_scanning(self) -> None:
+        """
+        Verify that bulk scanning agrees with the regular expressions.
+        """
+        for text in self.texts:
+            with self.subTest(text=text):
+                self.assertEqual(
+                    U.ident_spans(text),
+                    [m.span() for m in re.finditer(IDENT_PATTERN, text)])
+                for pos in range(len(text) + 1):
+                    for length, pattern in [(U.ident_length, IDENT_PATTERN),
+                                            (U.qualid_length,
+                                             QUALIFIED_IDENT_PATTERN)]:
+                        m = pattern.match(text, pos)
+                        self.assertEqual(
+                            length(text,
+                                   pos),
+                            0 if m is None else m.end() - pos)
+        with self.assertRaises(IndexError):
+            U.ident_length("abc", 4)
+
+    def test_header(self) -> None:
+        """
+        Verify that the generated table header is up to date.
+        """
+        header = Path(U.__file__).parent / "_unicode_table.h"
+        with tempfile.TemporaryDirectory() as tmpdir:
+            generated = Path(tmpdir) / "_unicode_table.h"
+            U.generate_table_header(generated)
+            self.assertEqual(generated.read_text(), header.read_text())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -20,12 +20,45 @@
 #
 """
 Utilities for working with Unicode, especially for regular expressions.
+
+The identifier character classes derived from `unicode_table` are
+compiled into a two-level lookup table in the native
+``prism.interface.coq._unicode`` module, which classifies code points
+in constant time.
+The header containing the table is generated from `unicode_table` by
+running this module as a script.
 """
 
 import re
-from typing import List, Tuple
+import sys
+from pathlib import Path
+from typing import Iterable, List, Tuple
+
+from prism.interface.coq._unicode import (
+    class_ranges,
+    ident_length,
+    ident_spans,
+    is_ident_part,
+    is_ident_start,
+    qualid_length,
+)
+from prism.util.radpytools import PathLike
 
-import prism.interface.coq.unicode_table as UT
+__all__ = [
+    'IDENT_INIT',
+    'IDENT_TRAILING',
+    'IDENTPART',
+    'IDENTSEP',
+    'LETTER',
+    'chr_escape',
+    'ident_length',
+    'ident_spans',
+    'is_ident_part',
+    'is_ident_start',
+    'mk_regex_from_unicode_tables',
+    'qualid_length',
+    'single',
+]
 
 _special_regex_chars = {
     "(",
@@ -44,6 +77,24 @@ _special_regex_chars = {
     "|"
 }
 
+_LETTER = 1
+"""
+The class of Unicode letters (see `LETTER`).
+"""
+_IDENTSEP = 2
+"""
+The class of identifier separators (see `IDENTSEP`).
+"""
+_IDENTPART = 4
+"""
+The class of non-initial identifier characters (see `IDENTPART`).
+"""
+
+_BLOCK_SIZE = 128
+"""
+The number of code points covered by each block of the lookup table.
+"""
+
 
 def chr_escape(code: int) -> str:
     """
@@ -55,24 +106,48 @@ def chr_escape(code: int) -> str:
     return code
 
 
+def _merge_ranges(ranges: Iterable[Tuple[int, int]]) -> List[Tuple[int, int]]:
+    """
+    Sort inclusive ranges and merge those that overlap or are adjacent.
+    """
+    merged: List[Tuple[int, int]] = []
+    for lb, ub in sorted(ranges):
+        if merged and lb <= merged[-1][1] + 1:
+            if ub > merged[-1][1]:
+                merged[-1] = (merged[-1][0], ub)
+        else:
+            merged.append((lb, ub))
+    return merged
+
+
+def _mk_regex_from_ranges(ranges: Iterable[Tuple[int, int]]) -> re.Pattern:
+    """
+    Compile a regex that matches the characters in the given ranges.
+    """
+    options = ["["]
+    for lb, ub in ranges:
+        if lb != ub:
+            option = f"{chr_escape(lb)}-{chr_escape(ub)}"
+        else:
+            option = chr_escape(lb)
+        options.append(option)
+    options.append("]")
+    pattern = re.compile(''.join(options))
+    return pattern
+
+
 def mk_regex_from_unicode_tables(
         *tables: Tuple[List[Tuple[int,
                                   int]],
                        ...]) -> re.Pattern:
     """
     Compile a regex that matches the characters in given Unicode tables.
+
+    Adjacent ranges of the tables are merged, which keeps the character
+    class (and its compilation time) small.
     """
-    options = ["["]
-    for table in tables:
-        for lb, ub in table:
-            if lb != ub:
-                option = f"{chr_escape(lb)}-{chr_escape(ub)}"
-            else:
-                option = chr_escape(lb)
-            options.append(option)
-    options.append("]")
-    pattern = re.compile(''.join(options))
-    return pattern
+    return _mk_regex_from_ranges(
+        _merge_ranges(r for table in tables for r in table))
 
 
 def single(code: int) -> Tuple[int, int]:
@@ -82,27 +157,122 @@ def single(code: int) -> Tuple[int, int]:
     return (code, code)
 
 
-LETTER = mk_regex_from_unicode_tables(
-    UT.lu,
-    UT.ll,
-    UT.lt,
-    UT.lo,
-    UT.lm,
-    [(0x01D00,
-      0x01D7F)],  # Phonetic Extensions.
-    [(0x01D80,
-      0x01DBF)],  # Phonetic Extensions Suppl.
-    [(0x01DC0,
-      0x01DFF)])  # Combining Diacritical Marks Suppl.
-
-IDENTPART = mk_regex_from_unicode_tables(
-    UT.nd,
-    UT.nl,
-    UT.no,
-    [single(0x0027)],  # Single quote.
-)
+def _ident_class_tables() -> Tuple[List[List[Tuple[int, int]]], ...]:
+    """
+    Get the Unicode tables comprising each identifier character class.
+
+    Returns
+    -------
+    Tuple[List[List[Tuple[int, int]]], ...]
+        The tables of the classes `LETTER`, `IDENTSEP`, and `IDENTPART`.
+    """
+    import prism.interface.coq.unicode_table as UT
+    letter = [
+        UT.lu,
+        UT.ll,
+        UT.lt,
+        UT.lo,
+        UT.lm,
+        [(0x01D00,
+          0x01D7F)],  # Phonetic Extensions.
+        [(0x01D80,
+          0x01DBF)],  # Phonetic Extensions Suppl.
+        [(0x01DC0,
+          0x01DFF)],  # Combining Diacritical Marks Suppl.
+    ]
+    identsep = [[
+        single(0x005F),  # Underscore.
+        single(0x00A0),  # Non breaking space, overrides Sep
+    ]]
+    identpart = [
+        UT.nd,
+        UT.nl,
+        UT.no,
+        [single(0x0027)],  # Single quote.
+    ]
+    return letter, identsep, identpart
+
+
+def generate_table_header(filename: PathLike) -> None:
+    """
+    Generate the C++ header of the native identifier class table.
+
+    The table maps each code point to a bitmask of the classes that
+    contain it in two levels: an index of blocks of `_BLOCK_SIZE` code
+    points and the distinct blocks themselves.
+
+    Parameters
+    ----------
+    filename : PathLike
+        The path of the header to write.
+    """
+    flags = bytearray(sys.maxunicode + 1)
+    for bit, tables in zip([_LETTER, _IDENTSEP, _IDENTPART],
+                           _ident_class_tables()):
+        for table in tables:
+            for lb, ub in table:
+                for code in range(lb, ub + 1):
+                    flags[code] |= bit
+    blocks: List[bytes] = []
+    block_ids = {}
+    index = []
+    for start in range(0, len(flags), _BLOCK_SIZE):
+        block = bytes(flags[start : start + _BLOCK_SIZE])
+        if block not in block_ids:
+            block_ids[block] = len(blocks)
+            blocks.append(block)
+        index.append(block_ids[block])
+
+    def _array(values: Iterable[int], per_line: int, indent: str) -> str:
+        values = [str(v) for v in values]
+        return ",\n".join(
+            indent + ", ".join(values[i : i + per_line])
+            for i in range(0, len(values), per_line))
+
+    with open(filename, "w") as f:
+        f.write(
+            "/* Generated by `python -m prism.interface.coq.unicode`;"
+            " do not edit. */\n"
+            f"const unsigned ident_class_letter     = {_LETTER};\n"
+            f"const unsigned ident_class_identsep   = {_IDENTSEP};\n"
+            f"const unsigned ident_class_identpart  = {_IDENTPART};\n"
+            f"const unsigned ident_class_block_size = {_BLOCK_SIZE};\n\n"
+            f"static const uint16_t ident_class_index[{len(index)}] = {{\n"
+            f"{_array(index, 16, '    ')}}};\n\n"
+            "static const uint8_t ident_class_blocks"
+            f"[{len(blocks)}][{_BLOCK_SIZE}] = {{\n")
+        f.write(
+            ",\n".join(
+                f"    {{\n{_array(block, 32, '        ')}}}"
+                for block in blocks))
+        f.write("};\n")
+
+
+LETTER = _mk_regex_from_ranges(class_ranges(_LETTER))
+"""
+A Unicode letter-like character.
+"""
+
+IDENTPART = _mk_regex_from_ranges(class_ranges(_IDENTPART))
+"""
+A digit-like character or single quote.
+"""
+
+IDENTSEP = _mk_regex_from_ranges(class_ranges(_IDENTSEP))
+"""
+An underscore or non-breaking space.
+"""
+
+IDENT_INIT = _mk_regex_from_ranges(class_ranges(_LETTER | _IDENTSEP))
+"""
+A `LETTER` or `IDENTSEP` as a single character class.
+"""
+
+IDENT_TRAILING = _mk_regex_from_ranges(
+    class_ranges(_LETTER | _IDENTSEP | _IDENTPART))
+"""
+An `IDENT_INIT` or `IDENTPART` as a single character class.
+"""
 
-IDENTSEP = mk_regex_from_unicode_tables([
-    single(0x005F),  # Underscore.
-    single(0x00A0),  # Non breaking space, overrides Sep
-])
+if __name__ == "__main__":
+    generate_table_header(Path(__file__).parent / "_unicode_table.h")
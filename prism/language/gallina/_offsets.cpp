@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+/*
+ * An offset index is a bytestring of 64-bit words laid out as follows:
+ *
+ *   header[4]            number of bytes, number of characters,
+ *                        number of bitvector words, number of samples
+ *   words[num_words]     bitvector marking the first byte of each
+ *                        character in the UTF-8 encoding of the text
+ *   ranks[num_words + 1] number of marked bytes preceding each word
+ *   samples[num_samples] word containing every 64th marked byte
+ *
+ * Converting a byte index to a character index is then a rank query
+ * and the converse is a select query, both in constant time.
+ */
+
+/* Conversion modes (see prism/language/gallina/util.py) */
+const long mode_byte_to_char       = 0;
+const long mode_char_to_first_byte = 1;
+const long mode_char_to_last_byte  = 2;
+
+const size_t header_size = 4;
+
+struct OffsetIndex
+{
+    int64_t         num_bytes;
+    int64_t         num_chars;
+    const uint64_t* words;
+    const uint64_t* ranks;
+    const uint64_t* samples;
+};
+
+/*
+ * Get the number of marked bytes strictly before the given index.
+ */
+static inline int64_t rank(const OffsetIndex& index, int64_t pos)
+{
+    int64_t  word   = pos >> 6;
+    unsigned offset = pos & 63;
+    int64_t  result = (int64_t)index.ranks[word];
+    if (offset != 0)
+    {
+        result += __builtin_popcountll(index.words[word] & ((1ULL << offset) - 1));
+    }
+    return result;
+}
+
+/*
+ * Get the index of the marked byte with the given rank.
+ */
+static inline int64_t select(const OffsetIndex& index, int64_t rank)
+{
+    uint64_t word = index.samples[rank >> 6];
+    while (index.ranks[word + 1] <= (uint64_t)rank)
+    {
+        word++;
+    }
+    uint64_t bits = index.words[word];
+    for (uint64_t i = rank - index.ranks[word]; i > 0; i--)
+    {
+        bits &= bits - 1;
+    }
+    return (int64_t)(word << 6) + __builtin_ctzll(bits);
+}
+
+static inline int64_t convert(const OffsetIndex& index, long mode, int64_t value)
+{
+    if (value < 0)
+    {
+        return value;
+    }
+    if (mode == mode_byte_to_char)
+    {
+        if (value >= index.num_bytes)
+        {
+            return index.num_chars + (value - index.num_bytes);
+        }
+        // index of the character containing the byte
+        return rank(index, value + 1) - 1;
+    }
+    if (value >= index.num_chars)
+    {
+        return index.num_bytes + (value - index.num_chars);
+    }
+    if (mode == mode_char_to_first_byte)
+    {
+        return select(index, value);
+    }
+    // the last byte precedes the first byte of the next character
+    return (value + 1 < index.num_chars ? select(index, value + 1) : index.num_bytes)
+         - 1;
+}
+
+/*
+ * Unpack an index built by `build_offset_index`.
+ */
+static bool unpack_index(PyObject* packed, OffsetIndex& index)
+{
+    char*      data = NULL;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(packed, &data, &size) < 0)
+    {
+        return false;
+    }
+    const uint64_t* header = (const uint64_t*)data;
+    if ((size_t)size < header_size * sizeof(uint64_t)
+        or (size_t)size
+               != (header_size + 2 * header[2] + 1 + header[3]) * sizeof(uint64_t))
+    {
+        PyErr_SetString(PyExc_ValueError, "Malformed offset index");
+        return false;
+    }
+    index.num_bytes = (int64_t)header[0];
+    index.num_chars = (int64_t)header[1];
+    index.words     = header + header_size;
+    index.ranks     = index.words + header[2];
+    index.samples   = index.ranks + header[2] + 1;
+    return true;
+}
+
+static PyObject* build_offset_index(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    PyObject* encoded = PyUnicode_AsUTF8String(text);
+    if (encoded == NULL)
+    {
+        return NULL;
+    }
+    char*      raw_data  = NULL;
+    Py_ssize_t num_bytes = 0;
+    if (PyBytes_AsStringAndSize(encoded, &raw_data, &num_bytes) < 0)
+    {
+        Py_DecRef(encoded);
+        return NULL;
+    }
+    const unsigned char*  data      = (const unsigned char*)raw_data;
+    size_t                num_words = (num_bytes + 63) / 64;
+    std::vector<uint64_t> words(num_words, 0);
+    std::vector<uint64_t> ranks(num_words + 1, 0);
+    std::vector<uint64_t> samples;
+    uint64_t              num_chars = 0;
+    for (size_t word = 0; word < num_words; word++)
+    {
+        ranks[word]   = num_chars;
+        size_t   end  = std::min((size_t)num_bytes, (word + 1) * 64);
+        uint64_t bits = 0;
+        for (size_t pos = word * 64; pos < end; pos++)
+        {
+            // continuation bytes have the form 0b10xxxxxx
+            if ((data[pos] & 0xC0) != 0x80)
+            {
+                if ((num_chars & 63) == 0)
+                {
+                    samples.push_back(word);
+                }
+                bits |= 1ULL << (pos & 63);
+                num_chars++;
+            }
+        }
+        words[word] = bits;
+    }
+    ranks[num_words] = num_chars;
+    Py_DecRef(encoded);
+    uint64_t header[header_size] = {
+        (uint64_t)num_bytes, num_chars, num_words, samples.size()};
+    size_t    total_words = header_size + words.size() + ranks.size() + samples.size();
+    PyObject* result = PyBytes_FromStringAndSize(NULL, total_words * sizeof(uint64_t));
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    char* out = PyBytes_AsString(result);
+    memcpy(out, header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, words.data(), words.size() * sizeof(uint64_t));
+    out += words.size() * sizeof(uint64_t);
+    memcpy(out, ranks.data(), ranks.size() * sizeof(uint64_t));
+    out += ranks.size() * sizeof(uint64_t);
+    memcpy(out, samples.data(), samples.size() * sizeof(uint64_t));
+    return result;
+};
+
+static PyObject* convert_offset(PyObject* self, PyObject* args)
+{
+    PyObject* packed = NULL;
+    long      mode   = 0;
+    long long value  = 0;
+    if (!PyArg_ParseTuple(args, "O!lL", &PyBytes_Type, &packed, &mode, &value))
+    {
+        return NULL;
+    }
+    OffsetIndex index;
+    if (!unpack_index(packed, index))
+    {
+        return NULL;
+    }
+    return PyLong_FromLongLong(convert(index, mode, value));
+};
+
+static PyObject* convert_offsets(PyObject* self, PyObject* args)
+{
+    PyObject* packed = NULL;
+    long      mode   = 0;
+    PyObject* values = NULL;
+    if (!PyArg_ParseTuple(
+            args,
+            "O!lO!",
+            &PyBytes_Type,
+            &packed,
+            &mode,
+            &PyBytes_Type,
+            &values))
+    {
+        return NULL;
+    }
+    OffsetIndex index;
+    if (!unpack_index(packed, index))
+    {
+        return NULL;
+    }
+    char*      raw_values = NULL;
+    Py_ssize_t size       = 0;
+    if (PyBytes_AsStringAndSize(values, &raw_values, &size) < 0)
+    {
+        return NULL;
+    }
+    if (size % sizeof(int64_t) != 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Expected a buffer of 64-bit integers");
+        return NULL;
+    }
+    PyObject* result = PyBytes_FromStringAndSize(NULL, size);
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    Py_ssize_t count = size / sizeof(int64_t);
+    int64_t*   out   = (int64_t*)PyBytes_AsString(result);
+    int64_t    value = 0;
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        memcpy(&value, raw_values + i * sizeof(int64_t), sizeof(int64_t));
+        out[i] = convert(index, mode, value);
+    }
+    return result;
+};
+
+static PyMethodDef OffsetMethods[] = {
+    {"build_offset_index",
+     build_offset_index, METH_VARARGS,
+     "Build an index of the UTF-8 encoding of a string."},
+    {"convert_offset",
+     convert_offset,     METH_VARARGS,
+     "Convert a byte or character offset using an index."},
+    {"convert_offsets",
+     convert_offsets,    METH_VARARGS,
+     "Convert a buffer of byte or character offsets using an index."},
+    {NULL,               NULL,           0,            NULL}
+};
+
+static struct PyModuleDef offsets_module = {
+    PyModuleDef_HEAD_INIT,
+    "prism.language.gallina._offsets",
+    "Library for converting between UTF-8 byte and character offsets",
+    -1,
+    OffsetMethods};
+
+PyMODINIT_FUNC PyInit__offsets(void)
+{
+    return PyModule_Create(&offsets_module);
+};
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ * A node of a parsed s-expression.
+ */
+struct Node
+{
+    bool                 is_list;
+    std::u32string       text;
+    std::vector<int64_t> children;
+};
+
+/*
+ * Test whether a character is whitespace in the sense of `str.isspace`.
+ */
+static inline bool is_space(Py_UCS4 c)
+{
+    if (c < 0x80)
+    {
+        return (c >= 0x09 and c <= 0x0D) or (c >= 0x1C and c <= 0x20);
+    }
+    return c == 0x85 or c == 0xA0 or c == 0x1680 or (c >= 0x2000 and c <= 0x200A)
+        or c == 0x2028 or c == 0x2029 or c == 0x202F or c == 0x205F or c == 0x3000;
+}
+
+/*
+ * A decoding error, after which the caller falls back to
+ * `SexpAnalyzer.analyze_sertok_sentences` to report the precise error.
+ */
+struct DecodeError
+{
+    const char* message;
+};
+
+/*
+ * An s-expression tree with the same atoms as `SexpParser.parse_list`.
+ */
+class Tree
+{
+  public:
+    std::vector<Node>    nodes;
+    std::vector<int64_t> roots;
+
+    /*
+     * Parse text with the same state machine as
+     * prism/language/sexp/_parse.cpp.
+     */
+    void parse(const Py_UCS4* text, Py_ssize_t size)
+    {
+        std::vector<std::vector<int64_t>> stack(1);
+        std::u32string                    quoted;
+        std::u32string                    terminal;
+        bool                              escaped = false;
+        for (Py_ssize_t i = 0; i < size; i++)
+        {
+            Py_UCS4 c = text[i];
+            if (!terminal.empty())
+            {
+                if (!quoted.empty())
+                {
+                    throw DecodeError{"quoted is not empty"};
+                }
+                else if (escaped)
+                {
+                    c = unescape(c, terminal);
+                }
+                if (!escaped and (c == '(' or c == ')' or c == '"' or is_space(c)))
+                {
+                    stack.back().push_back(atom(terminal));
+                    terminal.clear();
+                }
+                else
+                {
+                    escaped = false;
+                    terminal.push_back(c);
+                    continue;
+                }
+            }
+            if (escaped)
+            {
+                if (c == '"')
+                {
+                    if (!quoted.empty())
+                    {
+                        // keep double-quotes escaped if inside of a quote
+                        quoted.push_back('\\');
+                    }
+                }
+                else
+                {
+                    c = unescape(c, quoted.empty() ? terminal : quoted);
+                }
+            }
+            else if (c == '\\')
+            {
+                escaped = true;
+                continue;
+            }
+            if (!quoted.empty())
+            {
+                if (!escaped and c == '"')
+                {
+                    quoted.push_back('"');
+                    stack.back().push_back(atom(quoted));
+                    quoted.clear();
+                }
+                else
+                {
+                    escaped = false;
+                    quoted.push_back(c);
+                }
+            }
+            else if (!escaped)
+            {
+                if (is_space(c))
+                {
+                    continue;
+                }
+                else if (c == '(')
+                {
+                    stack.emplace_back();
+                }
+                else if (c == ')')
+                {
+                    if (stack.size() == 1)
+                    {
+                        throw DecodeError{"Extra close parenthesis"};
+                    }
+                    Node node{true, std::u32string(), std::move(stack.back())};
+                    stack.pop_back();
+                    nodes.push_back(std::move(node));
+                    stack.back().push_back((int64_t)nodes.size() - 1);
+                }
+                else if (c == '"')
+                {
+                    quoted = U"\"";
+                }
+                else
+                {
+                    terminal.push_back(c);
+                }
+            }
+            else
+            {
+                escaped = false;
+                terminal.push_back(c);
+            }
+        }
+        if (!terminal.empty())
+        {
+            stack.back().push_back(atom(terminal));
+        }
+        if (stack.size() != 1 or stack.front().empty())
+        {
+            throw DecodeError{"Malformed sexp"};
+        }
+        roots = std::move(stack.front());
+    }
+
+    const Node& operator[](int64_t i) const
+    {
+        return nodes[i];
+    }
+
+    /* Get a child of a list like `SexpNode.__getitem__`. */
+    const Node& child(const Node& node, size_t i) const
+    {
+        if (!node.is_list or i >= node.children.size())
+        {
+            throw DecodeError{"Missing child"};
+        }
+        return nodes[node.children[i]];
+    }
+
+    /* Get the content of an atom like `SexpNode.content`. */
+    static const std::u32string& content(const Node& node)
+    {
+        if (node.is_list)
+        {
+            throw DecodeError{"Expected an atom"};
+        }
+        return node.text;
+    }
+
+    /* Serialize a node like `str(SexpNode)`. */
+    void serialize(const Node& node, std::u32string& out) const
+    {
+        if (!node.is_list)
+        {
+            const std::u32string& text = node.text;
+            bool                  is_quoted
+                = !text.empty() and text.front() == '"' and text.back() == '"';
+            if (!is_quoted and text.find(' ') != std::u32string::npos)
+            {
+                out.push_back('"');
+                for (Py_UCS4 c : text)
+                {
+                    if (c == '\\')
+                    {
+                        out.push_back('\\');
+                    }
+                    out.push_back(c);
+                }
+                out.push_back('"');
+            }
+            else
+            {
+                out += text;
+            }
+            return;
+        }
+        out.push_back('(');
+        for (size_t i = 0; i < node.children.size(); i++)
+        {
+            if (i > 0)
+            {
+                out.push_back(' ');
+            }
+            serialize(nodes[node.children[i]], out);
+        }
+        out.push_back(')');
+    }
+
+  private:
+    int64_t atom(const std::u32string& text)
+    {
+        nodes.push_back(Node{false, text, {}});
+        return (int64_t)nodes.size() - 1;
+    }
+
+    /*
+     * Unescape a character, appending a backslash to `out` if the
+     * escape is not recognized.
+     */
+    static Py_UCS4 unescape(Py_UCS4 c, std::u32string& out)
+    {
+        switch (c)
+        {
+            case '\\':
+            case '\'':
+            case '"': return c;
+            case 'b': return '\b';
+            case 'f': return '\f';
+            case 't': return '\t';
+            case 'n': return '\n';
+            case 'r': return '\r';
+            case 'v': return '\v';
+            case 'a': return '\a';
+            default: out.push_back('\\'); return c;
+        }
+    }
+};
+
+/* The number of location fields of each token */
+const size_t num_loc_fields = 6;
+
+/*
+ * Flat arrays of decoded tokens (see prism/language/gallina/sertok.py).
+ */
+class Decoder
+{
+  public:
+    std::u32string              content;
+    std::vector<int64_t>        bounds;
+    std::vector<uint8_t>        quoted;
+    std::vector<int64_t>        kinds;
+    std::vector<std::u32string> kind_names;
+    std::vector<int64_t>        locs;
+    std::vector<int32_t>        files;
+    std::vector<std::u32string> file_names;
+    std::vector<int64_t>        sentences;
+
+    explicit Decoder(const Tree& tree) : tree(tree)
+    {
+    }
+
+    void decode()
+    {
+        sentences.push_back(0);
+        for (int64_t root : tree.roots)
+        {
+            const Node& sentence = tree[root];
+            if (Tree::content(tree.child(sentence, 0)) != U"Sentence")
+            {
+                throw DecodeError{"Not a valid SertokSentence sexp"};
+            }
+            const Node& tokens = tree.child(sentence, 1);
+            if (!tokens.is_list)
+            {
+                throw DecodeError{"Expected a list of tokens"};
+            }
+            for (int64_t token : tokens.children)
+            {
+                decode_token(tree[token]);
+            }
+            sentences.push_back((int64_t)quoted.size());
+        }
+    }
+
+  private:
+    const Tree&                        tree;
+    std::map<std::u32string, int64_t> kind_ids;
+    std::map<std::u32string, int64_t> file_ids;
+
+    static int64_t intern(const std::u32string&             text,
+                          std::map<std::u32string, int64_t>& ids,
+                          std::vector<std::u32string>&       names)
+    {
+        auto it = ids.find(text);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        int64_t id = (int64_t)names.size();
+        ids.emplace(text, id);
+        names.push_back(text);
+        return id;
+    }
+
+    const std::u32string& numeral(const Node& node)
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            const Node&           part = tree.child(tree.child(node, i), 1);
+            const std::u32string& text = Tree::content(part);
+            if (!text.empty())
+            {
+                return text;
+            }
+        }
+        throw DecodeError{"Unknown numeral"};
+    }
+
+    void decode_token(const Node& token)
+    {
+        const Node& value = tree.child(token, 0);
+        if (Tree::content(tree.child(value, 0)) != U"v")
+        {
+            throw DecodeError{"Expected a located token"};
+        }
+        const Node&    kind_node = tree.child(value, 1);
+        std::u32string kind;
+        std::u32string text;
+        if (kind_node.is_list)
+        {
+            kind = Tree::content(tree.child(kind_node, 0));
+            if (kind == U"NUMERAL")
+            {
+                text = numeral(tree.child(kind_node, 1));
+            }
+            else
+            {
+                text = Tree::content(tree.child(kind_node, 1));
+            }
+        }
+        else
+        {
+            kind = kind_node.text;
+            if (kind != U"LEFTQMARK")
+            {
+                throw DecodeError{"Unknown special token"};
+            }
+            text = U"?";
+        }
+        decode_loc(tree.child(token, 1));
+        kinds.push_back(intern(kind, kind_ids, kind_names));
+        // It can never be empty string; if it is, it is '""'
+        if (text.empty())
+        {
+            text = U"\"\"";
+        }
+        bool is_quoted = text.front() == '"' and text.back() == '"';
+        // Escape the " in coq style
+        if (is_quoted and text.size() > 2
+            and text.find('"', 1) < text.size() - 1)
+        {
+            std::u32string escaped = U"\"";
+            for (size_t i = 1; i + 1 < text.size(); i++)
+            {
+                escaped.push_back(text[i]);
+                if (text[i] == '"')
+                {
+                    escaped.push_back('"');
+                }
+            }
+            escaped.push_back('"');
+            text = std::move(escaped);
+        }
+        // pad with quotes that may be added once locations are known
+        content.push_back('"');
+        bounds.push_back((int64_t)content.size());
+        content += text;
+        bounds.push_back((int64_t)content.size());
+        content.push_back('"');
+        quoted.push_back(is_quoted);
+    }
+
+    int64_t loc_field(const Node& field, const char32_t* name)
+    {
+        if (Tree::content(tree.child(field, 0)) != name)
+        {
+            throw DecodeError{"Unexpected location field"};
+        }
+        const Node& value = tree.child(field, 1);
+        if (value.is_list or value.text.empty() or value.text.size() > 18)
+        {
+            throw DecodeError{"Expected an integer"};
+        }
+        int64_t result = 0;
+        for (Py_UCS4 c : value.text)
+        {
+            if (c < '0' or c > '9')
+            {
+                throw DecodeError{"Expected an integer"};
+            }
+            result = result * 10 + (int64_t)(c - '0');
+        }
+        return result;
+    }
+
+    void decode_loc(const Node& loc)
+    {
+        if (!loc.is_list or loc.children.size() != 2
+            or Tree::content(tree.child(loc, 0)) != U"loc")
+        {
+            throw DecodeError{"Expected a location"};
+        }
+        const Node& data = tree.child(tree.child(loc, 1), 0);
+        if (!data.is_list or data.children.size() != 7)
+        {
+            throw DecodeError{"Expected a location"};
+        }
+        const Node& fname = tree.child(data, 0);
+        if (Tree::content(tree.child(fname, 0)) != U"fname")
+        {
+            throw DecodeError{"Unexpected location field"};
+        }
+        std::u32string file;
+        tree.serialize(tree.child(fname, 1), file);
+        if (file.compare(0, 7, U"(InFile") == 0)
+        {
+            // equivalent to `file[8:-1]`
+            file = file.size() > 9 ? file.substr(8, file.size() - 9) : U"";
+        }
+        files.push_back((int32_t)intern(file, file_ids, file_names));
+        static const char32_t* const fields[]
+            = {U"line_nb", U"bol_pos", U"line_nb_last", U"bol_pos_last", U"bp", U"ep"};
+        for (size_t i = 0; i < num_loc_fields; i++)
+        {
+            locs.push_back(loc_field(tree.child(data, i + 1), fields[i]));
+        }
+    }
+};
+
+static PyObject* ucs4_to_str(const std::u32string& text)
+{
+    int byteorder = PY_LITTLE_ENDIAN ? -1 : 1;
+    return PyUnicode_DecodeUTF32((const char*)text.data(),
+                                 (Py_ssize_t)(text.size() * sizeof(char32_t)),
+                                 "surrogatepass",
+                                 &byteorder);
+}
+
+static PyObject* strs_to_list(const std::vector<std::u32string>& texts)
+{
+    PyObject* list = PyList_New((Py_ssize_t)texts.size());
+    if (list == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        PyObject* text = ucs4_to_str(texts[i]);
+        if (text == NULL)
+        {
+            Py_DecRef(list);
+            return NULL;
+        }
+        PyList_SetItem(list, (Py_ssize_t)i, text);
+    }
+    return list;
+}
+
+template <typename T>
+static PyObject* to_bytes(const std::vector<T>& values)
+{
+    return PyBytes_FromStringAndSize((const char*)values.data(),
+                                     (Py_ssize_t)(values.size() * sizeof(T)));
+}
+
+static PyObject* decode_sertok(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    Tree        tree;
+    Decoder     decoder(tree);
+    const char* error = NULL;
+    /* The decoder only touches its own copy of the text. */
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        tree.parse(data, size);
+        decoder.decode();
+    }
+    catch (const DecodeError& e)
+    {
+        error = e.message;
+    }
+    Py_END_ALLOW_THREADS
+    PyMem_Free(data);
+    if (error != NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, error);
+        return NULL;
+    }
+    PyObject* items[] = {
+        ucs4_to_str(decoder.content),
+        to_bytes(decoder.bounds),
+        to_bytes(decoder.quoted),
+        to_bytes(decoder.kinds),
+        strs_to_list(decoder.kind_names),
+        to_bytes(decoder.locs),
+        to_bytes(decoder.files),
+        strs_to_list(decoder.file_names),
+        to_bytes(decoder.sentences),
+    };
+    const size_t num_items = sizeof(items) / sizeof(items[0]);
+    PyObject*    result    = PyTuple_New((Py_ssize_t)num_items);
+    for (size_t i = 0; i < num_items; i++)
+    {
+        if (items[i] == NULL or result == NULL)
+        {
+            for (size_t j = i; j < num_items; j++)
+            {
+                Py_DecRef(items[j]);
+            }
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyTuple_SetItem(result, (Py_ssize_t)i, items[i]);
+    }
+    return result;
+};
+
+static PyMethodDef SertokMethods[] = {
+    {"decode_sertok",
+     decode_sertok, METH_VARARGS,
+     "Decode the output of `sertok` into flat arrays of tokens."},
+    {NULL,            NULL,          0,            NULL}
+};
+
+static struct PyModuleDef sertok_module = {PyModuleDef_HEAD_INIT,
+                                           "prism.language.gallina._sertok",
+                                           "Library for decoding sertok output",
+                                           -1,
+                                           SertokMethods};
+
+PyMODINIT_FUNC            PyInit__sertok(void)
+{
+    return PyModule_Create(&sertok_module);
+};
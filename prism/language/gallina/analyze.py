@@ -29,15 +29,17 @@ import enum
 import functools
 import logging
 import re
-from dataclasses import asdict, dataclass
-from typing import Any, Callable, List, Optional, Set, Union
+import sys
+from dataclasses import dataclass, replace
+from typing import Any, Callable, List, Optional, Set, Tuple, Union
 
-from prism.language.gallina.util import ParserUtils
+from prism.language.gallina.util import ParserUtils, UnicodeOffsets
 from prism.language.sexp import (
     IllegalSexpOperationException,
     SexpNode,
     SexpParser,
 )
+from prism.language.sexp._parse import parse_vernac_sexps
 from prism.language.sexp.list import SexpList
 from prism.language.sexp.string import SexpString
 from prism.language.token import TokenConsts
@@ -264,10 +266,16 @@ class SexpInfo:
 
         extend_type_obligations = "Obligations"
 
-    @dataclass(frozen=True)
+    @dataclass(frozen=True, slots=True)
     class Loc:
         """
         A location within a file.
+
+        Locations are slotted and their filenames are interned since
+        extracted data holds a location for every sentence, nearly all
+        of which share a handful of filenames.
+        See `prism.language.gallina.locations.LocArray` for a packed
+        representation of many locations.
         """
 
         filename: str
@@ -301,6 +309,28 @@ class SexpInfo:
         The ending character offset from the start of the file.
         """
 
+        def __post_init__(self) -> None:
+            """
+            Intern the filename.
+            """
+            if type(self.filename) is str:
+                object.__setattr__(self, 'filename', sys.intern(self.filename))
+
+        def __reduce__(self) -> Tuple[type, Tuple[Any, ...]]:
+            """
+            Pickle the location as a tuple of its fields.
+            """
+            return (
+                SexpInfo.Loc,
+                (
+                    self.filename,
+                    self.lineno,
+                    self.bol_pos,
+                    self.lineno_last,
+                    self.bol_pos_last,
+                    self.beg_charno,
+                    self.end_charno))
+
         def __bool__(self) -> bool:
             """
             Return True if the location is non-empty, False otherwise.
@@ -385,15 +415,16 @@ class SexpInfo:
                 raise ValueError(
                     "Cannot combine locations from different files.")
             if self.beg_charno <= other.beg_charno:
-                kwargs = asdict(self)
                 if self.end_charno < other.end_charno:
-                    kwargs['lineno_last'] = other.lineno_last
-                    kwargs['bol_pos_last'] = other.bol_pos_last
-                    kwargs['end_charno'] = other.end_charno
-                loc = SexpInfo.Loc(**kwargs)
+                    loc = replace(
+                        self,
+                        lineno_last=other.lineno_last,
+                        bol_pos_last=other.bol_pos_last,
+                        end_charno=other.end_charno)
+                else:
+                    loc = self
             elif self.end_charno == other.end_charno:
-                kwargs = asdict(other)
-                loc = SexpInfo.Loc(**kwargs)
+                loc = other
             else:
                 loc = other | self
             return loc
@@ -529,13 +560,13 @@ class SexpInfo:
 
         def offset_byte_to_char(
                 self,
-                unicode_offsets: List[int]) -> 'SexpInfo.Loc':
+                unicode_offsets: UnicodeOffsets) -> 'SexpInfo.Loc':
             """
             Offset byte-relative character indices to unicode indices..
 
             Parameters
             ----------
-            unicode_offsets : List[int]
+            unicode_offsets : UnicodeOffsets
                 Offsets of unicode (non-ASCII) characters from the start
                 of the file.
 
@@ -544,24 +575,24 @@ class SexpInfo:
             SexpInfo.Loc
                 The offset location.
             """
-            kwargs = asdict(self)
-            kwargs['beg_charno'] = ParserUtils.coq_charno_to_actual_charno(
-                kwargs['beg_charno'],
-                unicode_offsets)
-            kwargs['end_charno'] = ParserUtils.coq_charno_to_actual_charno(
-                kwargs['end_charno'],
-                unicode_offsets)
-            return SexpInfo.Loc(**kwargs)
+            return replace(
+                self,
+                beg_charno=ParserUtils.coq_charno_to_actual_charno(
+                    self.beg_charno,
+                    unicode_offsets),
+                end_charno=ParserUtils.coq_charno_to_actual_charno(
+                    self.end_charno,
+                    unicode_offsets))
 
         def offset_char_to_byte(
                 self,
-                unicode_offsets: List[int]) -> 'SexpInfo.Loc':
+                unicode_offsets: UnicodeOffsets) -> 'SexpInfo.Loc':
             """
             Offset byte-relative character indices to unicode indices..
 
             Parameters
             ----------
-            unicode_offsets : List[int]
+            unicode_offsets : UnicodeOffsets
                 Offsets of unicode (non-ASCII) characters from the start
                 of the file.
 
@@ -570,14 +601,14 @@ class SexpInfo:
             SexpInfo.Loc
                 The offset location.
             """
-            kwargs = asdict(self)
-            kwargs['beg_charno'] = ParserUtils.actual_charno_to_coq_charno_bp(
-                kwargs['beg_charno'],
-                unicode_offsets)
-            kwargs['end_charno'] = ParserUtils.actual_charno_to_coq_charno_ep(
-                kwargs['end_charno'],
-                unicode_offsets)
-            return SexpInfo.Loc(**kwargs)
+            return replace(
+                self,
+                beg_charno=ParserUtils.actual_charno_to_coq_charno_bp(
+                    self.beg_charno,
+                    unicode_offsets),
+                end_charno=ParserUtils.actual_charno_to_coq_charno_ep(
+                    self.end_charno,
+                    unicode_offsets))
 
         def rename(self, new_name: str) -> 'SexpInfo.Loc':
             """
@@ -849,32 +880,30 @@ class SexpAnalyzer:
     logger: logging.Logger = logging.getLogger(__name__)
     logger.setLevel(logging.DEBUG)
 
-    _vt_proof_regex: re.Pattern = re.compile(
-        "|".join(
-            [
-                # VtStartProof
-                "VernacProof",
-                # VtProofMode
-                "VernacProofMode",  # NOTE: not sure if this belongs
-                # VtQed
-                "VernacAbort",
-                "VernacEndProof",
-                "VernacEndSubproof",
-                "VernacExactProof",
-                # VtProofStep
-                "VernacBullet",
-                "VernacCheckGuard",
-                "VernacFocus",
-                "VernacShow",
-                "VernacSubproof",
-                "VernacUnfocus",
-                "VernacUnfocused",
-                # VtMeta
-                "VernacAbortAll",
-                "VernacRestart",
-                "VernacUndo",
-                "VernacUndoTo",
-            ]))
+    _vt_proof_types: List[str] = [
+        # VtStartProof
+        "VernacProof",
+        # VtProofMode
+        "VernacProofMode",  # NOTE: not sure if this belongs
+        # VtQed
+        "VernacAbort",
+        "VernacEndProof",
+        "VernacEndSubproof",
+        "VernacExactProof",
+        # VtProofStep
+        "VernacBullet",
+        "VernacCheckGuard",
+        "VernacFocus",
+        "VernacShow",
+        "VernacSubproof",
+        "VernacUnfocus",
+        "VernacUnfocused",
+        # VtMeta
+        "VernacAbortAll",
+        "VernacRestart",
+        "VernacUndo",
+        "VernacUndoTo",
+    ]
     """
     A white-list of Vernacular commands that are part of a proof.
 
@@ -885,27 +914,28 @@ class SexpAnalyzer:
     as well as documentation at
     https://coq.inria.fr/refman/proofs/writing-proofs/proof-mode.html.
     """
-    _vt_proof_extend_regex: re.Pattern = regex_from_options(
-        [
-            # from Ltac
-            "Obligations",
-            "OptimizeProof",
-            # from Ltac: Questionable
-            # "Admit_Obligations",
-            # "Solve_Obligation",
-            # "Solve_Obligations",
-            # "Solve_All_Obligations",
-            "Unshelve",
-            "VernacSolve",
-            "VernacSolveParallel",
-            # from Ltac2
-            "VernacLtac2",
-            # from Mtac2
-            "MProofInstr",
-            "MProofCommand",
-        ],
-        False,
-        False)
+    _vt_proof_regex: re.Pattern = re.compile("|".join(_vt_proof_types))
+    """
+    A pattern matching the start of `_vt_proof_types`.
+    """
+    _vt_proof_extend_types: List[str] = [
+        # from Ltac
+        "Obligations",
+        "OptimizeProof",
+        # from Ltac: Questionable
+        # "Admit_Obligations",
+        # "Solve_Obligation",
+        # "Solve_Obligations",
+        # "Solve_All_Obligations",
+        "Unshelve",
+        "VernacSolve",
+        "VernacSolveParallel",
+        # from Ltac2
+        "VernacLtac2",
+        # from Mtac2
+        "MProofInstr",
+        "MProofCommand",
+    ]
     """
     A white-list of VernacExtend commands that are part of a proof.
 
@@ -914,6 +944,13 @@ class SexpAnalyzer:
     https://github.com/coq-community/awesome-coq by looking for
     command definitions that classify as ``VtProofStep``.
     """
+    _vt_proof_extend_regex: re.Pattern = regex_from_options(
+        _vt_proof_extend_types,
+        False,
+        False)
+    """
+    A pattern matching the start of `_vt_proof_extend_types`.
+    """
     _vernac_extend_regex: re.Pattern = re.compile("VernacExtend")
 
     @classmethod
@@ -1099,11 +1136,113 @@ class SexpAnalyzer:
         except IllegalSexpOperationException:
             raise SexpAnalyzingException(sexp)
 
+    @classmethod
+    def _py_parse_vernacs(
+        cls,
+        sexp_str: str) -> Tuple[List[SexpNode],
+                                List[SexpInfo.Vernac],
+                                List[bool]]:
+        """
+        Parse and analyze s-expressions of Vernacular commands.
+
+        Reference implementation for `parse_vernacs`.
+        """
+        sexps = SexpParser.parse_list(sexp_str)
+        vernacs = [cls.analyze_vernac(sexp) for sexp in sexps]
+        is_ltac = [
+            cls._is_ltac_type(vernac.vernac_type,
+                              vernac.extend_type) for vernac in vernacs
+        ]
+        return sexps, vernacs, is_ltac
+
+    @classmethod
+    def parse_vernacs(
+        cls,
+        sexp_str: str) -> Tuple[List[SexpNode],
+                                List[SexpInfo.Vernac],
+                                List[bool]]:
+        """
+        Parse and analyze s-expressions of Vernacular commands.
+
+        The commands are summarized natively while they are parsed,
+        which avoids most of the cost of traversing the parsed
+        s-expressions in Python.
+
+        Parameters
+        ----------
+        sexp_str : str
+            A string of s-expressions representing Vernacular commands,
+            e.g., the output of ``sercomp``.
+
+        Returns
+        -------
+        sexps : List[SexpNode]
+            The result of ``SexpParser.parse_list(sexp_str)``.
+        vernacs : List[SexpInfo.Vernac]
+            The result of `analyze_vernac` for each s-expression.
+        is_ltac : List[bool]
+            The result of `is_ltac` for each s-expression.
+
+        Raises
+        ------
+        ValueError
+            If the s-expressions cannot be parsed.
+        SexpAnalyzingException
+            If any s-expression is not representative of a Vernacular
+            command.
+        """
+        sexps, summaries = parse_vernac_sexps(
+            sexp_str,
+            cls._vt_proof_types,
+            cls._vt_proof_extend_types)
+        vernacs = []
+        is_ltac = []
+        for sexp, summary in zip(sexps, summaries):
+            if summary is None:
+                # the native analysis defers unusual structures
+                vernac = cls.analyze_vernac(sexp)
+                vernacs.append(vernac)
+                is_ltac.append(
+                    cls._is_ltac_type(vernac.vernac_type,
+                                      vernac.extend_type))
+                continue
+            (
+                vernac_type,
+                extend_type,
+                flags,
+                attributes,
+                loc,
+                path,
+                ltac) = summary
+            control_flags = []
+            for name, arg in flags:
+                control_flag = ControlFlag[name]
+                if control_flag == ControlFlag.Redirect:
+                    control_flag.filename = arg
+                elif control_flag == ControlFlag.Timeout:
+                    control_flag.limit = arg
+                elif control_flag == ControlFlag.Time:
+                    control_flag.is_batch_mode = arg
+                control_flags.append(control_flag)
+            vernac_sexp = sexp
+            for i in path:
+                vernac_sexp = vernac_sexp[i]
+            vernacs.append(
+                SexpInfo.Vernac(
+                    vernac_type,
+                    extend_type,
+                    control_flags,
+                    attributes,
+                    vernac_sexp,
+                    SexpInfo.Loc(*loc) if loc is not None else None))
+            is_ltac.append(ltac)
+        return sexps, vernacs, is_ltac
+
     @classmethod
     def analyze_constr_expr_r(
-            cls,
-            sexp: SexpNode,
-            unicode_offsets: Optional[List[int]] = None
+        cls,
+        sexp: SexpNode,
+        unicode_offsets: Optional[UnicodeOffsets] = None
     ) -> SexpInfo.ConstrExprR:
         """
         Analyze a ConstrExprR s-expression.
@@ -1120,7 +1259,7 @@ class SexpAnalyzer:
             <ConstrExprR> = ( ( v  (  CXxx ... ) ) (  loc ... )
                                 ^-expr_sexp-^   ^-expr_loc-^
                             0 00 01 010          1  10
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1181,9 +1320,9 @@ class SexpAnalyzer:
 
     @classmethod
     def analyze_c_local_assume(
-            cls,
-            sexp: SexpNode,
-            unicode_offsets: Optional[List[int]] = None
+        cls,
+        sexp: SexpNode,
+        unicode_offsets: Optional[UnicodeOffsets] = None
     ) -> SexpInfo.CLocalAssum:
         """
         Analyzes a CLocalAssum sexp.
@@ -1203,7 +1342,7 @@ class SexpAnalyzer:
                                ( (v (CXxx ...) ... ) (loc ...) ) )
                                ^---<ConstrExprR>---------------^
                                2
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1252,7 +1391,7 @@ class SexpAnalyzer:
     def find_gallina_parts(
         cls,
         sexp: SexpNode,
-        unicode_offsets: Optional[List[int]] = None
+        unicode_offsets: Optional[UnicodeOffsets] = None
     ) -> List[Union[SexpInfo.ConstrExprR,
                     SexpInfo.CLocalAssum]]:
         """
@@ -1264,7 +1403,7 @@ class SexpAnalyzer:
         ----------
         sexp : SexpNode
             An s-expression representing a Vernacular or Ltac command.
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1465,7 +1604,7 @@ class SexpAnalyzer:
     def analyze_loc(
             cls,
             sexp: SexpNode,
-            unicode_offsets: Optional[List[int]] = None) -> SexpInfo.Loc:
+            unicode_offsets: Optional[UnicodeOffsets] = None) -> SexpInfo.Loc:
         """
         Get source code location metadata from a ``loc`` s-expression.
 
@@ -1484,7 +1623,7 @@ class SexpAnalyzer:
                                   (bol_pos_last X)
                                   (bp <BEG_CHARNO>)
                                   (ep <END_CHARNO>) )) )
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1567,7 +1706,7 @@ class SexpAnalyzer:
     def analyze_sertok_sentences(
         cls,
         tok_sexp_list: List[SexpNode],
-        unicode_offsets: Optional[List[int]] = None
+        unicode_offsets: Optional[UnicodeOffsets] = None
     ) -> List[SexpInfo.SertokSentence]:
         """
         Convert `sertok` output to object-oriented abstractions.
@@ -1580,7 +1719,7 @@ class SexpAnalyzer:
         tok_sexp_list : list of SexpNode
             A sequence of `SexpNode`s yielded from parsing `sertok`'s
             output with each item corresponding to a sentence.
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1667,9 +1806,9 @@ class SexpAnalyzer:
 
     @classmethod
     def analyze_sertok_token(
-            cls,
-            sexp: SexpNode,
-            unicode_offsets: Optional[List[int]] = None
+        cls,
+        sexp: SexpNode,
+        unicode_offsets: Optional[UnicodeOffsets] = None
     ) -> SexpInfo.SertokToken:
         """
         Convert a parsed `sertok` token s-expression into an object.
@@ -1679,7 +1818,7 @@ class SexpAnalyzer:
         sexp : SexpNode
             An s-expression yielded from parsing `sertok`'s output and
             corresponding to a lexical token.
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1762,7 +1901,8 @@ class SexpAnalyzer:
     def get_locs(
             cls,
             sexp: SexpNode,
-            unicode_offsets: Optional[List[int]] = None) -> List[SexpInfo.Loc]:
+            unicode_offsets: Optional[UnicodeOffsets] = None
+    ) -> List[SexpInfo.Loc]:
         """
         Get all of the locations in the given s-expression.
 
@@ -1770,7 +1910,7 @@ class SexpAnalyzer:
         ----------
         sexp : SexpNode
             An s-expression, presumed to be correspond to a valid AST.
-        unicode_offsets : list of int | None, optional
+        unicode_offsets : UnicodeOffsets | None, optional
             Offsets of unicode (non-ASCII) characters from the start of
             the file, by default None.
 
@@ -1840,15 +1980,30 @@ class SexpAnalyzer:
             if not isinstance(vernac, SexpNode):
                 vernac = SexpParser.parse(vernac)
             vernac = cls.analyze_vernac(vernac, with_flags=False)
-        if vernac.extend_type is not None:
-            if cls._vt_proof_extend_regex.match(vernac.extend_type) is not None:
+        return cls._is_ltac_type(vernac.vernac_type, vernac.extend_type)
+
+    @classmethod
+    @functools.lru_cache(maxsize=1024)
+    def _is_ltac_type(
+            cls,
+            vernac_type: str,
+            extend_type: Optional[str]) -> bool:
+        """
+        Determine whether a type of Vernacular command contains Ltac.
+
+        See Also
+        --------
+        is_ltac : For the public API
+        """
+        if extend_type is not None:
+            if cls._vt_proof_extend_regex.match(extend_type) is not None:
                 # The sentence is part of a proof
                 return True
             else:
                 # The sentence is defining new tactics or otherwise not
                 # part of a proof
                 return False
-        elif cls._vt_proof_regex.match(vernac.vernac_type) is not None:
+        elif cls._vt_proof_regex.match(vernac_type) is not None:
             # The sentence is part of a proof
             return True
         else:
@@ -1859,7 +2014,7 @@ class SexpAnalyzer:
     def offset_locs(
             cls,
             sexp: SexpNode,
-            unicode_offsets: List[int],
+            unicode_offsets: UnicodeOffsets,
             byte_to_char: bool = True) -> SexpNode:
         """
         Offset the locations in an s-expression based on encoding.
@@ -1873,7 +2028,7 @@ class SexpAnalyzer:
             An s-expression, presumed to be correspond to a valid AST
             with locations relative to either bytestring indices or
             UTF-8 characters as appropriate for the `byte_to_char`
-        unicode_offsets : List[int]
+        unicode_offsets : UnicodeOffsets
             Offsets of unicode (non-ASCII) characters from the start of
             the file.
         byte_to_char : bool, optional
@@ -1893,9 +2048,9 @@ class SexpAnalyzer:
         """
         if sexp.is_list():
             if sexp.head() == "loc" and sexp[1].children:
-                if not byte_to_char:
-                    unicode_offsets = None
-                loc: SexpInfo.Loc = cls.analyze_loc(sexp, unicode_offsets)
+                loc: SexpInfo.Loc = cls.analyze_loc(
+                    sexp,
+                    unicode_offsets if byte_to_char else None)
                 if not byte_to_char:
                     loc = loc.offset_char_to_byte(unicode_offsets)
                 sexp = loc.to_sexp()
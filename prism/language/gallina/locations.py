@@ -0,0 +1,472 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Packed arrays of source code locations.
+"""
+import heapq
+from typing import Callable, Dict, Iterable, Iterator, List, Tuple, Union
+
+import numpy as np
+
+from prism.language.gallina.analyze import SexpInfo
+from prism.language.gallina.util import UnicodeOffsetMap
+
+LOC_FIELDS = (
+    'lineno',
+    'bol_pos',
+    'lineno_last',
+    'bol_pos_last',
+    'beg_charno',
+    'end_charno')
+"""
+The numeric fields of a location in the order of their declaration.
+"""
+
+LOC_DTYPE = np.dtype(
+    [('filename',
+      np.int32)] + [(name,
+                     np.int64) for name in LOC_FIELDS])
+"""
+The structured type of a packed location.
+
+The filename is stored as an index into a table of distinct filenames.
+"""
+
+ArrayLike = Union[int, np.ndarray]
+
+
+class LocArray:
+    """
+    A packed array of locations.
+
+    Locations are stored as a structured array with one record per
+    location such that shifting or otherwise offsetting many locations
+    at once reduces to vectorized arithmetic over its fields.
+    `SexpInfo.Loc` objects are only created upon access.
+    """
+
+    def __init__(self, filenames: List[str], data: np.ndarray) -> None:
+        """
+        Initialize from a table of filenames and packed locations.
+
+        Parameters
+        ----------
+        filenames : List[str]
+            The distinct filenames referenced by the locations.
+        data : np.ndarray
+            A one-dimensional array of type `LOC_DTYPE` whose filename
+            fields index `filenames`.
+        """
+        if data.dtype != LOC_DTYPE:
+            raise TypeError(f"Expected array of {LOC_DTYPE}, got {data.dtype}")
+        self.filenames = filenames
+        """
+        The distinct filenames referenced by the locations.
+        """
+        self.data = data
+        """
+        The packed locations.
+        """
+
+    def __eq__(self, other: object) -> bool:
+        """
+        Return whether two arrays contain equal locations.
+        """
+        if not isinstance(other, LocArray):
+            return NotImplemented
+        return list(self) == list(other)
+
+    def __getitem__(
+        self,
+        index: Union[int,
+                     slice,
+                     np.ndarray]) -> Union[SexpInfo.Loc,
+                                           'LocArray']:
+        """
+        Get a location or a subarray of locations.
+        """
+        if isinstance(index, (int, np.integer)):
+            record = self.data[index].item()
+            return SexpInfo.Loc(self.filenames[record[0]], *record[1 :])
+        return LocArray(self.filenames, self.data[index])
+
+    def __iter__(self) -> Iterator[SexpInfo.Loc]:
+        """
+        Iterate over the locations in this array.
+        """
+        filenames = self.filenames
+        for record in self.data.tolist():
+            yield SexpInfo.Loc(filenames[record[0]], *record[1 :])
+
+    def __len__(self) -> int:  # noqa: D105
+        return len(self.data)
+
+    def argsort(self) -> np.ndarray:
+        """
+        Get the indices that would sort the locations.
+
+        Returns
+        -------
+        np.ndarray
+            An array of indices that stably sorts the locations by their
+            ending character numbers.
+
+        Notes
+        -----
+        This order is a linear extension of the partial order defined by
+        `SexpInfo.Loc.__lt__`: if one location is less than another,
+        then it precedes the other in the sorted order.
+        Locations that are incomparable, e.g., nested locations with a
+        common end, keep their relative order as they would with
+        `sorted`, except that empty locations follow the nonempty
+        locations that end where they begin.
+        Like `SexpInfo.Loc.__lt__`, filenames are ignored.
+        """
+        begs = self.data['beg_charno']
+        ends = self.data['end_charno']
+        return np.lexsort((begs == ends, ends))
+
+    def contained_in(self, loc: SexpInfo.Loc) -> np.ndarray:
+        """
+        Get which locations are points or subintervals of another.
+
+        This is the vectorized analogue of ``x in loc`` for each
+        location ``x`` in this array.
+
+        Parameters
+        ----------
+        loc : SexpInfo.Loc
+            A location.
+
+        Returns
+        -------
+        np.ndarray
+            A Boolean mask indicating the locations in this array that
+            are contained in `loc`.
+        """
+        return (self.data['beg_charno'] >= loc.beg_charno) & (
+            self.data['end_charno'] <= loc.end_charno)
+
+    def copy(self) -> 'LocArray':
+        """
+        Get a copy of this array.
+        """
+        return LocArray(list(self.filenames), self.data.copy())
+
+    def filename_id(self, filename: str) -> int:
+        """
+        Get the index of a filename, adding it if it is not present.
+        """
+        try:
+            return self.filenames.index(filename)
+        except ValueError:
+            self.filenames.append(filename)
+            return len(self.filenames) - 1
+
+    def offset_byte_to_char(self, offset_map: UnicodeOffsetMap) -> 'LocArray':
+        """
+        Convert byte-relative character indices to unicode indices.
+
+        This is the batched analogue of `SexpInfo.Loc.offset_byte_to_char`
+        for, e.g., all of the locations in a file.
+        """
+        data = self.data.copy()
+        data['beg_charno'] = offset_map.bytes_to_chars(data['beg_charno'])
+        data['end_charno'] = offset_map.bytes_to_chars(data['end_charno'])
+        return LocArray(list(self.filenames), data)
+
+    def offset_char_to_byte(self, offset_map: UnicodeOffsetMap) -> 'LocArray':
+        """
+        Convert unicode character indices to byte-relative indices.
+
+        This is the batched analogue of `SexpInfo.Loc.offset_char_to_byte`
+        for, e.g., all of the locations in a file.
+        """
+        data = self.data.copy()
+        data['beg_charno'] = offset_map.chars_to_first_bytes(data['beg_charno'])
+        data['end_charno'] = offset_map.chars_to_last_bytes(data['end_charno'])
+        return LocArray(list(self.filenames), data)
+
+    def shift(
+            self,
+            offset: ArrayLike,
+            line_offset: ArrayLike = 0) -> 'LocArray':
+        """
+        Shift the character positions of each location.
+
+        This is the vectorized analogue of `SexpInfo.Loc.shift`.
+
+        Parameters
+        ----------
+        offset : ArrayLike
+            The amount, positive or negative, by which the locations
+            should be shifted in terms of characters, either for all
+            locations or per location.
+        line_offset : ArrayLike, optional
+            The amount, positive or negative, by which the locations
+            should be shifted in terms of lines, either for all
+            locations or per location, by default 0.
+
+        Returns
+        -------
+        LocArray
+            The shifted locations.
+        """
+        data = self.data.copy()
+        data['lineno'] += line_offset
+        data['lineno_last'] += line_offset
+        data['beg_charno'] += offset
+        data['end_charno'] += offset
+        return LocArray(list(self.filenames), data)
+
+    def translate(self, filename: str, offsets: np.ndarray) -> 'LocArray':
+        """
+        Move each location to a file and offset each of its fields.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file to which the locations are moved.
+        offsets : np.ndarray
+            An integer array of shape ``(len(LOC_FIELDS),)`` or
+            ``(len(self), len(LOC_FIELDS))`` giving the change in each
+            numeric field, either for all locations or per location.
+
+        Returns
+        -------
+        LocArray
+            The translated locations.
+        """
+        offsets = np.asarray(offsets, dtype=np.int64)
+        result = LocArray(list(self.filenames), self.data.copy())
+        result.data['filename'] = result.filename_id(filename)
+        for i, name in enumerate(LOC_FIELDS):
+            result.data[name] += offsets[..., i]
+        return result
+
+    def tolist(self) -> List[SexpInfo.Loc]:
+        """
+        Get the locations in this array as a list.
+        """
+        return list(self)
+
+    @classmethod
+    def from_locs(cls, locs: Iterable[SexpInfo.Loc]) -> 'LocArray':
+        """
+        Pack a sequence of locations into an array.
+
+        Parameters
+        ----------
+        locs : Iterable[SexpInfo.Loc]
+            A sequence of locations.
+
+        Returns
+        -------
+        LocArray
+            The packed locations.
+        """
+        filename_ids: Dict[str,
+                           int] = {}
+        records = [
+            (
+                filename_ids.setdefault(loc.filename,
+                                        len(filename_ids)),
+                loc.lineno,
+                loc.bol_pos,
+                loc.lineno_last,
+                loc.bol_pos_last,
+                loc.beg_charno,
+                loc.end_charno) for loc in locs
+        ]
+        return cls(list(filename_ids), np.array(records, dtype=LOC_DTYPE))
+
+
+def _expand_ranges(starts: np.ndarray,
+                   stops: np.ndarray) -> Tuple[np.ndarray,
+                                               np.ndarray]:
+    """
+    Enumerate the elements of many ranges at once.
+
+    Parameters
+    ----------
+    starts, stops : np.ndarray
+        The bounds of each half-open range.
+        Empty or reversed ranges contribute no elements.
+
+    Returns
+    -------
+    range_indices : np.ndarray
+        The index of the range to which each element belongs.
+    elements : np.ndarray
+        The elements of each range in order.
+    """
+    counts = np.maximum(stops - starts, 0)
+    range_indices = np.repeat(np.arange(len(counts)), counts)
+    firsts = np.cumsum(counts) - counts
+    elements = (
+        np.arange(counts.sum()) - np.repeat(firsts,
+                                            counts) + np.repeat(starts,
+                                                                counts))
+    return range_indices, elements
+
+
+class LocIndex:
+    """
+    An immutable index for batched point and range queries.
+
+    The locations are partitioned into a minimal number of chains, each
+    a sequence of non-overlapping locations in ascending order.
+    Within a chain, both the beginning and ending character numbers are
+    sorted, so the locations matching any point or range query form a
+    contiguous run found by binary search.
+    Since the number of chains is the maximum depth of nesting among the
+    locations, which is small for commands and sentences of a document,
+    each query takes logarithmic time in the number of locations plus
+    the number of results.
+
+    Like `SexpInfo.Loc.__contains__`, filenames are ignored.
+    """
+
+    def __init__(self, locs: LocArray) -> None:
+        """
+        Index the given locations.
+        """
+        begs = locs.data['beg_charno']
+        ends = locs.data['end_charno']
+        # greedily assign each location in order of its beginning to
+        # the chain that became free earliest
+        chains: List[List[int]] = []
+        free_chains: List[Tuple[int, int]] = []
+        for i in np.lexsort((-ends, begs)).tolist():
+            if free_chains and free_chains[0][0] <= begs[i]:
+                _, chain_id = heapq.heappop(free_chains)
+            else:
+                chain_id = len(chains)
+                chains.append([])
+            chains[chain_id].append(i)
+            heapq.heappush(free_chains, (int(ends[i]), chain_id))
+        self._chains = [np.array(chain, dtype=np.int64) for chain in chains]
+        self._chain_begs = [begs[chain] for chain in self._chains]
+        self._chain_ends = [ends[chain] for chain in self._chains]
+        self._size = len(locs)
+
+    def __len__(self) -> int:  # noqa: D105
+        return self._size
+
+    def _query(
+        self,
+        bounds: Callable[[np.ndarray,
+                          np.ndarray],
+                         Tuple[np.ndarray,
+                               np.ndarray]]
+    ) -> Tuple[np.ndarray,
+               np.ndarray]:
+        """
+        Collect the results of a query over each chain.
+
+        Parameters
+        ----------
+        bounds : Callable[[np.ndarray, np.ndarray],
+                          Tuple[np.ndarray, np.ndarray]]
+            A function that maps the sorted beginning and ending
+            character numbers of a chain to the half-open ranges of
+            matches within the chain for each query.
+
+        Returns
+        -------
+        query_indices : np.ndarray
+            The index of the query of each result.
+        loc_indices : np.ndarray
+            The index in the original array of each matched location.
+            Results are sorted by query and then location index.
+        """
+        query_indices = [np.zeros(0, dtype=np.int64)]
+        loc_indices = [np.zeros(0, dtype=np.int64)]
+        for chain, begs, ends in zip(self._chains,
+                                     self._chain_begs,
+                                     self._chain_ends):
+            starts, stops = bounds(begs, ends)
+            chain_query_indices, positions = _expand_ranges(starts, stops)
+            query_indices.append(chain_query_indices)
+            loc_indices.append(chain[positions])
+        query_index = np.concatenate(query_indices)
+        loc_index = np.concatenate(loc_indices)
+        order = np.lexsort((loc_index, query_index))
+        return query_index[order], loc_index[order]
+
+    def containing(self,
+                   begs: ArrayLike,
+                   ends: ArrayLike) -> Tuple[np.ndarray,
+                                             np.ndarray]:
+        """
+        Find the locations that contain each of a batch of ranges.
+
+        A location contains a range (or a point if the range is empty)
+        if it begins before or at the range's beginning and ends at or
+        after the range's end.
+
+        Parameters
+        ----------
+        begs, ends : ArrayLike
+            The beginning and ending character numbers of each range.
+
+        Returns
+        -------
+        query_indices : np.ndarray
+            The index of the range of each result.
+        loc_indices : np.ndarray
+            The index of the containing location of each result.
+        """
+        begs = np.atleast_1d(np.asarray(begs, dtype=np.int64))
+        ends = np.atleast_1d(np.asarray(ends, dtype=np.int64))
+        return self._query(
+            lambda chain_begs, chain_ends: (
+                np.searchsorted(chain_ends, ends, 'left'), np.searchsorted(
+                    chain_begs, begs, 'right')))
+
+    def contained_in(self,
+                     begs: ArrayLike,
+                     ends: ArrayLike) -> Tuple[np.ndarray,
+                                               np.ndarray]:
+        """
+        Find the locations that are contained in each of a batch ranges.
+
+        This is the batched analogue of ``x in loc`` for each location
+        ``x`` in the index and each queried range ``loc``.
+
+        Parameters
+        ----------
+        begs, ends : ArrayLike
+            The beginning and ending character numbers of each range.
+
+        Returns
+        -------
+        query_indices : np.ndarray
+            The index of the range of each result.
+        loc_indices : np.ndarray
+            The index of the contained location of each result.
+        """
+        begs = np.atleast_1d(np.asarray(begs, dtype=np.int64))
+        ends = np.atleast_1d(np.asarray(ends, dtype=np.int64))
+        return self._query(
+            lambda chain_begs, chain_ends: (
+                np.searchsorted(chain_begs, begs, 'left'), np.searchsorted(
+                    chain_ends, ends, 'right')))
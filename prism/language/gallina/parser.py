@@ -30,7 +30,12 @@ from typing import List, Optional, Set, Tuple, Union
 from prism.data.document import CoqDocument, VernacularSentence
 from prism.interface.coq.options import SerAPIOptions
 from prism.language.gallina.analyze import SexpAnalyzer, SexpInfo
-from prism.language.gallina.util import ParserUtils
+from prism.language.gallina.sertok import SertokTokens
+from prism.language.gallina.util import (
+    ParserUtils,
+    UnicodeOffsetMap,
+    UnicodeOffsets,
+)
 from prism.language.id import LanguageId
 from prism.language.sexp import SexpNode, SexpParser
 from prism.language.token import Token, TokenConsts
@@ -903,35 +908,51 @@ class CoqParser:
         serapi_options: Optional[SerAPIOptions] = None,
         opam_switch: Optional[OpamSwitch] = None,
         serapi_version: Optional[Union[str,
-                                       Version]] = None
+                                       Version]] = None,
+        parse_token_sexps: bool = True
     ) -> Tuple[List[VernacularSentence],
                List[SexpNode],
                List[SexpNode]]:
         """
         Parse representations of the indicated Coq document.
 
+        If `parse_token_sexps` is False, then the output of ``sertok``
+        is only parsed into s-expressions if it cannot be decoded
+        directly, and the returned list of token s-expressions is
+        otherwise empty.
+
         See Also
         --------
         CoqParser.parse_sentences : For the public API
         """
-        unicode_offsets = ParserUtils.get_unicode_offsets(source_code)
+        unicode_offsets = UnicodeOffsetMap(source_code)
 
-        ast_sexp_list = cls.parse_asts(
+        ast_sexp_list, vernacs, _ = cls.parse_vernacs(
             file_path,
             serapi_options,
             opam_switch,
             serapi_version)
-        tok_sexp_list = cls.parse_tokens(
+        tok_sexp_str = cls._run_sertok(
             file_path,
             serapi_options,
             opam_switch,
             serapi_version)
+        try:
+            sertok_tokens = SertokTokens.decode(tok_sexp_str, unicode_offsets)
+        except ValueError:
+            # let the analyzer report the precise error, if any
+            sertok_tokens = None
+        tok_sexp_list: List[SexpNode] = []
+        if parse_token_sexps or sertok_tokens is None:
+            tok_sexp_list = SexpParser.parse_list(tok_sexp_str)
 
         sentences = cls.parse_sentences_from_sexps(
             source_code,
             ast_sexp_list,
             tok_sexp_list,
-            unicode_offsets)
+            unicode_offsets,
+            sertok_tokens,
+            vernacs)
 
         return sentences, ast_sexp_list, tok_sexp_list
 
@@ -966,6 +987,78 @@ class CoqParser:
             A list of s-expression nodes representing the ASTs of
             sentences in the order of their definition in the document.
         """
+        ast_sexp_str = cls._run_sercomp(
+            file_path,
+            sercomp_options,
+            opam_switch,
+            serapi_version)
+        ast_sexp_list: List[SexpNode] = SexpParser.parse_list(ast_sexp_str)
+        return ast_sexp_list
+
+    @classmethod
+    def parse_vernacs(
+        cls,
+        file_path: PathLike,
+        sercomp_options: Optional[SerAPIOptions] = None,
+        opam_switch: Optional[OpamSwitch] = None,
+        serapi_version: Optional[Union[str,
+                                       Version]] = None
+    ) -> Tuple[List[SexpNode],
+               List[SexpInfo.Vernac],
+               List[bool]]:
+        """
+        Parse and analyze the ASTs of sentences in the given file.
+
+        Parameters
+        ----------
+        file_path : PathLike
+            The absolute or relative path of a Coq file.
+        sercomp_options : str, optional
+            Options to control the output of ``sercomp``, which is used
+            to parse the document. By default the empty string.
+        opam_switch : Optional[OpamSwitch], optional
+            The switch in which to execute the `sercomp` SerAPI
+            executable, by default the global "default" switch.
+        serapi_version : Optional[Union[str, Version]], optional
+            The version of `coq-serapi` installed in the `opam_switch`.
+            If not provided, then it will be retrieved automatically.
+
+        Returns
+        -------
+        asts : List[SexpNode]
+            The result of `parse_asts`.
+        vernacs : List[SexpInfo.Vernac]
+            The Vernacular command of each AST.
+        is_ltac : List[bool]
+            Whether each AST comprises Ltac in the sense of
+            `SexpAnalyzer.is_ltac`.
+
+        See Also
+        --------
+        SexpAnalyzer.parse_vernacs : For details on the analysis
+        """
+        ast_sexp_str = cls._run_sercomp(
+            file_path,
+            sercomp_options,
+            opam_switch,
+            serapi_version)
+        return SexpAnalyzer.parse_vernacs(ast_sexp_str)
+
+    @classmethod
+    def _run_sercomp(
+            cls,
+            file_path: PathLike,
+            sercomp_options: Optional[SerAPIOptions] = None,
+            opam_switch: Optional[OpamSwitch] = None,
+            serapi_version: Optional[Union[str,
+                                           Version]] = None) -> str:
+        """
+        Get the raw output of ``sercomp`` for the given file.
+
+        See Also
+        --------
+        CoqParser.parse_asts : For the parsed output
+        """
         if opam_switch is None:
             opam_switch = OpamSwitch()
         if sercomp_options is None:
@@ -974,11 +1067,9 @@ class CoqParser:
             serapi_version = opam_switch.get_installed_version('coq-serapi')
             assert serapi_version is not None, \
                 f"coq-serapi is not installed in {opam_switch}"
-        ast_sexp_str: str = opam_switch.run(
+        return opam_switch.run(
             f"sercomp {sercomp_options.as_serapi_args(serapi_version)} "
             f"--mode=sexp -- {file_path}").stdout
-        ast_sexp_list: List[SexpNode] = SexpParser.parse_list(ast_sexp_str)
-        return ast_sexp_list
 
     @classmethod
     def parse_document(
@@ -1066,7 +1157,8 @@ class CoqParser:
             source_code,
             serapi_options,
             opam_switch,
-            serapi_version)[0]
+            serapi_version,
+            parse_token_sexps=False)[0]
 
     @classmethod
     def parse_sentences_from_sexps(  # noqa: C901
@@ -1074,7 +1166,9 @@ class CoqParser:
         source_code: SourceCode,
         ast_sexp_list: List[SexpNode],
         tok_sexp_list: List[SexpNode],
-        unicode_offsets: List[int],
+        unicode_offsets: UnicodeOffsets,
+        sertok_tokens: Optional[SertokTokens] = None,
+        vernacs: Optional[List[SexpInfo.Vernac]] = None,
     ) -> List[VernacularSentence]:
         """
         Parse s-expressions into sentences.
@@ -1089,9 +1183,17 @@ class CoqParser:
         tok_sexp_list : list of SexpNode
             A list of lexical-token s-expressions presumably yielded
             from ``sertok`` and corresponding to `source_code`.
-        unicode_offsets : List[int]
+        unicode_offsets : UnicodeOffsets
             The offsets of unicode characters in `source_code` from the
             beginning of the document.
+        sertok_tokens : Optional[SertokTokens], optional
+            The tokens of `tok_sexp_list` already decoded from the
+            output of ``sertok``, by default None, in which case they
+            are extracted from `tok_sexp_list`.
+        vernacs : Optional[List[SexpInfo.Vernac]], optional
+            The Vernacular commands of `ast_sexp_list` already analyzed,
+            e.g., with `SexpAnalyzer.parse_vernacs`, by default None,
+            in which case they are analyzed from `ast_sexp_list`.
 
         Returns
         -------
@@ -1105,8 +1207,11 @@ class CoqParser:
         CoqParser.parse_tokens : For the usual source of `tok_sexp_list`
         """
         # Parse tok sexp to vernacular setences
-        sertok_sentences: List[
-            SexpInfo.SertokSentence] = SexpAnalyzer.analyze_sertok_sentences(
+        sertok_sentences: List[SexpInfo.SertokSentence]
+        if sertok_tokens is not None:
+            sertok_sentences = sertok_tokens.to_sentences()
+        else:
+            sertok_sentences = SexpAnalyzer.analyze_sertok_sentences(
                 tok_sexp_list,
                 unicode_offsets)
         vernac_sentences: List[VernacularSentence] = cls.parse_sertok_sentences(
@@ -1114,9 +1219,14 @@ class CoqParser:
             source_code)
 
         # Parse ast sexp
-        vernac_asts: List[Optional[SexpInfo.Vernac]] = [
-            SexpAnalyzer.analyze_vernac(ast_sexp) for ast_sexp in ast_sexp_list
-        ]
+        vernac_asts: List[Optional[SexpInfo.Vernac]]
+        if vernacs is not None:
+            vernac_asts = list(vernacs)
+        else:
+            vernac_asts = [
+                SexpAnalyzer.analyze_vernac(ast_sexp)
+                for ast_sexp in ast_sexp_list
+            ]
 
         # Prepare for warning of unseen vernacular types and token kinds
         unseen_vernacular_types = set()
@@ -1302,6 +1412,29 @@ class CoqParser:
             lexical tokens in each sentence in the order of their
             definition in the document.
         """
+        tok_sexp_str = cls._run_sertok(
+            file_path,
+            sertok_options,
+            opam_switch,
+            serapi_version)
+        tok_sexp_list: List[SexpNode] = SexpParser.parse_list(tok_sexp_str)
+        return tok_sexp_list
+
+    @classmethod
+    def _run_sertok(
+            cls,
+            file_path: PathLike,
+            sertok_options: Optional[SerAPIOptions] = None,
+            opam_switch: Optional[OpamSwitch] = None,
+            serapi_version: Optional[Union[str,
+                                           Version]] = None) -> str:
+        """
+        Get the raw output of ``sertok`` for the given file.
+
+        See Also
+        --------
+        CoqParser.parse_tokens : For the parsed output
+        """
         if opam_switch is None:
             opam_switch = OpamSwitch()
         if sertok_options is None:
@@ -1310,8 +1443,6 @@ class CoqParser:
             serapi_version = opam_switch.get_installed_version('coq-serapi')
             assert serapi_version is not None, \
                 f"coq-serapi is not installed in {opam_switch}"
-        tok_sexp_str: str = opam_switch.run(
+        return opam_switch.run(
             f"sertok {sertok_options.as_serapi_args(serapi_version)} "
             f"-- {file_path}").stdout
-        tok_sexp_list: List[SexpNode] = SexpParser.parse_list(tok_sexp_str)
-        return tok_sexp_list
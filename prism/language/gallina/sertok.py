@@ -0,0 +1,268 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Flat arrays of the lexical tokens of a document obtained via `sertok`.
+"""
+from typing import List, Optional
+
+import numpy as np
+
+from prism.language.gallina._sertok import decode_sertok
+from prism.language.gallina.analyze import SexpAnalyzer, SexpInfo
+from prism.language.gallina.locations import LOC_DTYPE, LOC_FIELDS, LocArray
+from prism.language.gallina.util import (
+    ParserUtils,
+    UnicodeOffsetMap,
+    UnicodeOffsets,
+)
+from prism.language.sexp import SexpParser
+from prism.language.token import TokenConsts
+
+
+class SertokTokens:
+    """
+    The lexical tokens of a document decoded from `sertok` output.
+
+    The contents of all tokens are slices of one shared string, and
+    their locations are packed into a `LocArray`, such that decoding a
+    document does not create any objects per token.
+    `SexpInfo.SertokToken` objects are only created upon access.
+    """
+
+    def __init__(
+            self,
+            kind_names: List[str],
+            kinds: np.ndarray,
+            content: str,
+            bounds: np.ndarray,
+            locs: LocArray,
+            sentence_bounds: np.ndarray) -> None:
+        """
+        Initialize from decoded arrays.
+
+        Parameters
+        ----------
+        kind_names : List[str]
+            The distinct (normalized) kinds of tokens.
+        kinds : np.ndarray
+            The kind of each token as an index into `kind_names`.
+        content : str
+            A string containing the content of each token.
+        bounds : np.ndarray
+            An integer array of shape ``(len(kinds), 2)`` giving the
+            start and end of each token's content within `content`.
+        locs : LocArray
+            The location of each token.
+        sentence_bounds : np.ndarray
+            The index of the first token of each sentence followed by
+            the total number of tokens.
+        """
+        self.kind_names = kind_names
+        """
+        The distinct (normalized) kinds of tokens.
+        """
+        self.kinds = kinds
+        """
+        The kind of each token as an index into `kind_names`.
+        """
+        self.content = content
+        """
+        A string containing the content of each token.
+        """
+        self.bounds = bounds
+        """
+        The start and end of each token's content within `content`.
+        """
+        self.locs = locs
+        """
+        The location of each token.
+        """
+        self.sentence_bounds = sentence_bounds
+        """
+        The index of the first token of each sentence followed by the
+        total number of tokens.
+        """
+
+    def __getitem__(self, index: int) -> SexpInfo.SertokToken:
+        """
+        Get a token.
+        """
+        start, end = self.bounds[index].tolist()
+        return SexpInfo.SertokToken(
+            self.kind_names[self.kinds[index]],
+            self.content[start : end],
+            self.locs[index])
+
+    def __len__(self) -> int:  # noqa: D105
+        return len(self.kinds)
+
+    @property
+    def num_sentences(self) -> int:
+        """
+        Get the number of sentences.
+        """
+        return len(self.sentence_bounds) - 1
+
+    def sentence(self, index: int) -> SexpInfo.SertokSentence:
+        """
+        Get the tokens of a sentence.
+        """
+        start, end = self.sentence_bounds[index : index + 2].tolist()
+        return SexpInfo.SertokSentence([self[i] for i in range(start, end)])
+
+    def to_sentences(self) -> List[SexpInfo.SertokSentence]:
+        """
+        Get the tokens of each sentence.
+
+        Returns
+        -------
+        List[SexpInfo.SertokSentence]
+            The same sentences as yielded by
+            `SexpAnalyzer.analyze_sertok_sentences`.
+        """
+        kind_names = self.kind_names
+        content = self.content
+        tokens = [
+            SexpInfo.SertokToken(kind_names[kind],
+                                 content[start : end],
+                                 loc)
+            for kind, (start, end), loc in zip(
+                self.kinds.tolist(), self.bounds.tolist(), self.locs)
+        ]
+        sentence_bounds = self.sentence_bounds.tolist()
+        return [
+            SexpInfo.SertokSentence(tokens[start : end])
+            for start, end in zip(sentence_bounds[:-1], sentence_bounds[1 :])
+        ]
+
+    @classmethod
+    def decode(
+            cls,
+            sertok_output: str,
+            unicode_offsets: Optional[UnicodeOffsets] = None) -> 'SertokTokens':
+        """
+        Decode the output of `sertok`.
+
+        Parameters
+        ----------
+        sertok_output : str
+            The s-expressions printed by `sertok` for a document.
+        unicode_offsets : UnicodeOffsets | None, optional
+            Offsets of unicode (non-ASCII) characters from the start of
+            the file, by default None.
+
+        Returns
+        -------
+        SertokTokens
+            The decoded tokens.
+
+        Raises
+        ------
+        ValueError
+            If the output is malformed or does not conform to the
+            structure expected from `sertok` output.
+            `SexpAnalyzer.analyze_sertok_sentences` may be used to
+            obtain a more precise error.
+        """
+        (
+            content,
+            bounds,
+            quoted,
+            kinds,
+            kind_names,
+            loc_fields,
+            filenames,
+            filename_names,
+            sentence_bounds) = decode_sertok(sertok_output)
+        bounds = np.frombuffer(bounds, dtype=np.int64).reshape(-1, 2).copy()
+        quoted = np.frombuffer(quoted, dtype=np.uint8).astype(bool)
+        kinds = np.frombuffer(kinds, dtype=np.int64)
+        kind_names = [
+            SexpAnalyzer.SERTOK_TOKEN_KIND_MAPPING.get(k,
+                                                       k) for k in kind_names
+        ]
+        data = np.empty(len(kinds), dtype=LOC_DTYPE)
+        data['filename'] = np.frombuffer(filenames, dtype=np.int32)
+        loc_fields = np.frombuffer(
+            loc_fields,
+            dtype=np.int64).reshape(-1,
+                                    len(LOC_FIELDS))
+        for i, name in enumerate(LOC_FIELDS):
+            data[name] = loc_fields[:, i]
+        locs = LocArray(filename_names, data)
+        if isinstance(unicode_offsets, UnicodeOffsetMap):
+            locs = locs.offset_byte_to_char(unicode_offsets)
+        elif unicode_offsets is not None:
+            for name in ['beg_charno', 'end_charno']:
+                data[name] = [
+                    ParserUtils.coq_charno_to_actual_charno(
+                        charno,
+                        unicode_offsets) for charno in data[name].tolist()
+                ]
+        # Apply the location-dependent adjustments of
+        # SexpAnalyzer.analyze_sertok_token.
+        # Each content is padded by quotes in `content` such that adding
+        # quotes amounts to widening its bounds.
+        beg_charno = locs.data['beg_charno']
+        span = locs.data['end_charno'] - beg_charno
+        # Adjust content to remove quotes, if necessary
+        strip = quoted & (bounds[:, 1] - bounds[:, 0] != span)
+        bounds[strip, 0] += 1
+        bounds[strip, 1] = np.maximum(bounds[strip, 1] - 1, bounds[strip, 0])
+        # Adjust content to add quotes, if necessary
+        str_kinds = [
+            i for i, k in enumerate(kind_names) if k == TokenConsts.KIND_STR
+        ]
+        widen = np.isin(kinds,
+                        str_kinds) & (
+                            bounds[:,
+                                   1] - bounds[:,
+                                               0] == span - 2)
+        bounds[widen, 0] -= 1
+        bounds[widen, 1] += 1
+        # Fix for charno mismatch
+        locs.data['end_charno'] = np.maximum(
+            locs.data['end_charno'],
+            beg_charno + bounds[:,
+                                1] - bounds[:,
+                                            0])
+        return cls(
+            kind_names,
+            kinds,
+            content,
+            bounds,
+            locs,
+            np.frombuffer(sentence_bounds,
+                          dtype=np.int64))
+
+
+def _py_decode_sertok(
+    sertok_output: str,
+    unicode_offsets: Optional[UnicodeOffsets] = None
+) -> List[SexpInfo.SertokSentence]:
+    """
+    Decode the output of `sertok` into sentences.
+
+    This is the reference implementation of `SertokTokens.decode`.
+    """
+    return SexpAnalyzer.analyze_sertok_sentences(
+        SexpParser.parse_list(sertok_output),
+        unicode_offsets)
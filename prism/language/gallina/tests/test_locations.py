@@ -0,0 +1,249 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.language.gallina.locations.
+"""
+import pickle
+import random
+import unittest
+
+import numpy as np
+
+from prism.language.gallina.analyze import SexpInfo
+from prism.language.gallina.locations import LocArray, LocIndex
+from prism.language.gallina.util import ParserUtils, UnicodeOffsetMap
+
+
+class TestLocArray(unittest.TestCase):
+    """
+    Tests for `LocArray`.
+    """
+
+    locs = [
+        SexpInfo.Loc("a.v",
+                     0,
+                     0,
+                     1,
+                     10,
+                     3,
+                     15),
+        SexpInfo.Loc("b.v",
+                     2,
+                     20,
+                     2,
+                     20,
+                     22,
+                     30),
+        SexpInfo.Loc("a.v",
+                     4,
+                     40,
+                     6,
+                     60,
+                     40,
+                     70),
+    ]
+
+    def test_roundtrip(self) -> None:
+        """
+        Verify that locations are packed and unpacked losslessly.
+        """
+        locs = LocArray.from_locs(self.locs)
+        self.assertEqual(len(locs), 3)
+        self.assertEqual(locs.filenames, ["a.v", "b.v"])
+        self.assertEqual(locs.tolist(), self.locs)
+        self.assertEqual(locs[1], self.locs[1])
+        self.assertEqual(locs[1 :].tolist(), self.locs[1 :])
+        self.assertEqual(LocArray.from_locs([]).tolist(), [])
+        self.assertEqual(locs.copy(), locs)
+
+    def test_shift(self) -> None:
+        """
+        Verify that vectorized shifts agree with `SexpInfo.Loc.shift`.
+        """
+        locs = LocArray.from_locs(self.locs)
+        self.assertEqual(
+            locs.shift(5,
+                       -1).tolist(),
+            [loc.shift(5,
+                       -1) for loc in self.locs])
+        offsets = np.array([1, 0, -2])
+        line_offsets = np.array([0, 3, 1])
+        self.assertEqual(
+            locs.shift(offsets,
+                       line_offsets).tolist(),
+            [
+                loc.shift(offset,
+                          line_offset)
+                for loc, offset, line_offset in zip(
+                    self.locs, offsets.tolist(), line_offsets.tolist())
+            ])
+        # the original is unchanged
+        self.assertEqual(locs.tolist(), self.locs)
+
+    def test_translate(self) -> None:
+        """
+        Verify that locations can be moved between files.
+        """
+        locs = LocArray.from_locs(self.locs)
+        translated = locs.translate("c.v", np.array([1, 2, 3, 4, 5, 6]))
+        self.assertEqual(translated.filenames, ["a.v", "b.v", "c.v"])
+        self.assertEqual(translated[0], SexpInfo.Loc("c.v", 1, 2, 4, 14, 8, 21))
+        self.assertEqual(
+            locs.translate("a.v",
+                           np.zeros(6,
+                                    dtype=int)).tolist(),
+            [loc.rename("a.v") for loc in self.locs])
+
+    def test_argsort(self) -> None:
+        """
+        Verify that sorting respects the order of `SexpInfo.Loc`.
+        """
+        rng = random.Random(0)
+        # generate random nested and adjacent intervals
+        locs = []
+        for _ in range(50):
+            beg = rng.randrange(100)
+            end = beg + rng.randrange(10)
+            locs.append(SexpInfo.Loc("a.v", 0, 0, 0, 0, beg, end))
+        order = LocArray.from_locs(locs).argsort().tolist()
+        sorted_locs = [locs[i] for i in order]
+        for i, a in enumerate(sorted_locs):
+            for b in sorted_locs[: i]:
+                # no location precedes one that is less than it
+                self.assertFalse(a < b and not b < a, f"{a} < {b}")
+        self.assertEqual(sorted_locs, sorted(sorted_locs))
+        # nested locations with a common end keep their order
+        nested = [
+            SexpInfo.Loc("a.v",
+                         0,
+                         0,
+                         0,
+                         0,
+                         5,
+                         10),
+            SexpInfo.Loc("a.v",
+                         0,
+                         0,
+                         0,
+                         0,
+                         0,
+                         10),
+            SexpInfo.Loc("a.v",
+                         0,
+                         0,
+                         0,
+                         0,
+                         20,
+                         25)
+        ]
+        for locs in [nested, nested[::-1]]:
+            order = LocArray.from_locs(locs).argsort().tolist()
+            self.assertEqual([locs[i] for i in order], sorted(locs))
+
+    def test_contained_in(self) -> None:
+        """
+        Verify that containment agrees with `SexpInfo.Loc.__contains__`.
+        """
+        locs = LocArray.from_locs(self.locs)
+        for loc in self.locs:
+            self.assertEqual(
+                locs.contained_in(loc).tolist(),
+                [other in loc for other in self.locs])
+
+    def test_loc(self) -> None:
+        """
+        Verify that locations pickle and intern their filenames.
+        """
+        loc = SexpInfo.Loc("".join(["a", ".v"]), 0, 0, 1, 10, 3, 15)
+        self.assertIs(loc.filename, self.locs[0].filename)
+        unpickled = pickle.loads(pickle.dumps(loc))
+        self.assertEqual(unpickled, loc)
+        self.assertIs(unpickled.filename, loc.filename)
+
+    def test_offset(self) -> None:
+        """
+        Verify that batched encoding offsets agree with `SexpInfo.Loc`.
+        """
+        code = "Lemma λ : ∀ x, x = x.\nProof. auto. Qed.\n" * 3
+        offset_map = UnicodeOffsetMap(code)
+        locs = LocArray.from_locs(self.locs)
+        self.assertEqual(
+            locs.offset_byte_to_char(offset_map).tolist(),
+            [loc.offset_byte_to_char(offset_map) for loc in self.locs])
+        self.assertEqual(
+            locs.offset_char_to_byte(offset_map).tolist(),
+            [
+                loc.offset_char_to_byte(ParserUtils.get_unicode_offsets(code))
+                for loc in self.locs
+            ])
+
+
+class TestLocIndex(unittest.TestCase):
+    """
+    Tests for `LocIndex`.
+    """
+
+    def test_queries(self) -> None:
+        """
+        Verify batched queries against exhaustive searches.
+        """
+        rng = random.Random(0)
+        for _ in range(50):
+            locs = []
+            for _ in range(rng.randrange(30)):
+                beg = rng.randrange(60)
+                end = beg + rng.randrange(15)
+                locs.append(SexpInfo.Loc("a.v", 0, 0, 0, 0, beg, end))
+            index = LocIndex(LocArray.from_locs(locs))
+            self.assertEqual(len(index), len(locs))
+            queries = []
+            for _ in range(20):
+                beg = rng.randrange(-5, 70)
+                end = beg + rng.randrange(20)
+                queries.append(SexpInfo.Loc("a.v", 0, 0, 0, 0, beg, end))
+            begs = [q.beg_charno for q in queries]
+            ends = [q.end_charno for q in queries]
+            query_indices, loc_indices = index.containing(begs, ends)
+            self.assertEqual(
+                list(zip(query_indices.tolist(),
+                         loc_indices.tolist())),
+                [
+                    (i,
+                     j)
+                    for i, query in enumerate(queries)
+                    for j, loc in enumerate(locs)
+                    if query in loc
+                ])
+            query_indices, loc_indices = index.contained_in(begs, ends)
+            self.assertEqual(
+                list(zip(query_indices.tolist(),
+                         loc_indices.tolist())),
+                [
+                    (i,
+                     j)
+                    for i, query in enumerate(queries)
+                    for j, loc in enumerate(locs)
+                    if loc in query
+                ])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,155 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.language.gallina.sertok.
+"""
+import unittest
+
+from prism.language.gallina.analyze import SexpInfo
+from prism.language.gallina.sertok import SertokTokens, _py_decode_sertok
+from prism.language.gallina.util import ParserUtils, UnicodeOffsetMap
+from prism.language.token import TokenConsts
+
+
+def _loc(bp: int, ep: int, fname: str = "ToplevelInput") -> str:
+    return (
+        f"(loc(((fname {fname})(line_nb 1)(bol_pos 0)(line_nb_last 1)"
+        f"(bol_pos_last 0)(bp {bp})(ep {ep}))))")
+
+
+class TestSertokTokens(unittest.TestCase):
+    """
+    Tests for `SertokTokens`.
+    """
+
+    source = 'Definition xé := "a  b". Check 1.5. ?y.'
+    sertok_output = "\n".join(
+        [
+            "(Sentence(((v(KEYWORD Definition))" + _loc(0,
+                                                        10) + ")"
+            "((v(IDENT xé))" + _loc(11,
+                                    14) + ")"
+            "((v(KEYWORD :=))" + _loc(15,
+                                      17) + ")"
+            '((v(STRING"a  b"))' + _loc(18,
+                                        24) + ")"
+            "((v(KEYWORD .))" + _loc(24,
+                                     25) + ")))",
+            "(Sentence(((v(IDENT Check))" + _loc(29,
+                                                 34,
+                                                 "(InFile x.v)") + ")"
+            "((v(NUMERAL((int 1)(frac 5)(exp\"\"))))" + _loc(35,
+                                                             38) + ")"
+            "((v(KEYWORD .))" + _loc(38,
+                                     39) + ")))",
+            "(Sentence(((v LEFTQMARK)" + _loc(40,
+                                              41) + ")"
+            "((v(IDENT y))" + _loc(41,
+                                   42) + ")"
+            "((v(KEYWORD .))" + _loc(42,
+                                     43) + ")))",
+        ])
+
+    def test_decode(self) -> None:
+        """
+        Verify that tokens are decoded like `SexpAnalyzer`.
+        """
+        tokens = SertokTokens.decode(
+            self.sertok_output,
+            UnicodeOffsetMap(self.source))
+        self.assertEqual(len(tokens), 11)
+        self.assertEqual(tokens.num_sentences, 3)
+        self.assertEqual(
+            tokens[1],
+            SexpInfo.SertokToken(
+                TokenConsts.KIND_ID,
+                "xé",
+                SexpInfo.Loc("ToplevelInput",
+                             1,
+                             0,
+                             1,
+                             0,
+                             11,
+                             13)))
+        self.assertEqual(tokens[3].kind, TokenConsts.KIND_STR)
+        self.assertEqual(tokens[3].content, '"a  b"')
+        self.assertEqual(tokens[5].loc.filename, "x.v")
+        self.assertEqual(tokens[6].content, "1")
+        self.assertEqual(tokens[8].content, "?")
+        self.assertEqual(
+            tokens.sentence(2).tokens,
+            [tokens[i] for i in range(8, 11)])
+        for unicode_offsets in [None,
+                                UnicodeOffsetMap(self.source),
+                                ParserUtils.get_unicode_offsets(self.source)]:
+            with self.subTest(unicode_offsets=unicode_offsets):
+                self.assertEqual(
+                    SertokTokens.decode(self.sertok_output,
+                                        unicode_offsets).to_sentences(),
+                    _py_decode_sertok(self.sertok_output,
+                                      unicode_offsets))
+
+    def test_adjust_quotes(self) -> None:
+        """
+        Verify that quotes are adjusted to match token locations.
+        """
+        sertok_output = (
+            '(Sentence(((v(IDENT"x"))' + _loc(0,
+                                              1) + ")"
+            "((v(STRING x))" + _loc(1,
+                                    4) + ")"
+            '((v(KEYWORD""))' + _loc(6,
+                                     6) + ")))")
+        self.assertEqual(
+            SertokTokens.decode(sertok_output).to_sentences(),
+            _py_decode_sertok(sertok_output))
+        self.assertEqual(
+            [
+                t.content
+                for t in SertokTokens.decode(sertok_output).sentence(0).tokens
+            ],
+            ["x",
+             '"x"',
+             ''])
+
+    def test_malformed(self) -> None:
+        """
+        Verify that unexpected structures are rejected.
+        """
+        for sertok_output in ["",
+                              "(Sentence",
+                              "(Sentence())))",
+                              "(NotSentence())",
+                              "(Sentence(((v(IDENT x))(loc()))))",
+                              "(Sentence(((v FOO)" + _loc(0,
+                                                          1) + ")))",
+                              "(Sentence(((v(IDENT x))" + _loc(0,
+                                                               "x") + ")))"]:
+            with self.subTest(sertok_output=sertok_output):
+                with self.assertRaises(ValueError):
+                    SertokTokens.decode(sertok_output)
+        self.assertEqual(
+            SertokTokens.decode("(Sentence())").to_sentences(),
+            [SexpInfo.SertokSentence()])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -21,6 +21,7 @@
 """
 Tests for prism.language.gallina.analyze.SexpAnalyzer.
 """
+import json
 import unittest
 
 import pytest
@@ -29,7 +30,7 @@ from prism.language.gallina.analyze import ControlFlag, SexpAnalyzer, SexpInfo
 from prism.language.gallina.exception import SexpAnalyzingException
 from prism.language.gallina.parser import CoqParser
 from prism.language.sexp import SexpList, SexpParser, SexpString
-from prism.tests import _COQ_EXAMPLES_PATH
+from prism.tests import _COQ_EXAMPLES_PATH, _DATA_PATH
 from prism.util.opam import OpamSwitch
 
 
@@ -235,6 +236,97 @@ class TestSexpAnalyzer(unittest.TestCase):
                         vernac.attributes))
             self.assertEqual(actual_vernac, expected_vernac)
 
+    def test_parse_vernacs(self):
+        """
+        Verify that the native summary matches the Python analysis.
+        """
+        loc = (
+            '(loc(((fname(InFile a.v))(line_nb 1)(bol_pos 0)'
+            '(line_nb_last 1)(bol_pos_last 0)(bp 7)(ep 12))))')
+        expr = (
+            '(VernacExtend(Set_Solver 0)((GenArg raw(ExtraArg tactic)'
+            '(TacAtom((v(TacIntroPattern false(((v(IntroForthcoming false))'
+            f'{loc}))))(loc("[LOC]")))))))')
+        deep = "(a" * 24 + ")" * 24
+        sexp_str = "\n".join(
+            [
+                # pre-8.11
+                '((v(VernacTime false((v(VernacFail((v(VernacExpr'
+                f'((local VernacFlagEmpty)){expr}))(loc("[LOC]")))))'
+                f'(loc("[LOC]")))))(loc("[LOC]")))',
+                # post-8.11
+                '((v((control((ControlTime false)(ControlTimeout 5)'
+                '(ControlRedirect "out.txt")))'
+                '(attrs((program VernacFlagEmpty)'
+                '(global(VernacFlagList((local(VernacFlagLeaf leaf))))))'
+                f')(expr {expr}))){loc})',
+                # Coq 8.15
+                f'((v((control())(attrs(((v(local VernacFlagEmpty)){loc})))'
+                f'(expr VernacEndProof))){loc})',
+                # unparseable loc, deferred to `analyze_vernac`
+                '((v((control())(attrs())(expr VernacEndProof)))'
+                '(loc(((fname ToplevelInput)(line_nb +1)(bol_pos 0)'
+                '(line_nb_last 1)(bol_pos_last 0)(bp 7)(ep 12)))))',
+                # deeper than the native mirror
+                f'((v((control())(attrs())(expr(VernacProof {deep}))))'
+                f'{loc})',
+                '((v((control())(attrs())'
+                f'(expr(VernacExtend(VernacSolve 0){deep})))){loc})',
+            ])
+        # commands without locations
+        data = json.loads((_DATA_PATH / "initial_state.json").read_text())
+        asts = []
+
+        def find_asts(obj):
+            if isinstance(obj, dict):
+                for key, value in obj.items():
+                    if key == "ast" and isinstance(value, str):
+                        asts.append(value)
+                    else:
+                        find_asts(value)
+            elif isinstance(obj, list):
+                for value in obj:
+                    find_asts(value)
+
+        find_asts(data["command_data"])
+        self.assertTrue(asts)
+        for text in [sexp_str, "\n".join(asts)]:
+            expected = SexpAnalyzer._py_parse_vernacs(text)
+            actual = SexpAnalyzer.parse_vernacs(text)
+            self.assertEqual(actual[0], expected[0])
+            self.assertEqual(actual[1], expected[1])
+            self.assertEqual(actual[2], expected[2])
+            for a, e in zip(actual[1], expected[1]):
+                self.assertEqual(a.vernac_sexp, e.vernac_sexp)
+                self.assertEqual(a.loc, e.loc)
+                self.assertEqual(a.control_flags, e.control_flags)
+        sexps, vernacs, is_ltac = SexpAnalyzer.parse_vernacs(sexp_str)
+        self.assertEqual(
+            [v.control_flags for v in vernacs],
+            [
+                [ControlFlag.Time,
+                 ControlFlag.Fail],
+                [ControlFlag.Time,
+                 ControlFlag.Timeout,
+                 ControlFlag.Redirect],
+                [],
+                [],
+                [],
+                []
+            ])
+        self.assertEqual(vernacs[1].loc.filename, "a.v")
+        self.assertEqual(
+            vernacs[1].attributes,
+            ["program",
+             "global (local=leaf)"])
+        self.assertEqual(vernacs[3].loc.lineno, 1)
+        self.assertEqual(is_ltac, [False, False, True, True, True, True])
+        self.assertEqual(is_ltac, [SexpAnalyzer.is_ltac(v) for v in vernacs])
+        with self.assertRaises(SexpAnalyzingException):
+            SexpAnalyzer.parse_vernacs("(a b)")
+        with self.assertRaises(ValueError):
+            SexpAnalyzer.parse_vernacs("((v")
+
     @pytest.mark.coq_8_10_2
     def test_is_ltac(self):
         """
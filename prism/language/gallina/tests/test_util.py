@@ -0,0 +1,85 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.language.gallina.util.
+"""
+import pickle
+import random
+import unittest
+
+import numpy as np
+
+from prism.language.gallina.util import ParserUtils, UnicodeOffsetMap
+
+
+class TestUnicodeOffsetMap(unittest.TestCase):
+    """
+    Tests for `UnicodeOffsetMap`.
+    """
+
+    def test_conversions(self) -> None:
+        """
+        Verify that conversions agree with the list-based conversions.
+        """
+        rng = random.Random(0)
+        codes = ["", "Lemma foo : True.", "∀ x, x = x.\n(* λ *)"]
+        for _ in range(50):
+            codes.append(
+                ''.join(rng.choices("ab \nλ∀é𝔸",
+                                    k=rng.randrange(200))))
+        for code in codes:
+            unicode_offsets = ParserUtils.get_unicode_offsets(code)
+            offset_map = pickle.loads(pickle.dumps(UnicodeOffsetMap(code)))
+            num_bytes = len(code.encode('utf-8'))
+            coq_charnos = list(range(-1, num_bytes + 3))
+            expected = [
+                ParserUtils.coq_charno_to_actual_charno(b,
+                                                        unicode_offsets)
+                for b in coq_charnos
+            ]
+            self.assertEqual(
+                [
+                    ParserUtils.coq_charno_to_actual_charno(b,
+                                                            offset_map)
+                    for b in coq_charnos
+                ],
+                expected)
+            self.assertEqual(
+                offset_map.bytes_to_chars(np.array(coq_charnos)).tolist(),
+                expected)
+            actual_charnos = list(range(-1, len(code) + 3))
+            for convert, convert_many in [
+                (ParserUtils.actual_charno_to_coq_charno_bp,
+                 offset_map.chars_to_first_bytes),
+                (ParserUtils.actual_charno_to_coq_charno_ep,
+                 offset_map.chars_to_last_bytes)]:
+                expected = [convert(c, unicode_offsets) for c in actual_charnos]
+                self.assertEqual(
+                    [convert(c,
+                             offset_map) for c in actual_charnos],
+                    expected)
+                self.assertEqual(
+                    convert_many(np.array(actual_charnos)).tolist(),
+                    expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
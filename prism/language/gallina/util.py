@@ -23,7 +23,110 @@ Defines utilities for parsing Coq/Gallina.
 """
 
 import re
-from typing import List, Optional, Tuple
+from typing import List, Optional, Tuple, Union
+
+import numpy as np
+
+from prism.language.gallina._offsets import (
+    build_offset_index,
+    convert_offset,
+    convert_offsets,
+)
+
+_BYTE_TO_CHAR = 0
+_CHAR_TO_FIRST_BYTE = 1
+_CHAR_TO_LAST_BYTE = 2
+
+
+class UnicodeOffsetMap:
+    """
+    A map between byte and character indices of a UTF-8 encoded string.
+
+    Coq reports locations as indices into a UTF-8 bytestring while
+    Python strings are indexed by character.
+    In contrast to the list of offsets given by
+    `ParserUtils.get_unicode_offsets`, which must be scanned for each
+    conversion, this map is built once per document as a rank/select
+    index over the bytes that begin each character, after which each
+    conversion takes constant time.
+    Instances may be given to any `ParserUtils` method or
+    `SexpInfo.Loc` method in place of a list of unicode offsets.
+    """
+
+    def __init__(self, code: str) -> None:
+        """
+        Build a map for the given string.
+        """
+        self._index = build_offset_index(code)
+
+    def __reduce__(self) -> Tuple[type, Tuple[()], bytes]:  # noqa: D105
+        return (UnicodeOffsetMap.__new__,
+                (UnicodeOffsetMap,
+                 ),
+                self._index)
+
+    def __setstate__(self, state: bytes) -> None:  # noqa: D105
+        self._index = state
+
+    def byte_to_char(self, coq_charno: int) -> int:
+        """
+        Convert a UTF-8 byte index to a character index.
+
+        See Also
+        --------
+        ParserUtils.coq_charno_to_actual_charno
+        """
+        return convert_offset(self._index, _BYTE_TO_CHAR, coq_charno)
+
+    def char_to_first_byte(self, actual_charno: int) -> int:
+        """
+        Convert a character index to the index of its first byte.
+
+        See Also
+        --------
+        ParserUtils.actual_charno_to_coq_charno_bp
+        """
+        return convert_offset(self._index, _CHAR_TO_FIRST_BYTE, actual_charno)
+
+    def char_to_last_byte(self, actual_charno: int) -> int:
+        """
+        Convert a character index to the index of its last byte.
+
+        See Also
+        --------
+        ParserUtils.actual_charno_to_coq_charno_ep
+        """
+        return convert_offset(self._index, _CHAR_TO_LAST_BYTE, actual_charno)
+
+    def _convert_many(self, mode: int, values: np.ndarray) -> np.ndarray:
+        values = np.ascontiguousarray(values, dtype=np.int64)
+        result = convert_offsets(self._index, mode, values.tobytes())
+        return np.frombuffer(result, dtype=np.int64).reshape(values.shape)
+
+    def bytes_to_chars(self, coq_charnos: np.ndarray) -> np.ndarray:
+        """
+        Convert an array of UTF-8 byte indices to character indices.
+        """
+        return self._convert_many(_BYTE_TO_CHAR, coq_charnos)
+
+    def chars_to_first_bytes(self, actual_charnos: np.ndarray) -> np.ndarray:
+        """
+        Convert an array of character indices to their first bytes.
+        """
+        return self._convert_many(_CHAR_TO_FIRST_BYTE, actual_charnos)
+
+    def chars_to_last_bytes(self, actual_charnos: np.ndarray) -> np.ndarray:
+        """
+        Convert an array of character indices to their last bytes.
+        """
+        return self._convert_many(_CHAR_TO_LAST_BYTE, actual_charnos)
+
+
+UnicodeOffsets = Union[List[int], UnicodeOffsetMap]
+"""
+Either a list of unicode offsets (see `ParserUtils.get_unicode_offsets`)
+or an equivalent `UnicodeOffsetMap`.
+"""
 
 
 class ParserUtils:
@@ -38,7 +141,7 @@ class ParserUtils:
     def actual_charno_to_coq_charno_bp(
             cls,
             actual_charno: int,
-            unicode_offsets: List[int]) -> int:
+            unicode_offsets: UnicodeOffsets) -> int:
         """
         Convert a lexical character index to its first index in UTF-8.
 
@@ -47,7 +150,7 @@ class ParserUtils:
         actual_charno : int
             The raw character index of a lexical symbol or character
             irrespective of encoding in a string.
-        unicode_offsets : List[int]
+        unicode_offsets : UnicodeOffsets
             The number of bytes in excess of one of each non-ASCII
             UTF-8 character in the implicit string.
 
@@ -57,6 +160,8 @@ class ParserUtils:
             The index of the first byte of the indicated lexical
             character in a UTF-8 encoding of the implicit string.
         """
+        if isinstance(unicode_offsets, UnicodeOffsetMap):
+            return unicode_offsets.char_to_first_byte(actual_charno)
         return actual_charno + len(
             [offset for offset in unicode_offsets if offset < actual_charno])
 
@@ -64,7 +169,7 @@ class ParserUtils:
     def actual_charno_to_coq_charno_ep(
             cls,
             actual_charno: int,
-            unicode_offsets: List[int]) -> int:
+            unicode_offsets: UnicodeOffsets) -> int:
         """
         Convert a lexical character index to its last index in UTF-8.
 
@@ -73,7 +178,7 @@ class ParserUtils:
         actual_charno : int
             The raw character index of a lexical symbol or character
             irrespective of encoding in a string.
-        unicode_offsets : List[int]
+        unicode_offsets : UnicodeOffsets
             The number of bytes in excess of one of each non-ASCII
             UTF-8 character in the implicit string.
 
@@ -83,6 +188,8 @@ class ParserUtils:
             The index of the last byte of the indicated lexical
             character in a UTF-8 encoding of the implicit string.
         """
+        if isinstance(unicode_offsets, UnicodeOffsetMap):
+            return unicode_offsets.char_to_last_byte(actual_charno)
         return actual_charno + len(
             [offset for offset in unicode_offsets if offset <= actual_charno])
 
@@ -90,7 +197,7 @@ class ParserUtils:
     def coq_charno_to_actual_charno(
             cls,
             coq_charno: int,
-            unicode_offsets: List[int]) -> int:
+            unicode_offsets: UnicodeOffsets) -> int:
         """
         Convert a UTF-8 character index to a lexical character index.
 
@@ -99,7 +206,7 @@ class ParserUtils:
         coq_charno : int
             The index of a character in a UTF-8 encoded string, where
             each "character" is a byte.
-        unicode_offsets : List[int]
+        unicode_offsets : UnicodeOffsets
             The number of bytes in excess of one of each non-ASCII
             UTF-8 character in the implicit string.
 
@@ -109,6 +216,8 @@ class ParserUtils:
             The actual character index of the indicated byte
             irrespective of encoding.
         """
+        if isinstance(unicode_offsets, UnicodeOffsetMap):
+            return unicode_offsets.byte_to_char(coq_charno)
         # count the number of excess bytes appearing prior to the given
         # index
         excess_count = len(
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/* Token kinds (see prism/language/heuristic/lexer.py) */
+enum TokenKind
+{
+    kind_char,
+    kind_space,
+    kind_string
+};
+
+struct Token
+{
+    TokenKind kind;
+    Py_UCS4   c;
+    int64_t   beg;
+    int64_t   end;
+};
+
+typedef std::vector<Token> Tokens;
+
+/*
+ * Test whether a character is whitespace in the sense of `str.isspace`.
+ */
+static inline bool is_space(Py_UCS4 c)
+{
+    if (c < 0x80)
+    {
+        return (c >= 0x09 and c <= 0x0D) or (c >= 0x1C and c <= 0x20);
+    }
+    return c == 0x85 or c == 0xA0 or c == 0x1680 or (c >= 0x2000 and c <= 0x200A)
+        or c == 0x2028 or c == 0x2029 or c == 0x202F or c == 0x205F or c == 0x3000;
+}
+
+class Lexer
+{
+  public:
+    Lexer(const Py_UCS4* text, int64_t size) : text(text), size(size), unterminated(-1)
+    {
+    }
+
+    void lex()
+    {
+        scan();
+        // split sentences by single periods followed by whitespace
+        size_t beg = 0;
+        size_t i   = 0;
+        while (i < tokens.size())
+        {
+            if (is_char(tokens, i, '.') and !(i > 0 and is_char(tokens, i - 1, '.'))
+                and is_space_token(tokens, i + 1))
+            {
+                process_piece(Tokens(tokens.begin() + beg, tokens.begin() + i),
+                              &tokens[i]);
+                beg = i = i + 2;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        process_piece(Tokens(tokens.begin() + beg, tokens.end()), NULL);
+        // lop off the final sentence if it's just a period
+        if (!items.empty() and items.back().size() == 1
+            and is_char(items.back(), 0, '.'))
+        {
+            items.pop_back();
+        }
+    }
+
+    const Py_UCS4*        text;
+    int64_t               size;
+    Tokens                tokens;
+    std::vector<int64_t>  comments;
+    std::vector<Tokens>   items;
+    int64_t               unterminated;
+
+  private:
+    static bool is_char(const Tokens& tokens, size_t i, Py_UCS4 c)
+    {
+        return i < tokens.size() and tokens[i].kind == kind_char and tokens[i].c == c;
+    }
+
+    static bool is_space_token(const Tokens& tokens, size_t i)
+    {
+        return i < tokens.size() and tokens[i].kind == kind_space;
+    }
+
+    bool starts_with(int64_t i, Py_UCS4 first, Py_UCS4 second) const
+    {
+        return i + 1 < size and text[i] == first and text[i + 1] == second;
+    }
+
+    /*
+     * Get the offset after the string literal starting at `beg` or the
+     * size of the text if the string is unterminated.
+     */
+    int64_t skip_string(int64_t beg) const
+    {
+        int64_t i = beg + 1;
+        while (i < size)
+        {
+            if (text[i] == '"')
+            {
+                if (i + 1 < size and text[i + 1] == '"')
+                {
+                    // escaped double quote
+                    i += 2;
+                    continue;
+                }
+                return i + 1;
+            }
+            i++;
+        }
+        return size;
+    }
+
+    /*
+     * Get the offset after the (nested) comment starting at `beg` or -1
+     * if the comment is unterminated.
+     */
+    int64_t skip_comment(int64_t beg) const
+    {
+        int64_t depth = 0;
+        int64_t i     = beg;
+        while (i < size)
+        {
+            if (starts_with(i, '(', '*'))
+            {
+                depth++;
+                i += 2;
+            }
+            else if (starts_with(i, '*', ')'))
+            {
+                depth--;
+                i += 2;
+                if (depth == 0)
+                {
+                    return i;
+                }
+            }
+            else if (text[i] == '"')
+            {
+                i = skip_string(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+        return -1;
+    }
+
+    void scan()
+    {
+        int64_t i = 0;
+        while (i < size)
+        {
+            int64_t j;
+            if (starts_with(i, '(', '*'))
+            {
+                j = skip_comment(i);
+                if (j < 0)
+                {
+                    // the rest of the document is commented out
+                    break;
+                }
+                comments.push_back(i);
+                comments.push_back(j);
+            }
+            else if (text[i] == '"')
+            {
+                j = skip_string(i);
+                tokens.push_back({kind_string, 0, i, j});
+            }
+            else
+            {
+                j = i + 1;
+                tokens.push_back(
+                    {is_space(text[i]) ? kind_space : kind_char, text[i], i, j});
+            }
+            i = j;
+        }
+    }
+
+    void process_piece(Tokens piece, const Token* period)
+    {
+        std::deque<Tokens> queue;
+        queue.push_back(std::move(piece));
+        while (!queue.empty())
+        {
+            Tokens current = std::move(queue.front());
+            queue.pop_front();
+            process(current, period, queue);
+            // only the original piece is followed by a period
+            period = NULL;
+        }
+    }
+
+    /*
+     * Emit the braces, bullets, and sentence of a period-delimited
+     * piece, pushing pieces split by ellipses to the front of the queue.
+     */
+    void process(const Tokens& tokens, const Token* period, std::deque<Tokens>& queue)
+    {
+        bool all_space = true;
+        for (const Token& token : tokens)
+        {
+            all_space = all_space and token.kind == kind_space;
+        }
+        if (all_space or (is_char(tokens, 0, '.') and is_space_token(tokens, 1)))
+        {
+            return;
+        }
+        // collapse whitespace and strip
+        Tokens collapsed;
+        for (const Token& token : tokens)
+        {
+            if (token.kind == kind_space)
+            {
+                if (!collapsed.empty() and collapsed.back().kind == kind_space)
+                {
+                    collapsed.back().end = token.end;
+                }
+                else
+                {
+                    collapsed.push_back({kind_space, ' ', token.beg, token.end});
+                }
+            }
+            else
+            {
+                collapsed.push_back(token);
+            }
+        }
+        size_t first = 0;
+        while (is_space_token(collapsed, first))
+        {
+            first++;
+        }
+        while (!collapsed.empty() and collapsed.back().kind == kind_space)
+        {
+            collapsed.pop_back();
+        }
+        // restore the period
+        if (!is_char(collapsed, collapsed.size() - 1, '.'))
+        {
+            if (period == NULL)
+            {
+                unterminated = collapsed[first].beg;
+                return;
+            }
+            collapsed.push_back(*period);
+        }
+        // split braces and bullets
+        size_t i = first;
+        while (true)
+        {
+            while (is_space_token(collapsed, i))
+            {
+                i++;
+            }
+            if (is_char(collapsed, i, '-') or is_char(collapsed, i, '+')
+                or is_char(collapsed, i, '*'))
+            {
+                size_t j = i + 1;
+                while (is_char(collapsed, j, collapsed[i].c))
+                {
+                    j++;
+                }
+                items.emplace_back(collapsed.begin() + i, collapsed.begin() + j);
+                i = j;
+            }
+            else if (is_char(collapsed, i, '{') or is_char(collapsed, i, '}'))
+            {
+                items.emplace_back(collapsed.begin() + i, collapsed.begin() + i + 1);
+                i++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        // split on ellipses
+        std::vector<Tokens> pieces;
+        size_t              beg = i;
+        size_t              j   = i;
+        while (j + 2 < collapsed.size())
+        {
+            if (is_char(collapsed, j, '.') and is_char(collapsed, j + 1, '.')
+                and is_char(collapsed, j + 2, '.'))
+            {
+                if (j > beg)
+                {
+                    // restore the ellipsis
+                    pieces.emplace_back(collapsed.begin() + beg,
+                                        collapsed.begin() + j + 3);
+                }
+                beg = j = j + 3;
+            }
+            else
+            {
+                j++;
+            }
+        }
+        if (beg < collapsed.size())
+        {
+            pieces.emplace_back(collapsed.begin() + beg, collapsed.end());
+        }
+        if (pieces.size() > 1)
+        {
+            for (size_t k = pieces.size() - 1; k > 0; k--)
+            {
+                queue.push_front(std::move(pieces[k]));
+            }
+            items.push_back(std::move(pieces[0]));
+        }
+        else
+        {
+            items.emplace_back(collapsed.begin() + i, collapsed.end());
+        }
+    }
+};
+
+static PyObject* int64s_to_bytes(const std::vector<int64_t>& values)
+{
+    return PyBytes_FromStringAndSize((const char*)values.data(),
+                                     (Py_ssize_t)(values.size() * sizeof(int64_t)));
+}
+
+/*
+ * Get the text of an item, with strings copied verbatim.
+ */
+static PyObject* item_text(const Lexer& lexer, const Tokens& item)
+{
+    std::vector<Py_UCS4> buffer;
+    for (const Token& token : item)
+    {
+        if (token.kind == kind_string)
+        {
+            buffer.insert(buffer.end(), lexer.text + token.beg, lexer.text + token.end);
+        }
+        else
+        {
+            buffer.push_back(token.c);
+        }
+    }
+    int byteorder = PY_LITTLE_ENDIAN ? -1 : 1;
+    return PyUnicode_DecodeUTF32((const char*)buffer.data(),
+                                 (Py_ssize_t)(buffer.size() * sizeof(Py_UCS4)),
+                                 "surrogatepass",
+                                 &byteorder);
+}
+
+static PyObject* lex_sentences(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    Lexer lexer(data, size);
+    /* The lexer only touches its own copy of the text. */
+    Py_BEGIN_ALLOW_THREADS
+    lexer.lex();
+    Py_END_ALLOW_THREADS
+    PyObject*            sentences = PyList_New(0);
+    std::vector<int64_t> spans;
+    for (const Tokens& item : lexer.items)
+    {
+        PyObject* sentence = sentences == NULL ? NULL : item_text(lexer, item);
+        if (sentence == NULL or PyList_Append(sentences, sentence) < 0)
+        {
+            Py_DecRef(sentence);
+            Py_DecRef(sentences);
+            PyMem_Free(data);
+            return NULL;
+        }
+        Py_DecRef(sentence);
+        spans.push_back(item.front().beg);
+        spans.push_back(item.back().end);
+    }
+    PyMem_Free(data);
+    PyObject* packed_spans    = int64s_to_bytes(spans);
+    PyObject* packed_comments = int64s_to_bytes(lexer.comments);
+    PyObject* result          = NULL;
+    if (packed_spans != NULL and packed_comments != NULL)
+    {
+        result = Py_BuildValue("(OOOL)",
+                               sentences,
+                               packed_spans,
+                               packed_comments,
+                               (long long)lexer.unterminated);
+    }
+    Py_DecRef(sentences);
+    Py_DecRef(packed_spans);
+    Py_DecRef(packed_comments);
+    return result;
+};
+
+static PyMethodDef LexerMethods[] = {
+    {"lex_sentences",
+     lex_sentences, METH_VARARGS,
+     "Split a Coq document into sentences and comments."},
+    {NULL,            NULL,          0,            NULL}
+};
+
+static struct PyModuleDef lexer_module = {PyModuleDef_HEAD_INIT,
+                                          "prism.language.heuristic._lexer",
+                                          "Library for lexing Coq sentences",
+                                          -1,
+                                          LexerMethods};
+
+PyMODINIT_FUNC            PyInit__lexer(void)
+{
+    return PyModule_Create(&lexer_module);
+};
@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/*
+ * Locations of a string are encoded as a bytestring of segments, each
+ * a triple of 64-bit integers (length, start, width) locating `length`
+ * consecutive characters at (start + k, start + k + width) for k in
+ * [0, length).
+ * Segments are canonical: none is empty and no two adjacent segments
+ * are collinear (see prism/language/heuristic/str_with_location.py).
+ */
+struct Segment
+{
+    int64_t length;
+    int64_t start;
+    int64_t width;
+};
+
+typedef std::vector<Segment> Segments;
+
+/*
+ * Append a segment, merging it with the last one if they are collinear.
+ */
+static inline void append_segment(Segments& segments,
+                                  int64_t   length,
+                                  int64_t   start,
+                                  int64_t   width)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+    if (!segments.empty())
+    {
+        Segment& last = segments.back();
+        if (last.width == width and last.start + last.length == start)
+        {
+            last.length += length;
+            return;
+        }
+    }
+    segments.push_back({length, start, width});
+}
+
+/*
+ * Read a buffer of 64-bit integers whose count is a multiple of `arity`.
+ */
+static bool read_int64s(PyObject* obj, size_t arity, std::vector<int64_t>& values)
+{
+    char*      data = NULL;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(obj, &data, &size) < 0)
+    {
+        return false;
+    }
+    if (size % (arity * sizeof(int64_t)) != 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Malformed buffer of 64-bit integers");
+        return false;
+    }
+    values.resize(size / sizeof(int64_t));
+    memcpy(values.data(), data, size);
+    return true;
+}
+
+static bool read_segments(PyObject* obj, Segments& segments)
+{
+    std::vector<int64_t> values;
+    if (!read_int64s(obj, 3, values))
+    {
+        return false;
+    }
+    segments.resize(values.size() / 3);
+    memcpy(segments.data(), values.data(), values.size() * sizeof(int64_t));
+    return true;
+}
+
+static PyObject* write_segments(const Segments& segments)
+{
+    return PyBytes_FromStringAndSize(
+        (const char*)segments.data(),
+        (Py_ssize_t)(segments.size() * sizeof(Segment)));
+}
+
+/*
+ * Get the offset in the string of each segment and of the end.
+ */
+static std::vector<int64_t> segment_offsets(const Segments& segments)
+{
+    std::vector<int64_t> offsets(segments.size() + 1, 0);
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        offsets[i + 1] = offsets[i] + segments[i].length;
+    }
+    return offsets;
+}
+
+/*
+ * Visit the portion of each segment within the characters [start, stop)
+ * as (segment, first character, one past the last character).
+ */
+template <typename Visitor>
+static void visit_range(const Segments&             segments,
+                        const std::vector<int64_t>& offsets,
+                        int64_t                     start,
+                        int64_t                     stop,
+                        Visitor                     visit)
+{
+    start = std::max(start, (int64_t)0);
+    stop  = std::min(stop, offsets.back());
+    if (start >= stop)
+    {
+        return;
+    }
+    size_t i = std::upper_bound(offsets.begin(), offsets.end(), start)
+             - offsets.begin() - 1;
+    while (start < stop)
+    {
+        int64_t k0 = start - offsets[i];
+        int64_t k1 = std::min(stop - offsets[i], segments[i].length);
+        visit(segments[i], k0, k1);
+        start = offsets[i] + k1;
+        i++;
+    }
+}
+
+static void append_range(Segments&                   out,
+                         const Segments&             segments,
+                         const std::vector<int64_t>& offsets,
+                         int64_t                     start,
+                         int64_t                     stop)
+{
+    visit_range(segments,
+                offsets,
+                start,
+                stop,
+                [&out](const Segment& segment, int64_t k0, int64_t k1)
+                { append_segment(out, k1 - k0, segment.start + k0, segment.width); });
+}
+
+/*
+ * Get the least start and greatest end of the characters [start, stop).
+ * Return false if there are no such characters.
+ */
+static bool range_bounds(const Segments&             segments,
+                         const std::vector<int64_t>& offsets,
+                         int64_t                     start,
+                         int64_t                     stop,
+                         int64_t&                    lo,
+                         int64_t&                    hi)
+{
+    bool found = false;
+    visit_range(segments,
+                offsets,
+                start,
+                stop,
+                [&](const Segment& segment, int64_t k0, int64_t k1)
+                {
+                    int64_t seg_lo = segment.start + k0;
+                    int64_t seg_hi = segment.start + k1 - 1 + segment.width;
+                    lo             = found ? std::min(lo, seg_lo) : seg_lo;
+                    hi             = found ? std::max(hi, seg_hi) : seg_hi;
+                    found          = true;
+                });
+    return found;
+}
+
+/*
+ * Spread `length` characters evenly over the interval [start, end).
+ */
+static void append_spread(Segments& out, int64_t length, int64_t start, int64_t end)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+    double step = (double)(end - start) / (double)length;
+    for (int64_t i = 0; i < length; i++)
+    {
+        int64_t char_start = start + (int64_t)std::floor((double)i * step);
+        int64_t char_end
+            = std::min(end, start + (int64_t)std::ceil((double)(i + 1) * step));
+        append_segment(out, 1, char_start, char_end - char_start);
+    }
+}
+
+static PyObject* encode_indices(PyObject* self, PyObject* args)
+{
+    PyObject* indices = NULL;
+    if (!PyArg_ParseTuple(args, "O", &indices))
+    {
+        return NULL;
+    }
+    PyObject* iterator = PyObject_GetIter(indices);
+    if (iterator == NULL)
+    {
+        return NULL;
+    }
+    Segments  segments;
+    PyObject* item   = NULL;
+    bool      failed = false;
+    while (!failed and (item = PyIter_Next(iterator)) != NULL)
+    {
+        if (!PyTuple_Check(item))
+        {
+            PyObject* type = PyObject_Type(item);
+            PyErr_Format(PyExc_TypeError,
+                         "'indices' attribute contains object that is not a tuple. "
+                         "The incorrect type is %R.",
+                         type);
+            Py_DecRef(type);
+            failed = true;
+        }
+        else if (PyTuple_Size(item) != 2)
+        {
+            PyErr_Format(PyExc_ValueError,
+                         "Expected two locations in ascending order, got %R",
+                         item);
+            failed = true;
+        }
+        else
+        {
+            long long start = PyLong_AsLongLong(PyTuple_GetItem(item, 0));
+            long long end   = PyLong_AsLongLong(PyTuple_GetItem(item, 1));
+            if (PyErr_Occurred())
+            {
+                failed = true;
+            }
+            else if (start > end)
+            {
+                PyErr_Format(PyExc_ValueError,
+                             "Expected two locations in ascending order, got %R",
+                             item);
+                failed = true;
+            }
+            else
+            {
+                append_segment(segments, 1, start, end - start);
+            }
+        }
+        Py_DecRef(item);
+    }
+    Py_DecRef(iterator);
+    if (failed or PyErr_Occurred())
+    {
+        return NULL;
+    }
+    return write_segments(segments);
+};
+
+static PyObject* slice_segments(PyObject* self, PyObject* args)
+{
+    PyObject* packed = NULL;
+    long long start  = 0;
+    long long stop   = 0;
+    if (!PyArg_ParseTuple(args, "O!LL", &PyBytes_Type, &packed, &start, &stop))
+    {
+        return NULL;
+    }
+    Segments segments;
+    if (!read_segments(packed, segments))
+    {
+        return NULL;
+    }
+    Segments result;
+    append_range(result, segments, segment_offsets(segments), start, stop);
+    return write_segments(result);
+};
+
+static PyObject* split_segments(PyObject* self, PyObject* args)
+{
+    PyObject* packed        = NULL;
+    PyObject* packed_bounds = NULL;
+    if (!PyArg_ParseTuple(
+            args,
+            "O!O!",
+            &PyBytes_Type,
+            &packed,
+            &PyBytes_Type,
+            &packed_bounds))
+    {
+        return NULL;
+    }
+    Segments             segments;
+    std::vector<int64_t> bounds;
+    if (!read_segments(packed, segments) or !read_int64s(packed_bounds, 2, bounds))
+    {
+        return NULL;
+    }
+    std::vector<int64_t> offsets = segment_offsets(segments);
+    PyObject*            result  = PyList_New(0);
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    Segments piece;
+    for (size_t i = 0; i < bounds.size(); i += 2)
+    {
+        piece.clear();
+        append_range(piece, segments, offsets, bounds[i], bounds[i + 1]);
+        PyObject* packed_piece = write_segments(piece);
+        if (packed_piece == NULL or PyList_Append(result, packed_piece) < 0)
+        {
+            Py_DecRef(packed_piece);
+            Py_DecRef(result);
+            return NULL;
+        }
+        Py_DecRef(packed_piece);
+    }
+    return result;
+};
+
+static PyObject* substitute_segments(PyObject* self, PyObject* args)
+{
+    PyObject* packed      = NULL;
+    PyObject* packed_subs = NULL;
+    if (!PyArg_ParseTuple(
+            args,
+            "O!O!",
+            &PyBytes_Type,
+            &packed,
+            &PyBytes_Type,
+            &packed_subs))
+    {
+        return NULL;
+    }
+    Segments             segments;
+    std::vector<int64_t> subs;
+    if (!read_segments(packed, segments) or !read_int64s(packed_subs, 3, subs))
+    {
+        return NULL;
+    }
+    std::vector<int64_t> offsets = segment_offsets(segments);
+    int64_t              total   = offsets.back();
+    int64_t              prev    = 0;
+    Segments             result;
+    for (size_t i = 0; i < subs.size(); i += 3)
+    {
+        int64_t match_start = subs[i];
+        int64_t match_end   = subs[i + 1];
+        int64_t length      = subs[i + 2];
+        append_range(result, segments, offsets, prev, match_start);
+        if (length > 0)
+        {
+            int64_t lo = 0;
+            int64_t hi = 0;
+            if (match_start < match_end)
+            {
+                range_bounds(segments, offsets, match_start, match_end, lo, hi);
+            }
+            else if (match_start < total)
+            {
+                // an empty match precedes the next character
+                range_bounds(segments, offsets, match_start, match_start + 1, lo, hi);
+                hi = lo;
+            }
+            else if (range_bounds(segments, offsets, 0, total, lo, hi))
+            {
+                lo = hi;
+            }
+            else
+            {
+                PyErr_SetString(PyExc_ValueError,
+                                "Cannot locate a substitution in an empty string");
+                return NULL;
+            }
+            append_spread(result, length, lo, hi);
+        }
+        prev = match_end;
+    }
+    append_range(result, segments, offsets, prev, total);
+    return write_segments(result);
+};
+
+static PyObject* concat_segments(PyObject* self, PyObject* args)
+{
+    PyObject* parts = NULL;
+    if (!PyArg_ParseTuple(args, "O", &parts))
+    {
+        return NULL;
+    }
+    PyObject* iterator = PyObject_GetIter(parts);
+    if (iterator == NULL)
+    {
+        return NULL;
+    }
+    Segments  result;
+    Segments  part;
+    PyObject* item   = NULL;
+    bool      failed = false;
+    while (!failed and (item = PyIter_Next(iterator)) != NULL)
+    {
+        if (read_segments(item, part))
+        {
+            for (const Segment& segment : part)
+            {
+                append_segment(result, segment.length, segment.start, segment.width);
+            }
+        }
+        else
+        {
+            failed = true;
+        }
+        Py_DecRef(item);
+    }
+    Py_DecRef(iterator);
+    if (failed or PyErr_Occurred())
+    {
+        return NULL;
+    }
+    return write_segments(result);
+};
+
+static PyObject* spread_segments(PyObject* self, PyObject* args)
+{
+    long long length = 0;
+    long long start  = 0;
+    long long end    = 0;
+    if (!PyArg_ParseTuple(args, "LLL", &length, &start, &end))
+    {
+        return NULL;
+    }
+    Segments result;
+    append_spread(result, length, start, end);
+    return write_segments(result);
+};
+
+static PyObject* segment_bounds(PyObject* self, PyObject* args)
+{
+    PyObject* packed = NULL;
+    if (!PyArg_ParseTuple(args, "O!", &PyBytes_Type, &packed))
+    {
+        return NULL;
+    }
+    Segments segments;
+    if (!read_segments(packed, segments))
+    {
+        return NULL;
+    }
+    std::vector<int64_t> offsets = segment_offsets(segments);
+    int64_t              lo      = 0;
+    int64_t              hi      = 0;
+    if (!range_bounds(segments, offsets, 0, offsets.back(), lo, hi))
+    {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(LL)", (long long)lo, (long long)hi);
+};
+
+static PyMethodDef StrWithLocationMethods[] = {
+    {"encode_indices",
+     encode_indices,      METH_VARARGS,
+     "Validate per-character indices and encode them as segments."},
+    {"slice_segments",
+     slice_segments,      METH_VARARGS,
+     "Get the segments of a slice of a located string."},
+    {"split_segments",
+     split_segments,      METH_VARARGS,
+     "Get the segments of each of a buffer of slices of a located string."},
+    {"substitute_segments",
+     substitute_segments, METH_VARARGS,
+     "Get the segments of a located string after substitutions."},
+    {"concat_segments",
+     concat_segments,     METH_VARARGS,
+     "Get the segments of a concatenation of located strings."},
+    {"spread_segments",
+     spread_segments,     METH_VARARGS,
+     "Get the segments of characters spread evenly over an interval."},
+    {"segment_bounds",
+     segment_bounds,      METH_VARARGS,
+     "Get the least start and greatest end of the segments, if any."},
+    {NULL,                  NULL,                0,            NULL}
+};
+
+static struct PyModuleDef str_with_location_module = {
+    PyModuleDef_HEAD_INIT,
+    "prism.language.heuristic._str_with_location",
+    "Library for manipulating segment-encoded string locations",
+    -1,
+    StrWithLocationMethods};
+
+PyMODINIT_FUNC PyInit__str_with_location(void)
+{
+    return PyModule_Create(&str_with_location_module);
+};
@@ -0,0 +1,376 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Single-pass lexing of Coq documents into sentences and comments.
+"""
+from array import array
+from collections import deque
+from typing import Deque, List, NamedTuple, Optional, Tuple
+
+import numpy as np
+
+from prism.language.heuristic._lexer import lex_sentences as _lex_sentences
+
+__all__ = ['LexedDocument', 'lex_sentences', 'sentence_text']
+
+_CHAR = 0
+"""
+A single non-whitespace character outside of comments and strings.
+"""
+_SPACE = 1
+"""
+A single whitespace character or a collapsed run of whitespace.
+"""
+_STRING = 2
+"""
+A complete string literal including its delimiting quotes.
+"""
+
+_Token = Tuple[int, str, int, int]
+"""
+A token given as a tuple ``(kind, text, beg, end)``, where ``beg`` and
+``end`` delimit the token's text in the document.
+"""
+
+
+class LexedDocument(NamedTuple):
+    """
+    The sentences and comments of a Coq document.
+    """
+
+    sentences: List[str]
+    """
+    The normalized text of each sentence, brace, and bullet in order.
+
+    Comments are removed, whitespace outside of strings is collapsed to
+    single spaces, and leading and trailing whitespace is stripped.
+    """
+    sentence_spans: np.ndarray
+    """
+    An ``(len(sentences), 2)`` array of the document offsets of the
+    first character and one past the last character of each sentence.
+    """
+    comment_spans: np.ndarray
+    """
+    An ``(N, 2)`` array of the offsets delimiting each top-level comment
+    in the document.
+    """
+    unterminated: int
+    """
+    The offset of a trailing sentence that lacks an ending period,
+    which is excluded from `sentences`, or -1 if there is no such
+    sentence.
+    """
+
+
+def lex_sentences(text: str) -> LexedDocument:
+    """
+    Split a Coq document into sentences and comments.
+
+    Parameters
+    ----------
+    text : str
+        The contents of a Coq document.
+
+    Returns
+    -------
+    LexedDocument
+        The lexed sentences and comments.
+
+    Notes
+    -----
+    Sentences are split in one native pass over the document that
+    skips nested comments and ``""``-escaped strings, ends sentences at
+    periods that are followed by whitespace and not preceded by another
+    period, and splits braces, bullets, and ellipses from sentences.
+    This replicates the regular expression-based splitting of earlier
+    versions of `HeuristicParser` except that comment delimiters within
+    strings and string delimiters within comments are lexed as Coq
+    does.
+    """
+    sentences, sentence_spans, comment_spans, unterminated = _lex_sentences(text)
+    return LexedDocument(
+        sentences,
+        np.frombuffer(sentence_spans,
+                      dtype=np.int64).reshape(-1,
+                                              2),
+        np.frombuffer(comment_spans,
+                      dtype=np.int64).reshape(-1,
+                                              2),
+        unterminated)
+
+
+def _skip_string(text: str, beg: int) -> int:
+    """
+    Get the offset after the string literal starting at `beg`.
+
+    If the string is unterminated, then the length of the text is
+    returned.
+    """
+    i = beg + 1
+    while i < len(text):
+        if text[i] == '"':
+            if text.startswith('"', i + 1):
+                # escaped double quote
+                i += 2
+                continue
+            return i + 1
+        i += 1
+    return len(text)
+
+
+def _skip_comment(text: str, beg: int) -> int:
+    """
+    Get the offset after the (nested) comment starting at `beg`.
+
+    If the comment is unterminated, then -1 is returned.
+    """
+    depth = 0
+    i = beg
+    while i < len(text):
+        if text.startswith("(*", i):
+            depth += 1
+            i += 2
+        elif text.startswith("*)", i):
+            depth -= 1
+            i += 2
+            if depth == 0:
+                return i
+        elif text[i] == '"':
+            i = _skip_string(text, i)
+        else:
+            i += 1
+    return -1
+
+
+def _scan(text: str) -> Tuple[List[_Token], array]:
+    """
+    Tokenize a document, dropping comments.
+
+    Returns
+    -------
+    List[_Token]
+        The tokens of the document.
+    array
+        The start and end offsets of each top-level comment.
+    """
+    tokens: List[_Token] = []
+    comments = array('q')
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if text.startswith("(*", i):
+            j = _skip_comment(text, i)
+            if j < 0:
+                # the rest of the document is commented out
+                break
+            comments.extend((i, j))
+        elif c == '"':
+            j = _skip_string(text, i)
+            tokens.append((_STRING, text[i : j], i, j))
+        else:
+            j = i + 1
+            tokens.append((_SPACE if c.isspace() else _CHAR, c, i, j))
+        i = j
+    return tokens, comments
+
+
+def _is_char(tokens: List[_Token], i: int, c: str) -> bool:
+    return 0 <= i < len(tokens) and tokens[i][0] == _CHAR and tokens[i][1] == c
+
+
+def _is_space(tokens: List[_Token], i: int) -> bool:
+    return 0 <= i < len(tokens) and tokens[i][0] == _SPACE
+
+
+class _Unterminated(Exception):
+    pass
+
+
+def _process(
+        tokens: List[_Token],
+        period: Optional[_Token],
+        queue: Deque[Tuple[List[_Token],
+                           Optional[_Token]]],
+        items: List[List[_Token]]) -> None:
+    """
+    Emit the braces, bullets, and sentence of a period-delimited piece.
+
+    Pieces split from the sentence by ellipses are pushed to the front
+    of the queue.
+    """
+    if all(kind == _SPACE for kind, _, _, _ in tokens):
+        return
+    if _is_char(tokens, 0, '.') and _is_space(tokens, 1):
+        return
+    # collapse whitespace and strip
+    collapsed: List[_Token] = []
+    for token in tokens:
+        if token[0] == _SPACE and collapsed and collapsed[-1][0] == _SPACE:
+            collapsed[-1] = (_SPACE, ' ', collapsed[-1][2], token[3])
+        elif token[0] == _SPACE:
+            collapsed.append((_SPACE, ' ', token[2], token[3]))
+        else:
+            collapsed.append(token)
+    while collapsed and collapsed[0][0] == _SPACE:
+        collapsed.pop(0)
+    while collapsed and collapsed[-1][0] == _SPACE:
+        collapsed.pop()
+    # restore the period
+    if not _is_char(collapsed, len(collapsed) - 1, '.'):
+        if period is None:
+            raise _Unterminated(collapsed[0][2])
+        collapsed.append(period)
+    # split braces and bullets
+    i = 0
+    while True:
+        while _is_space(collapsed, i):
+            i += 1
+        if any(_is_char(collapsed, i, c) for c in "-+*"):
+            j = i + 1
+            while _is_char(collapsed, j, collapsed[i][1]):
+                j += 1
+            items.append(collapsed[i : j])
+            i = j
+        elif _is_char(collapsed, i, '{') or _is_char(collapsed, i, '}'):
+            items.append(collapsed[i : i + 1])
+            i += 1
+        else:
+            break
+    sentence = collapsed[i :]
+    # split on ellipses
+    pieces: List[List[_Token]] = []
+    beg = 0
+    j = 0
+    while j + 2 < len(sentence):
+        if all(_is_char(sentence, k, '.') for k in range(j, j + 3)):
+            if j > beg:
+                # restore the ellipsis
+                pieces.append(sentence[beg : j + 3])
+            beg = j = j + 3
+        else:
+            j += 1
+    if beg < len(sentence):
+        pieces.append(sentence[beg :])
+    if len(pieces) > 1:
+        sentence = pieces[0]
+        queue.extendleft((piece, None) for piece in reversed(pieces[1 :]))
+    items.append(sentence)
+
+
+def _py_lex_sentences(text: str) -> Tuple[List[str], bytes, bytes, int]:
+    """
+    Split a Coq document into sentences and comments.
+
+    This is the reference implementation of the native lexer.
+
+    Returns
+    -------
+    List[str]
+        The text of each sentence.
+    bytes
+        The start and end offsets of each sentence.
+    bytes
+        The start and end offsets of each top-level comment.
+    int
+        The offset of an unterminated trailing sentence or -1.
+    """
+    tokens, comments = _scan(text)
+    # split sentences by single periods followed by whitespace
+    pieces: List[Tuple[List[_Token], Optional[_Token]]] = []
+    beg = 0
+    i = 0
+    while i < len(tokens):
+        if (_is_char(tokens,
+                     i,
+                     '.') and not _is_char(tokens,
+                                           i - 1,
+                                           '.') and _is_space(tokens,
+                                                              i + 1)):
+            pieces.append((tokens[beg : i], tokens[i]))
+            beg = i = i + 2
+        else:
+            i += 1
+    pieces.append((tokens[beg :], None))
+    items: List[List[_Token]] = []
+    unterminated = -1
+    for piece in pieces:
+        queue = deque([piece])
+        while queue:
+            try:
+                _process(*queue.popleft(), queue, items)
+            except _Unterminated as e:
+                unterminated = e.args[0]
+    texts = [''.join(text for _, text, _, _ in item) for item in items]
+    spans = array('q')
+    for item in items:
+        spans.extend((item[0][2], item[-1][3]))
+    # lop off the final sentence if it's just a period
+    if texts and texts[-1] == ".":
+        texts.pop()
+        del spans[-2 :]
+    return texts, spans.tobytes(), comments.tobytes(), unterminated
+
+
+def sentence_text(text: str, beg: int, end: int) -> str:
+    """
+    Get the normalized text of a sentence from its span in a document.
+
+    Parameters
+    ----------
+    text : str
+        The contents of a Coq document.
+    beg : int
+        The offset of the sentence's first character as given by
+        `LexedDocument.sentence_spans`.
+    end : int
+        The offset one past the sentence's last character as given by
+        `LexedDocument.sentence_spans`.
+
+    Returns
+    -------
+    str
+        The sentence as it appears in `LexedDocument.sentences`.
+
+    Notes
+    -----
+    Only the span and the comments immediately following it are
+    scanned, so this is much cheaper than lexing the whole document.
+    """
+    tokens, _ = _scan(text[beg : end])
+    collapsed: List[Tuple[int, str]] = []
+    for kind, token_text, _, _ in tokens:
+        if kind == _SPACE:
+            if collapsed and collapsed[-1][0] == _SPACE:
+                continue
+            token_text = ' '
+        collapsed.append((kind, token_text))
+    if (len(collapsed) >= 2 and collapsed[-1] == (_CHAR,
+                                                  '.')
+            and collapsed[-2][0] == _SPACE):
+        # A sentence-ending period is followed by whitespace (possibly
+        # after comments) and was appended after stripping whitespace.
+        i = end
+        while i >= 0 and text.startswith("(*", i):
+            i = _skip_comment(text, i)
+        if 0 <= i < len(text) and text[i].isspace():
+            del collapsed[-2]
+    return ''.join(token_text for _, token_text in collapsed)
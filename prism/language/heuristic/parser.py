@@ -36,13 +36,14 @@ from prism.interface.coq.options import SerAPIOptions
 from prism.language.gallina.analyze import SexpAnalyzer, SexpInfo
 from prism.language.gallina.parser import CoqParser
 from prism.language.heuristic.assertion import Assertion
+from prism.language.heuristic.lexer import LexedDocument, lex_sentences
 from prism.language.heuristic.str_with_location import StrWithLocation
 from prism.language.heuristic.util import ParserUtils
 from prism.language.sexp.list import SexpList
 from prism.language.sexp.node import SexpNode
 from prism.language.sexp.string import SexpString
 from prism.util.io import Fmt
-from prism.util.iterable import CallableIterator, CompareIterator
+from prism.util.iterable import CompareIterator
 from prism.util.path import get_relative_path
 from prism.util.radpytools import PathLike
 from prism.util.radpytools.dataclasses import default_field
@@ -713,7 +714,8 @@ class HeuristicParser:
         cls,
         file_contents: str,
         skip_sentence_errors: bool = False,
-        return_comments: bool = False
+        return_comments: bool = False,
+        lexed: Optional[LexedDocument] = None
     ) -> Union[List[StrWithLocation],
                Tuple[List[StrWithLocation],
                      List[StrWithLocation]]]:
@@ -731,6 +733,9 @@ class HeuristicParser:
         return_comments : bool, optional
             If True, then return comments in a separate list alongside
             sentences. Otherwise, return only sentences.
+        lexed : Optional[LexedDocument], optional
+            The result of lexing `file_contents` if already known, e.g.,
+            from a `SentenceIndex`, by default None.
 
         Returns
         -------
@@ -739,107 +744,42 @@ class HeuristicParser:
         comments : List[StrWithLocation], optional
             The comments of the Coq document if `return_comments` is
             True.
+
+        Raises
+        ------
+        ValueError
+            If the final sentence lacks an ending period and
+            `skip_sentence_errors` is False.
+
+        Notes
+        -----
+        The document is split by a native lexer (see `lex_sentences`).
+        Each sentence is located by its first and last characters.
         """
-        located_file_contents = StrWithLocation.create_from_file_contents(
-            file_contents)
-        # Remove comments
-        file_contents_no_comments = ParserUtils._strip_comments(
-            located_file_contents,
-            return_comments)
-        comments = None
-        if return_comments:
-            file_contents_no_comments = typing.cast(
-                Tuple[StrWithLocation,
-                      List[StrWithLocation]],
-                file_contents_no_comments)
-            file_contents_no_comments, comments = file_contents_no_comments
-        else:
-            file_contents_no_comments = typing.cast(
-                StrWithLocation,
-                file_contents_no_comments)
-        # Mask notations to avoid accidental splitting on quoted
-        # periods.
-        # TODO: Make a proper lexer/parser; rare notations could still
-        # break this
-        # Mask strings to avoid accidental splitting on quoted periods
-        # or other weird notations.
-        (file_contents_no_comments,
-         strings) = ParserUtils._mask_strings(
-             file_contents_no_comments,
-             cls.string_mask)
-        # Split sentences by instances of single periods followed by
-        # whitespace. Double (or more) periods are specifically
-        # excluded.
-        # Ellipses will be handled later.
-        # Due to the parenthetical grouping, this split keeps the period
-        # characters as separate items between each pair of sentences.
-        sentences = StrWithLocation.re_split(
-            r"(?<!\.)(\.\s)",
-            file_contents_no_comments)
-        # Now perform further splitting of braces, bullets, and ellipses
-        i = 0
-        # re.sub will pull from this automatically to make substitutions
-        string_it = CallableIterator[str](strings)
-        processed_sentences: List[StrWithLocation] = []
-        while i < len(sentences):  # `sentences` length may change
-            try:
-                # Replace any whitespace or group of whitespace with a
-                # single space.
-                sentence = sentences[i]
-                # If the sentence is whitespace only, skip it.
-                if not sentence.strip():
-                    i += 1
-                    continue
-                # If the sentence is just a period, skip it
-                if re.match(r"\.\s", sentence):
-                    i += 1
-                    continue
-                sentence = StrWithLocation.re_sub(r"(\s)+", " ", sentence)
-                sentence = sentence.strip()
-                # restore periods
-                if not sentence.endswith("."):
-                    period = sentences[i + 1][0]
-                    assert str(period) == "."
-                    sentence += period
-                # split braces and bullets
-                (braces_and_bullets,
-                 sentence) = ParserUtils.split_braces_and_bullets(sentence)
-                # split on ellipses
-                new_sentences = StrWithLocation.re_split(r"(\.\.\.)", sentence)
-                new_new_sentences = []
-                for j, new_sentence in enumerate(new_sentences):
-                    if not new_sentence or new_sentence == "...":
-                        continue
-                    elif (j < len(new_sentences) - 1
-                          and new_sentences[j + 1] == "..."):
-                        # Restore the ellipsis if one is present
-                        new_new_sentences.append(
-                            new_sentence + new_sentences[j + 1])
-                    else:
-                        new_new_sentences.append(new_sentence)
-                num_new = len(new_new_sentences) - 1
-                if num_new > 0:
-                    sentences[i : i + 1] = new_new_sentences
-                    sentence = sentences[i]
-                # restore strings
-                sentence = StrWithLocation.re_sub(
-                    cls.string_mask,
-                    string_it,
-                    sentence)
-                processed_sentences.extend(braces_and_bullets)
-                processed_sentences.append(sentence)
-            except Exception as exc:
-                if not skip_sentence_errors:
-                    raise exc
-            i += 1
-        # Lop off the final line if it's just a period, i.e., blank.
-        if processed_sentences[-1] == ".":
-            processed_sentences.pop()
+        if lexed is None:
+            lexed = lex_sentences(file_contents)
+        if lexed.unterminated >= 0 and not skip_sentence_errors:
+            raise ValueError(
+                "Sentence lacks an ending period at offset "
+                f"{lexed.unterminated}")
+        sentences = [
+            StrWithLocation.spanning(sentence,
+                                     beg,
+                                     end)
+            for sentence, (
+                beg,
+                end) in zip(lexed.sentences, lexed.sentence_spans.tolist())
+        ]
         if return_comments:
-            assert comments is not None
-            return processed_sentences, comments
+            located_file_contents = StrWithLocation.create_from_file_contents(
+                file_contents)
+            comments = [
+                located_file_contents[beg : end]
+                for beg, end in lexed.comment_spans.tolist()
+            ]
+            return sentences, comments
         else:
-            return processed_sentences
+            return sentences
 
     @classmethod
     def parse_proofs(
@@ -941,6 +881,7 @@ class HeuristicParser:
         return_locations: bool = False,
         return_comments: bool = False,
         skip_sentence_errors: bool = False,
+        lexed: Optional[LexedDocument] = None,
         **kwargs
     ) -> Union[List[CoqSentence],
                Tuple[List[CoqSentence],
@@ -974,6 +915,9 @@ class HeuristicParser:
             If True, return list of sentences that were successfully
             parsed while ignoring sentences where an exception was
             raised, otherwise raise the exception.
+        lexed : Optional[LexedDocument], optional
+            The result of lexing the `document` if already known, e.g.,
+            from a `SentenceIndex`, by default None.
         kwargs : Dict[str, Any]
             Optional keyword arguments for subclass implementations.
 
@@ -993,7 +937,8 @@ class HeuristicParser:
         sentences = cls._get_sentences(
             file_contents,
             skip_sentence_errors,
-            return_comments)
+            return_comments,
+            lexed)
         comments = None
         if return_comments:
             sentences = typing.cast(
@@ -1045,6 +990,7 @@ class SerAPIParser(HeuristicParser):
         vernac_sentences: List[str],
         sexp_asts: List[SexpNode],
         locations: List[SexpInfo.Loc],
+        is_ltac: Optional[List[bool]] = None,
     ) -> Tuple[List[str],
                List[SexpNode],
                List[SexpInfo.Loc]]:
@@ -1060,6 +1006,10 @@ class SerAPIParser(HeuristicParser):
             in `vernac_sentences`.
         locations : List[SexpInfo.Loc]
             List of locations for each sentence in `vernac_sentences`.
+        is_ltac : Optional[List[bool]], optional
+            Whether each AST in `sexp_asts` comprises Ltac, e.g., as
+            obtained from `CoqParser.parse_vernacs`, by default None, in
+            which case it is determined with `SexpAnalyzer.is_ltac`.
 
         Returns
         -------
@@ -1081,8 +1031,13 @@ class SerAPIParser(HeuristicParser):
         ltac_sentences: List[str] = []
         ltac_asts: List[SexpNode] = []
         ltac_locs: List[SexpInfo.Loc] = []
-        for sentence, ast, loc in zip(vernac_sentences, sexp_asts, locations):
-            if SexpAnalyzer.is_ltac(ast):
+        if is_ltac is None:
+            is_ltac = [SexpAnalyzer.is_ltac(ast) for ast in sexp_asts]
+        for sentence, ast, loc, ltac in zip(vernac_sentences,
+                                            sexp_asts,
+                                            locations,
+                                            is_ltac):
+            if ltac:
                 if not in_ltac_region:
                     # Enter ltac region and create empty buffers
                     in_ltac_region = True
@@ -1216,7 +1171,7 @@ class SerAPIParser(HeuristicParser):
                 "Returning comments alongside sentences is not currently supported."
             )
         source_code = document.source_code
-        unicode_offsets = gu.ParserUtils.get_unicode_offsets(source_code)
+        unicode_offsets = gu.UnicodeOffsetMap(source_code)
         coq_file = document.abspath
         serapi_options: Optional[SerAPIOptions] = kwargs.pop(
             'serapi_options',
@@ -1231,8 +1186,15 @@ class SerAPIParser(HeuristicParser):
                 serapi_options = SerAPIOptions.empty()
         else:
             assert isinstance(serapi_options, SerAPIOptions)
+        is_ltac = None
         with pushd(document.project_path):
-            asts = CoqParser.parse_asts(coq_file, serapi_options, **kwargs)
+            if glom_ltac:
+                asts, _, is_ltac = CoqParser.parse_vernacs(
+                    coq_file,
+                    serapi_options,
+                    **kwargs)
+            else:
+                asts = CoqParser.parse_asts(coq_file, serapi_options, **kwargs)
         # get raw sentences
         sentences = []
         locs = []
@@ -1243,7 +1205,11 @@ class SerAPIParser(HeuristicParser):
             sentences.append(source_code[loc.beg_charno : loc.end_charno])
             locs.append(loc)
         if glom_ltac:
-            sentences, asts, locs = cls._glom_ltac(sentences, asts, locs)
+            sentences, asts, locs = cls._glom_ltac(
+                sentences,
+                asts,
+                locs,
+                is_ltac)
         if glom_proofs:
             stats = cls._compute_sentence_statistics(sentences)
             sentences = cls._glom_proofs(document.index, sentences, stats)
@@ -0,0 +1,244 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+A content-addressed cache of lexed Coq documents.
+"""
+import json
+import os
+from collections import deque
+from concurrent.futures import Future, ThreadPoolExecutor
+from pathlib import Path
+from typing import Deque, Dict, Iterable, Iterator, Optional, Tuple
+
+from prism.language.gallina.parser import CoqParser
+from prism.language.heuristic.lexer import LexedDocument, lex_sentences
+from prism.util.content_cache import ContentCache
+from prism.util.radpytools import PathLike
+
+__all__ = ['SentenceIndex']
+
+
+class SentenceIndex(ContentCache[LexedDocument]):
+    """
+    A cache of lexed documents keyed by a hash of their contents.
+
+    Since identical files share an entry, a file that is unchanged
+    between commits of a project is lexed only once.
+    Manifests mapping the files of a commit to the hashes of their
+    contents can also be stored so that the sentences of a commit may
+    be located without reading its files.
+    """
+
+    version: int = 1
+    """
+    The version of the lexer's output.
+    """
+
+    def _manifest_path(self, key: str) -> Path:
+        assert self.cache_dir is not None
+        return self.cache_dir / "manifests" / f"{key}.json"
+
+    def lex(self, text: str) -> LexedDocument:
+        """
+        Lex a document, consulting the cache first.
+
+        Parameters
+        ----------
+        text : str
+            The contents of a Coq document.
+
+        Returns
+        -------
+        LexedDocument
+            The lexed sentences and comments of the document.
+        """
+        return self._lex(self.digest(text), text)
+
+    def _lex(self, digest: str, text: str) -> LexedDocument:
+        # lexing releases the GIL
+        return self.get_or_compute(digest, lambda: lex_sentences(text))
+
+    def lex_file(self, filename: PathLike) -> str:
+        """
+        Lex a file, consulting the cache first.
+
+        Parameters
+        ----------
+        filename : PathLike
+            The path to a Coq source file.
+
+        Returns
+        -------
+        str
+            The hash of the file's contents, by which its lexed
+            document may be retrieved with `get`.
+        """
+        digest, _ = self._lex_file(filename)
+        return digest
+
+    def _lex_file(self, filename: PathLike) -> Tuple[str, LexedDocument]:
+        text = CoqParser.parse_source(filename)
+        digest = self.digest(text)
+        return digest, self._lex(digest, text)
+
+    def lex_files(
+            self,
+            filenames: Iterable[PathLike],
+            max_workers: Optional[int] = None) -> Dict[str,
+                                                       str]:
+        """
+        Lex files in parallel, consulting the cache first.
+
+        Parameters
+        ----------
+        filenames : Iterable[PathLike]
+            Paths to Coq source files.
+        max_workers : Optional[int], optional
+            The maximum number of files to lex at once, by default the
+            number of processors.
+
+        Returns
+        -------
+        Dict[str, str]
+            A map from each of the given filenames to the hash of its
+            contents.
+
+        Raises
+        ------
+        OSError
+            If a file cannot be read.
+        UnicodeDecodeError
+            If a file cannot be decoded.
+        """
+        return {
+            filename: digest for filename, digest, _ in self.lex_files_iter(
+                filenames, max_workers)
+        }
+
+    def lex_files_iter(
+        self,
+        filenames: Iterable[PathLike],
+        max_workers: Optional[int] = None
+    ) -> Iterator[Tuple[str,
+                        str,
+                        LexedDocument]]:
+        """
+        Lex files in parallel and yield their lexed documents.
+
+        Unlike `lex_files`, the lexed documents are yielded directly, so
+        they need not remain in the bounded in-memory cache until they
+        are retrieved.
+        Only a few files are lexed ahead of the consumer.
+
+        Parameters
+        ----------
+        filenames : Iterable[PathLike]
+            Paths to Coq source files.
+        max_workers : Optional[int], optional
+            The maximum number of files to lex at once, by default the
+            number of processors.
+
+        Yields
+        ------
+        filename : str
+            One of the given filenames in the given order.
+        digest : str
+            The hash of the file's contents.
+        document : LexedDocument
+            The file's lexed sentences and comments.
+
+        Raises
+        ------
+        OSError
+            If a file cannot be read.
+        UnicodeDecodeError
+            If a file cannot be decoded.
+        """
+        if max_workers is None:
+            max_workers = os.cpu_count() or 1
+        with ThreadPoolExecutor(max_workers=max_workers) as executor:
+            pending: Deque[Tuple[str,
+                                 Future[Tuple[str,
+                                              LexedDocument]]]] = deque()
+            for filename in filenames:
+                filename = str(filename)
+                pending.append(
+                    (filename,
+                     executor.submit(self._lex_file,
+                                     filename)))
+                if len(pending) > 2 * max_workers:
+                    filename, future = pending.popleft()
+                    yield (filename, *future.result())
+            while pending:
+                filename, future = pending.popleft()
+                yield (filename, *future.result())
+
+    def load_manifest(self, key: str) -> Optional[Dict[str, str]]:
+        """
+        Load a map from filenames to content hashes.
+
+        Parameters
+        ----------
+        key : str
+            The key under which the manifest was saved, e.g., a commit
+            SHA.
+
+        Returns
+        -------
+        Optional[Dict[str, str]]
+            The manifest or None if no manifest was saved under `key`
+            or there is no cache directory.
+        """
+        if self.cache_dir is None:
+            return None
+        try:
+            with open(self._manifest_path(key), "r") as f:
+                return json.load(f)
+        except FileNotFoundError:
+            return None
+
+    def save_manifest(self, key: str, manifest: Dict[str, str]) -> None:
+        """
+        Save a map from filenames to content hashes.
+
+        Nothing is saved if there is no cache directory.
+
+        Parameters
+        ----------
+        key : str
+            The key under which to save the manifest, e.g., a commit
+            SHA.
+        manifest : Dict[str, str]
+            A map from filenames to content hashes such as that
+            returned by `lex_files`.
+        """
+        if self.cache_dir is not None:
+            self._write(
+                self._manifest_path(key),
+                json.dumps(manifest,
+                           sort_keys=True).encode('utf-8'))
+
+    @staticmethod
+    def digest(text: str) -> str:
+        """
+        Hash the contents of a document encoded as UTF-8.
+        """
+        return ContentCache.digest(text.encode('utf-8', 'surrogatepass'))
@@ -23,10 +23,10 @@ Module providing a class that ties strings to original file locations.
 """
 import math
 import re
+import struct
 import warnings
-from dataclasses import dataclass
+from array import array
 from functools import cached_property
-from itertools import repeat
 from typing import (
     Callable,
     ClassVar,
@@ -39,12 +39,225 @@ from typing import (
 )
 
 from prism.language.gallina.analyze import SexpInfo
+from prism.language.heuristic._str_with_location import (
+    concat_segments,
+    encode_indices,
+    segment_bounds,
+    slice_segments,
+    split_segments,
+    spread_segments,
+    substitute_segments,
+)
 from prism.util.radpytools import PathLike
-from prism.util.radpytools.dataclasses import default_field
-from prism.util.string import escape_backslash
+
+Segment = Tuple[int, int, int]
+"""
+A run of ``length`` consecutive characters located at ``(start + k,
+start + k + width)`` for ``k`` in ``range(length)``, given as a tuple
+``(length, start, width)``.
+"""
+
+_segment_struct = struct.Struct("=qqq")
+"""
+The packed form of a `Segment`.
+"""
+
+
+def _pack_segments(segments: Iterable[Segment]) -> bytes:
+    return b''.join(_segment_struct.pack(*segment) for segment in segments)
+
+
+def _unpack_segments(packed: bytes) -> List[Segment]:
+    return list(_segment_struct.iter_unpack(packed))
+
+
+def _append_segment(
+        segments: List[Segment],
+        length: int,
+        start: int,
+        width: int) -> None:
+    """
+    Append a segment, merging it with the last one if they are collinear.
+    """
+    if length <= 0:
+        return
+    if segments:
+        last_length, last_start, last_width = segments[-1]
+        if last_width == width and last_start + last_length == start:
+            segments[-1] = (last_length + length, last_start, width)
+            return
+    segments.append((length, start, width))
+
+
+def _slice(segments: List[Segment], start: int, stop: int) -> List[Segment]:
+    """
+    Get the segments of the characters ``[start, stop)``.
+    """
+    result: List[Segment] = []
+    offset = 0
+    for length, seg_start, width in segments:
+        k0 = max(start - offset, 0)
+        k1 = min(stop - offset, length)
+        if k0 < k1:
+            result.append((k1 - k0, seg_start + k0, width))
+        offset += length
+    return result
+
+
+def _bounds(segments: List[Segment]) -> Optional[Tuple[int, int]]:
+    """
+    Get the least start and greatest end of the segments, if any.
+    """
+    if not segments:
+        return None
+    return (
+        min(start for _, start, _ in segments),
+        max(start + length - 1 + width for length, start, width in segments))
+
+
+def _py_encode_indices(indices: Iterable[Tuple[int, int]]) -> bytes:
+    """
+    Validate per-character indices and encode them as segments.
+
+    This is the reference implementation of `encode_indices`.
+
+    Raises
+    ------
+    TypeError
+        If an index is not a tuple.
+    ValueError
+        If an index is not a pair of ascending locations.
+    """
+    segments: List[Segment] = []
+    for ind in indices:
+        if not isinstance(ind, tuple):
+            raise TypeError(
+                "'indices' attribute contains object that is not a tuple. "
+                f"The incorrect type is {type(ind)}.")
+        if len(ind) != 2 or ind[0] > ind[1]:
+            raise ValueError(
+                f"Expected two locations in ascending order, got {ind}")
+        start, end = ind
+        _append_segment(segments, 1, start, end - start)
+    return _pack_segments(segments)
+
+
+def _py_slice_segments(packed: bytes, start: int, stop: int) -> bytes:
+    """
+    Get the segments of a slice of a located string.
+
+    This is the reference implementation of `slice_segments`.
+    """
+    return _pack_segments(_slice(_unpack_segments(packed), start, stop))
+
+
+def _py_split_segments(packed: bytes, bounds: bytes) -> List[bytes]:
+    """
+    Get the segments of each of a buffer of slices of a located string.
+
+    This is the reference implementation of `split_segments`.
+    """
+    segments = _unpack_segments(packed)
+    bounds = array('q', bounds)
+    return [
+        _pack_segments(_slice(segments,
+                              bounds[i],
+                              bounds[i + 1])) for i in range(0, len(bounds), 2)
+    ]
+
+
+def _py_spread_segments(length: int, start: int, end: int) -> bytes:
+    """
+    Get the segments of characters spread evenly over an interval.
+
+    This is the reference implementation of `spread_segments`.
+    """
+    segments: List[Segment] = []
+    if length > 0:
+        step = (end - start) / length
+        for i in range(length):
+            char_start = start + math.floor(i * step)
+            char_end = min(end, start + math.ceil((i + 1) * step))
+            _append_segment(segments, 1, char_start, char_end - char_start)
+    return _pack_segments(segments)
+
+
+def _py_substitute_segments(packed: bytes, subs: bytes) -> bytes:
+    """
+    Get the segments of a located string after substitutions.
+
+    This is the reference implementation of `substitute_segments`.
+
+    Parameters
+    ----------
+    packed : bytes
+        The segments of the located string.
+    subs : bytes
+        A buffer of 64-bit integer triples ``(match_start, match_end,
+        length)`` indicating that the characters ``[match_start,
+        match_end)`` are replaced with ``length`` characters, in order.
+
+    Raises
+    ------
+    ValueError
+        If a nonempty substitution is made in an empty string.
+    """
+    segments = _unpack_segments(packed)
+    total = sum(length for length, _, _ in segments)
+    subs = array('q', subs)
+    result: List[Segment] = []
+    prev = 0
+    for i in range(0, len(subs), 3):
+        match_start, match_end, length = subs[i : i + 3]
+        for segment in _slice(segments, prev, match_start):
+            _append_segment(result, *segment)
+        if length > 0:
+            if match_start < match_end:
+                bounds = _bounds(_slice(segments, match_start, match_end))
+            elif match_start < total:
+                # an empty match precedes the next character
+                bounds = _bounds(_slice(segments, match_start, match_start + 1))
+                assert bounds is not None
+                bounds = (bounds[0], bounds[0])
+            elif segments:
+                bounds = _bounds(segments)
+                assert bounds is not None
+                bounds = (bounds[1], bounds[1])
+            else:
+                raise ValueError(
+                    "Cannot locate a substitution in an empty string")
+            assert bounds is not None
+            for segment in _unpack_segments(_py_spread_segments(length,
+                                                                *bounds)):
+                _append_segment(result, *segment)
+        prev = match_end
+    for segment in _slice(segments, prev, total):
+        _append_segment(result, *segment)
+    return _pack_segments(result)
+
+
+def _py_concat_segments(parts: Iterable[bytes]) -> bytes:
+    """
+    Get the segments of a concatenation of located strings.
+
+    This is the reference implementation of `concat_segments`.
+    """
+    result: List[Segment] = []
+    for part in parts:
+        for segment in _unpack_segments(part):
+            _append_segment(result, *segment)
+    return _pack_segments(result)
+
+
+def _py_segment_bounds(packed: bytes) -> Optional[Tuple[int, int]]:
+    """
+    Get the least start and greatest end of the segments, if any.
+
+    This is the reference implementation of `segment_bounds`.
+    """
+    return _bounds(_unpack_segments(packed))
 
 
-@dataclass(frozen=True, init=False)
 class StrWithLocation(str):
     """
     Class that ties strings to their original in-file locations.
@@ -56,21 +269,19 @@ class StrWithLocation(str):
     If a string spans multiple lines, it is assumed that the newline
     and other whitespace characters that situate the lines are
     present in the string.
+
+    Locations are stored natively as a minimal sequence of
+    piecewise-linear segments (see `Segment`) rather than as one
+    interval per character, so slicing, joining, stripping, splitting,
+    and substitution take time linear in the number of segments rather
+    than the number of characters.
+    A string read verbatim from a file is a single segment.
     """
 
-    indices: List[Tuple[int, int]] = default_field(list())
+    _segments: bytes
     """
-    Indices that refer to the string's original location in the full
-    document string. Each index in the outer list corresponds to the
-    same index in the string. Each tuple in the indices list represents
-    an open interval (start, end) indicating the index or indices in the
-    original document the correponsding string components come from.
-
-    If a tuple in this list does not take the form (i, i+1), it is
-    likely because a substitution has been made such that the string-to-
-    indices correspondence is no longer exact. A tuple of (3, 8) for
-    instance might arise from replacing a substring of length 5 with a
-    single character.
+    The packed canonical segment encoding of `indices`: no segment is
+    empty and no two adjacent segments are collinear.
     """
     _bol_matcher: ClassVar[re.Pattern] = re.compile(
         r"(?:^|\n)([^\n])[^\n]*\n*$")
@@ -102,52 +313,40 @@ class StrWithLocation(str):
         -------
         StrWithLocation
             The newly-constructed `StrWithLocation` object
-        """
-        if indices is None:
-            indices = []
-        result = super().__new__(cls, string, *args, **kwargs)
-        object.__setattr__(result, 'indices', indices)
-        return result
-
-    def __init__(self, *args_ignore, **kwargs_ignore):
-        """
-        Provide dummy __init__.
-
-        The __init__ function will inevitably be called, since __new__
-        returns an instance of the object, but we don't actually need it
-        to do anything.
-        """
-        self.__post_init__()
-
-    def __post_init__(self):
-        """
-        Verify inputs.
 
         Raises
         ------
         ValueError
-            If the length of the string list does not match the
-            length of the loc list
+            If the length of the string does not match the number of
+            indices or if an index is not a pair of ascending locations
+        TypeError
+            If an index is not a tuple
         """
-        if len(self) != len(self.indices):
+        result = super().__new__(cls, string, *args, **kwargs)
+        segments = encode_indices(indices) if indices is not None else b''
+        result._segments = segments
+        if len(result) != sum(length for length, _, _ in result.segments):
             raise ValueError("Each character should have a location.")
-        for ind in self.indices:
-            if not isinstance(ind, tuple):
-                raise TypeError(
-                    "'indices' attribute contains object that is not a tuple. "
-                    f"The incorrect type is {type(ind)}.")
-            if len(ind) != 2 or ind[0] > ind[1]:
-                raise ValueError(
-                    f"Expected two locations in ascending order, got {ind}")
+        return result
+
+    @classmethod
+    def _from_segments(cls, string: str, segments: bytes) -> 'StrWithLocation':
+        """
+        Construct an instance directly from packed canonical segments.
+        """
+        result = str.__new__(cls, string)
+        result._segments = segments
+        return result
 
     def __add__(self, other: str) -> 'StrWithLocation':
         """
         Combine this instance with another using '+'.
         """
         if isinstance(other, StrWithLocation):
-            return StrWithLocation(
+            return self._from_segments(
                 str(self) + str(other),
-                self.indices + other.indices)
+                concat_segments([self._segments,
+                                 other._segments]))
         else:
             return NotImplemented
 
@@ -155,14 +354,16 @@ class StrWithLocation(str):
         """
         Test equality of objects.
         """
-        if isinstance(other, str) and not hasattr(other, 'indices'):
+        if isinstance(other, str) and not isinstance(other, StrWithLocation):
             # i.e., other is an actual str
             return str(self) == other
         elif isinstance(other, StrWithLocation):
-            return str(self) == str(other) and self.indices == other.indices
+            return str(self) == str(other) and self._segments == other._segments
         else:
             return NotImplemented
 
+    __hash__ = str.__hash__
+
     def __getitem__(
             self,
             idx: Union[SupportsIndex,
@@ -170,24 +371,88 @@ class StrWithLocation(str):
         """
         Return a portion of the located string at the given idx.
         """
-        new_indices = self.indices.__getitem__(idx)
-        if isinstance(new_indices, tuple):
-            new_indices = [new_indices]
-        return StrWithLocation(super().__getitem__(idx), new_indices)
+        string = super().__getitem__(idx)
+        if isinstance(idx, slice):
+            start, stop, step = idx.indices(len(self))
+            if step != 1:
+                return StrWithLocation(string, self.indices[idx])
+        else:
+            start = idx.__index__()
+            if start < 0:
+                start += len(self)
+            stop = start + 1
+        return self._from_segments(
+            string,
+            slice_segments(self._segments,
+                           start,
+                           stop))
+
+    def __reduce__(self):
+        """
+        Pickle the string with its segments.
+        """
+        return (self._from_segments, (str(self), self._segments))
+
+    def __repr__(self) -> str:
+        """
+        Represent the string with its segments.
+        """
+        return f"{type(self).__name__}({str(self)!r}, segments={self.segments})"
+
+    @property
+    def segments(self) -> List[Segment]:
+        """
+        Get the canonical segment encoding of `indices`.
+        """
+        return _unpack_segments(self._segments)
+
+    @property
+    def indices(self) -> List[Tuple[int, int]]:
+        """
+        Get the indices that refer to the string's original location.
+
+        Each index in the outer list corresponds to the same index in
+        the string. Each tuple in the indices list represents an open
+        interval (start, end) indicating the index or indices in the
+        original document the correponsding string components come from.
+
+        If a tuple in this list does not take the form (i, i+1), it is
+        likely because a substitution has been made such that the
+        string-to-indices correspondence is no longer exact. A tuple of
+        (3, 8) for instance might arise from replacing a substring of
+        length 5 with a single character.
+
+        The list is expanded from `segments` upon each access.
+        """
+        return [
+            (start + k,
+             start + k + width)
+            for length, start, width in self.segments
+            for k in range(length)
+        ]
 
     @cached_property
+    def _bounds(self) -> Optional[Tuple[int, int]]:
+        """
+        Get the least start and greatest end of the indices, if any.
+        """
+        return segment_bounds(self._segments)
+
+    @property
     def start(self) -> Optional[int]:
         """
         Get the least first index in the indices list.
         """
-        return min([x for x, _ in self.indices]) if self.indices else None
+        bounds = self._bounds
+        return bounds[0] if bounds is not None else None
 
-    @cached_property
+    @property
     def end(self) -> Optional[int]:
         """
         Get the largest second index in the indices list.
         """
-        return max([x for _, x in self.indices]) if self.indices else None
+        bounds = self._bounds
+        return bounds[1] if bounds is not None else None
 
     def get_location(
             self,
@@ -278,17 +543,15 @@ class StrWithLocation(str):
         # make a copy of input in case it can only be iterated once
         it = list(it)
         str_part = super().join(it)
-        indices_part = []
+        parts = []
         for i, item in enumerate(it):
             if not isinstance(item, StrWithLocation):
                 raise NotImplementedError(
                     f"Joining with type {type(item)} not implemented.")
-            if i < len(it) - 1:
-                indices_part.extend(item.indices)
-                indices_part.extend(self.indices)
-            else:
-                indices_part.extend(item.indices)
-        return StrWithLocation(str_part, indices_part)
+            if i > 0:
+                parts.append(self._segments)
+            parts.append(item._segments)
+        return self._from_segments(str_part, concat_segments(parts))
 
     def lstrip(self, s: Optional[str] = None) -> 'StrWithLocation':
         """
@@ -299,7 +562,11 @@ class StrWithLocation(str):
                 "Stripping of given strings not implemented.")
         stripped = super().lstrip()
         len_to_strip = len(self) - len(stripped)
-        return StrWithLocation(stripped, self.indices[len_to_strip :])
+        return self._from_segments(
+            stripped,
+            slice_segments(self._segments,
+                           len_to_strip,
+                           len(self)))
 
     def rstrip(self, s: Optional[str] = None) -> 'StrWithLocation':
         """
@@ -309,9 +576,11 @@ class StrWithLocation(str):
             raise NotImplementedError(
                 "Stripping of given strings not implemented.")
         stripped = super().rstrip()
-        len_to_strip = len(self) - len(stripped)
-        end_idx = -1 * len_to_strip if len_to_strip > 0 else None
-        return StrWithLocation(stripped, self.indices[: end_idx])
+        return self._from_segments(
+            stripped,
+            slice_segments(self._segments,
+                           0,
+                           len(stripped)))
 
     def strip(self, s: Optional[str] = None) -> 'StrWithLocation':
         """
@@ -335,10 +604,38 @@ class StrWithLocation(str):
         StrWithLocation
             The instance created from the file contents
         """
-        return cls(
+        return cls._from_segments(
             file_contents,
-            [(i,
-              i + 1) for i in range(len(file_contents))])
+            _pack_segments([(len(file_contents),
+                             0,
+                             1)]) if file_contents else b'')
+
+    @classmethod
+    def spanning(cls, string: str, start: int, end: int) -> 'StrWithLocation':
+        """
+        Spread a string evenly over an interval of a document.
+
+        Parameters
+        ----------
+        string : str
+            A string that replaces the original text in the interval.
+        start : int
+            The start of the interval.
+        end : int
+            The (exclusive) end of the interval.
+
+        Returns
+        -------
+        StrWithLocation
+            The string such that the ``i``-th character is located at
+            ``(start + floor(i * step), min(end, start + ceil((i + 1) *
+            step)))``, where ``step = (end - start) / len(string)``.
+        """
+        return cls._from_segments(
+            string,
+            spread_segments(len(string),
+                            start,
+                            end))
 
     @classmethod
     def re_split(
@@ -369,22 +666,32 @@ class StrWithLocation(str):
         -------
         List[StrWithLocation]
             A list of strings with locations after being split by
-            the pattern
+            the pattern.
+            As with `re.split`, groups of the pattern that do not
+            participate in a match yield None.
         """
         if isinstance(pattern, str):
             pattern = re.compile(pattern, flags)
-        located_result: List[StrWithLocation] = []
-        string = cls(str(string), string.indices)
-        split_list = pattern.split(string, maxsplit=maxsplit)
-        match_start_pos = 0
-        for split in split_list:
-            match_start = string.index(split, match_start_pos)
-            match_end = match_start + len(split)
-            located_result.append(
-                cls(split,
-                    string.indices[match_start : match_end]))
-            match_start_pos = match_end
-        return located_result
+        # collect the bounds of each piece and locate them in one pass
+        bounds = array('q')
+        prev_end = 0
+        for i, match in enumerate(pattern.finditer(string)):
+            if maxsplit > 0 and i >= maxsplit:
+                break
+            bounds.extend((prev_end, match.start()))
+            for group in range(1, pattern.groups + 1):
+                bounds.extend(match.span(group))
+            prev_end = match.end()
+        bounds.extend((prev_end, len(string)))
+        pieces = split_segments(string._segments, bounds.tobytes())
+        return [
+            None if bounds[2 * i] < 0 else StrWithLocation._from_segments(
+                str.__getitem__(
+                    string,
+                    slice(bounds[2 * i],
+                          bounds[2 * i + 1])),
+                segments) for i, segments in enumerate(pieces)
+        ]  # type: ignore
 
     @classmethod
     def re_sub(
@@ -413,6 +720,8 @@ class StrWithLocation(str):
         repl : Union[str, Callable[[re.Match], str]]]
             String to substitute in when pattern is found or a function
             with which to compute a substitution given a match.
+            A string is substituted literally, i.e., backslash escapes
+            and group references are not processed.
         string : StrWithLocation
             The string to perform the substitution on
         count : int, optional
@@ -425,60 +734,40 @@ class StrWithLocation(str):
         Returns
         -------
         StrWithLocation
-            Located string with substitution performed
+            Located string with substitution performed.
+            Each substitution is spread evenly over the location of the
+            text it replaces (see `spanning`); a substitution for an
+            empty match is located at a zero-width interval preceding
+            the next character (or following the last one).
+
+        Raises
+        ------
+        ValueError
+            If a nonempty substitution would be made in an empty string,
+            which has no location.
         """
         if repl == "":
             warnings.warn(
                 "Substituting in an empty string will cause location "
                 "information where the empty string is substituted to"
                 " be lost.")
-        string = cls(str(string), string.indices)
         if isinstance(pattern, str):
             pattern = re.compile(pattern, flags)
-        match = pattern.search(string)
-        if not match:
-            return string
-        repls: Iterable[str]
-        if callable(repl):
-            repls = []
-
-            def _repl(match: re.Match, repl=repl) -> str:
-                nonlocal repls
-                sub = repl(match)
-                repls.append(sub)  # type: ignore
-                return sub
-
-            repl = _repl
-        else:
-            repls = repeat(repl)
-            repl = escape_backslash(repl)
-
-        subbed_string = pattern.sub(repl, string, count)
-        subbed_indices = []
+        # collect the substitutions and locate them in one pass
+        pieces: List[str] = []
+        subs = array('q')
         prev_end = 0
-        idx = 0
-        for match, repl in zip(pattern.finditer(string), repls):
-            if count > 0 and idx >= count:
+        for i, match in enumerate(pattern.finditer(string)):
+            if count > 0 and i >= count:
                 break
-            else:
-                # Get the indices prior to subbed location
-                subbed_indices.extend(string.indices[prev_end : match.start()])
-                # Get the indices for the next subbed location
-                subbed = string[match.start(): match.end()]
-                start = subbed.start
-                end = subbed.end
-                assert start is not None
-                assert end is not None
-                step = (end - start) / len(repl)
-                subbed_indices.extend(
-                    [
-                        (
-                            start + math.floor(i * step),
-                            min(end,
-                                start + math.ceil((i + 1) * step)))
-                        for i in range(len(repl))
-                    ])
-                prev_end = match.end()
-                idx += 1
-        subbed_indices.extend(string.indices[prev_end :])
-        return cls(subbed_string, subbed_indices)
+            match_start, match_end = match.span()
+            pieces.append(str.__getitem__(string, slice(prev_end, match_start)))
+            sub = repl(match) if callable(repl) else repl
+            pieces.append(sub)
+            subs.extend((match_start, match_end, len(sub)))
+            prev_end = match_end
+        pieces.append(str.__getitem__(string, slice(prev_end, None)))
+        return cls._from_segments(
+            ''.join(pieces),
+            substitute_segments(string._segments,
+                                subs.tobytes()))
@@ -0,0 +1,173 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the lexer module.
+"""
+import random
+import unittest
+
+from prism.language.heuristic import lexer
+from prism.language.heuristic._lexer import lex_sentences as native_lex
+from prism.language.heuristic.lexer import lex_sentences
+from prism.language.heuristic.parser import HeuristicParser
+
+
+class TestLexer(unittest.TestCase):
+    """
+    Tests for `lex_sentences`.
+    """
+
+    def _spans(self, text: str):
+        lexed = lex_sentences(text)
+        return [
+            (sentence,
+             text[beg : end]) for sentence, (
+                 beg,
+                 end) in zip(lexed.sentences, lexed.sentence_spans.tolist())
+        ]
+
+    def test_sentences(self):
+        """
+        Verify that sentences, braces, bullets, and ellipses are split.
+        """
+        text = (
+            "Lemma foo : forall x,\n  x = x.\nProof.\n"
+            "  intros.\n  - { auto...\n  reflexivity. }\n"
+            "  ++ simpl;   auto.\nQed.")
+        self.assertEqual(
+            lex_sentences(text).sentences,
+            [
+                "Lemma foo : forall x, x = x.",
+                "Proof.",
+                "intros.",
+                "-",
+                "{",
+                "auto...",
+                "reflexivity.",
+                "}",
+                "++",
+                "simpl; auto.",
+                "Qed."
+            ])
+        for sentence, source in self._spans(text):
+            self.assertEqual(source.split(), sentence.split())
+        self.assertEqual(lex_sentences(text).unterminated, -1)
+
+    def test_comments_and_strings(self):
+        """
+        Verify that comments and strings are lexed as Coq does.
+        """
+        text = (
+            'Definition x := "a. (* b". (* c (* d *) "*)" . *)\n'
+            'Notation "x .. y" := (x y). (* e *)')
+        lexed = lex_sentences(text)
+        self.assertEqual(
+            lexed.sentences,
+            ['Definition x := "a. (* b".',
+             'Notation "x .. y" := (x y).'])
+        self.assertEqual(
+            [text[beg : end] for beg, end in lexed.comment_spans.tolist()],
+            ['(* c (* d *) "*)" . *)',
+             '(* e *)'])
+        lexed = lex_sentences('Check "a""b". Check (c^*).')
+        self.assertEqual(lexed.sentences, ['Check "a""b".', 'Check (c^*).'])
+
+    def test_unterminated(self):
+        """
+        Verify that a trailing sentence without a period is reported.
+        """
+        lexed = lex_sentences("Check a.\n  Check b (* c. *)\n")
+        self.assertEqual(lexed.sentences, ["Check a."])
+        self.assertEqual(lexed.unterminated, 11)
+        lexed = lex_sentences("Check a. (* unterminated. ")
+        self.assertEqual(lexed.sentences, ["Check a."])
+        self.assertEqual(lexed.comment_spans.shape, (0, 2))
+        self.assertEqual(lex_sentences("").sentences, [])
+        with self.assertRaises(ValueError):
+            HeuristicParser._get_sentences("Check a. Check b")
+        self.assertEqual(
+            HeuristicParser._get_sentences(
+                "Check a. Check b",
+                skip_sentence_errors=True),
+            ["Check a."])
+
+    def test_native(self):
+        """
+        Verify the native lexer against the reference implementation.
+        """
+        rng = random.Random(0)
+        alphabet = [
+            '.',
+            '.',
+            ' ',
+            '\n',
+            '　',
+            '-',
+            '+',
+            '*',
+            '{',
+            '}',
+            '"',
+            '(',
+            ')',
+            'a',
+            'é',
+            '(*',
+            '*)',
+            '...',
+        ]
+        for _ in range(5000):
+            text = ''.join(
+                rng.choice(alphabet) for _ in range(rng.randint(0, 30)))
+            self.assertEqual(native_lex(text), lexer._py_lex_sentences(text))
+
+    def test_sentence_text(self):
+        """
+        Verify that sentences are recovered from their spans.
+        """
+        rng = random.Random(0)
+        alphabet = [
+            '.',
+            ' . ',
+            ' ',
+            '\n',
+            '-',
+            '*',
+            '{',
+            '}',
+            '"',
+            'a',
+            '(* c *)',
+            '(*',
+            '*)',
+            '...',
+        ]
+        for _ in range(5000):
+            text = ''.join(
+                rng.choice(alphabet) for _ in range(rng.randint(0, 30)))
+            lexed = lex_sentences(text)
+            for sentence, (beg, end) in zip(lexed.sentences,
+                                            lexed.sentence_spans.tolist()):
+                self.assertEqual(lexer.sentence_text(text, beg, end), sentence)
+
+
+if __name__ == '__main__':
+    unittest.main()
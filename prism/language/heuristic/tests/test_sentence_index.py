@@ -0,0 +1,124 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the sentence_index module.
+"""
+import tempfile
+import unittest
+from pathlib import Path
+
+from prism.data.document import CoqDocument
+from prism.language.heuristic.lexer import lex_sentences
+from prism.language.heuristic.parser import HeuristicParser
+from prism.language.heuristic.sentence_index import SentenceIndex
+from prism.tests import _COQ_EXAMPLES_PATH
+
+
+class TestSentenceIndex(unittest.TestCase):
+    """
+    Tests for `SentenceIndex`.
+    """
+
+    def setUp(self) -> None:
+        """
+        Gather example Coq files.
+        """
+        self.files = sorted(Path(_COQ_EXAMPLES_PATH).glob("*.v"))
+
+    def test_lex(self):
+        """
+        Verify that lexed documents are cached by content.
+        """
+        index = SentenceIndex()
+        text = "Lemma foo : True.\nProof. auto. Qed.\n"
+        lexed = index.lex(text)
+        self.assertIs(index.lex(str(text)), lexed)
+        self.assertEqual(len(index), 1)
+        self.assertEqual(lexed.sentences, lex_sentences(text).sentences)
+        self.assertIs(index.get(index.digest(text)), lexed)
+        self.assertIsNone(index.get(index.digest(text + " ")))
+
+    def test_lex_files(self):
+        """
+        Verify that files are lexed in parallel and persist on disk.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            index = SentenceIndex(tmpdir)
+            manifest = index.lex_files(self.files, max_workers=4)
+            self.assertEqual(list(manifest), [str(f) for f in self.files])
+            index.save_manifest("abc", manifest)
+            # a new index reads the cache directory
+            index = SentenceIndex(tmpdir)
+            self.assertEqual(index.load_manifest("abc"), manifest)
+            self.assertIsNone(index.load_manifest("def"))
+            for filename, digest in manifest.items():
+                with open(filename, "r") as f:
+                    text = f.read()
+                expected = lex_sentences(text)
+                lexed = index.get(digest)
+                self.assertIsNotNone(lexed)
+                self.assertEqual(lexed.sentences, expected.sentences)
+                self.assertEqual(
+                    lexed.sentence_spans.tolist(),
+                    expected.sentence_spans.tolist())
+                self.assertEqual(
+                    lexed.comment_spans.tolist(),
+                    expected.comment_spans.tolist())
+        self.assertIsNone(SentenceIndex().load_manifest("abc"))
+        # documents are yielded even if the cache cannot hold them
+        index = SentenceIndex(maxsize=1)
+        lexed_files = list(index.lex_files_iter(self.files, max_workers=2))
+        self.assertEqual([f for f, _, _ in lexed_files], list(manifest))
+        self.assertEqual(len(index), 1)
+        for filename, digest, lexed in lexed_files:
+            self.assertEqual(digest, manifest[filename])
+            with open(filename, "r") as f:
+                self.assertEqual(
+                    lexed.sentences,
+                    lex_sentences(f.read()).sentences)
+
+    def test_parser(self):
+        """
+        Verify that parsing from cached lexing results is unchanged.
+        """
+        index = SentenceIndex()
+        for filename in self.files:
+            with open(filename, "r") as f:
+                document = CoqDocument(filename.name, f.read())
+            for return_locations in [True, False]:
+                expected = HeuristicParser.parse_sentences_from_document(
+                    document,
+                    glom_proofs=False,
+                    return_locations=return_locations,
+                    return_comments=True,
+                    skip_sentence_errors=True)
+                actual = HeuristicParser.parse_sentences_from_document(
+                    document,
+                    glom_proofs=False,
+                    return_locations=return_locations,
+                    return_comments=True,
+                    skip_sentence_errors=True,
+                    lexed=index.lex(document.source_code))
+                self.assertEqual(actual, expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
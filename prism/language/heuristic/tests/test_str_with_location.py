@@ -21,13 +21,18 @@
 """
 Tests for the StrWithLocation class.
 """
+import pickle
+import random
+import re
 import unittest
+from array import array
 from pathlib import Path
 
 from prism.data.document import CoqDocument
 from prism.interface.coq.options import SerAPIOptions
 from prism.language.gallina.analyze import SexpInfo
 from prism.language.gallina.parser import CoqParser
+from prism.language.heuristic import str_with_location
 from prism.language.heuristic.str_with_location import StrWithLocation
 from prism.tests import _COQ_EXAMPLES_PATH
 
@@ -258,6 +263,147 @@ class TestStrWithLocation(unittest.TestCase):
         # have an assertion in the test.
         self.assertIsInstance(loc, SexpInfo.Loc)
 
+    def test_segments(self):
+        """
+        Verify that locations are encoded as canonical segments.
+        """
+        self.assertEqual(self.example.segments, [(43, 0, 1)])
+        self.assertEqual(StrWithLocation().segments, [])
+        example = StrWithLocation("abcd", [(0, 1), (1, 2), (5, 8), (6, 9)])
+        self.assertEqual(example.segments, [(2, 0, 1), (2, 5, 3)])
+        self.assertEqual(example.indices, [(0, 1), (1, 2), (5, 8), (6, 9)])
+        self.assertEqual(example.start, 0)
+        self.assertEqual(example.end, 9)
+        self.assertEqual(example[1 : 3].indices, [(1, 2), (5, 8)])
+        self.assertEqual(example[-1].indices, [(6, 9)])
+        self.assertEqual(example[:: 2].indices, [(0, 1), (5, 8)])
+        self.assertEqual(example[: 2] + example[2 :], example)
+        self.assertEqual(pickle.loads(pickle.dumps(example)), example)
+        with self.assertRaises(ValueError):
+            StrWithLocation("ab", [(0, 1)])
+        with self.assertRaises(ValueError):
+            StrWithLocation("a", [(1, 0)])
+        with self.assertRaises(TypeError):
+            StrWithLocation("a", [[0, 1]])
+
+    def test_re_split_repeated_text(self):
+        """
+        Verify that split pieces are located where they were matched.
+        """
+        example = StrWithLocation.create_from_file_contents("aba")
+        result = StrWithLocation.re_split(r"(b)|(c)", example)
+        self.assertEqual(result[0].indices, [(0, 1)])
+        self.assertEqual(result[1].indices, [(1, 2)])
+        self.assertIsNone(result[2])
+        self.assertEqual(result[3].indices, [(2, 3)])
+        result = StrWithLocation.re_split("a", example, maxsplit=1)
+        self.assertEqual(result, ["", "ba"])
+        self.assertEqual(result[1].indices, [(1, 2), (2, 3)])
+
+    def test_native(self):
+        """
+        Verify native segment operations against reference versions.
+        """
+        rng = random.Random(0)
+        for _ in range(500):
+            indices = []
+            for _ in range(rng.randint(0, 12)):
+                start = rng.randint(0, 20)
+                indices.append((start, start + rng.randint(0, 3)))
+            packed = str_with_location.encode_indices(indices)
+            self.assertEqual(
+                packed,
+                str_with_location._py_encode_indices(indices))
+            self.assertEqual(
+                str_with_location.segment_bounds(packed),
+                str_with_location._py_segment_bounds(packed))
+            total = len(indices)
+            start = rng.randint(-2, total + 2)
+            stop = rng.randint(-2, total + 2)
+            self.assertEqual(
+                str_with_location.slice_segments(packed,
+                                                 start,
+                                                 stop),
+                str_with_location._py_slice_segments(packed,
+                                                     start,
+                                                     stop))
+            bounds = array(
+                'q',
+                [rng.randint(-1,
+                             total) for _ in range(2 * rng.randint(0, 4))])
+            self.assertEqual(
+                str_with_location.split_segments(packed,
+                                                 bounds.tobytes()),
+                str_with_location._py_split_segments(packed,
+                                                     bounds.tobytes()))
+            subs = array('q')
+            prev = 0
+            for _ in range(rng.randint(0, 3)):
+                match_start = rng.randint(prev, total)
+                match_end = rng.randint(match_start, total)
+                subs.extend((match_start, match_end, rng.randint(0, 4)))
+                prev = match_end
+            if total or not any(subs[2 :: 3]):
+                self.assertEqual(
+                    str_with_location.substitute_segments(
+                        packed,
+                        subs.tobytes()),
+                    str_with_location._py_substitute_segments(
+                        packed,
+                        subs.tobytes()))
+            else:
+                with self.assertRaises(ValueError):
+                    str_with_location.substitute_segments(
+                        packed,
+                        subs.tobytes())
+            length = rng.randint(0, 7)
+            start = rng.randint(0, 20)
+            end = start + rng.randint(0, 20)
+            self.assertEqual(
+                str_with_location.spread_segments(length,
+                                                  start,
+                                                  end),
+                str_with_location._py_spread_segments(length,
+                                                      start,
+                                                      end))
+            self.assertEqual(
+                str_with_location.concat_segments([packed,
+                                                   packed]),
+                str_with_location._py_concat_segments([packed,
+                                                       packed]))
+
+    def test_re_sub_matches_re(self):
+        """
+        Verify that substitutions agree with `re.sub`.
+        """
+        rng = random.Random(0)
+        for _ in range(200):
+            text = ''.join(
+                rng.choice("ab \n") for _ in range(rng.randint(0, 15)))
+            example = StrWithLocation.create_from_file_contents(text)
+            pattern = rng.choice([r"a+", r"\s", r"b?"])
+            count = rng.randint(0, 2)
+            if not text and pattern == r"b?":
+                continue
+            result = StrWithLocation.re_sub(pattern, "**", example, count=count)
+            self.assertEqual(
+                str(result),
+                re.sub(pattern,
+                       "**",
+                       text,
+                       count=count))
+            self.assertEqual(len(result.indices), len(result))
+            result = StrWithLocation.re_split(pattern, example)
+            self.assertEqual(result, re.split(pattern, text))
+            for piece in result:
+                self.assertEqual(
+                    piece.indices,
+                    [
+                        (i,
+                         i + 1)
+                        for i in range(piece.start or 0, (piece.end or 0))
+                    ])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -22,7 +22,6 @@
 Provides internal utilities for heuristic parsing of Coq source files.
 """
 
-import math
 import re
 from functools import partialmethod
 from typing import Iterable, List, Optional, Set, Tuple, Union
@@ -519,7 +518,6 @@ class ParserUtils:
         str_no_strings = []
         strings = []
         current_string: Optional[List[StrWithLocation]] = None
-        string_mask_size = len(string_mask)
         i = 0
         while i < len(string_delimited):
             segment = string_delimited[i]
@@ -540,17 +538,10 @@ class ParserUtils:
                         end = string.end
                         assert start is not None
                         assert end is not None
-                        step = (end - start) / string_mask_size
-                        subbed_indices = [
-                            (
-                                start + math.floor(i * step),
-                                min(end,
-                                    start + math.ceil((i + 1) * step)))
-                            for i in range(string_mask_size)
-                        ]
-                        subbed_mask = StrWithLocation(
+                        subbed_mask = StrWithLocation.spanning(
                             string_mask,
-                            subbed_indices)
+                            start,
+                            end)
                         str_no_strings.append(subbed_mask)
                         current_string = None
                 else:
@@ -764,9 +755,7 @@ class ParserUtils:
             if attribute is None:
                 attribute = StrWithLocation()
             else:
-                attribute = StrWithLocation(
-                    attribute.group(),
-                    sentence.indices[attribute.start(): attribute.end()])
+                attribute = sentence[attribute.start(): attribute.end()]
             if attribute:
                 stripped = StrWithLocation.re_split(
                     ParserUtils.attributes,
@@ -23,6 +23,8 @@
 #include <codecvt>
 #include <locale>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 // #define EMBEDDED
@@ -269,7 +271,735 @@ std::wstring string_to_wstring(const std::string& str)
     return converter.from_bytes(str);
 }
 
-PyObject* sexp_parse(PyObject* sexp_str)
+/*
+ * The depth to which top-level s-expressions are mirrored while parsing
+ * Vernacular commands, which bounds the cost of summarizing them
+ * without copying the bodies of commands.
+ * Deeper command structures are left to the Python analyzer.
+ */
+const size_t max_vernac_depth = 16;
+
+/*
+ * An error for which a command's summary is deferred to the Python
+ * analyzer, which reports the precise error, if any.
+ */
+struct DecodeError
+{
+    const char* message;
+};
+
+/*
+ * An error for which `SexpAnalyzer.analyze_loc` raises a
+ * `SexpAnalyzingException`.
+ */
+struct MalformedLoc : DecodeError
+{
+};
+
+/*
+ * A node of a mirrored s-expression.
+ *
+ * The text of an atom and the children of a list are ranges of arrays
+ * shared by all nodes of a `Tree`.
+ */
+struct Node
+{
+    bool   is_list;
+    /* Whether the children of a list were omitted */
+    bool   truncated;
+    size_t begin;
+    size_t size;
+};
+
+/*
+ * A depth-limited mirror of one top-level s-expression, built from the
+ * same atoms and lists as the `SexpNode`s returned by `sexp_parse`.
+ */
+class Tree
+{
+  public:
+    /* The number of open lists */
+    size_t depth = 0;
+
+    void open_list()
+    {
+        if (depth < max_vernac_depth)
+        {
+            starts.push_back(stack.size());
+        }
+        depth++;
+    }
+
+    void close_list()
+    {
+        depth--;
+        if (depth < max_vernac_depth)
+        {
+            size_t start = starts.back();
+            starts.pop_back();
+            nodes.push_back(Node{true, false, child_ids.size(), stack.size() - start});
+            child_ids.insert(child_ids.end(), stack.begin() + start, stack.end());
+            stack.resize(start);
+            stack.push_back(nodes.size() - 1);
+        }
+        else if (depth == max_vernac_depth)
+        {
+            nodes.push_back(Node{true, true, 0, 0});
+            stack.push_back(nodes.size() - 1);
+        }
+    }
+
+    void add_atom(const std::wstring& text)
+    {
+        if (depth <= max_vernac_depth)
+        {
+            nodes.push_back(Node{false, false, atoms.size(), text.size()});
+            atoms += text;
+            stack.push_back(nodes.size() - 1);
+        }
+    }
+
+    /* Get the completed top-level s-expression. */
+    const Node& root() const
+    {
+        return nodes[stack.back()];
+    }
+
+    /* Forget the completed top-level s-expression. */
+    void clear()
+    {
+        nodes.clear();
+        stack.clear();
+        atoms.clear();
+        child_ids.clear();
+    }
+
+    /* Get the number of children of a list, which must not be truncated. */
+    size_t num_children(const Node& node) const
+    {
+        if (node.truncated)
+        {
+            throw DecodeError{"Truncated s-expression"};
+        }
+        return node.is_list ? node.size : 0;
+    }
+
+    /* Get a child of a list like `SexpNode.__getitem__`. */
+    const Node& child(const Node& node, size_t i) const
+    {
+        if (i >= num_children(node))
+        {
+            throw DecodeError{"Missing child"};
+        }
+        return nodes[child_ids[node.begin + i]];
+    }
+
+    /* Get the text of an atom or an empty string for a list. */
+    std::wstring_view text(const Node& node) const
+    {
+        if (node.is_list)
+        {
+            return std::wstring_view();
+        }
+        return std::wstring_view(atoms.data() + node.begin, node.size);
+    }
+
+    /* Get the first atom of a subtree like `SexpNode.head`. */
+    std::wstring_view head(const Node& node) const
+    {
+        const Node* current = &node;
+        while (current->is_list)
+        {
+            if (num_children(*current) == 0)
+            {
+                return std::wstring_view();
+            }
+            current = &child(*current, 0);
+        }
+        return text(*current);
+    }
+
+    /* Get the content of an atom like `SexpNode.content`. */
+    std::wstring_view content(const Node& node) const
+    {
+        if (node.is_list)
+        {
+            throw DecodeError{"Expected an atom"};
+        }
+        return text(node);
+    }
+
+    /* Serialize a node like `str(SexpNode)`. */
+    void serialize(const Node& node, std::wstring& out) const
+    {
+        if (!node.is_list)
+        {
+            std::wstring_view atom = text(node);
+            bool              is_quoted
+                = !atom.empty() and atom.front() == '"' and atom.back() == '"';
+            if (!is_quoted and atom.find(' ') != std::wstring_view::npos)
+            {
+                out.push_back('"');
+                for (wchar_t c : atom)
+                {
+                    if (c == '\\')
+                    {
+                        out.push_back('\\');
+                    }
+                    out.push_back(c);
+                }
+                out.push_back('"');
+            }
+            else
+            {
+                out += atom;
+            }
+            return;
+        }
+        out.push_back('(');
+        for (size_t i = 0; i < num_children(node); i++)
+        {
+            if (i > 0)
+            {
+                out.push_back(' ');
+            }
+            serialize(child(node, i), out);
+        }
+        out.push_back(')');
+    }
+
+  private:
+    std::vector<Node>   nodes;
+    /* The nodes of each open list followed by completed roots */
+    std::vector<size_t> stack;
+    /* The positions in `stack` at which each open list begins */
+    std::vector<size_t> starts;
+    std::wstring        atoms;
+    std::vector<size_t> child_ids;
+};
+
+/* The number of numeric fields of a location */
+const size_t num_loc_fields = 6;
+
+/*
+ * A location read like `SexpAnalyzer.analyze_loc` without unicode offsets.
+ */
+struct Loc
+{
+    std::wstring filename;
+    long long    fields[num_loc_fields];
+};
+
+/*
+ * A control flag with its argument, if any.
+ */
+struct Flag
+{
+    const char*  kind;
+    bool         has_arg;
+    std::wstring arg;
+};
+
+/*
+ * The result of `SexpAnalyzer.analyze_vernac` (see
+ * prism/language/gallina/analyze.py).
+ */
+struct Vernac
+{
+    std::wstring              vernac_type;
+    bool                      has_extend_type = false;
+    std::wstring              extend_type;
+    std::vector<Flag>         control_flags;
+    std::vector<std::wstring> attributes;
+    bool                      has_loc = false;
+    Loc                       loc;
+    /* The indices leading from the root to the `vernac_sexp` */
+    std::vector<long long>    path;
+};
+
+/*
+ * Summarize Vernacular commands with the same checks in the same order
+ * as `SexpAnalyzer.analyze_vernac` and `SexpAnalyzer.is_ltac`.
+ *
+ * A `DecodeError` is raised wherever the analyzer would raise any error
+ * or where its result is not certain to match, e.g., when it would
+ * parse an unusual integer literal.
+ */
+class VernacSummarizer
+{
+  public:
+    Tree      tree;
+    /* The summary of each top-level s-expression or None if deferred */
+    PyObject* summaries = NULL;
+
+    VernacSummarizer(std::vector<std::wstring> proof_types,
+                     std::vector<std::wstring> proof_extend_types)
+        : proof_types(std::move(proof_types)),
+          proof_extend_types(std::move(proof_extend_types))
+    {
+        summaries = PyList_New(0);
+    }
+
+    ~VernacSummarizer()
+    {
+        Py_DecRef(summaries);
+    }
+
+    /* Whether a Python error occurred while summarizing */
+    bool failed = false;
+
+    void open_list()
+    {
+        tree.open_list();
+    }
+
+    void close_list()
+    {
+        tree.close_list();
+        if (tree.depth == 0)
+        {
+            summarize();
+        }
+    }
+
+    void add_atom(const std::wstring& text)
+    {
+        tree.add_atom(text);
+        if (tree.depth == 0)
+        {
+            summarize();
+        }
+    }
+
+  private:
+    /* Prefixes of Vernacular types that are part of a proof */
+    std::vector<std::wstring> proof_types;
+    /* Prefixes of VernacExtend types that are part of a proof */
+    std::vector<std::wstring> proof_extend_types;
+
+    /* Summarize the completed top-level s-expression. */
+    void summarize()
+    {
+        if (failed or summaries == NULL)
+        {
+            failed = true;
+            tree.clear();
+            return;
+        }
+        PyObject* summary = NULL;
+        try
+        {
+            Vernac vernac = analyze_vernac(tree.root(), {});
+            summary       = vernac_to_tuple(vernac, is_ltac(vernac));
+        }
+        catch (const DecodeError&)
+        {
+            Py_IncRef(Py_None);
+            summary = Py_None;
+        }
+        tree.clear();
+        if (summary == NULL or PyList_Append(summaries, summary) < 0)
+        {
+            failed = true;
+        }
+        Py_DecRef(summary);
+    }
+
+    Vernac analyze_vernac(const Node& sexp, const std::vector<long long>& path) const
+    {
+        const Node*            vernac_control = &sexp;
+        std::vector<long long> control_path   = path;
+        bool                   has_loc        = false;
+        Loc                    loc;
+        if (sexp.is_list and tree.num_children(sexp) == 2 and tree.head(sexp) == L"v"
+            and tree.head(tree.child(sexp, 1)) == L"loc"
+            and has_children(tree.child(tree.child(sexp, 1), 1)))
+        {
+            const Node& v_child = tree.child(sexp, 0);
+            try
+            {
+                read_loc(tree.child(sexp, 1), loc);
+                has_loc = true;
+            }
+            catch (const MalformedLoc&)
+            {
+            }
+            control_path.push_back(0);
+            if (!tree.content(tree.child(v_child, 0)).empty())
+            {
+                vernac_control = &tree.child(v_child, 1);
+                control_path.push_back(1);
+            }
+            else
+            {
+                vernac_control = &v_child;
+            }
+        }
+        const Node& control = *vernac_control;
+        Vernac      vernac;
+        if (tree.head(control) == L"control")
+        {
+            // Coq version > 8.10.2
+            analyze_vernac_expr(tree.child(tree.child(control, 2), 1), vernac);
+            analyze_vernac_flags(tree.child(tree.child(control, 1), 1),
+                                 vernac.attributes);
+            const Node& flags = tree.child(tree.child(control, 0), 1);
+            if (!flags.is_list)
+            {
+                throw DecodeError{"Expected a list of control flags"};
+            }
+            for (size_t i = 0; i < tree.num_children(flags); i++)
+            {
+                const Node& c = tree.child(flags, i);
+                Flag        flag;
+                flag.kind    = control_flag(tree.head(c));
+                flag.has_arg = has_arg(flag.kind);
+                if (flag.has_arg)
+                {
+                    flag.arg = control_arg(flag.kind, tree.child(c, 1));
+                }
+                vernac.control_flags.push_back(flag);
+            }
+        }
+        else if (tree.content(tree.child(control, 0)) == L"VernacExpr")
+        {
+            // Coq version <= 8.10.2
+            analyze_vernac_expr(tree.child(control, 2), vernac);
+            analyze_vernac_flags(tree.child(control, 1), vernac.attributes);
+        }
+        else
+        {
+            // Coq version <= 8.10.2
+            Flag flag;
+            flag.kind    = control_flag(tree.content(tree.child(control, 0)));
+            flag.has_arg = has_arg(flag.kind);
+            std::vector<long long> sub_path = control_path;
+            if (flag.has_arg)
+            {
+                flag.arg = control_arg(flag.kind, tree.child(control, 1));
+            }
+            sub_path.push_back(std::string(flag.kind) == "Fail" ? 1 : 2);
+            vernac = analyze_vernac(tree.child(control, sub_path.back()), sub_path);
+            vernac.control_flags.insert(vernac.control_flags.begin(), flag);
+        }
+        vernac.has_loc = has_loc;
+        vernac.loc     = loc;
+        vernac.path    = control_path;
+        return vernac;
+    }
+
+    /* Get whether `node.children` is truthy. */
+    bool has_children(const Node& node) const
+    {
+        if (!node.is_list)
+        {
+            throw DecodeError{"Expected a list"};
+        }
+        return tree.num_children(node) > 0;
+    }
+
+    /* Get the name of the `ControlFlag` constructed from a string. */
+    static const char* control_flag(std::wstring_view name)
+    {
+        if (name == L"ControlTime" or name == L"VernacTime")
+        {
+            return "Time";
+        }
+        else if (name == L"ControlRedirect" or name == L"VernacRedirect")
+        {
+            return "Redirect";
+        }
+        else if (name == L"ControlTimeout" or name == L"VernacTimeout")
+        {
+            return "Timeout";
+        }
+        else if (name == L"ControlFail" or name == L"VernacFail")
+        {
+            return "Fail";
+        }
+        else if (name == L"ControlSucceed")
+        {
+            return "Succeed";
+        }
+        throw DecodeError{"Unknown control flag"};
+    }
+
+    static bool has_arg(const char* kind)
+    {
+        std::string name(kind);
+        return name == "Time" or name == "Redirect" or name == "Timeout";
+    }
+
+    std::wstring control_arg(const char* kind, const Node& node) const
+    {
+        std::wstring_view arg = tree.content(node);
+        if (std::string(kind) == "Timeout")
+        {
+            read_int(arg);
+        }
+        return std::wstring(arg);
+    }
+
+    /* Read a decimal literal, deferring any other integer literal. */
+    static long long read_int(std::wstring_view digits)
+    {
+        if (digits.empty() or digits.size() > 18)
+        {
+            throw DecodeError{"Expected an integer"};
+        }
+        long long result = 0;
+        for (wchar_t c : digits)
+        {
+            if (c < '0' or c > '9')
+            {
+                throw DecodeError{"Expected an integer"};
+            }
+            result = result * 10 + (long long)(c - '0');
+        }
+        return result;
+    }
+
+    void analyze_vernac_expr(const Node& sexp, Vernac& vernac) const
+    {
+        vernac.vernac_type
+            = sexp.is_list ? tree.content(tree.child(sexp, 0)) : tree.text(sexp);
+        if (vernac.vernac_type == L"VernacExtend")
+        {
+            vernac.has_extend_type = true;
+            vernac.extend_type = tree.content(tree.child(tree.child(sexp, 1), 0));
+        }
+    }
+
+    void analyze_vernac_flags(const Node& sexp, std::vector<std::wstring>& out) const
+    {
+        if (!sexp.is_list)
+        {
+            throw DecodeError{"Expected a list of attributes"};
+        }
+        for (size_t i = 0; i < tree.num_children(sexp); i++)
+        {
+            const Node* vernac_flag = &tree.child(sexp, i);
+            if (vernac_flag->is_list and tree.num_children(*vernac_flag) == 2
+                and tree.head(*vernac_flag) == L"v"
+                and tree.head(tree.child(*vernac_flag, 1)) == L"loc"
+                and has_children(tree.child(tree.child(*vernac_flag, 1), 1)))
+            {
+                // Coq 8.15 added locations to attributes
+                vernac_flag = &tree.child(tree.child(*vernac_flag, 0), 1);
+            }
+            std::wstring attribute(tree.content(tree.child(*vernac_flag, 0)));
+            const Node&  value = tree.child(*vernac_flag, 1);
+            if (value.is_list)
+            {
+                // not VernacFlagEmpty
+                std::wstring_view flag_type = tree.content(tree.child(value, 0));
+                if (flag_type == L"VernacFlagLeaf")
+                {
+                    const Node* leaf = &tree.child(value, 1);
+                    if (leaf->is_list)
+                    {
+                        // Coq version > 8.10.2
+                        leaf = &tree.child(*leaf, 1);
+                    }
+                    attribute.push_back('=');
+                    tree.serialize(*leaf, attribute);
+                }
+                else if (flag_type == L"VernacFlagList")
+                {
+                    std::vector<std::wstring> args;
+                    analyze_vernac_flags(tree.child(value, 1), args);
+                    attribute += L" (";
+                    for (size_t j = 0; j < args.size(); j++)
+                    {
+                        if (j > 0)
+                        {
+                            attribute.push_back(',');
+                        }
+                        attribute += args[j];
+                    }
+                    attribute.push_back(')');
+                }
+            }
+            out.push_back(std::move(attribute));
+        }
+    }
+
+    /*
+     * Read a numeric field of a location, raising a plain `DecodeError`
+     * if the value is not a decimal literal.
+     */
+    long long read_loc_field(const Node& field, const wchar_t* name) const
+    {
+        if (tree.num_children(field) < 2)
+        {
+            throw MalformedLoc{{"Missing location field"}};
+        }
+        const Node& key = tree.child(field, 0);
+        if (key.is_list or tree.text(key) != name)
+        {
+            throw MalformedLoc{{"Unexpected location field"}};
+        }
+        const Node& value = tree.child(field, 1);
+        if (value.is_list)
+        {
+            throw DecodeError{"Expected an integer"};
+        }
+        return read_int(tree.text(value));
+    }
+
+    /*
+     * Read a location with the same checks in the same order as
+     * `SexpAnalyzer.analyze_loc`.
+     */
+    void read_loc(const Node& loc, Loc& out) const
+    {
+        if (tree.num_children(loc) != 2)
+        {
+            throw MalformedLoc{{"Expected a location"}};
+        }
+        const Node& key  = tree.child(loc, 0);
+        const Node& body = tree.child(loc, 1);
+        if (key.is_list or tree.text(key) != L"loc" or tree.num_children(body) == 0)
+        {
+            throw MalformedLoc{{"Expected a location"}};
+        }
+        const Node& data = tree.child(body, 0);
+        if (tree.num_children(data) != 7)
+        {
+            throw MalformedLoc{{"Expected a location"}};
+        }
+        const Node& fname = tree.child(data, 0);
+        if (tree.num_children(fname) < 2 or tree.child(fname, 0).is_list
+            or tree.text(tree.child(fname, 0)) != L"fname")
+        {
+            throw MalformedLoc{{"Unexpected location field"}};
+        }
+        out.filename.clear();
+        tree.serialize(tree.child(fname, 1), out.filename);
+        if (out.filename.compare(0, 7, L"(InFile") == 0)
+        {
+            // equivalent to `filename[8:-1]`
+            if (out.filename.size() > 9)
+            {
+                out.filename.pop_back();
+                out.filename.erase(0, 8);
+            }
+            else
+            {
+                out.filename.clear();
+            }
+        }
+        static const wchar_t* const names[]
+            = {L"line_nb", L"bol_pos", L"line_nb_last", L"bol_pos_last", L"bp", L"ep"};
+        for (size_t i = 0; i < num_loc_fields; i++)
+        {
+            out.fields[i] = read_loc_field(tree.child(data, i + 1), names[i]);
+        }
+    }
+
+    /* Test whether any prefix starts a string like `re.match`. */
+    static bool has_prefix(const std::vector<std::wstring>& prefixes,
+                           const std::wstring&              text)
+    {
+        for (const auto& prefix : prefixes)
+        {
+            if (text.compare(0, prefix.size(), prefix) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Classify a command like `SexpAnalyzer._is_ltac_type`. */
+    bool is_ltac(const Vernac& vernac) const
+    {
+        if (vernac.has_extend_type)
+        {
+            return has_prefix(proof_extend_types, vernac.extend_type);
+        }
+        return has_prefix(proof_types, vernac.vernac_type);
+    }
+
+    static PyObject* str_or_none(bool has_text, const std::wstring& text)
+    {
+        if (!has_text)
+        {
+            Py_IncRef(Py_None);
+            return Py_None;
+        }
+        return PyUnicode_FromWideChar(text.c_str(), (Py_ssize_t)text.size());
+    }
+
+    static PyObject* loc_to_tuple(const Vernac& vernac)
+    {
+        if (!vernac.has_loc)
+        {
+            Py_IncRef(Py_None);
+            return Py_None;
+        }
+        const long long* f = vernac.loc.fields;
+        return Py_BuildValue("(NLLLLLL)",
+                             str_or_none(true, vernac.loc.filename),
+                             f[0],
+                             f[1],
+                             f[2],
+                             f[3],
+                             f[4],
+                             f[5]);
+    }
+
+    static PyObject* vernac_to_tuple(const Vernac& vernac, bool is_ltac)
+    {
+        PyObject* flags = PyList_New((Py_ssize_t)vernac.control_flags.size());
+        for (size_t i = 0; flags != NULL and i < vernac.control_flags.size(); i++)
+        {
+            const Flag& flag = vernac.control_flags[i];
+            PyObject*   item
+                = Py_BuildValue("(sN)", flag.kind, str_or_none(flag.has_arg, flag.arg));
+            if (item == NULL)
+            {
+                Py_DecRef(flags);
+                flags = NULL;
+                break;
+            }
+            PyList_SetItem(flags, (Py_ssize_t)i, item);
+        }
+        PyObject* attributes = PyList_New((Py_ssize_t)vernac.attributes.size());
+        for (size_t i = 0; attributes != NULL and i < vernac.attributes.size(); i++)
+        {
+            PyObject* item = str_or_none(true, vernac.attributes[i]);
+            if (item == NULL)
+            {
+                Py_DecRef(attributes);
+                attributes = NULL;
+                break;
+            }
+            PyList_SetItem(attributes, (Py_ssize_t)i, item);
+        }
+        PyObject* path = PyTuple_New((Py_ssize_t)vernac.path.size());
+        for (size_t i = 0; path != NULL and i < vernac.path.size(); i++)
+        {
+            PyTuple_SetItem(path, (Py_ssize_t)i, PyLong_FromLongLong(vernac.path[i]));
+        }
+        /* `N` steals references and fails cleanly given NULL arguments */
+        return Py_BuildValue("(NNNNNNN)",
+                             str_or_none(true, vernac.vernac_type),
+                             str_or_none(vernac.has_extend_type, vernac.extend_type),
+                             flags,
+                             attributes,
+                             loc_to_tuple(vernac),
+                             path,
+                             PyBool_FromLong(is_ltac));
+    }
+};
+
+/*
+ * Parse a string of s-expressions into `SexpNode`s, optionally
+ * summarizing each top-level s-expression as a Vernacular command in
+ * the same pass.
+ */
+PyObject* sexp_parse(PyObject* sexp_str, VernacSummarizer* summarizer = NULL)
 {
     std::vector<PyObject*> return_stack;
     return_stack.push_back(PyList_New(0));
@@ -352,6 +1082,10 @@ PyObject* sexp_parse(PyObject* sexp_str)
                 Py_DecRef(new_char);
                 PyList_Append(return_stack.back(), sexp_string);
                 Py_DecRef(sexp_string);
+                if (summarizer != NULL)
+                {
+                    summarizer->add_atom(terminal);
+                }
                 terminal = L"";
             }
             else
@@ -434,6 +1168,10 @@ PyObject* sexp_parse(PyObject* sexp_str)
                 Py_DecRef(new_char);
                 PyList_Append(return_stack.back(), sexp_string);
                 Py_DecRef(sexp_string);
+                if (summarizer != NULL)
+                {
+                    summarizer->add_atom(quoted);
+                }
                 quoted = L"";
             }
             else
@@ -454,6 +1192,10 @@ PyObject* sexp_parse(PyObject* sexp_str)
                 // consume the left paren
                 // Start SexpList
                 return_stack.push_back(PyList_New(0));
+                if (summarizer != NULL)
+                {
+                    summarizer->open_list();
+                }
             }
             else if (cur_char == c_rpar)
             {
@@ -480,6 +1222,10 @@ PyObject* sexp_parse(PyObject* sexp_str)
                 Py_DecRef(children);
                 PyList_Append(return_stack.back(), sexp_list);
                 Py_DecRef(sexp_list);
+                if (summarizer != NULL)
+                {
+                    summarizer->close_list();
+                }
             }
             else if (cur_char == c_quote)
             {
@@ -510,6 +1256,19 @@ PyObject* sexp_parse(PyObject* sexp_str)
         Py_DecRef(new_char);
         PyList_Append(return_stack.back(), sexp_string);
         Py_DecRef(sexp_string);
+        if (summarizer != NULL)
+        {
+            summarizer->add_atom(terminal);
+        }
+    }
+    if (summarizer != NULL and summarizer->failed)
+    {
+        /* Release accumulated SexpNodes */
+        for (const auto& py_object: return_stack)
+        {
+            Py_DecRef(py_object);
+        }
+        return NULL;
     }
     if (return_stack.size() != 1 or PyList_Size(return_stack.front()) == 0)
     {
@@ -550,10 +1309,65 @@ static PyObject* py_sexp_parse(PyObject* self, PyObject* args)
     return sexps;
 };
 
+/*
+ * Read an iterable of strings, returning false if a Python error
+ * occurred.
+ */
+static bool read_strs(PyObject* iterable, std::vector<std::wstring>& out)
+{
+    PyObject* iterator = PyObject_GetIter(iterable);
+    if (iterator == NULL)
+    {
+        return false;
+    }
+    PyObject* item = NULL;
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        Py_ssize_t size = 0;
+        wchar_t*   text = PyUnicode_AsWideCharString(item, &size);
+        Py_DecRef(item);
+        if (text == NULL)
+        {
+            Py_DecRef(iterator);
+            return false;
+        }
+        out.emplace_back(text, (size_t)size);
+        PyMem_Free(text);
+    }
+    Py_DecRef(iterator);
+    return PyErr_Occurred() == NULL;
+}
+
+static PyObject* py_vernac_parse(PyObject* self, PyObject* args)
+{
+    PyObject*                 sexp_str           = NULL;
+    PyObject*                 proof_types        = NULL;
+    PyObject*                 proof_extend_types = NULL;
+    std::vector<std::wstring> proof_prefixes;
+    std::vector<std::wstring> proof_extend_prefixes;
+    if (!PyArg_ParseTuple(args, "UOO", &sexp_str, &proof_types, &proof_extend_types)
+        or !read_strs(proof_types, proof_prefixes)
+        or !read_strs(proof_extend_types, proof_extend_prefixes))
+    {
+        return NULL;
+    }
+    VernacSummarizer summarizer(std::move(proof_prefixes),
+                                std::move(proof_extend_prefixes));
+    PyObject*        sexps = sexp_parse(sexp_str, &summarizer);
+    if (sexps == NULL)
+    {
+        return NULL;
+    }
+    return Py_BuildValue("(NO)", sexps, summarizer.summaries);
+};
+
 static PyMethodDef ParsingMethods[] = {
     {"parse_sexps",
      py_sexp_parse,       METH_VARARGS,
      "Parse a string of a list of s-expressions into `SexpNode`s."},
+    {"parse_vernac_sexps",
+     py_vernac_parse,     METH_VARARGS,
+     "Parse s-expressions of Vernacular commands with their summaries."},
     {NULL,          NULL, 0,            NULL                      }
 };
 
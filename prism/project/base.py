@@ -69,6 +69,7 @@ from prism.language.heuristic.parser import (
     HeuristicParser,
     SerAPIParser,
 )
+from prism.language.heuristic.sentence_index import SentenceIndex
 from prism.project.exception import (
     ExecutionError,
     MissingMetadataError,
@@ -169,6 +170,9 @@ class Project(ABC):
         The method by which sentences are extracted.
     project_logger : logging.Logger
         Logger used to send log messages.
+    sentence_index : SentenceIndex, optional
+        A cache of lexed files, which may be shared between projects.
+        By default, each project caches its files in memory.
     """
 
     _missing_dependency_pattern = regex_from_options(
@@ -216,7 +220,8 @@ class Project(ABC):
             sentence_extraction_method: SEM = SentenceExtractionMethod.SERAPI,
             num_cores: Optional[int] = None,
             switch_manager: Optional[SwitchManager] = None,
-            project_logger: Optional[logging.Logger] = None):
+            project_logger: Optional[logging.Logger] = None,
+            sentence_index: Optional[SentenceIndex] = None):
         """
         Initialize Project object.
         """
@@ -243,6 +248,12 @@ class Project(ABC):
         self._last_metadata_args: Optional[MetadataArgs] = None
         self._metadata: Optional[ProjectMetadata] = None
         self.switch_manager = switch_manager
+        if sentence_index is None:
+            sentence_index = SentenceIndex()
+        self.sentence_index = sentence_index
+        """
+        A cache of lexed files used for heuristic sentence extraction.
+        """
 
     @property
     def build_cmd(self) -> List[str]:
@@ -578,7 +589,9 @@ class Project(ABC):
                 sentence_extraction_method=self.sentence_extraction_method,
                 serapi_options=self.serapi_options,
                 opam_switch=self.opam_switch,
-                return_comments=False))
+                return_comments=False,
+                **self._lexed_kwargs(obj,
+                                     self.sentence_extraction_method)))
         return sentences
 
     def _iqr_bound_directories(
@@ -639,6 +652,20 @@ class Project(ABC):
         is_build_healthy = self._check_build_health()
         return is_build_error_message or not is_build_healthy
 
+    def _lexed_kwargs(
+            self,
+            document: CoqDocument,
+            sentence_extraction_method: SEM) -> Dict[str,
+                                                     Any]:
+        """
+        Get cached lexing results for heuristic sentence extraction.
+        """
+        if sentence_extraction_method == SEM.HEURISTIC:
+            return {
+                'lexed': self.sentence_index.lex(document.source_code)
+            }
+        return {}
+
     def _prepare_command(self, target: str) -> str:
         # wrap in parentheses to preserve operator precedence when
         # joining commands with &&
@@ -1665,8 +1692,50 @@ class Project(ABC):
         kwargs['sentence_extraction_method'] = sentence_extraction_method
         kwargs['opam_switch'] = self.opam_switch
         kwargs['serapi_options'] = self.serapi_options
+        kwargs.update(self._lexed_kwargs(document, sentence_extraction_method))
         return self.extract_sentences(document, **kwargs)
 
+    def index_sentences(
+            self,
+            files: Optional[Iterable[PathLike]] = None,
+            key: Optional[str] = None) -> Dict[str,
+                                               str]:
+        """
+        Lex the project's files in parallel into its `sentence_index`.
+
+        Subsequent heuristic sentence extraction from any of the files
+        reads the cached results instead of lexing the file again.
+
+        Parameters
+        ----------
+        files : Optional[Iterable[PathLike]], optional
+            The files to lex, by default all of the project's files.
+        key : Optional[str], optional
+            If given, a key such as a commit SHA under which a manifest
+            of the lexed files is saved, by default None.
+
+        Returns
+        -------
+        Dict[str, str]
+            A map from the path of each file relative to the project
+            root to the hash of the file's contents.
+
+        See Also
+        --------
+        SentenceIndex.lex_files : For details and exceptions.
+        """
+        if files is None:
+            files = self.get_file_list()
+        manifest = {
+            str(get_relative_path(f,
+                                  self.path)): digest
+            for f, digest in self.sentence_index.lex_files(
+                files, self.num_cores).items()
+        }
+        if key is not None:
+            self.sentence_index.save_manifest(key, manifest)
+        return manifest
+
     def infer_build_cmd(self) -> List[str]:
         """
         Try to infer a build command based on common templates.
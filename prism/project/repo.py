@@ -25,18 +25,20 @@ from __future__ import annotations
 
 import pathlib
 import random
-import warnings
 from collections import deque
 from enum import Enum
-from typing import List, Optional, Set, Tuple
+from typing import Dict, Iterable, List, Optional, Set, Tuple
 
 from git.exc import GitCommandError, NoSuchPathError
 from git.objects import Commit
 from git.repo import Repo
 
 from prism.data.document import CoqDocument
+from prism.language.gallina.parser import CoqParser
 from prism.project.base import MetadataArgs, Project
 from prism.project.metadata.storage import MetadataStorage
+from prism.util.git_objects import GitObjectReader
+from prism.util.path import get_relative_path
 from prism.util.radpytools import PathLike
 
 
@@ -217,10 +219,9 @@ class ChangedCoqCommitIterator(CommitIterator):
             if self._last is None:
                 break
             else:
-                changed_files = self._repo.git.diff(
-                    "--name-only",
-                    commit,
-                    self._last).split("\n")
+                changed_files = self._repo.objects.changed_files(
+                    commit.hexsha,
+                    self._last.hexsha)
                 if any(filename.endswith(".v") for filename in changed_files):
                     break
         self._last = commit
@@ -275,6 +276,10 @@ class ProjectRepo(Repo, Project):
                 # re-raise original error
                 raise
             Repo.__init__(self, dir_abspath)
+        self.objects = GitObjectReader(self.git_dir)
+        """
+        A reader of files at any commit that does not require checkouts.
+        """
         Project.__init__(self, dir_abspath, *args, **kwargs)
         self.current_commit_name: Optional[str] = None  # i.e., HEAD
         """
@@ -352,18 +357,32 @@ class ProjectRepo(Repo, Project):
             kwargs['commit_name'] = self.get_random_commit()
         self._pre_get_file(**kwargs)
 
+    def _resolve_commit(self, commit_name: str) -> str:
+        """
+        Get the SHA of a commit named by hash, branch, tag, or rev.
+        """
+        commit_name = str(commit_name)
+        try:
+            return self.objects.resolve(commit_name)
+        except ValueError:
+            # fall back to GitPython for more complex revisions
+            return self.commit(commit_name).hexsha
+
     def _traverse_file_tree(self) -> List[CoqDocument]:
         """
         Traverse the file tree and return a full list of file objects.
 
-        This function may change the git repo HEAD on disk.
+        Files of a commit other than HEAD are read from the object
+        store without checking out the commit.
         """
-        if self.current_commit_name is not None:
-            warnings.warn(
-                "Querying files of a non-checked out commit is deprecated",
-                DeprecationWarning)
-        self.git.checkout(self.current_commit_name)
-        return super()._traverse_file_tree()
+        if self.current_commit_name is None:
+            return super()._traverse_file_tree()
+        commit_sha = self._resolve_commit(self.current_commit_name)
+        return [
+            self.get_file(f,
+                          commit_sha)
+            for f in self.get_file_list(commit_name=commit_sha)
+        ]
 
     def get_file(
             self,
@@ -372,7 +391,8 @@ class ProjectRepo(Repo, Project):
         """
         Return a specific Coq source file from a specific commit.
 
-        This function may change the git repo HEAD on disk.
+        Files of a commit other than HEAD are read from the object
+        store without checking out the commit.
 
         Parameters
         ----------
@@ -392,12 +412,21 @@ class ProjectRepo(Repo, Project):
         ValueError
             If given `filename` does not end in ".v"
         """
-        if commit_name is not None:
-            warnings.warn(
-                "Querying files of a non-checked out commit is deprecated",
-                DeprecationWarning)
-            self.git.checkout(commit_name)
-        return super().get_file(filename)
+        if commit_name is None:
+            return super().get_file(filename)
+        filename = str(filename)
+        if not filename.endswith(".v"):
+            raise ValueError("filename must end in .v")
+        relative_filename = get_relative_path(filename, self.path)
+        source_code = CoqParser.decode_byte_string(
+            self.objects.read_file(
+                self._resolve_commit(commit_name),
+                relative_filename))
+        return CoqDocument(
+            relative_filename,
+            project_path=self.path,
+            source_code=source_code,
+            serapi_options=self.serapi_options)
 
     def get_file_list(
             self,
@@ -431,11 +460,9 @@ class ProjectRepo(Repo, Project):
             including those ignored by `ignore_path_regex`.
         """
         if commit_name is not None:
-            warnings.warn(
-                "Querying files of a non-checked out commit is deprecated",
-                DeprecationWarning)
+            files = self.objects.list_files(self._resolve_commit(commit_name))
             return self.filter_files(
-                self.commit(commit_name).tree.traverse(),
+                (self.path / f for f in files if f.endswith(".v")),
                 relative,
                 dependency_order)
         else:
@@ -450,11 +477,7 @@ class ProjectRepo(Repo, Project):
         Commit
             A random `Commit` object from the project repo
         """
-
-        def _get_hash(commit: Commit) -> str:
-            return commit.hexsha
-
-        commit_hashes = list(map(_get_hash, self.iter_commits('--all')))
+        commit_hashes = sorted(c.hexsha for c in self.objects.iter_commits())
         chosen_hash = random.choice(commit_hashes)
         result = self.commit(chosen_hash)
         return result
@@ -477,7 +500,11 @@ class ProjectRepo(Repo, Project):
         CoqDocument
             A random Coq source file in the form of a CoqDocument
         """
-        return super().get_random_file(commit_name=commit_name)
+        if commit_name is None:
+            commit_name = self.get_random_commit().hexsha
+        # choose the file first so that only it is read
+        filename = random.choice(self.get_file_list(commit_name=commit_name))
+        return self.get_file(filename, commit_name)
 
     def get_random_sentence(
             self,
@@ -544,6 +571,27 @@ class ProjectRepo(Repo, Project):
             glom_proofs,
             commit_name=commit_name)
 
+    def index_sentences(
+            self,
+            files: Optional[Iterable[PathLike]] = None,
+            key: Optional[str] = None) -> Dict[str,
+                                               str]:
+        """
+        Lex the files of the checked out commit in parallel.
+
+        The manifest of lexed files is saved under the commit's SHA
+        unless another `key` is given.
+        No manifest is saved by default if the working tree is dirty,
+        since it would not describe the commit.
+
+        See Also
+        --------
+        Project.index_sentences : For details on the parameters.
+        """
+        if key is None and not self.is_dirty(untracked_files=True):
+            key = self.commit_sha
+        return super().index_sentences(files, key)
+
     def infer_ignore_path_regex(self) -> Set[str]:
         """
         Infer a default regex that ignores submodule directories.
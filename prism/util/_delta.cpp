@@ -0,0 +1,692 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/* Operations of a string delta (see prism/util/delta.py) */
+const uint64_t op_copy   = 0;
+const uint64_t op_skip   = 1;
+const uint64_t op_insert = 2;
+
+/* Tags of packed values (see prism/util/delta.py) */
+const unsigned char tag_none    = 0;
+const unsigned char tag_false   = 1;
+const unsigned char tag_true    = 2;
+const unsigned char tag_int     = 3;
+const unsigned char tag_neg_int = 4;
+const unsigned char tag_float   = 5;
+const unsigned char tag_str     = 6;
+const unsigned char tag_bytes   = 7;
+const unsigned char tag_list    = 8;
+const unsigned char tag_dict    = 9;
+
+/* Maximum nesting depth of packed values, which also guards against cycles */
+const int max_depth = 1000;
+
+/*
+ * Read a LEB128-encoded integer, advancing `pos`.
+ * Return false if the integer is truncated or too large.
+ */
+static bool read_varint(const unsigned char* data,
+                        Py_ssize_t           size,
+                        Py_ssize_t&          pos,
+                        uint64_t&            value)
+{
+    value          = 0;
+    unsigned shift = 0;
+    while (pos < size and shift < 64)
+    {
+        unsigned char byte = data[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (byte < 0x80)
+        {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+/*
+ * Append a nonnegative integer in LEB128 form.
+ */
+static void write_varint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+/*
+ * Append a nonnegative integer of arbitrary size in LEB128 form.
+ */
+static bool write_long_varint(std::string& out, PyObject* value)
+{
+    PyObject* seven = PyLong_FromLong(7);
+    if (seven == NULL)
+    {
+        return false;
+    }
+    Py_IncRef(value);
+    bool ok = true;
+    while (ok)
+    {
+        unsigned char byte    = PyLong_AsUnsignedLongLongMask(value) & 0x7F;
+        PyObject*     shifted = PyNumber_Rshift(value, seven);
+        Py_DecRef(value);
+        value = shifted;
+        if (value == NULL)
+        {
+            ok = false;
+            break;
+        }
+        int more = PyObject_IsTrue(value);
+        if (more < 0)
+        {
+            ok = false;
+            break;
+        }
+        out.push_back((char)(more ? byte | 0x80 : byte));
+        if (!more)
+        {
+            break;
+        }
+    }
+    Py_DecRef(value);
+    Py_DecRef(seven);
+    return ok;
+}
+
+/*
+ * Read a LEB128-encoded integer of arbitrary size, advancing `pos`.
+ */
+static PyObject* read_long_varint(const unsigned char* data,
+                                  Py_ssize_t           size,
+                                  Py_ssize_t&          pos)
+{
+    Py_ssize_t end = pos;
+    while (end < size and data[end] >= 0x80)
+    {
+        end++;
+    }
+    if (end >= size)
+    {
+        PyErr_SetString(PyExc_ValueError, "Truncated varint");
+        return NULL;
+    }
+    if (end - pos < 9)
+    {
+        uint64_t value;
+        read_varint(data, size, pos, value);
+        return PyLong_FromUnsignedLongLong(value);
+    }
+    // too large for a machine word; accumulate from the most significant byte
+    PyObject* value = PyLong_FromLong(0);
+    PyObject* seven = PyLong_FromLong(7);
+    for (Py_ssize_t i = end; i >= pos and value != NULL and seven != NULL; i--)
+    {
+        PyObject* shifted = PyNumber_Lshift(value, seven);
+        Py_DecRef(value);
+        value = NULL;
+        if (shifted == NULL)
+        {
+            break;
+        }
+        PyObject* byte = PyLong_FromLong(data[i] & 0x7F);
+        if (byte != NULL)
+        {
+            value = PyNumber_Or(shifted, byte);
+            Py_DecRef(byte);
+        }
+        Py_DecRef(shifted);
+    }
+    if (seven != NULL)
+    {
+        Py_DecRef(seven);
+    }
+    else if (value != NULL)
+    {
+        Py_DecRef(value);
+        value = NULL;
+    }
+    pos = end + 1;
+    return value;
+}
+
+/*
+ * Append a piece to the list of result pieces, stealing the reference.
+ */
+static bool append_piece(PyObject* pieces, PyObject* piece)
+{
+    if (piece == NULL)
+    {
+        return false;
+    }
+    int failed = PyList_Append(pieces, piece);
+    Py_DecRef(piece);
+    return failed == 0;
+}
+
+static PyObject* apply_str_delta(PyObject* base, PyObject* delta)
+{
+    char*      raw_data = NULL;
+    Py_ssize_t size     = 0;
+    if (PyBytes_AsStringAndSize(delta, &raw_data, &size) < 0)
+    {
+        return NULL;
+    }
+    const unsigned char* data      = (const unsigned char*)raw_data;
+    Py_ssize_t           base_size = PyUnicode_GetLength(base);
+    if (base_size < 0)
+    {
+        return NULL;
+    }
+    PyObject* pieces = PyList_New(0);
+    if (pieces == NULL)
+    {
+        return NULL;
+    }
+    Py_ssize_t  pos      = 0;
+    Py_ssize_t  base_pos = 0;
+    const char* error    = NULL;
+    while (pos < size and error == NULL)
+    {
+        uint64_t header;
+        if (!read_varint(data, size, pos, header))
+        {
+            error = "Truncated varint";
+            break;
+        }
+        uint64_t op = header & 0x3;
+        uint64_t n  = header >> 2;
+        if (op == op_copy or op == op_skip)
+        {
+            if (n > (uint64_t)(base_size - base_pos))
+            {
+                error = op == op_copy ? "Delta copies beyond the end of the base"
+                                      : "Delta skips beyond the end of the base";
+                break;
+            }
+            if (op == op_copy
+                and !append_piece(
+                    pieces,
+                    PyUnicode_Substring(base, base_pos, base_pos + (Py_ssize_t)n)))
+            {
+                Py_DecRef(pieces);
+                return NULL;
+            }
+            base_pos += (Py_ssize_t)n;
+        }
+        else if (op == op_insert)
+        {
+            if (n > (uint64_t)(size - pos))
+            {
+                error = "Delta inserts beyond the end of the delta";
+                break;
+            }
+            if (!append_piece(
+                    pieces,
+                    PyUnicode_DecodeUTF8(raw_data + pos, (Py_ssize_t)n, "strict")))
+            {
+                Py_DecRef(pieces);
+                return NULL;
+            }
+            pos += (Py_ssize_t)n;
+        }
+        else
+        {
+            error = "Unknown delta operation";
+        }
+    }
+    if (error == NULL and base_pos != base_size)
+    {
+        error = "Delta does not span the base";
+    }
+    if (error != NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, error);
+        Py_DecRef(pieces);
+        return NULL;
+    }
+    PyObject* empty = PyUnicode_FromString("");
+    if (empty == NULL)
+    {
+        Py_DecRef(pieces);
+        return NULL;
+    }
+    PyObject* result = PyUnicode_Join(empty, pieces);
+    Py_DecRef(empty);
+    Py_DecRef(pieces);
+    return result;
+}
+
+/*
+ * Compute the lengths of the common prefix and (non-overlapping) suffix.
+ */
+static PyObject* common_affix_lengths(PyObject* a, PyObject* b)
+{
+    Py_UCS4* a_data = PyUnicode_AsUCS4Copy(a);
+    if (a_data == NULL)
+    {
+        return NULL;
+    }
+    Py_UCS4* b_data = PyUnicode_AsUCS4Copy(b);
+    if (b_data == NULL)
+    {
+        PyMem_Free(a_data);
+        return NULL;
+    }
+    Py_ssize_t a_size     = PyUnicode_GetLength(a);
+    Py_ssize_t b_size     = PyUnicode_GetLength(b);
+    Py_ssize_t max_prefix = a_size < b_size ? a_size : b_size;
+    Py_ssize_t prefix     = 0;
+    while (prefix < max_prefix and a_data[prefix] == b_data[prefix])
+    {
+        prefix++;
+    }
+    Py_ssize_t max_suffix = max_prefix - prefix;
+    Py_ssize_t suffix     = 0;
+    while (suffix < max_suffix
+           and a_data[a_size - 1 - suffix] == b_data[b_size - 1 - suffix])
+    {
+        suffix++;
+    }
+    PyMem_Free(a_data);
+    PyMem_Free(b_data);
+    return Py_BuildValue("nn", prefix, suffix);
+}
+
+static bool pack(std::string& out, PyObject* value, int depth);
+
+static bool pack_int(std::string& out, PyObject* value)
+{
+    int       overflow = 0;
+    long long v        = PyLong_AsLongLongAndOverflow(value, &overflow);
+    if (v == -1 and PyErr_Occurred())
+    {
+        return false;
+    }
+    if (overflow == 0)
+    {
+        out.push_back((char)(v >= 0 ? tag_int : tag_neg_int));
+        write_varint(out, v >= 0 ? (uint64_t)v : (uint64_t)(-(v + 1)) + 1);
+        return true;
+    }
+    out.push_back((char)(overflow > 0 ? tag_int : tag_neg_int));
+    PyObject* magnitude = PyNumber_Absolute(value);
+    if (magnitude == NULL)
+    {
+        return false;
+    }
+    bool ok = write_long_varint(out, magnitude);
+    Py_DecRef(magnitude);
+    return ok;
+}
+
+static bool pack_raw(std::string& out, unsigned char tag, const char* raw, Py_ssize_t n)
+{
+    out.push_back((char)tag);
+    write_varint(out, (uint64_t)n);
+    out.append(raw, (size_t)n);
+    return true;
+}
+
+static bool pack_str(std::string& out, PyObject* value)
+{
+    PyObject* encoded = PyUnicode_AsUTF8String(value);
+    if (encoded == NULL)
+    {
+        return false;
+    }
+    char*      raw = NULL;
+    Py_ssize_t n   = 0;
+    bool       ok  = PyBytes_AsStringAndSize(encoded, &raw, &n) == 0
+           and pack_raw(out, tag_str, raw, n);
+    Py_DecRef(encoded);
+    return ok;
+}
+
+static bool pack_sequence(std::string& out, PyObject* value, int depth)
+{
+    bool       is_list = PyList_Check(value);
+    Py_ssize_t n       = is_list ? PyList_Size(value) : PyTuple_Size(value);
+    if (n < 0)
+    {
+        return false;
+    }
+    out.push_back((char)tag_list);
+    write_varint(out, (uint64_t)n);
+    for (Py_ssize_t i = 0; i < n; i++)
+    {
+        PyObject* item = is_list ? PyList_GetItem(value, i) : PyTuple_GetItem(value, i);
+        if (item == NULL or !pack(out, item, depth + 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool pack_dict(std::string& out, PyObject* value, int depth)
+{
+    Py_ssize_t n = PyDict_Size(value);
+    if (n < 0)
+    {
+        return false;
+    }
+    out.push_back((char)tag_dict);
+    write_varint(out, (uint64_t)n);
+    Py_ssize_t pos = 0;
+    PyObject*  k   = NULL;
+    PyObject*  v   = NULL;
+    while (PyDict_Next(value, &pos, &k, &v))
+    {
+        if (!pack(out, k, depth + 1) or !pack(out, v, depth + 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Append the encoding of a value, mirroring `_py_pack_value`.
+ */
+static bool pack(std::string& out, PyObject* value, int depth)
+{
+    if (depth > max_depth)
+    {
+        PyErr_SetString(PyExc_RecursionError, "Value is too deeply nested to pack");
+        return false;
+    }
+    if (value == Py_None)
+    {
+        out.push_back((char)tag_none);
+    }
+    else if (value == Py_False)
+    {
+        out.push_back((char)tag_false);
+    }
+    else if (value == Py_True)
+    {
+        out.push_back((char)tag_true);
+    }
+    else if (PyLong_Check(value))
+    {
+        return pack_int(out, value);
+    }
+    else if (PyFloat_Check(value))
+    {
+        double v = PyFloat_AsDouble(value);
+        if (v == -1.0 and PyErr_Occurred())
+        {
+            return false;
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        out.push_back((char)tag_float);
+        for (int i = 0; i < 8; i++)
+        {
+            out.push_back((char)(bits >> (8 * i)));
+        }
+    }
+    else if (PyUnicode_Check(value))
+    {
+        return pack_str(out, value);
+    }
+    else if (PyBytes_Check(value))
+    {
+        char*      raw = NULL;
+        Py_ssize_t n   = 0;
+        return PyBytes_AsStringAndSize(value, &raw, &n) == 0
+           and pack_raw(out, tag_bytes, raw, n);
+    }
+    else if (PyByteArray_Check(value))
+    {
+        return pack_raw(out, tag_bytes, PyByteArray_AsString(value),
+                        PyByteArray_Size(value));
+    }
+    else if (PyList_Check(value) or PyTuple_Check(value))
+    {
+        return pack_sequence(out, value, depth);
+    }
+    else if (PyDict_Check(value))
+    {
+        return pack_dict(out, value, depth);
+    }
+    else
+    {
+        PyErr_Format(PyExc_TypeError, "Cannot pack value of type %R",
+                     (PyObject*)Py_TYPE(value));
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Decode a value at `pos`, advancing `pos`, mirroring `_py_unpack_value`.
+ */
+static PyObject* unpack(const unsigned char* data,
+                        Py_ssize_t           size,
+                        Py_ssize_t&          pos,
+                        int                  depth)
+{
+    if (depth > max_depth)
+    {
+        PyErr_SetString(PyExc_RecursionError, "Value is too deeply nested to unpack");
+        return NULL;
+    }
+    if (pos >= size)
+    {
+        PyErr_SetString(PyExc_ValueError, "Truncated value");
+        return NULL;
+    }
+    unsigned char tag = data[pos++];
+    if (tag == tag_none or tag == tag_false or tag == tag_true)
+    {
+        PyObject* value = tag == tag_none   ? Py_None
+                        : tag == tag_true ? Py_True
+                                          : Py_False;
+        Py_IncRef(value);
+        return value;
+    }
+    if (tag == tag_int or tag == tag_neg_int)
+    {
+        PyObject* value = read_long_varint(data, size, pos);
+        if (value == NULL or tag == tag_int)
+        {
+            return value;
+        }
+        PyObject* negated = PyNumber_Negative(value);
+        Py_DecRef(value);
+        return negated;
+    }
+    if (tag == tag_float)
+    {
+        if (size - pos < 8)
+        {
+            PyErr_SetString(PyExc_ValueError, "Truncated value");
+            return NULL;
+        }
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            bits |= (uint64_t)data[pos++] << (8 * i);
+        }
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return PyFloat_FromDouble(v);
+    }
+    uint64_t n;
+    if (tag > tag_dict)
+    {
+        PyErr_Format(PyExc_ValueError, "Unknown value tag %d", (int)tag);
+        return NULL;
+    }
+    if (!read_varint(data, size, pos, n))
+    {
+        PyErr_SetString(PyExc_ValueError, "Truncated varint");
+        return NULL;
+    }
+    if (tag == tag_str or tag == tag_bytes)
+    {
+        if (n > (uint64_t)(size - pos))
+        {
+            PyErr_SetString(PyExc_ValueError, "Truncated value");
+            return NULL;
+        }
+        const char* raw = (const char*)data + pos;
+        pos += (Py_ssize_t)n;
+        return tag == tag_str ? PyUnicode_DecodeUTF8(raw, (Py_ssize_t)n, "strict")
+                              : PyBytes_FromStringAndSize(raw, (Py_ssize_t)n);
+    }
+    // every item occupies at least one byte, which bounds preallocation
+    if (n > (uint64_t)(size - pos))
+    {
+        PyErr_SetString(PyExc_ValueError, "Truncated value");
+        return NULL;
+    }
+    if (tag == tag_list)
+    {
+        PyObject* items = PyList_New((Py_ssize_t)n);
+        for (Py_ssize_t i = 0; items != NULL and i < (Py_ssize_t)n; i++)
+        {
+            PyObject* item = unpack(data, size, pos, depth + 1);
+            if (item == NULL)
+            {
+                Py_DecRef(items);
+                return NULL;
+            }
+            PyList_SetItem(items, i, item);
+        }
+        return items;
+    }
+    PyObject* mapping = PyDict_New();
+    for (uint64_t i = 0; mapping != NULL and i < n; i++)
+    {
+        PyObject* k = unpack(data, size, pos, depth + 1);
+        PyObject* v = k == NULL ? NULL : unpack(data, size, pos, depth + 1);
+        int failed  = v == NULL or PyDict_SetItem(mapping, k, v) < 0;
+        if (k != NULL)
+        {
+            Py_DecRef(k);
+        }
+        if (v != NULL)
+        {
+            Py_DecRef(v);
+        }
+        if (failed)
+        {
+            Py_DecRef(mapping);
+            return NULL;
+        }
+    }
+    return mapping;
+}
+
+static PyObject* py_apply_str_delta(PyObject* self, PyObject* args)
+{
+    PyObject* base  = NULL;
+    PyObject* delta = NULL;
+    if (!PyArg_ParseTuple(args, "UO!", &base, &PyBytes_Type, &delta))
+    {
+        return NULL;
+    }
+    return apply_str_delta(base, delta);
+};
+
+static PyObject* py_common_affix_lengths(PyObject* self, PyObject* args)
+{
+    PyObject* a = NULL;
+    PyObject* b = NULL;
+    if (!PyArg_ParseTuple(args, "UU", &a, &b))
+    {
+        return NULL;
+    }
+    return common_affix_lengths(a, b);
+};
+
+static PyObject* py_pack_value(PyObject* self, PyObject* value)
+{
+    std::string out;
+    if (!pack(out, value, 0))
+    {
+        return NULL;
+    }
+    return PyBytes_FromStringAndSize(out.data(), (Py_ssize_t)out.size());
+};
+
+static PyObject* py_unpack_value(PyObject* self, PyObject* args)
+{
+    PyObject* data = NULL;
+    if (!PyArg_ParseTuple(args, "O!", &PyBytes_Type, &data))
+    {
+        return NULL;
+    }
+    char*      raw  = NULL;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(data, &raw, &size) < 0)
+    {
+        return NULL;
+    }
+    Py_ssize_t pos   = 0;
+    PyObject*  value = unpack((const unsigned char*)raw, size, pos, 0);
+    if (value != NULL and pos != size)
+    {
+        Py_DecRef(value);
+        PyErr_SetString(PyExc_ValueError, "Trailing data after value");
+        return NULL;
+    }
+    return value;
+};
+
+static PyMethodDef DeltaMethods[] = {
+    {"apply_str_delta",
+     py_apply_str_delta,      METH_VARARGS,
+     "Apply a delta computed by `compute_str_delta` to a string."},
+    {"common_affix_lengths",
+     py_common_affix_lengths, METH_VARARGS,
+     "Compute the lengths of the common prefix and suffix of two strings."},
+    {"pack_value",
+     py_pack_value,           METH_O,
+     "Encode a tree of primitive values in a compact binary form."},
+    {"unpack_value",
+     py_unpack_value,         METH_VARARGS,
+     "Decode a value encoded with `pack_value`."},
+    {NULL,                   NULL, 0,            NULL                 }
+};
+
+static struct PyModuleDef delta_module = {PyModuleDef_HEAD_INIT,
+                                          "prism.util._delta",
+                                          "Library for string deltas and packed values",
+                                          -1,
+                                          DeltaMethods};
+
+PyMODINIT_FUNC            PyInit__delta(void)
+{
+    return PyModule_Create(&delta_module);
+};
@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* An argument of a traced system call (see prism/util/build_tools/strace.py) */
+struct Item
+{
+    enum Kind
+    {
+        string,
+        list,
+        other
+    } kind;
+    std::string       text;
+    std::vector<Item> items;
+};
+
+/* The executable, arguments, and environment of an `execve` record */
+struct Record
+{
+    std::string              executable;
+    std::vector<std::string> args;
+    std::vector<std::string> env;
+};
+
+struct LogResult
+{
+    std::vector<Record> records;
+    std::string         error;
+};
+
+static inline int hex_value(char c)
+{
+    if (c >= '0' and c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' and c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' and c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/*
+ * A recursive descent parser for the arguments of one strace record.
+ */
+class RecordParser
+{
+  public:
+    RecordParser(const char* beg, const char* end) : pos(beg), end(end)
+    {
+    }
+
+    /*
+     * Parse the parenthesized arguments of the first system call in
+     * the line.
+     */
+    bool parse(std::vector<Item>& items)
+    {
+        // skip the optional timestamp and PID prefix to the call name
+        while (pos < end and *pos != '(')
+        {
+            if (*pos == '"')
+            {
+                return false;
+            }
+            pos++;
+        }
+        if (pos == end)
+        {
+            return false;
+        }
+        pos++;
+        return parse_items(items, ')');
+    }
+
+  private:
+    const char* pos;
+    const char* end;
+
+    void skip_space()
+    {
+        while (pos < end and (*pos == ' ' or *pos == '\t'))
+        {
+            pos++;
+        }
+    }
+
+    bool parse_items(std::vector<Item>& items, char close)
+    {
+        skip_space();
+        if (pos < end and *pos == close)
+        {
+            pos++;
+            return true;
+        }
+        while (pos < end)
+        {
+            items.emplace_back();
+            if (!parse_item(items.back()))
+            {
+                return false;
+            }
+            skip_space();
+            if (pos == end)
+            {
+                return false;
+            }
+            if (*pos == close)
+            {
+                pos++;
+                return true;
+            }
+            if (*pos != ',')
+            {
+                return false;
+            }
+            pos++;
+            skip_space();
+        }
+        return false;
+    }
+
+    bool parse_item(Item& item)
+    {
+        if (pos < end and *pos == '"')
+        {
+            item.kind = Item::string;
+            if (!parse_string(item.text))
+            {
+                return false;
+            }
+            // a truncated string is followed by an ellipsis
+            if (end - pos >= 3 and std::memcmp(pos, "...", 3) == 0)
+            {
+                pos += 3;
+            }
+            return true;
+        }
+        if (pos < end and *pos == '[')
+        {
+            pos++;
+            item.kind = Item::list;
+            return parse_items(item.items, ']');
+        }
+        // any other token extends to the next delimiter at depth 0
+        item.kind         = Item::other;
+        const char* start = pos;
+        int         depth = 0;
+        while (pos < end)
+        {
+            char c = *pos;
+            if (c == '"')
+            {
+                std::string ignored;
+                if (!parse_string(ignored))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '(' or c == '[' or c == '{')
+            {
+                depth++;
+            }
+            else if (c == ')' or c == ']' or c == '}')
+            {
+                if (depth == 0)
+                {
+                    break;
+                }
+                depth--;
+            }
+            else if (c == ',' and depth == 0)
+            {
+                break;
+            }
+            pos++;
+        }
+        item.text.assign(start, pos);
+        while (!item.text.empty() and item.text.back() == ' ')
+        {
+            item.text.pop_back();
+        }
+        return true;
+    }
+
+    /*
+     * Parse a C string literal with strace's escapes.
+     */
+    bool parse_string(std::string& text)
+    {
+        pos++;  // opening quote
+        while (pos < end)
+        {
+            char c = *pos++;
+            if (c == '"')
+            {
+                return true;
+            }
+            if (c != '\\')
+            {
+                text.push_back(c);
+                continue;
+            }
+            if (pos == end)
+            {
+                return false;
+            }
+            c = *pos++;
+            switch (c)
+            {
+                case 'x':
+                {
+                    int hi = pos < end ? hex_value(pos[0]) : -1;
+                    int lo = pos + 1 < end ? hex_value(pos[1]) : -1;
+                    if (hi < 0 or lo < 0)
+                    {
+                        return false;
+                    }
+                    text.push_back((char)(hi * 16 + lo));
+                    pos += 2;
+                    break;
+                }
+                case 'n': text.push_back('\n'); break;
+                case 't': text.push_back('\t'); break;
+                case 'r': text.push_back('\r'); break;
+                case 'v': text.push_back('\v'); break;
+                case 'f': text.push_back('\f'); break;
+                default:
+                    if (c >= '0' and c <= '7')
+                    {
+                        int value = c - '0';
+                        for (int k = 0; k < 2 and pos < end; k++)
+                        {
+                            if (*pos < '0' or *pos > '7')
+                            {
+                                break;
+                            }
+                            value = value * 8 + (*pos++ - '0');
+                        }
+                        text.push_back((char)value);
+                    }
+                    else
+                    {
+                        text.push_back(c);
+                    }
+            }
+        }
+        return false;
+    }
+};
+
+static bool to_strings(const Item& item, std::vector<std::string>& out)
+{
+    if (item.kind != Item::list)
+    {
+        return false;
+    }
+    for (const Item& element : item.items)
+    {
+        if (element.kind != Item::string)
+        {
+            return false;
+        }
+        out.push_back(element.text);
+    }
+    return true;
+}
+
+/*
+ * Parse every record of a log that contains the needle.
+ */
+static void scan_log(const char* path, const std::string& needle, LogResult& result)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        result.error = std::string("Cannot open ") + path + ": " + std::strerror(errno);
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        result.error = std::string("Cannot stat ") + path + ": " + std::strerror(errno);
+        close(fd);
+        return;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size == 0)
+    {
+        close(fd);
+        return;
+    }
+    void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        result.error = std::string("Cannot map ") + path + ": " + std::strerror(errno);
+        return;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    const char* data = (const char*)mapped;
+    const char* end  = data + size;
+    const char* pos  = data;
+    while (pos < end)
+    {
+        const char* hit = (const char*)memmem(
+            pos, (size_t)(end - pos), needle.data(), needle.size());
+        if (hit == NULL)
+        {
+            break;
+        }
+        const char* line_beg = hit;
+        while (line_beg > pos and line_beg[-1] != '\n')
+        {
+            line_beg--;
+        }
+        const char* line_end = (const char*)memchr(hit, '\n', (size_t)(end - hit));
+        if (line_end == NULL)
+        {
+            line_end = end;
+        }
+        std::vector<Item> items;
+        RecordParser      parser(line_beg, line_end);
+        Record            record;
+        if (!parser.parse(items) or items.size() < 3 or items[0].kind != Item::string
+            or !to_strings(items[1], record.args) or !to_strings(items[2], record.env))
+        {
+            result.error = std::string("Cannot parse strace record in ") + path + ": "
+                         + std::string(line_beg, line_end);
+            break;
+        }
+        record.executable = items[0].text;
+        result.records.push_back(std::move(record));
+        pos = line_end;
+    }
+    munmap(mapped, size);
+}
+
+static PyObject* decode(const std::string& text)
+{
+    return PyUnicode_DecodeUTF8(text.data(), (Py_ssize_t)text.size(), "strict");
+}
+
+static PyObject* decode_list(const std::vector<std::string>& texts)
+{
+    PyObject* list = PyList_New((Py_ssize_t)texts.size());
+    if (list == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        PyObject* text = decode(texts[i]);
+        if (text == NULL)
+        {
+            Py_DecRef(list);
+            return NULL;
+        }
+        PyList_SetItem(list, (Py_ssize_t)i, text);
+    }
+    return list;
+}
+
+static PyObject* record_to_tuple(const Record& record)
+{
+    PyObject* executable = decode(record.executable);
+    PyObject* args       = executable == NULL ? NULL : decode_list(record.args);
+    PyObject* env        = args == NULL ? NULL : decode_list(record.env);
+    PyObject* result     = NULL;
+    if (env != NULL)
+    {
+        result = PyTuple_Pack(3, executable, args, env);
+    }
+    Py_DecRef(executable);
+    Py_DecRef(args);
+    Py_DecRef(env);
+    return result;
+}
+
+static PyObject* parse_execve_logs(PyObject* self, PyObject* args)
+{
+    PyObject*  paths_obj   = NULL;
+    const char* needle_data = NULL;
+    Py_ssize_t needle_size = 0;
+    int        max_workers = 1;
+    if (!PyArg_ParseTuple(
+            args, "Oy#i", &paths_obj, &needle_data, &needle_size, &max_workers))
+    {
+        return NULL;
+    }
+    PyObject* paths_seq = PySequence_Fast(paths_obj, "paths must be a sequence");
+    if (paths_seq == NULL)
+    {
+        return NULL;
+    }
+    std::vector<std::string> paths;
+    Py_ssize_t               n = PySequence_Size(paths_seq);
+    for (Py_ssize_t i = 0; i < n; i++)
+    {
+        PyObject* path    = PySequence_GetItem(paths_seq, i);
+        PyObject* encoded = path == NULL ? NULL : PyUnicode_EncodeFSDefault(path);
+        Py_DecRef(path);
+        const char* data = encoded == NULL ? NULL : PyBytes_AsString(encoded);
+        if (data == NULL)
+        {
+            Py_DecRef(encoded);
+            Py_DecRef(paths_seq);
+            return NULL;
+        }
+        paths.emplace_back(data);
+        Py_DecRef(encoded);
+    }
+    Py_DecRef(paths_seq);
+    std::string            needle(needle_data, (size_t)needle_size);
+    std::vector<LogResult> results(paths.size());
+    if (needle.empty())
+    {
+        PyErr_SetString(PyExc_ValueError, "needle must not be empty");
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    std::atomic<size_t> next(0);
+    auto                work = [&]() {
+        for (size_t i = next++; i < paths.size(); i = next++)
+        {
+            scan_log(paths[i].c_str(), needle, results[i]);
+        }
+    };
+    size_t num_threads = max_workers < 1 ? 1 : (size_t)max_workers;
+    if (num_threads > paths.size())
+    {
+        num_threads = paths.size();
+    }
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; t++)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    Py_END_ALLOW_THREADS
+    PyObject* result = PyList_New((Py_ssize_t)results.size());
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (!results[i].error.empty())
+        {
+            PyErr_SetString(PyExc_ValueError, results[i].error.c_str());
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyObject* records = PyList_New((Py_ssize_t)results[i].records.size());
+        if (records == NULL)
+        {
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyList_SetItem(result, (Py_ssize_t)i, records);
+        for (size_t j = 0; j < results[i].records.size(); j++)
+        {
+            PyObject* record = record_to_tuple(results[i].records[j]);
+            if (record == NULL)
+            {
+                Py_DecRef(result);
+                return NULL;
+            }
+            PyList_SetItem(records, (Py_ssize_t)j, record);
+        }
+    }
+    return result;
+};
+
+static PyMethodDef StraceMethods[] = {
+    {"parse_execve_logs",
+     parse_execve_logs, METH_VARARGS,
+     "Parse the `execve` records of strace logs that contain a string."},
+    {NULL,                NULL, 0,            NULL                       }
+};
+
+static struct PyModuleDef strace_module = {PyModuleDef_HEAD_INIT,
+                                           "prism.util.build_tools._strace",
+                                           "Library for parsing strace logs",
+                                           -1,
+                                           StraceMethods};
+
+PyMODINIT_FUNC            PyInit__strace(void)
+{
+    return PyModule_Create(&strace_module);
+};
@@ -40,6 +40,7 @@ from strace_parser.parser import get_parser
 
 from prism.interface.coq.options import SerAPIOptions
 from prism.util.bash import escape
+from prism.util.build_tools._strace import parse_execve_logs
 from prism.util.opam.switch import OpamSwitch
 from prism.util.radpytools import PathLike
 
@@ -155,6 +156,49 @@ def _dict_of_list(el: Sequence[str], split: str = '=') -> Dict[str, str]:
     return d
 
 
+def _contexts_of_record(
+        executable: str,
+        args: List[str],
+        env: List[str],
+        regex: str) -> List[CoqContext]:
+    """
+    Get a CoqContext for each argument of a call matching regex.
+
+    Parameters
+    ----------
+    executable : str
+        The path of the called executable.
+    args : List[str]
+        The arguments of the call.
+    env : List[str]
+        The environment of the call as a list of ``NAME=VALUE``
+        strings.
+    regex : str
+        The pattern identifying targets of the executable.
+
+    Returns
+    -------
+    List[CoqContext]
+        One context per argument that fully matches `regex`.
+    """
+    p_context = ProcContext(
+        executable=executable,
+        args=args,
+        env=_dict_of_list(env))
+    res = []
+    for target in p_context.args:
+        if re.compile(regex).fullmatch(target):
+            pwd = p_context.env['PWD']
+            coq_context = CoqContext(
+                pwd=pwd,
+                executable=p_context.executable,
+                target=target,
+                args=p_context.args,
+                env=p_context.env)
+            res.append(coq_context)
+    return res
+
+
 def _record_context(line: str,
                     parser: lark.Lark,
                     regex: str) -> List[CoqContext]:
@@ -174,24 +218,13 @@ def _record_context(line: str,
     assert isinstance(executable, str)
     assert isinstance(args, list)
     assert isinstance(env, list)
-    p_context = ProcContext(
-        executable=executable,
-        args=typing.cast(List[str],
-                         args),
-        env=_dict_of_list(typing.cast(List[str],
-                                      env)))
-    res = []
-    for target in p_context.args:
-        if re.compile(regex).fullmatch(target):
-            pwd = p_context.env['PWD']
-            coq_context = CoqContext(
-                pwd=pwd,
-                executable=p_context.executable,
-                target=target,
-                args=p_context.args,
-                env=p_context.env)
-            res.append(coq_context)
-    return res
+    return _contexts_of_record(
+        executable,
+        typing.cast(List[str],
+                    args),
+        typing.cast(List[str],
+                    env),
+        regex)
 
 
 def _hex_rep(b: str) -> str:
@@ -313,20 +346,74 @@ def _parse_strace_line(parser: lark.Lark, line: str) -> RecursiveStrList:
     raise ValueError(f"can't parse lark object {p}")
 
 
-def _parse_strace_logdir(logdir: str,
-                         executable: str,
-                         regex: str) -> List[CoqContext]:
+def _parse_strace_logdir(
+        logdir: str,
+        executable: str,
+        regex: str,
+        max_workers: Optional[int] = None) -> List[CoqContext]:
     """
     Parse the strace log directory.
 
     For each strace log file in logdir, for each strace record in log
     file, parse the record matching to executable calling regex and save
-    the call information _pycoq_context
+    the call information _pycoq_context.
+
+    The logs are memory-mapped and scanned for records of the
+    executable in parallel by a native parser, which decodes the hex
+    escapes of each record directly.
+    Only the matching records are converted to Python objects.
+
+    Parameters
+    ----------
+    logdir : str
+        The directory containing the logs.
+    executable : str
+        The executable whose calls should be parsed.
+    regex : str
+        The pattern identifying targets of the executable.
+    max_workers : Optional[int], optional
+        The maximum number of logs to parse simultaneously, by default
+        the number of CPUs.
+
+    Returns
+    -------
+    List[CoqContext]
+        The contexts of the matching calls in the order of
+        ``os.listdir(logdir)`` and then in the order of each log.
+
+    Raises
+    ------
+    ValueError
+        If a record of the executable cannot be parsed.
     """
     logging.info(
         f"pycoq: parsing strace log "
         f"execve({executable}) and recording "
         f"arguments that match {regex} in cwd {os.getcwd()}")
+    if max_workers is None:
+        max_workers = os.cpu_count() or 1
+    paths = [
+        os.path.join(logdir,
+                     logfname_pid) for logfname_pid in os.listdir(logdir)
+    ]
+    needle = _hex_rep(executable).encode('ascii')
+    res = []
+    for path, records in zip(paths, parse_execve_logs(paths, needle, max_workers)):
+        if records:
+            logging.info(f"from {logdir} from {path} parsing..")
+        for record_executable, args, env in records:
+            res += _contexts_of_record(record_executable, args, env, regex)
+    return res
+
+
+def _py_parse_strace_logdir(logdir: str,
+                            executable: str,
+                            regex: str) -> List[CoqContext]:
+    """
+    Parse the strace log directory.
+
+    This is the reference implementation of `_parse_strace_logdir`.
+    """
     parser = get_parser()
     res = []
     for logfname_pid in os.listdir(logdir):
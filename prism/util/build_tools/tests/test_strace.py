@@ -0,0 +1,229 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for prism.util.build_tools.strace.
+"""
+import json
+import os
+import tempfile
+import unittest
+from typing import List
+
+from prism.tests import _DATA_PATH
+from prism.util.build_tools.strace import (
+    CoqContext,
+    _hex_rep,
+    _parse_strace_logdir,
+    _py_parse_strace_logdir,
+)
+
+_STRACE_LOGS_PATH = _DATA_PATH / "strace_logs"
+
+
+def _execve(executable: str, args: List[str], env: List[str]) -> str:
+    """
+    Format an `execve` record as logged by ``strace -v -xx -ttt``.
+    """
+
+    def quote(s: str) -> str:
+        return f'"{_hex_rep(s)}"'
+
+    args_str = ", ".join(quote(a) for a in args)
+    env_str = ", ".join(quote(e) for e in env)
+    return (
+        f'1680000000.123456 execve({quote(executable)}, [{args_str}], '
+        f'[{env_str}]) = 0\n')
+
+
+class TestStrace(unittest.TestCase):
+    """
+    Test suite for parsing strace logs.
+    """
+
+    def setUp(self) -> None:
+        """
+        Write synthetic strace logs to a temporary directory.
+        """
+        self.logdir = tempfile.TemporaryDirectory()
+        self.env = ["PWD=/home/user/proj", "PATH=/usr/bin:/bin", "X=a=b"]
+        self.logs = {
+            "strace.log.1":
+                _execve("/bin/bash",
+                        ["bash",
+                         "-c",
+                         "make"],
+                        self.env) + "1680000000.2 +++ exited with 0 +++\n",
+            "strace.log.2":
+                '1680000000.1 --- SIGCHLD {si_signo=SIGCHLD, si_pid=2} ---\n'
+                + _execve(
+                    "/usr/bin/coqc",
+                    ["coqc",
+                     "-R",
+                     "theories",
+                     "Proj",
+                     "theories/A.v"],
+                    self.env) + _execve(
+                        "/usr/bin/coqc",
+                        ["coqc",
+                         "-Q",
+                         "src",
+                         "Src",
+                         "src/B.v",
+                         "src/Ü.v"],
+                        self.env + ["INSIDE_DUNE=1"]),
+            "strace.log.3":
+                _execve("/usr/bin/coqc",
+                        ["coqc",
+                         "--version"],
+                        self.env),
+        }
+        for name, text in self.logs.items():
+            with open(os.path.join(self.logdir.name, name), "w") as f:
+                f.write(text)
+
+    def tearDown(self) -> None:
+        """
+        Remove the temporary logs.
+        """
+        self.logdir.cleanup()
+
+    def test_parse_strace_logdir(self) -> None:
+        """
+        Verify that Coq invocations are extracted from the logs.
+        """
+        contexts = _parse_strace_logdir(self.logdir.name, "coqc", r".*\.v$")
+        self.assertEqual(
+            sorted(c.target for c in contexts),
+            ["src/B.v",
+             "src/Ü.v",
+             "theories/A.v"])
+        for context in contexts:
+            self.assertEqual(context.pwd, "/home/user/proj")
+            self.assertEqual(context.executable, "/usr/bin/coqc")
+            self.assertEqual(context.env["X"], "a=b")
+            self.assertIn(context.target, context.args)
+        by_target = {
+            c.target: c for c in contexts
+        }
+        self.assertEqual(
+            by_target["theories/A.v"].args,
+            ["coqc",
+             "-R",
+             "theories",
+             "Proj",
+             "theories/A.v"])
+        self.assertIn("INSIDE_DUNE", by_target["src/B.v"].env)
+
+    def test_max_workers(self) -> None:
+        """
+        Verify that the result does not depend on the number of workers.
+        """
+        expected = _parse_strace_logdir(
+            self.logdir.name,
+            "coqc",
+            r".*\.v$",
+            max_workers=1)
+        for max_workers in [2, 8]:
+            self.assertEqual(
+                _parse_strace_logdir(
+                    self.logdir.name,
+                    "coqc",
+                    r".*\.v$",
+                    max_workers=max_workers),
+                expected)
+
+    def test_escapes(self) -> None:
+        """
+        Verify that strace's string escapes and ellipses are decoded.
+        """
+        with open(os.path.join(self.logdir.name, "strace.log.4"), "w") as f:
+            f.write(
+                '1680000000.5 execve("/usr/bin/coqc", ["coqc", "a\\tb\\n",'
+                ' "C.v"], ["PWD=/tmp\\x2fsub", "LONG=\\x61"...]) = 0\n')
+        contexts = _parse_strace_logdir(self.logdir.name, "coqc", r"C\.v")
+        self.assertEqual(len(contexts), 0)
+        with open(os.path.join(self.logdir.name, "strace.log.4"), "w") as f:
+            f.write(
+                '1680000000.5 execve("\\x63\\x6f\\x71\\x63", ["coqc", '
+                '"a\\tb\\n", "\\103.v"], ["PWD=/tmp\\x2fsub",'
+                ' "LONG=\\x61"...]) = 0\n')
+        contexts = _parse_strace_logdir(self.logdir.name, "coqc", r"C\.v")
+        self.assertEqual(len(contexts), 1)
+        self.assertEqual(contexts[0].args, ["coqc", "a\tb\n", "C.v"])
+        self.assertEqual(contexts[0].env,
+                         {
+                             "PWD": "/tmp/sub",
+                             "LONG": "a"
+                         })
+
+    def test_malformed(self) -> None:
+        """
+        Verify that unparseable records of the executable are reported.
+        """
+        with open(os.path.join(self.logdir.name, "strace.log.4"), "w") as f:
+            f.write('1680000000.5 execve("\\x63\\x6f\\x71\\x63", ["coqc"\n')
+        with self.assertRaises(ValueError):
+            _parse_strace_logdir(self.logdir.name, "coqc", r".*\.v$")
+
+    def test_fixtures(self) -> None:
+        """
+        Verify the parse of checked-in logs against expected contexts.
+
+        The logs imitate those of `strace_build`, including failed
+        calls, calls that merely mention the executable, and escaped
+        non-ASCII and control characters.
+        """
+        with open(_DATA_PATH / "strace_logs.json", "r") as f:
+            expected_by_log = json.load(f)
+        expected = [
+            CoqContext(**context)
+            for log in os.listdir(_STRACE_LOGS_PATH)
+            for context in expected_by_log.get(log, [])
+        ]
+        for max_workers in [1, 4]:
+            self.assertEqual(
+                _parse_strace_logdir(
+                    str(_STRACE_LOGS_PATH),
+                    "coqc",
+                    r".*\.v$",
+                    max_workers=max_workers),
+                expected)
+
+    def test_reference(self) -> None:
+        """
+        Verify that the native parser agrees with the reference parser.
+        """
+        try:
+            expected = _py_parse_strace_logdir(
+                self.logdir.name,
+                "coqc",
+                r".*\.v$")
+        except NotImplementedError:
+            self.skipTest("strace_parser is unavailable")
+        self.assertEqual(
+            _parse_strace_logdir(self.logdir.name,
+                                 "coqc",
+                                 r".*\.v$"),
+            expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,186 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+A content-addressed cache of values derived from files.
+"""
+import hashlib
+import os
+import pickle
+import tempfile
+import threading
+from collections import OrderedDict
+from pathlib import Path
+from typing import Callable, Generic, Optional, TypeVar
+
+from prism.util.radpytools import PathLike
+
+__all__ = ['ContentCache']
+
+T = TypeVar('T')
+
+
+class ContentCache(Generic[T]):
+    """
+    A cache of values keyed by a hash of the contents they derive from.
+
+    Values are kept in memory and, if a cache directory is given, on
+    disk as pickles, where they persist across processes.
+    Since identical contents share an entry, contents that do not
+    change between, e.g., commits are processed only once.
+    """
+
+    version: int = 1
+    """
+    The version of the cached values, which qualifies values on disk.
+
+    Subclasses should increment it whenever the derivation or the type
+    of their values changes so that stale values are not served.
+    """
+
+    def __init__(
+            self,
+            cache_dir: Optional[PathLike] = None,
+            maxsize: Optional[int] = 1024) -> None:
+        self.cache_dir = Path(cache_dir) if cache_dir is not None else None
+        """
+        The directory in which values persist or None if they are only
+        kept in memory.
+        """
+        self.maxsize = maxsize
+        """
+        The maximum number of values kept in memory, the least recently
+        used of which are evicted first, or None if unbounded.
+        """
+        self._values: OrderedDict[str, T] = OrderedDict()
+        self._lock = threading.Lock()
+
+    def __len__(self) -> int:  # noqa: D105
+        return len(self._values)
+
+    def _value_path(self, digest: str) -> Path:
+        assert self.cache_dir is not None
+        return self.cache_dir / f"v{self.version}" / digest[: 2] / digest
+
+    def _write(self, path: Path, data: bytes) -> None:
+        """
+        Atomically write data to a file in the cache directory.
+        """
+        path.parent.mkdir(parents=True, exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=path.parent)
+        try:
+            with os.fdopen(fd, "wb") as f:
+                f.write(data)
+            os.replace(tmp, path)
+        except BaseException:
+            os.unlink(tmp)
+            raise
+
+    def _remember(self, digest: str, value: T) -> T:
+        """
+        Add a value to the in-memory cache unless already present.
+
+        Returns
+        -------
+        T
+            The cached value.
+        """
+        with self._lock:
+            value = self._values.setdefault(digest, value)
+            self._values.move_to_end(digest)
+            if self.maxsize is not None:
+                while len(self._values) > self.maxsize:
+                    self._values.popitem(last=False)
+        return value
+
+    def get(self, digest: str) -> Optional[T]:
+        """
+        Get a cached value.
+
+        Parameters
+        ----------
+        digest : str
+            The hash of the contents from which the value derives (see
+            `digest`).
+
+        Returns
+        -------
+        Optional[T]
+            The value or None if it is not cached.
+        """
+        with self._lock:
+            value = self._values.get(digest)
+            if value is not None:
+                self._values.move_to_end(digest)
+        if value is None and self.cache_dir is not None:
+            try:
+                with open(self._value_path(digest), "rb") as f:
+                    value = pickle.load(f)
+            except (FileNotFoundError, EOFError, pickle.UnpicklingError):
+                # a missing or corrupt value is simply derived again
+                return None
+            value = self._remember(digest, value)
+        return value
+
+    def get_or_compute(self, digest: str, compute: Callable[[], T]) -> T:
+        """
+        Get a cached value, deriving and caching it if necessary.
+
+        Parameters
+        ----------
+        digest : str
+            The hash of the contents from which the value derives (see
+            `digest`).
+        compute : Callable[[], T]
+            A function that derives the value.
+            Nothing is cached if it raises an exception.
+
+        Returns
+        -------
+        T
+            The value.
+        """
+        value = self.get(digest)
+        if value is None:
+            value = compute()
+            if self.cache_dir is not None:
+                self._write(
+                    self._value_path(digest),
+                    pickle.dumps(value,
+                                 protocol=pickle.HIGHEST_PROTOCOL))
+            value = self._remember(digest, value)
+        return value
+
+    @staticmethod
+    def digest(data: bytes) -> str:
+        """
+        Hash contents from which a value derives.
+
+        Parameters
+        ----------
+        data : bytes
+            The contents.
+
+        Returns
+        -------
+        str
+            A hexadecimal digest of the contents.
+        """
+        return hashlib.blake2b(data, digest_size=20).hexdigest()
@@ -0,0 +1,399 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Compact binary encodings of string deltas and primitive values.
+"""
+import re
+import struct
+from difflib import SequenceMatcher
+from typing import Any, List, Tuple
+
+from prism.util._delta import (
+    apply_str_delta,
+    common_affix_lengths,
+    pack_value,
+    unpack_value,
+)
+
+__all__ = [
+    'apply_str_delta',
+    'compute_str_delta',
+    'pack_value',
+    'unpack_value',
+]
+
+_COPY = 0
+"""
+Copy the given number of code points from the base string.
+"""
+_SKIP = 1
+"""
+Skip the given number of code points of the base string.
+"""
+_INSERT = 2
+"""
+Insert the given number of bytes of UTF-8 encoded text.
+"""
+
+_MAX_ALIGNMENT_COST = 1 << 16
+"""
+The maximum product of the numbers of tokens in the changed regions of
+two strings for which the regions are aligned.
+
+Regions too large to align with fine-grained tokens are aligned with
+coarse tokens, and regions too large for coarse tokens are simply
+replaced, which bounds the (quadratic) cost of alignment.
+"""
+
+_token_res = [
+    re.compile(r"\w+|\s+|.",
+               re.DOTALL),
+    re.compile(r"\S+\s*|\s+"),
+]
+"""
+Patterns for fine-grained and coarse tokens.
+"""
+
+
+def _write_varint(out: bytearray, value: int) -> None:
+    """
+    Append a nonnegative integer in LEB128 form.
+    """
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _read_varint(data: bytes, pos: int) -> Tuple[int, int]:
+    """
+    Read a nonnegative integer in LEB128 form.
+
+    Returns
+    -------
+    int
+        The integer.
+    int
+        The position after the integer.
+    """
+    value = 0
+    shift = 0
+    while True:
+        try:
+            byte = data[pos]
+        except IndexError:
+            raise ValueError("Truncated varint") from None
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+
+
+def _write_op(out: bytearray, op: int, n: int) -> None:
+    _write_varint(out, (n << 2) | op)
+
+
+def _write_ops(out: bytearray, a: str, b: str) -> None:
+    """
+    Append operations transforming a region of `a` into one of `b`.
+
+    The regions are assumed to have no common prefix or suffix.
+    """
+    for token_re in _token_res:
+        a_tokens = token_re.findall(a)
+        b_tokens = token_re.findall(b)
+        if len(a_tokens) * len(b_tokens) <= _MAX_ALIGNMENT_COST:
+            break
+    if (len(a_tokens) * len(b_tokens) > _MAX_ALIGNMENT_COST or not a or not b):
+        opcodes = [('replace', 0, len(a_tokens), 0, len(b_tokens))]
+    else:
+        opcodes = SequenceMatcher(
+            None,
+            a_tokens,
+            b_tokens,
+            autojunk=False).get_opcodes()
+    # convert token indices to code point offsets
+    a_offsets = [0]
+    for token in a_tokens:
+        a_offsets.append(a_offsets[-1] + len(token))
+    b_offsets = [0]
+    for token in b_tokens:
+        b_offsets.append(b_offsets[-1] + len(token))
+    for tag, i1, i2, j1, j2 in opcodes:
+        a_len = a_offsets[i2] - a_offsets[i1]
+        if tag == 'equal':
+            _write_op(out, _COPY, a_len)
+            continue
+        if a_len:
+            _write_op(out, _SKIP, a_len)
+        if j2 > j1:
+            inserted = b[b_offsets[j1]: b_offsets[j2]].encode('utf-8')
+            _write_op(out, _INSERT, len(inserted))
+            out.extend(inserted)
+
+
+def compute_str_delta(a: str, b: str) -> bytes:
+    """
+    Compute a compact binary delta that transforms one string into another.
+
+    Parameters
+    ----------
+    a, b : str
+        Two strings.
+
+    Returns
+    -------
+    bytes
+        A delta such that ``apply_str_delta(a, delta) == b``.
+        The delta is a sequence of operations that copy or skip code
+        points of `a` or insert new text.
+
+    Notes
+    -----
+    Common prefixes and suffixes are matched before the remainder is
+    aligned token-wise, so a delta for a localized change is both cheap
+    to compute and proportional in size to the change.
+    """
+    out = bytearray()
+    prefix, suffix = common_affix_lengths(a, b)
+    if prefix:
+        _write_op(out, _COPY, prefix)
+    a_mid = a[prefix : len(a) - suffix]
+    b_mid = b[prefix : len(b) - suffix]
+    if a_mid or b_mid:
+        _write_ops(out, a_mid, b_mid)
+    if suffix:
+        _write_op(out, _COPY, suffix)
+    return bytes(out)
+
+
+def _py_common_affix_lengths(a: str, b: str) -> Tuple[int, int]:
+    """
+    Compute the lengths of the common prefix and suffix of two strings.
+
+    This is the reference implementation of `common_affix_lengths`.
+
+    Returns
+    -------
+    int
+        The length of the longest common prefix.
+    int
+        The length of the longest common suffix that does not overlap
+        the common prefix in either string.
+    """
+    prefix = 0
+    max_prefix = min(len(a), len(b))
+    while prefix < max_prefix and a[prefix] == b[prefix]:
+        prefix += 1
+    suffix = 0
+    max_suffix = max_prefix - prefix
+    while suffix < max_suffix and a[-1 - suffix] == b[-1 - suffix]:
+        suffix += 1
+    return prefix, suffix
+
+
+def _py_apply_str_delta(a: str, delta: bytes) -> str:
+    """
+    Apply a delta computed by `compute_str_delta`.
+
+    This is the reference implementation of `apply_str_delta`.
+
+    Raises
+    ------
+    ValueError
+        If the delta is malformed or does not span `a` exactly.
+    """
+    pieces: List[str] = []
+    a_pos = 0
+    pos = 0
+    while pos < len(delta):
+        header, pos = _read_varint(delta, pos)
+        op = header & 0x3
+        n = header >> 2
+        if op == _COPY:
+            if a_pos + n > len(a):
+                raise ValueError("Delta copies beyond the end of the base")
+            pieces.append(a[a_pos : a_pos + n])
+            a_pos += n
+        elif op == _SKIP:
+            if a_pos + n > len(a):
+                raise ValueError("Delta skips beyond the end of the base")
+            a_pos += n
+        elif op == _INSERT:
+            if pos + n > len(delta):
+                raise ValueError("Delta inserts beyond the end of the delta")
+            pieces.append(delta[pos : pos + n].decode('utf-8'))
+            pos += n
+        else:
+            raise ValueError(f"Unknown delta operation {op}")
+    if a_pos != len(a):
+        raise ValueError("Delta does not span the base")
+    return ''.join(pieces)
+
+
+_NONE = 0
+_FALSE = 1
+_TRUE = 2
+_INT = 3
+_NEG_INT = 4
+_FLOAT = 5
+_STR = 6
+_BYTES = 7
+_LIST = 8
+_DICT = 9
+
+_double = struct.Struct("<d")
+
+
+def _pack(out: bytearray, value: Any) -> None:
+    if value is None:
+        out.append(_NONE)
+    elif value is False:
+        out.append(_FALSE)
+    elif value is True:
+        out.append(_TRUE)
+    elif isinstance(value, int):
+        if value >= 0:
+            out.append(_INT)
+            _write_varint(out, value)
+        else:
+            out.append(_NEG_INT)
+            _write_varint(out, -value)
+    elif isinstance(value, float):
+        out.append(_FLOAT)
+        out.extend(_double.pack(value))
+    elif isinstance(value, str):
+        encoded = value.encode('utf-8')
+        out.append(_STR)
+        _write_varint(out, len(encoded))
+        out.extend(encoded)
+    elif isinstance(value, (bytes, bytearray)):
+        out.append(_BYTES)
+        _write_varint(out, len(value))
+        out.extend(value)
+    elif isinstance(value, (list, tuple)):
+        out.append(_LIST)
+        _write_varint(out, len(value))
+        for item in value:
+            _pack(out, item)
+    elif isinstance(value, dict):
+        out.append(_DICT)
+        _write_varint(out, len(value))
+        for k, v in value.items():
+            _pack(out, k)
+            _pack(out, v)
+    else:
+        raise TypeError(f"Cannot pack value of type {type(value)}")
+
+
+def _unpack(data: bytes, pos: int) -> Tuple[Any, int]:
+    try:
+        tag = data[pos]
+    except IndexError:
+        raise ValueError("Truncated value") from None
+    pos += 1
+    if tag == _NONE:
+        return None, pos
+    elif tag == _FALSE:
+        return False, pos
+    elif tag == _TRUE:
+        return True, pos
+    elif tag == _INT:
+        return _read_varint(data, pos)
+    elif tag == _NEG_INT:
+        value, pos = _read_varint(data, pos)
+        return -value, pos
+    elif tag == _FLOAT:
+        if pos + _double.size > len(data):
+            raise ValueError("Truncated value")
+        (value,
+         ) = _double.unpack_from(data,
+                                 pos)
+        return value, pos + _double.size
+    elif tag == _STR or tag == _BYTES:
+        n, pos = _read_varint(data, pos)
+        if pos + n > len(data):
+            raise ValueError("Truncated value")
+        raw = data[pos : pos + n]
+        return (raw.decode('utf-8') if tag == _STR else bytes(raw)), pos + n
+    elif tag == _LIST:
+        n, pos = _read_varint(data, pos)
+        items = []
+        for _ in range(n):
+            item, pos = _unpack(data, pos)
+            items.append(item)
+        return items, pos
+    elif tag == _DICT:
+        n, pos = _read_varint(data, pos)
+        mapping = {}
+        for _ in range(n):
+            k, pos = _unpack(data, pos)
+            mapping[k], pos = _unpack(data, pos)
+        return mapping, pos
+    raise ValueError(f"Unknown value tag {tag}")
+
+
+def _py_pack_value(value: Any) -> bytes:
+    """
+    Encode a tree of primitive values in a compact binary form.
+
+    This is the reference implementation of `pack_value`.
+
+    Parameters
+    ----------
+    value : Any
+        A value composed of None, booleans, integers, floats, strings,
+        bytes, lists (or tuples), and dictionaries, e.g., the result of
+        `seutil.io.serialize`.
+
+    Returns
+    -------
+    bytes
+        The encoded value.
+
+    Raises
+    ------
+    TypeError
+        If the value contains an unsupported type.
+    """
+    out = bytearray()
+    _pack(out, value)
+    return bytes(out)
+
+
+def _py_unpack_value(data: bytes) -> Any:
+    """
+    Decode a value encoded with `pack_value`.
+
+    This is the reference implementation of `unpack_value`.
+
+    Tuples are decoded as lists.
+
+    Raises
+    ------
+    ValueError
+        If the data is malformed.
+    """
+    value, pos = _unpack(data, 0)
+    if pos != len(data):
+        raise ValueError("Trailing data after value")
+    return value
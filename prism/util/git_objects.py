@@ -0,0 +1,498 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+In-process, checkout-free access to the objects of a git repository.
+"""
+import os
+import threading
+from binascii import hexlify, unhexlify
+from pathlib import Path
+from typing import (
+    Any,
+    Dict,
+    Iterable,
+    Iterator,
+    List,
+    NamedTuple,
+    Optional,
+    Set,
+    Tuple,
+)
+
+from git.objects.fun import tree_entries_from_data
+from gitdb import GitDB
+from gitdb.exc import BadObject
+
+from prism.util.radpytools import PathLike
+
+__all__ = ['CommitInfo', 'GitObjectReader']
+
+_TREE_MODE = 0o040000
+"""
+The file mode of a tree (directory) entry.
+"""
+_SUBMODULE_MODE = 0o160000
+"""
+The file mode of a submodule (commit) entry.
+"""
+
+
+class CommitInfo(NamedTuple):
+    """
+    The parsed header of a commit object.
+    """
+
+    hexsha: str
+    """
+    The SHA of the commit.
+    """
+    tree: str
+    """
+    The SHA of the commit's root tree.
+    """
+    parents: Tuple[str, ...]
+    """
+    The SHAs of the commit's parents.
+    """
+    committed_date: int
+    """
+    The commit's timestamp in seconds since the epoch.
+    """
+
+
+class GitObjectReader:
+    """
+    A reader of commits, trees, and blobs in a repository's object store.
+
+    Objects are read directly from loose object files and packfiles
+    (see `gitdb.GitDB`) and references are read directly from the
+    repository's files, so neither subprocesses nor checkouts are
+    required to read a file at an arbitrary commit.
+    The working tree and index are never touched.
+
+    Each thread reads through its own object database, so one reader
+    may be shared by concurrent threads scanning the same clone.
+    """
+
+    def __init__(self, git_dir: PathLike) -> None:
+        git_dir = Path(git_dir)
+        if (git_dir / ".git").exists():
+            # a working tree was given
+            git_dir = git_dir / ".git"
+        if git_dir.is_file():
+            # a linked worktree or submodule
+            with open(git_dir, "r") as f:
+                link = f.read().strip()
+            assert link.startswith("gitdir:")
+            git_dir = git_dir.parent / link[len("gitdir:"):].strip()
+        self.git_dir = git_dir
+        """
+        The repository's git directory.
+        """
+        common_dir = git_dir
+        if (git_dir / "commondir").exists():
+            with open(git_dir / "commondir", "r") as f:
+                common_dir = git_dir / f.read().strip()
+        self.common_dir = common_dir
+        """
+        The directory containing objects and references shared between
+        worktrees, which is usually the `git_dir`.
+        """
+        self._local = threading.local()
+
+    def __getstate__(self) -> Dict[str, Any]:  # noqa: D105
+        # object databases are per-thread and not picklable
+        state = self.__dict__.copy()
+        del state['_local']
+        return state
+
+    def __setstate__(self, state: Dict[str, Any]) -> None:  # noqa: D105
+        self.__dict__.update(state)
+        self._local = threading.local()
+
+    @property
+    def _db(self) -> GitDB:
+        db = getattr(self._local, 'db', None)
+        if db is None:
+            db = GitDB(str(self.common_dir / "objects"))
+            self._local.db = db
+        return db
+
+    def _read_ref_file(self, name: str) -> Optional[str]:
+        for root in (self.git_dir, self.common_dir):
+            try:
+                with open(root / name, "r") as f:
+                    return f.read().strip()
+            except (FileNotFoundError, IsADirectoryError, NotADirectoryError):
+                continue
+        return self._packed_refs().get(name)
+
+    def _packed_refs(self) -> Dict[str, str]:
+        refs: Dict[str,
+                   str] = {}
+        try:
+            with open(self.common_dir / "packed-refs", "r") as f:
+                for line in f:
+                    if line.startswith(('#', '^')):
+                        continue
+                    sha, _, name = line.strip().partition(' ')
+                    if name:
+                        refs[name] = sha
+        except FileNotFoundError:
+            pass
+        return refs
+
+    def _resolve_ref(self, name: str) -> Optional[str]:
+        """
+        Follow a (possibly symbolic) reference to an object SHA.
+        """
+        for _ in range(10):
+            value = self._read_ref_file(name)
+            if value is None:
+                return None
+            if not value.startswith("ref:"):
+                return value
+            name = value[len("ref:"):].strip()
+        raise ValueError(f"Reference cycle at {name}")
+
+    def read(self, sha: str) -> Tuple[str, bytes]:
+        """
+        Read an object.
+
+        Parameters
+        ----------
+        sha : str
+            The full hexadecimal SHA of the object.
+
+        Returns
+        -------
+        str
+            The object's type: ``"commit"``, ``"tree"``, ``"blob"``, or
+            ``"tag"``.
+        bytes
+            The object's uncompressed contents.
+
+        Raises
+        ------
+        ValueError
+            If the object does not exist.
+        """
+        binsha = unhexlify(sha)
+        try:
+            stream = self._db.stream(binsha)
+        except BadObject:
+            # objects may have been packed or fetched since
+            self._db.update_cache(force=True)
+            try:
+                stream = self._db.stream(binsha)
+            except BadObject:
+                raise ValueError(f"No object {sha}") from None
+        return stream.type.decode('ascii'), stream.read()
+
+    def refs(self) -> Dict[str, str]:
+        """
+        Get the object SHA of each reference under ``refs/``.
+
+        Returns
+        -------
+        Dict[str, str]
+            A map from full reference names (e.g., ``refs/heads/main``)
+            to the SHAs of the objects they reference.
+        """
+        refs = self._packed_refs()
+        refs_dir = self.common_dir / "refs"
+        for dirpath, _, filenames in os.walk(refs_dir):
+            for filename in filenames:
+                name = (Path(dirpath) / filename).relative_to(self.common_dir)
+                sha = self._resolve_ref(name.as_posix())
+                if sha is not None:
+                    refs[name.as_posix()] = sha
+        return refs
+
+    def peel(self, sha: str) -> str:
+        """
+        Dereference annotated tags until reaching a non-tag object.
+        """
+        while True:
+            kind, data = self.read(sha)
+            if kind != "tag":
+                return sha
+            sha = data[7 : 47].decode('ascii')  # "object <sha>\n..."
+
+    def resolve(self, rev: str) -> str:
+        """
+        Resolve a revision to a commit SHA.
+
+        Parameters
+        ----------
+        rev : str
+            A full or abbreviated SHA, ``HEAD``, or the full or short
+            name of a branch, tag, or remote-tracking branch.
+
+        Returns
+        -------
+        str
+            The SHA of the commit.
+
+        Raises
+        ------
+        ValueError
+            If the revision cannot be resolved to a commit.
+        """
+        for name in (rev,
+                     f"refs/{rev}",
+                     f"refs/tags/{rev}",
+                     f"refs/heads/{rev}",
+                     f"refs/remotes/{rev}",
+                     f"refs/remotes/{rev}/HEAD"):
+            if name == "HEAD" or name.startswith("refs/"):
+                sha = self._resolve_ref(name)
+                if sha is not None:
+                    return self.peel(sha)
+        if 4 <= len(rev) <= 40 and all(c in "0123456789abcdef" for c in rev):
+            try:
+                binsha = self._db.partial_to_complete_sha_hex(rev)
+            except BadObject:
+                pass
+            else:
+                return self.peel(hexlify(binsha).decode('ascii'))
+        raise ValueError(f"Cannot resolve revision {rev}")
+
+    def commit(self, sha: str) -> CommitInfo:
+        """
+        Read the header of a commit.
+
+        Parameters
+        ----------
+        sha : str
+            The full SHA of a commit.
+
+        Returns
+        -------
+        CommitInfo
+            The commit's tree, parents, and timestamp.
+
+        Raises
+        ------
+        ValueError
+            If the SHA does not name a commit.
+        """
+        kind, data = self.read(sha)
+        if kind != "commit":
+            raise ValueError(f"{sha} is a {kind}, not a commit")
+        tree = ""
+        parents = []
+        committed_date = 0
+        for line in data.split(b"\n"):
+            if not line:
+                # end of header
+                break
+            key, _, value = line.partition(b" ")
+            if key == b"tree":
+                tree = value.decode('ascii')
+            elif key == b"parent":
+                parents.append(value.decode('ascii'))
+            elif key == b"committer":
+                # "<name> <email> <timestamp> <timezone>"
+                committed_date = int(value.rsplit(b" ", 2)[1])
+        return CommitInfo(sha, tree, tuple(parents), committed_date)
+
+    def iter_commits(self,
+                     revs: Optional[Iterable[str]] = None
+                     ) -> Iterator[CommitInfo]:
+        """
+        Iterate over the commits reachable from the given revisions.
+
+        Parameters
+        ----------
+        revs : Optional[Iterable[str]], optional
+            Revisions from which to start, by default ``HEAD`` and all
+            references (i.e., as ``git rev-list --all``).
+
+        Yields
+        ------
+        CommitInfo
+            Each reachable commit exactly once in no particular order.
+        """
+        if revs is None:
+            starts = list(self.refs().values())
+            head = self._resolve_ref("HEAD")
+            if head is not None:
+                starts.append(head)
+        else:
+            starts = [self.resolve(rev) for rev in revs]
+        seen: Set[str] = set()
+        stack = []
+        for sha in starts:
+            sha = self.peel(sha)
+            if self.read(sha)[0] == "commit":
+                stack.append(sha)
+        while stack:
+            sha = stack.pop()
+            if sha in seen:
+                continue
+            seen.add(sha)
+            info = self.commit(sha)
+            stack.extend(p for p in info.parents if p not in seen)
+            yield info
+
+    def tree_entries(self, sha: str) -> List[Tuple[int, str, str]]:
+        """
+        List the entries of a tree.
+
+        Parameters
+        ----------
+        sha : str
+            The SHA of a tree.
+
+        Returns
+        -------
+        List[Tuple[int, str, str]]
+            The mode, name, and SHA of each entry.
+        """
+        kind, data = self.read(sha)
+        if kind != "tree":
+            raise ValueError(f"{sha} is a {kind}, not a tree")
+        return [
+            (mode,
+             name,
+             hexlify(binsha).decode('ascii'))
+            for binsha, mode, name in tree_entries_from_data(data)
+        ]
+
+    def _walk(self, tree: str, prefix: str) -> Iterator[Tuple[str, str]]:
+        for mode, name, sha in self.tree_entries(tree):
+            if mode == _TREE_MODE:
+                yield from self._walk(sha, f"{prefix}{name}/")
+            elif mode != _SUBMODULE_MODE:
+                yield f"{prefix}{name}", sha
+
+    def list_files(self, rev: str) -> Dict[str, str]:
+        """
+        List the files of a commit.
+
+        Parameters
+        ----------
+        rev : str
+            A revision naming a commit (see `resolve`).
+
+        Returns
+        -------
+        Dict[str, str]
+            A map from the path of each file relative to the root of the
+            repository to the SHA of its blob.
+            Submodules are excluded.
+        """
+        return dict(self._walk(self.commit(self.resolve(rev)).tree, ""))
+
+    def read_file(self, rev: str, path: PathLike) -> bytes:
+        """
+        Read a file at a commit.
+
+        Parameters
+        ----------
+        rev : str
+            A revision naming a commit (see `resolve`).
+        path : PathLike
+            The path of the file relative to the root of the repository.
+
+        Returns
+        -------
+        bytes
+            The contents of the file.
+
+        Raises
+        ------
+        FileNotFoundError
+            If the file does not exist at the commit.
+        """
+        sha = self.commit(self.resolve(rev)).tree
+        parts = Path(path).parts
+        for i, part in enumerate(parts):
+            # only the last part may name a file
+            expect_tree = i + 1 < len(parts)
+            for mode, name, entry_sha in self.tree_entries(sha):
+                if name == part and (mode == _TREE_MODE) == expect_tree:
+                    sha = entry_sha
+                    break
+            else:
+                raise FileNotFoundError(f"{path} does not exist at {rev}")
+        return self.read(sha)[1]
+
+    def _changed(
+            self,
+            a: Optional[str],
+            b: Optional[str],
+            prefix: str,
+            changed: Set[str]) -> None:
+        """
+        Collect the paths that differ between two (possibly absent) trees.
+        """
+        a_entries = {} if a is None else {
+            name: (mode,
+                   sha) for mode, name, sha in self.tree_entries(a)
+        }
+        b_entries = {} if b is None else {
+            name: (mode,
+                   sha) for mode, name, sha in self.tree_entries(b)
+        }
+        for name in a_entries.keys() | b_entries.keys():
+            a_entry = a_entries.get(name)
+            b_entry = b_entries.get(name)
+            if a_entry == b_entry:
+                continue
+            a_tree = a_entry is not None and a_entry[0] == _TREE_MODE
+            b_tree = b_entry is not None and b_entry[0] == _TREE_MODE
+            if a_tree or b_tree:
+                self._changed(
+                    a_entry[1] if a_tree else None,
+                    b_entry[1] if b_tree else None,
+                    f"{prefix}{name}/",
+                    changed)
+            a_file = a_entry is not None and not a_tree
+            b_file = b_entry is not None and not b_tree
+            if a_file or b_file:
+                changed.add(f"{prefix}{name}")
+
+    def changed_files(self, a: str, b: str) -> Set[str]:
+        """
+        Get the files that differ between two commits.
+
+        Parameters
+        ----------
+        a, b : str
+            Revisions naming commits (see `resolve`).
+
+        Returns
+        -------
+        Set[str]
+            The paths relative to the root of the repository of files
+            that were added, deleted, or modified (including changes to
+            their modes) between the commits, as listed by
+            ``git diff --no-renames --name-only a b``.
+        """
+        changed: Set[str] = set()
+        self._changed(
+            self.commit(self.resolve(a)).tree,
+            self.commit(self.resolve(b)).tree,
+            "",
+            changed)
+        return changed
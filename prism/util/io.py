@@ -22,16 +22,17 @@
 Provides utility functions for serialized data files.
 """
 import gzip
+import io
 import os
 import shutil
 import tempfile
 import typing
 from pathlib import Path
-from typing import IO, TYPE_CHECKING, Optional, TextIO, Union
+from typing import IO, TYPE_CHECKING, Any, BinaryIO, Optional, TextIO, Union
 
 import ujson
 import yaml
-from seutil.io import Fmt, FmtProperty
+from seutil.io import Fmt, FmtProperty, deserialize, serialize
 
 from prism.util.path import append_suffix
 from prism.util.radpytools.path import PathLike
@@ -181,9 +182,78 @@ def infer_format(filepath: os.PathLike) -> Fmt:
     return formatter
 
 
+def dumps(
+        obj: object,
+        fmt: Fmt = Fmt.json,
+        use_gzip_compression: bool = False) -> bytes:
+    """
+    Serialize an object to bytes as `Serializable.dump` would to file.
+
+    This allows the (potentially expensive) serialization of an object
+    to be performed in a different process than the one that writes it
+    to disk.
+
+    Parameters
+    ----------
+    obj : object
+        An object to serialize.
+    fmt : Fmt, optional
+        The serialization format, by default `Fmt.json`.
+        Line-based formats are not supported.
+    use_gzip_compression : bool, optional
+        Whether to compress the serialized object with gzip.
+
+    Returns
+    -------
+    bytes
+        The serialized object encoded as UTF-8 and optionally
+        compressed.
+    """
+    if fmt.line_mode:
+        raise ValueError(f"Line-based formats are not supported: {fmt}")
+    if fmt.serialize:
+        obj = serialize(obj, fmt=fmt)
+    with io.StringIO() as f:
+        fmt.writer(f, obj)
+        text = f.getvalue()
+    data = text.encode("utf-8")
+    if use_gzip_compression:
+        data = gzip.compress(data)
+    return data
+
+
+def loads(data: bytes, clz: Optional[type] = None, fmt: Fmt = Fmt.json) -> Any:
+    """
+    Deserialize an object from bytes produced by `dumps`.
+
+    Parameters
+    ----------
+    data : bytes
+        The serialized object, which may be compressed with gzip.
+    clz : Optional[type], optional
+        The type of the serialized object, by default None.
+        If None, then the raw deserialized data is returned.
+    fmt : Fmt, optional
+        The serialization format, by default `Fmt.json`.
+
+    Returns
+    -------
+    Any
+        The deserialized object.
+    """
+    if data[: 2] == b"\x1f\x8b":
+        data = gzip.decompress(data)
+    with io.StringIO(data.decode("utf-8")) as f:
+        obj = fmt.reader(f)
+    if fmt.serialize and clz is not None:
+        obj = deserialize(obj, clz)
+    return obj
+
+
 def atomic_write(
         full_file_path: Path,
         file_contents: Union[str,
+                             bytes,
                              'Serializable'],
         use_gzip_compression_for_serializable: bool = False) -> None:
     r"""
@@ -196,8 +266,9 @@ def atomic_write(
     full_file_path : Path
         Full file path, including directory, filename, and extension, to
         write to
-    file_contents : Union[str, Serializable]
+    file_contents : Union[str, bytes, Serializable]
         The contents to write or serialized to the file.
+        Bytes are written verbatim, e.g., as produced by `dumps`.
     use_gzip_compression_for_serializable : bool, optional
         Compress the resulting file using gzip before saving to
         disk. A ``".gz"`` suffix will be added in this case.
@@ -205,11 +276,11 @@ def atomic_write(
     Raises
     ------
     TypeError
-        If `file_contents` is not a string or `Serializable`.
+        If `file_contents` is not a string, bytes, or `Serializable`.
     """
     # TODO: Refactor to avoid circular import
     from prism.util.serialize import Serializable
-    if not isinstance(file_contents, (str, Serializable)):
+    if not isinstance(file_contents, (str, bytes, Serializable)):
         raise TypeError(
             f"Cannot write object of type {type(file_contents)} to file")
     fmt_ext = full_file_path.suffix  # contains leading period
@@ -219,13 +290,20 @@ def atomic_write(
     # Ensure that we write atomically.
     # First, we write to a temporary file so that if we get
     # interrupted, we aren't left with a corrupted file.
-    with typing.cast(TextIO,
-                     PermissiveNamedTemporaryFile("w",
-                                                  delete=False,
-                                                  dir=directory,
-                                                  encoding='utf-8')) as f:
-        if isinstance(file_contents, str):
+    if isinstance(file_contents, bytes):
+        with typing.cast(BinaryIO,
+                         PermissiveNamedTemporaryFile("wb",
+                                                      delete=False,
+                                                      dir=directory)) as f:
             f.write(file_contents)
+    else:
+        with typing.cast(TextIO,
+                         PermissiveNamedTemporaryFile("w",
+                                                      delete=False,
+                                                      dir=directory,
+                                                      encoding='utf-8')) as f:
+            if isinstance(file_contents, str):
+                f.write(file_contents)
     f_name = f.name
     if isinstance(file_contents, Serializable):
         fmt = infer_fmt_from_ext(fmt_ext)
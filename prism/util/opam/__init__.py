@@ -23,6 +23,7 @@ Supplies utilities for querying OCaml package information.
 """
 
 from .api import OpamAPI  # noqa: F401
+from .clone import CloneMethod  # noqa: F401
 from .formula import (  # noqa: F401
     AssignedVariables,
     PackageFormula,
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string>
+#include <vector>
+
+/*
+ * A native implementation of `_py_scan_fields` in
+ * prism/util/opam/file.py, which documents the recognized syntax.
+ */
+
+struct Field
+{
+    Py_ssize_t     name_begin;
+    Py_ssize_t     name_end;
+    std::u32string value;
+};
+
+static inline bool is_blank(Py_UCS4 c)
+{
+    return c == ' ' or c == '\t' or c == '\r' or c == '\n';
+}
+
+static inline bool is_identchar(Py_UCS4 c)
+{
+    return (c >= 'A' and c <= 'Z') or (c >= 'a' and c <= 'z')
+        or (c >= '0' and c <= '9') or c == '-' or c == '_' or c == '+';
+}
+
+class Scanner
+{
+  public:
+    std::vector<Field> fields;
+
+    Scanner(const Py_UCS4* text, Py_ssize_t size) : text(text), size(size) {}
+
+    void scan()
+    {
+        Py_ssize_t pos        = 0;
+        int64_t    depth      = 0;
+        bool       line_start = true;
+        while (pos < size)
+        {
+            Py_UCS4 c = text[pos];
+            if (is_blank(c))
+            {
+                line_start = line_start or c == '\n';
+                value.push_back(c);
+                pos++;
+                continue;
+            }
+            if (depth == 0 and line_start and is_identchar(c))
+            {
+                Py_ssize_t end = pos + 1;
+                while (end < size and is_identchar(text[end]))
+                {
+                    end++;
+                }
+                Py_ssize_t after      = skip_spaces(end);
+                bool       is_field   = at(after, ':');
+                bool       is_section = false;
+                if (!is_field)
+                {
+                    if (at(after, '"'))
+                    {
+                        after = skip_spaces(skip_string(after));
+                    }
+                    is_section = at(after, '{');
+                }
+                if (is_field or is_section)
+                {
+                    finish();
+                    name_begin = pos;
+                    name_end   = end;
+                    in_section = is_section;
+                    pos        = is_field ? after + 1 : end;
+                    line_start = false;
+                    continue;
+                }
+            }
+            line_start = false;
+            if (c == '#' or at(pos, "(*"))
+            {
+                pos = skip_comment(pos);
+                value.push_back(' ');
+                continue;
+            }
+            else if (c == '"')
+            {
+                Py_ssize_t end = skip_string(pos);
+                value.append(text + pos, text + end);
+                pos = end;
+                continue;
+            }
+            else if (c == '(' or c == '[' or c == '{')
+            {
+                depth++;
+            }
+            else if (c == ')' or c == ']' or c == '}')
+            {
+                depth = depth > 0 ? depth - 1 : 0;
+                if (in_section and depth == 0)
+                {
+                    value.push_back(c);
+                    finish();
+                    in_section = false;
+                    pos++;
+                    continue;
+                }
+            }
+            value.push_back(c);
+            pos++;
+        }
+        finish();
+    }
+
+  private:
+    const Py_UCS4*   text;
+    const Py_ssize_t size;
+    /* The current field, if its name begins at a nonnegative position. */
+    Py_ssize_t       name_begin = -1;
+    Py_ssize_t       name_end   = -1;
+    std::u32string   value;
+    bool             in_section = false;
+
+    bool at(Py_ssize_t pos, Py_UCS4 c) const
+    {
+        return pos < size and text[pos] == c;
+    }
+
+    bool at(Py_ssize_t pos, const char* s) const
+    {
+        for (; *s; s++, pos++)
+        {
+            if (!at(pos, (Py_UCS4)*s))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Py_ssize_t skip_spaces(Py_ssize_t pos) const
+    {
+        while (at(pos, ' ') or at(pos, '\t'))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    /* See `_skip_string`. */
+    Py_ssize_t skip_string(Py_ssize_t pos) const
+    {
+        bool        triple = at(pos, "\"\"\"");
+        const char* close  = triple ? "\"\"\"" : "\"";
+        pos += triple ? 3 : 1;
+        while (pos < size)
+        {
+            if (text[pos] == '\\')
+            {
+                pos += 2;
+            }
+            else if (at(pos, close))
+            {
+                return pos + (triple ? 3 : 1);
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        return size;
+    }
+
+    /* See `_skip_comment`. */
+    Py_ssize_t skip_comment(Py_ssize_t pos) const
+    {
+        if (text[pos] == '#')
+        {
+            while (pos < size and text[pos] != '\n')
+            {
+                pos++;
+            }
+            return pos;
+        }
+        pos += 2;
+        int64_t level = 1;
+        while (pos < size and level > 0)
+        {
+            if (at(pos, "(*"))
+            {
+                level++;
+                pos += 2;
+            }
+            else if (at(pos, "*)"))
+            {
+                level--;
+                pos += 2;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        return pos < size ? pos : size;
+    }
+
+    /* Record the current field, if any, with its value stripped. */
+    void finish()
+    {
+        if (name_begin >= 0)
+        {
+            size_t begin = 0;
+            size_t end   = value.size();
+            while (begin < end and is_blank(value[begin]))
+            {
+                begin++;
+            }
+            while (end > begin and is_blank(value[end - 1]))
+            {
+                end--;
+            }
+            fields.push_back({name_begin, name_end, value.substr(begin, end - begin)});
+        }
+        name_begin = -1;
+        value.clear();
+    }
+};
+
+static PyObject* ucs4_to_str(const std::u32string& text)
+{
+    int byteorder = PY_LITTLE_ENDIAN ? -1 : 1;
+    return PyUnicode_DecodeUTF32((const char*)text.data(),
+                                 (Py_ssize_t)(text.size() * sizeof(char32_t)),
+                                 "surrogatepass",
+                                 &byteorder);
+}
+
+static PyObject* scan_fields(PyObject* self, PyObject* args)
+{
+    PyObject* text = NULL;
+    if (!PyArg_ParseTuple(args, "U", &text))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    Scanner scanner(data, size);
+    /* The scanner only touches its own copy of the text. */
+    Py_BEGIN_ALLOW_THREADS
+    scanner.scan();
+    Py_END_ALLOW_THREADS
+    PyMem_Free(data);
+    PyObject* result = PyList_New((Py_ssize_t)scanner.fields.size());
+    for (size_t i = 0; result != NULL and i < scanner.fields.size(); i++)
+    {
+        const Field& field = scanner.fields[i];
+        /* `N` steals references and fails cleanly given NULL arguments */
+        PyObject*    item  = Py_BuildValue(
+            "(NN)",
+            PyUnicode_Substring(text, field.name_begin, field.name_end),
+            ucs4_to_str(field.value));
+        if (item == NULL)
+        {
+            Py_DecRef(result);
+            return NULL;
+        }
+        PyList_SetItem(result, (Py_ssize_t)i, item);
+    }
+    return result;
+};
+
+static PyMethodDef FileMethods[] = {
+    {"scan_fields",
+     scan_fields, METH_VARARGS,
+     "Split the contents of an opam file into its fields."},
+    {NULL,        NULL,        0,            NULL}
+};
+
+static struct PyModuleDef file_module = {PyModuleDef_HEAD_INIT,
+                                         "prism.util.opam._file",
+                                         "Library for scanning opam files",
+                                         -1,
+                                         FileMethods};
+
+PyMODINIT_FUNC            PyInit__file(void)
+{
+    return PyModule_Create(&file_module);
+};
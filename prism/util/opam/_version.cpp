@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string>
+
+/*
+ * Bytes of a version sort key (see `Version.sort_key` in
+ * prism/util/opam/version.py).
+ * Within a non-digit field, '~' sorts before the end of the field,
+ * which sorts before letters, which sort before all other characters.
+ */
+const unsigned char key_tilde       = 0x01;
+const unsigned char key_end         = 0x02;
+const unsigned char key_letter      = 0x03;
+const unsigned char key_other       = 0x40;
+const unsigned char key_long_number = 0xFF;
+
+static inline bool is_digit(Py_UCS4 c)
+{
+    return c >= '0' and c <= '9';
+}
+
+static inline bool is_letter(Py_UCS4 c)
+{
+    return (c >= 'A' and c <= 'Z') or (c >= 'a' and c <= 'z');
+}
+
+/*
+ * Append the key of a non-digit field, which is terminated so that no
+ * key of a field is a prefix of another.
+ */
+static Py_ssize_t append_nondigits(const Py_UCS4* text,
+                                   Py_ssize_t     size,
+                                   Py_ssize_t     pos,
+                                   std::string&   key)
+{
+    for (; pos < size and !is_digit(text[pos]); pos++)
+    {
+        Py_UCS4 c = text[pos];
+        if (c == '~')
+        {
+            key.push_back((char)key_tilde);
+        }
+        else if (is_letter(c))
+        {
+            key.push_back((char)(key_letter + (c - 'A')));
+        }
+        else
+        {
+            key.push_back((char)key_other);
+            key.push_back((char)((c >> 16) & 0xFF));
+            key.push_back((char)((c >> 8) & 0xFF));
+            key.push_back((char)(c & 0xFF));
+        }
+    }
+    key.push_back((char)key_end);
+    return pos;
+}
+
+/*
+ * Append the key of a digit field, i.e., its number of significant
+ * digits followed by the digits themselves.
+ */
+static Py_ssize_t append_digits(const Py_UCS4* text,
+                                Py_ssize_t     size,
+                                Py_ssize_t     pos,
+                                std::string&   key)
+{
+    while (pos < size and text[pos] == '0')
+    {
+        pos++;
+    }
+    Py_ssize_t begin = pos;
+    for (; pos < size and is_digit(text[pos]); pos++)
+    {
+    }
+    Py_ssize_t length = pos - begin;
+    if (length < key_long_number)
+    {
+        key.push_back((char)length);
+    }
+    else
+    {
+        key.push_back((char)key_long_number);
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            key.push_back((char)((length >> shift) & 0xFF));
+        }
+    }
+    for (Py_ssize_t i = begin; i < pos; i++)
+    {
+        key.push_back((char)text[i]);
+    }
+    return pos;
+}
+
+static PyObject* version_key(PyObject* self, PyObject* args)
+{
+    PyObject* version = NULL;
+    if (!PyArg_ParseTuple(args, "U", &version))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = PyUnicode_GetLength(version);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* text = PyUnicode_AsUCS4Copy(version);
+    if (text == NULL)
+    {
+        return NULL;
+    }
+    std::string key;
+    Py_ssize_t  pos      = 0;
+    bool        nondigit = true;
+    do
+    {
+        if (nondigit)
+        {
+            pos = append_nondigits(text, size, pos, key);
+        }
+        else
+        {
+            pos = append_digits(text, size, pos, key);
+        }
+        nondigit = !nondigit;
+    } while (pos < size);
+    PyMem_Free(text);
+    // pad with an empty field like `OpamVersion.fields`
+    if (nondigit)
+    {
+        key.push_back((char)key_end);
+    }
+    else
+    {
+        key.push_back(0);
+    }
+    return PyBytes_FromStringAndSize(key.data(), (Py_ssize_t)key.size());
+};
+
+static PyMethodDef VersionMethods[] = {
+    {"version_key",
+     version_key, METH_VARARGS,
+     "Get a key by which opam versions may be compared bytewise."},
+    {NULL,          NULL,        0,            NULL}
+};
+
+static struct PyModuleDef version_module = {PyModuleDef_HEAD_INIT,
+                                            "prism.util.opam._version",
+                                            "Library for ordering opam versions",
+                                            -1,
+                                            VersionMethods};
+
+PyMODINIT_FUNC            PyInit__version(void)
+{
+    return PyModule_Create(&version_module);
+};
@@ -32,6 +32,7 @@ from typing import ClassVar, Generator, Optional, Union
 from prism.util.exception import raise_
 from prism.util.radpytools import PathLike
 
+from .clone import CloneMethod, copy_tree
 from .switch import OpamSwitch
 from .version import OCamlVersion, Version
 
@@ -118,7 +119,8 @@ class OpamAPI:
             cls,
             switch_name: str,
             clone_name: str,
-            opam_root: Optional[PathLike] = None) -> OpamSwitch:
+            opam_root: Optional[PathLike] = None,
+            method: CloneMethod = CloneMethod.REFLINK) -> OpamSwitch:
         """
         Clone the indicated switch.
 
@@ -138,6 +140,10 @@ class OpamAPI:
             The root of the existing switch and the resulting clone.
             Support for clones at different roots is currently not
             available.
+        method : CloneMethod, optional
+            How to copy the files of the switch, by default with
+            copy-on-write reflinks where the filesystem supports them
+            and full copies otherwise.
 
         Returns
         -------
@@ -165,7 +171,7 @@ class OpamAPI:
                 f"The proposed switch name '{clone_name}' already exists"
                 " or there's a file with that name.")
 
-        shutil.copytree(origin.path, destination, symlinks=True)
+        copy_tree(origin.path, destination, method)
 
         return OpamSwitch(clone_name, opam_root)
 
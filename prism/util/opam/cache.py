@@ -0,0 +1,144 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+A content-addressed cache of parsed opam files.
+"""
+import os
+from concurrent.futures import ThreadPoolExecutor
+from typing import Dict, Iterable, Optional
+
+from prism.util.content_cache import ContentCache
+from prism.util.radpytools import PathLike
+
+from .file import ParsedOpamFile
+
+__all__ = ['OpamFileCache']
+
+
+class OpamFileCache(ContentCache[ParsedOpamFile]):
+    """
+    A cache of parsed opam files keyed by a hash of their contents.
+
+    Since most opam files in a repository do not change between
+    updates, rescanning a repository reduces to reading and hashing
+    its files.
+    """
+
+    version: int = 1
+    """
+    The version of the parser's output.
+    """
+
+    def __init__(
+            self,
+            cache_dir: Optional[PathLike] = None,
+            maxsize: Optional[int] = 4096) -> None:
+        super().__init__(cache_dir, maxsize)
+
+    def parse(self, data: bytes) -> ParsedOpamFile:
+        """
+        Parse the contents of an opam file, consulting the cache first.
+
+        Parameters
+        ----------
+        data : bytes
+            The UTF-8 encoded contents of an opam file.
+
+        Returns
+        -------
+        ParsedOpamFile
+            The parsed file.
+
+        Raises
+        ------
+        ParseError
+            If one of the file's package formulas cannot be parsed, in
+            which case nothing is cached.
+        UnicodeDecodeError
+            If the contents cannot be decoded.
+        """
+        return self.get_or_compute(
+            self.digest(data),
+            lambda: ParsedOpamFile.parse(data.decode('utf-8')))
+
+    def load(self, filename: PathLike) -> ParsedOpamFile:
+        """
+        Parse an opam file, consulting the cache first.
+
+        Parameters
+        ----------
+        filename : PathLike
+            The path to an opam file.
+
+        Returns
+        -------
+        ParsedOpamFile
+            The parsed file.
+
+        Raises
+        ------
+        OSError
+            If the file cannot be read.
+        ParseError
+            If one of the file's package formulas cannot be parsed.
+        UnicodeDecodeError
+            If the file cannot be decoded.
+        """
+        with open(filename, "rb") as f:
+            return self.parse(f.read())
+
+    def load_files(
+            self,
+            filenames: Iterable[PathLike],
+            max_workers: Optional[int] = None) -> Dict[str,
+                                                       ParsedOpamFile]:
+        """
+        Parse opam files in parallel, consulting the cache first.
+
+        Parameters
+        ----------
+        filenames : Iterable[PathLike]
+            Paths to opam files.
+        max_workers : Optional[int], optional
+            The maximum number of files to load at once, by default the
+            number of processors.
+
+        Returns
+        -------
+        Dict[str, ParsedOpamFile]
+            A map from each of the given filenames to its parsed
+            contents.
+
+        Raises
+        ------
+        OSError
+            If a file cannot be read.
+        ParseError
+            If one of the package formulas in a file cannot be parsed.
+        UnicodeDecodeError
+            If a file cannot be decoded.
+        """
+        filenames = [str(f) for f in filenames]
+        if max_workers is None:
+            max_workers = os.cpu_count()
+        with ThreadPoolExecutor(max_workers=max_workers) as executor:
+            parsed = executor.map(self.load, filenames)
+            return dict(zip(filenames, parsed))
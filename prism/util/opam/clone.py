@@ -0,0 +1,189 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Copy-on-write cloning of switch directories.
+"""
+import enum
+import errno
+import fcntl
+import os
+import shutil
+from pathlib import Path
+from typing import Callable, Tuple
+
+from prism.util.radpytools import PathLike
+
+__all__ = ['CloneMethod', 'copy_tree']
+
+_FICLONE = 0x40049409
+"""
+The Linux ioctl request that shares the extents of one file with another
+(see ``ioctl_ficlone(2)``).
+"""
+
+_UNSUPPORTED = {
+    errno.EBADF,
+    errno.EINVAL,
+    errno.ENOTTY,
+    errno.EOPNOTSUPP,
+    errno.EPERM,
+    errno.EXDEV,
+}
+"""
+Error codes indicating that reflinks or hard links are not supported
+between two files.
+"""
+
+_MUTABLE_DIRS = ('.opam-switch', 'etc')
+"""
+Top-level directories of a switch whose files opam rewrites in place.
+"""
+
+_MUTABLE_SUFFIXES = ('.conf', '.config')
+"""
+Suffixes of configuration files that may be rewritten in place.
+"""
+
+
+class CloneMethod(enum.Enum):
+    """
+    Methods of copying a switch directory.
+    """
+
+    COPY = 'copy'
+    """
+    Copy the contents of every file.
+    """
+    REFLINK = 'reflink'
+    """
+    Share the contents of every file through copy-on-write reflinks,
+    which are supported by filesystems such as Btrfs and XFS.
+
+    Files are copied wherever reflinks are not supported, so this
+    method is always safe to use.
+    """
+    HARDLINK = 'hardlink'
+    """
+    Hard link files that opam does not modify after installation and
+    copy the rest, e.g., the switch state in ``.opam-switch``.
+
+    .. warning::
+        A hard-linked file is shared with the original switch.
+        Builds that modify installed files in place rather than
+        replacing them will thus modify the original switch too.
+    """
+
+
+def _reflink(src: str, dst: str) -> None:
+    """
+    Clone the contents of a file with a reflink.
+
+    Raises
+    ------
+    OSError
+        If the reflink cannot be created.
+    """
+    with open(src, 'rb') as src_file:
+        with open(dst, 'wb') as dst_file:
+            fcntl.ioctl(dst_file.fileno(), _FICLONE, src_file.fileno())
+
+
+def _reflink_or_copy() -> Callable[[str, str], str]:
+    """
+    Get a copy function for `shutil.copytree` that uses reflinks.
+
+    Once reflinks are found to be unsupported, the function copies
+    the remaining files without trying to reflink each of them.
+    """
+    supported = True
+
+    def copy(src: str, dst: str) -> str:
+        nonlocal supported
+        if supported:
+            try:
+                _reflink(src, dst)
+            except OSError as e:
+                if e.errno not in _UNSUPPORTED:
+                    raise
+                supported = False
+            else:
+                shutil.copystat(src, dst)
+                return dst
+        return shutil.copy2(src, dst)
+
+    return copy
+
+
+def _is_mutable(relpath: Tuple[str, ...]) -> bool:
+    """
+    Determine whether opam may rewrite a file of a switch in place.
+    """
+    return relpath[0] in _MUTABLE_DIRS or relpath[-1].endswith(
+        _MUTABLE_SUFFIXES)
+
+
+def _link_or_copy(root: str) -> Callable[[str, str], str]:
+    """
+    Get a copy function for `shutil.copytree` that uses hard links.
+
+    Mutable files of the switch at `root` are copied, as are files on
+    filesystems that do not support hard links.
+    """
+    supported = True
+
+    def copy(src: str, dst: str) -> str:
+        nonlocal supported
+        relpath = Path(os.path.relpath(src, root)).parts
+        if supported and not _is_mutable(relpath):
+            try:
+                os.link(src, dst)
+            except OSError as e:
+                if e.errno not in _UNSUPPORTED:
+                    raise
+                supported = False
+            else:
+                return dst
+        return shutil.copy2(src, dst)
+
+    return copy
+
+
+def copy_tree(src: PathLike, dst: PathLike, method: CloneMethod) -> None:
+    """
+    Copy a switch directory.
+
+    Parameters
+    ----------
+    src : PathLike
+        The directory to copy.
+    dst : PathLike
+        The destination, which must not exist.
+    method : CloneMethod
+        How to copy the contents of files.
+        Symbolic links are always copied as links.
+    """
+    if method == CloneMethod.REFLINK:
+        copy_function = _reflink_or_copy()
+    elif method == CloneMethod.HARDLINK:
+        copy_function = _link_or_copy(os.fspath(src))
+    else:
+        copy_function = shutil.copy2
+    shutil.copytree(src, dst, symlinks=True, copy_function=copy_function)
@@ -32,6 +32,7 @@ from typing import Any, Dict, List, Optional, Tuple, Union
 
 from prism.util.radpytools.dataclasses import default_field
 
+from ._file import scan_fields
 from .formula import PackageFormula
 from .version import Version
 
@@ -286,3 +287,209 @@ class OpamFile:
             field_str.append(f'"{field_value}"')
         else:
             field_str.append(str(field_value))
+
+
+_BLANKS = " \t\r\n"
+_IDENTCHARS = frozenset(
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_+")
+
+FORMULA_FIELDS = ("depends", "depopts", "conflicts")
+"""
+The names of fields whose values are lists of package formulas.
+"""
+
+
+def _skip_string(text: str, pos: int) -> int:
+    """
+    Get the position after the string starting at `pos`.
+    """
+    size = len(text)
+    if text.startswith('"""', pos):
+        pos += 3
+        while pos < size:
+            if text[pos] == '\\':
+                pos += 2
+            elif text.startswith('"""', pos):
+                return pos + 3
+            else:
+                pos += 1
+    else:
+        pos += 1
+        while pos < size:
+            if text[pos] == '\\':
+                pos += 2
+            elif text[pos] == '"':
+                return pos + 1
+            else:
+                pos += 1
+    return size
+
+
+def _skip_comment(text: str, pos: int) -> int:
+    """
+    Get the position after the (nested) comment starting at `pos`.
+    """
+    size = len(text)
+    if text[pos] == '#':
+        end = text.find('\n', pos)
+        return size if end < 0 else end
+    pos += 2
+    level = 1
+    while pos < size and level > 0:
+        if text.startswith("(*", pos):
+            level += 1
+            pos += 2
+        elif text.startswith("*)", pos):
+            level -= 1
+            pos += 2
+        else:
+            pos += 1
+    return min(pos, size)
+
+
+def _py_scan_fields(text: str) -> List[Tuple[str, str]]:  # noqa: C901
+    """
+    Split the contents of an opam file into its fields.
+
+    A field begins at the start of a line outside of any brackets with
+    an identifier followed by a colon, and its value extends to the
+    beginning of the next field or section.
+    A section, e.g., ``url { ... }``, begins at the start of a line
+    with an identifier followed by an optional string and an opening
+    brace, and its value extends to the matching closing brace.
+    Comments are replaced by spaces and values are stripped of
+    surrounding whitespace, but the values are otherwise kept as
+    written.
+
+    Parameters
+    ----------
+    text : str
+        The contents of an opam file.
+
+    Returns
+    -------
+    List[Tuple[str, str]]
+        The name and value of each field and section in the order in
+        which they appear.
+    """
+    fields = []
+    name = None
+    value = []
+    in_section = False
+    depth = 0
+    line_start = True
+    pos = 0
+    size = len(text)
+    while pos < size:
+        c = text[pos]
+        if c in _BLANKS:
+            line_start = line_start or c == '\n'
+            value.append(c)
+            pos += 1
+            continue
+        if depth == 0 and line_start and c in _IDENTCHARS:
+            end = pos + 1
+            while end < size and text[end] in _IDENTCHARS:
+                end += 1
+            after = end
+            while after < size and text[after] in " \t":
+                after += 1
+            is_field = after < size and text[after] == ':'
+            is_section = False
+            if not is_field:
+                if after < size and text[after] == '"':
+                    after = _skip_string(text, after)
+                    while after < size and text[after] in " \t":
+                        after += 1
+                is_section = after < size and text[after] == '{'
+            if is_field or is_section:
+                if name is not None:
+                    fields.append((name, ''.join(value).strip(_BLANKS)))
+                name = text[pos : end]
+                value = []
+                in_section = is_section
+                pos = after + 1 if is_field else end
+                line_start = False
+                continue
+        line_start = False
+        if c == '#' or text.startswith("(*", pos):
+            pos = _skip_comment(text, pos)
+            value.append(' ')
+            continue
+        elif c == '"':
+            end = _skip_string(text, pos)
+            value.append(text[pos : end])
+            pos = end
+            continue
+        elif c in "([{":
+            depth += 1
+        elif c in ")]}":
+            depth = max(depth - 1, 0)
+            if in_section and depth == 0:
+                value.append(c)
+                fields.append((name, ''.join(value).strip(_BLANKS)))
+                name = None
+                in_section = False
+                pos += 1
+                continue
+        value.append(c)
+        pos += 1
+    if name is not None:
+        fields.append((name, ''.join(value).strip(_BLANKS)))
+    return fields
+
+
+@dataclass
+class ParsedOpamFile:
+    """
+    The fields of an opam file with their package formulas parsed.
+
+    Unlike `OpamFile`, which is meant for writing opam files, the
+    values of fields other than package formulas are kept as raw text.
+    """
+
+    fields: Dict[str, str]
+    """
+    The value of each field keyed by its name as split by
+    `scan_fields`.
+
+    Sections are keyed by their names, and the last of any repeated
+    field or section is kept.
+    """
+    formulas: Dict[str, PackageFormula] = default_field(dict())
+    """
+    The conjunctions of the package formulas listed in each nonempty
+    field named in `FORMULA_FIELDS`.
+    """
+
+    @classmethod
+    def parse(cls, text: str) -> 'ParsedOpamFile':
+        """
+        Parse the contents of an opam file.
+
+        Parameters
+        ----------
+        text : str
+            The contents of an opam file.
+
+        Returns
+        -------
+        ParsedOpamFile
+            The parsed file.
+
+        Raises
+        ------
+        ParseError
+            If one of the package formulas cannot be parsed.
+        """
+        fields = dict(scan_fields(text))
+        formulas = {}
+        for name in FORMULA_FIELDS:
+            value = fields.get(name)
+            if value is None:
+                continue
+            if value.startswith("[") and value.endswith("]"):
+                value = value[1 :-1].strip(_BLANKS)
+            if value:
+                formulas[name] = PackageFormula.parse_conjunction(value)
+        return cls(fields, formulas)
@@ -0,0 +1,951 @@
+/*
+ * Copyright (c) 2023 Radiance Technologies, Inc.
+ *
+ * This file is part of PRISM
+ * (see https://github.com/orgs/Radiance-Technologies/prism).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * A native implementation of the `_chain_parse` methods of
+ * `PackageFormula`, `VersionFormula`, and `Filter` in
+ * prism/util/opam/formula.
+ * Every choice, lookahead, and lookback of the Python parsers is
+ * mirrored so that both parse the same input to the same formula.
+ * Parsed formulas are returned as trees of tuples tagged by the first
+ * character of each tuple (see `to_python`), which are built into
+ * formula objects by the Python modules.
+ * Input the native parser cannot faithfully handle, e.g., non-ASCII
+ * text or escaped strings, is declined so that the caller falls back
+ * to the Python parsers.
+ */
+
+const int package_formula = 0;
+const int version_formula = 1;
+const int filter_formula  = 2;
+
+/*
+ * The maximum nesting of formulas, beyond which the input is declined
+ * so that neither this parser nor the Python builder of its result
+ * exhausts the stack.
+ */
+const int max_depth = 200;
+
+struct Node
+{
+    /* See `to_python` for the meaning of each tag. */
+    char       tag;
+    int        atom_kind = 0;
+    bool       truth     = false;
+    /* The span of an atom or version. */
+    Py_ssize_t begin     = 0;
+    Py_ssize_t end       = 0;
+    /*
+     * The span of a logical or relational operator or of the name of a
+     * package.
+     * A logical operator beginning at -1 is an implicit conjunction.
+     */
+    Py_ssize_t op_begin  = 0;
+    Py_ssize_t op_end    = 0;
+    int64_t    left      = -1;
+    int64_t    right     = -1;
+};
+
+const int atom_bool     = 0;
+const int atom_int      = 1;
+const int atom_string   = 2;
+const int atom_variable = 3;
+
+static inline bool is_letter(Py_UCS4 c)
+{
+    return (c >= 'A' and c <= 'Z') or (c >= 'a' and c <= 'z');
+}
+
+static inline bool is_digit(Py_UCS4 c)
+{
+    return c >= '0' and c <= '9';
+}
+
+/* See `prism.util.opam.formula.common._identchar_syntax`. */
+static inline bool is_identchar(Py_UCS4 c)
+{
+    return is_letter(c) or is_digit(c) or c == '-' or c == '_' or c == '+';
+}
+
+/* See `prism.util.opam.version.Version._version_chars`. */
+static inline bool is_version_char(Py_UCS4 c)
+{
+    return is_identchar(c) or c == '.' or c == '/' or c == ':' or c == '~';
+}
+
+/* Equivalent to `str.isspace` for ASCII characters. */
+static inline bool is_space(Py_UCS4 c)
+{
+    return c == ' ' or (c >= '\t' and c <= '\r') or (c >= 0x1C and c <= 0x1F);
+}
+
+class Parser
+{
+  public:
+    std::vector<Node> nodes;
+    bool              declined = false;
+
+    Parser(const Py_UCS4* text, Py_ssize_t size) : text(text), size(size) {}
+
+    int64_t parse(int kind, Py_ssize_t& pos)
+    {
+        if (kind == package_formula)
+        {
+            return package(pos);
+        }
+        else if (kind == version_formula)
+        {
+            return version(pos);
+        }
+        else
+        {
+            return filter(pos);
+        }
+    }
+
+    /* See `Parseable._lstrip`. */
+    Py_ssize_t lstrip(Py_ssize_t pos) const
+    {
+        while (pos < size and is_space(text[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+  private:
+    const Py_UCS4*   text;
+    const Py_ssize_t size;
+    int              depth = 0;
+
+    struct Nested
+    {
+        Parser& parser;
+
+        Nested(Parser& parser) : parser(parser)
+        {
+            if (++parser.depth > max_depth)
+            {
+                parser.declined = true;
+            }
+        }
+
+        ~Nested()
+        {
+            parser.depth--;
+        }
+    };
+
+    int64_t add(const Node& node)
+    {
+        nodes.push_back(node);
+        return (int64_t)nodes.size() - 1;
+    }
+
+    bool at(Py_ssize_t pos, Py_UCS4 c) const
+    {
+        return pos < size and text[pos] == c;
+    }
+
+    bool at(Py_ssize_t pos, const char* s) const
+    {
+        for (; *s; s++, pos++)
+        {
+            if (!at(pos, (Py_UCS4)*s))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* See `Parseable._lookback` with a count of one. */
+    Py_UCS4 lookback(Py_ssize_t pos) const
+    {
+        pos--;
+        while (pos > 0 and is_space(text[pos]))
+        {
+            pos--;
+        }
+        if (pos <= 0 or is_space(text[pos]))
+        {
+            return 0;
+        }
+        return text[pos];
+    }
+
+    /* See `LogOp._chain_parse`. */
+    bool logop(Py_ssize_t& pos, Node& node) const
+    {
+        if (at(pos, '&') or at(pos, '|'))
+        {
+            node.op_begin = pos;
+            node.op_end   = pos + 1;
+            pos           = lstrip(pos + 1);
+            return true;
+        }
+        return false;
+    }
+
+    /* See `RelOp._chain_parse`. */
+    bool relop(Py_ssize_t& pos, Node& node) const
+    {
+        if (pos >= size)
+        {
+            return false;
+        }
+        Py_UCS4    c      = text[pos];
+        Py_ssize_t length = 1;
+        if (at(pos + 1, '='))
+        {
+            if (c != '!' and c != '<' and c != '>')
+            {
+                return false;
+            }
+            length = 2;
+        }
+        else if (c != '=' and c != '<' and c != '>')
+        {
+            return false;
+        }
+        node.op_begin = pos;
+        node.op_end   = pos + length;
+        pos           = lstrip(pos + length);
+        return true;
+    }
+
+    /* Get the end of the version characters starting at `pos`. */
+    Py_ssize_t version_chars(Py_ssize_t pos) const
+    {
+        while (pos < size and is_version_char(text[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    Py_ssize_t identchars(Py_ssize_t pos) const
+    {
+        while (pos < size and is_identchar(text[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    bool has_letter(Py_ssize_t begin, Py_ssize_t end) const
+    {
+        for (; begin < end; begin++)
+        {
+            if (is_letter(text[begin]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Whether identifier characters match ``(?:<ident>|_)(?:\+(?:<ident>|_))*``.
+     */
+    bool is_varident_prefix(Py_ssize_t begin, Py_ssize_t end) const
+    {
+        if (begin == end)
+        {
+            return false;
+        }
+        else if (has_letter(begin, end))
+        {
+            return true;
+        }
+        for (Py_ssize_t i = begin; i < end; i++)
+        {
+            if (text[i] != ((i - begin) % 2 == 0 ? '_' : '+'))
+            {
+                return false;
+            }
+        }
+        return (end - begin) % 2 == 1;
+    }
+
+    /* See `FilterAtom._chain_parse`. */
+    int64_t atom(Py_ssize_t& pos)
+    {
+        Node node{'A'};
+        node.begin = pos;
+        if (at(pos, "true") or at(pos, "false"))
+        {
+            node.atom_kind = atom_bool;
+            node.truth     = at(pos, "true");
+            node.end       = pos + (node.truth ? 4 : 5);
+        }
+        else if (is_digit(text[pos])
+                 or (at(pos, '-') and pos + 1 < size and is_digit(text[pos + 1])))
+        {
+            node.atom_kind = atom_int;
+            node.end       = pos + 1;
+            while (node.end < size and is_digit(text[node.end]))
+            {
+                node.end++;
+            }
+        }
+        else if (at(pos, '"'))
+        {
+            Py_ssize_t next = string(pos, node);
+            if (next < 0)
+            {
+                return -1;
+            }
+            pos = lstrip(next);
+            return add(node);
+        }
+        else
+        {
+            Py_ssize_t run = identchars(pos);
+            node.atom_kind = atom_variable;
+            node.end       = run;
+            if (at(run, ':') and is_varident_prefix(pos, run))
+            {
+                Py_ssize_t name = identchars(run + 1);
+                if (has_letter(run + 1, name))
+                {
+                    node.end = name;
+                }
+            }
+            if (node.end == run and !has_letter(pos, run))
+            {
+                return -1;
+            }
+        }
+        pos = lstrip(node.end);
+        return add(node);
+    }
+
+    /*
+     * Match ``"([^\s"]+)"|"""(\S*)"""|""``, set the span of the atom to
+     * the content of the string, and get the position after the string.
+     */
+    Py_ssize_t string(Py_ssize_t pos, Node& node)
+    {
+        node.atom_kind  = atom_string;
+        Py_ssize_t next = -1;
+        Py_ssize_t end  = pos + 1;
+        while (end < size and !is_space(text[end]) and text[end] != '"')
+        {
+            end++;
+        }
+        if (end > pos + 1 and at(end, '"'))
+        {
+            node.begin = pos + 1;
+            node.end   = end;
+            next       = end + 1;
+        }
+        else if (at(pos, "\"\"\""))
+        {
+            end = pos + 3;
+            while (end < size and !is_space(text[end]))
+            {
+                end++;
+            }
+            // the content is greedy
+            for (Py_ssize_t close = end - 3; close >= pos + 3; close--)
+            {
+                if (at(close, "\"\"\""))
+                {
+                    node.begin = pos + 3;
+                    node.end   = close;
+                    next       = close + 3;
+                    break;
+                }
+            }
+        }
+        if (next < 0 and at(pos, "\"\""))
+        {
+            node.begin = pos + 2;
+            node.end   = pos + 2;
+            next       = pos + 2;
+        }
+        for (Py_ssize_t i = node.begin; next >= 0 and i < node.end; i++)
+        {
+            if (text[i] == '\\')
+            {
+                // escape sequences are left to the Python parser
+                declined = true;
+                return -1;
+            }
+        }
+        return next;
+    }
+
+    /* See `Filter._chain_parse`. */
+    int64_t filter(Py_ssize_t& pos)
+    {
+        Nested     nested(*this);
+        Py_ssize_t begin  = pos;
+        Py_ssize_t p      = pos;
+        int64_t    result = -1;
+        if (declined or pos >= size)
+        {
+            return -1;
+        }
+        result = atom(p);
+        if (result < 0 and !declined)
+        {
+            result = unary_filter(p, '(', 'P');
+        }
+        if (result < 0 and !declined)
+        {
+            result = unary_filter(p, '!', 'N');
+        }
+        if (result < 0 and !declined)
+        {
+            result = unary_filter(p, '?', 'D');
+        }
+        if (result < 0)
+        {
+            return -1;
+        }
+        Py_UCS4 prev = lookback(begin);
+        if (prev != '!' and prev != '?')
+        {
+            Py_ssize_t q      = p;
+            Node       node{'L'};
+            bool       has_op = logop(q, node);
+            if (!has_op)
+            {
+                node.tag = 'R';
+                has_op   = relop(q, node);
+            }
+            if (has_op)
+            {
+                int64_t right = filter(q);
+                if (right >= 0)
+                {
+                    node.left  = result;
+                    node.right = right;
+                    result     = add(node);
+                    p          = q;
+                }
+            }
+        }
+        pos = p;
+        return declined ? -1 : result;
+    }
+
+    /*
+     * See `ParensF._chain_parse`, `NotF._chain_parse`, and
+     * `IsDefined._chain_parse`.
+     */
+    int64_t unary_filter(Py_ssize_t& pos, Py_UCS4 prefix, char tag)
+    {
+        if (!at(pos, prefix))
+        {
+            return -1;
+        }
+        Py_ssize_t p     = lstrip(pos + 1);
+        int64_t    inner = filter(p);
+        if (inner < 0)
+        {
+            return -1;
+        }
+        if (tag == 'P')
+        {
+            p = lstrip(p);
+            if (!at(p, ')'))
+            {
+                return -1;
+            }
+            p = lstrip(p + 1);
+        }
+        Node node{tag};
+        node.left = inner;
+        pos       = p;
+        return add(node);
+    }
+
+    /* See `VersionFormula._chain_parse`. */
+    int64_t version(Py_ssize_t& pos)
+    {
+        Nested     nested(*this);
+        Py_ssize_t begin  = pos;
+        Py_ssize_t p      = pos;
+        int64_t    result = -1;
+        if (declined)
+        {
+            return -1;
+        }
+        // FilterVF
+        int64_t inner = filter(p);
+        if (inner >= 0)
+        {
+            Node node{'F'};
+            node.left = inner;
+            result    = add(node);
+        }
+        if (result < 0 and !declined)
+        {
+            // VersionConstraint
+            p = pos;
+            Node node{'V'};
+            if (relop(p, node) and at(p, '"'))
+            {
+                Py_ssize_t end = version_chars(p + 1);
+                if (end > p + 1 and at(end, '"'))
+                {
+                    node.begin = p + 1;
+                    node.end   = end;
+                    p          = lstrip(end + 1);
+                    result     = add(node);
+                }
+            }
+        }
+        if (result < 0 and !declined)
+        {
+            // FilterConstraint
+            p = pos;
+            Node node{'C'};
+            if (relop(p, node))
+            {
+                node.left = filter(p);
+                if (node.left >= 0)
+                {
+                    p      = lstrip(p);
+                    result = add(node);
+                }
+            }
+        }
+        if (result < 0 and !declined and at(pos, '('))
+        {
+            // ParensVF
+            p     = lstrip(pos + 1);
+            inner = version(p);
+            if (inner >= 0)
+            {
+                p = lstrip(p);
+                if (at(p, ')'))
+                {
+                    p = lstrip(p + 1);
+                    Node node{'P'};
+                    node.left = inner;
+                    result    = add(node);
+                }
+            }
+        }
+        if (result < 0 and !declined and at(pos, '!'))
+        {
+            // NotVF
+            p     = lstrip(pos + 1);
+            inner = version(p);
+            if (inner >= 0)
+            {
+                Node node{'N'};
+                node.left = inner;
+                result    = add(node);
+            }
+        }
+        if (result < 0 or declined)
+        {
+            return -1;
+        }
+        if (lookback(begin) != '!')
+        {
+            Py_ssize_t q = p;
+            Node       node{'L'};
+            if (!logop(q, node))
+            {
+                // an omitted operator is an implicit conjunction
+                node.op_begin = -1;
+            }
+            int64_t right = version(q);
+            if (right >= 0)
+            {
+                node.left  = result;
+                node.right = right;
+                result     = add(node);
+                p          = q;
+            }
+        }
+        pos = p;
+        return declined ? -1 : result;
+    }
+
+    /* See `PackageFormula._chain_parse`. */
+    int64_t package(Py_ssize_t& pos)
+    {
+        Nested     nested(*this);
+        Py_ssize_t p      = pos;
+        int64_t    result = -1;
+        if (declined)
+        {
+            return -1;
+        }
+        if (at(p, '('))
+        {
+            // ParensPF
+            p             = lstrip(p + 1);
+            int64_t inner = package(p);
+            if (inner >= 0)
+            {
+                p = lstrip(p);
+                if (at(p, ')'))
+                {
+                    p = lstrip(p + 1);
+                    Node node{'P'};
+                    node.left = inner;
+                    result    = add(node);
+                }
+            }
+        }
+        if (result < 0 and !declined)
+        {
+            p      = pos;
+            result = constraint(p);
+        }
+        if (result < 0 or declined)
+        {
+            return -1;
+        }
+        Py_ssize_t q = p;
+        Node       node{'L'};
+        if (logop(q, node))
+        {
+            int64_t right = package(q);
+            if (right >= 0)
+            {
+                node.left  = result;
+                node.right = right;
+                result     = add(node);
+                p          = q;
+            }
+        }
+        pos = p;
+        return declined ? -1 : result;
+    }
+
+    /* See `PackageConstraint._chain_parse`. */
+    int64_t constraint(Py_ssize_t& pos)
+    {
+        if (!at(pos, '"'))
+        {
+            return -1;
+        }
+        Node node{'K'};
+        node.op_begin  = pos + 1;
+        node.op_end    = identchars(pos + 1);
+        Py_ssize_t p   = node.op_end;
+        if (at(p, '.'))
+        {
+            node.tag   = 'E';
+            node.begin = p + 1;
+            node.end   = version_chars(p + 1);
+            if (node.end == node.begin)
+            {
+                return -1;
+            }
+            p = lstrip(node.end);
+            if (!at(p, '"'))
+            {
+                return -1;
+            }
+            p++;
+        }
+        else
+        {
+            if (!at(p, '"'))
+            {
+                return -1;
+            }
+            p = lstrip(p + 1);
+            if (at(p, '{'))
+            {
+                p         = lstrip(p + 1);
+                node.left = version(p);
+                if (node.left < 0)
+                {
+                    return -1;
+                }
+                p = lstrip(p);
+                if (!at(p, '}'))
+                {
+                    return -1;
+                }
+                p++;
+            }
+        }
+        pos = lstrip(p);
+        return add(node);
+    }
+};
+
+class Converter
+{
+  public:
+    Converter(PyObject* text, const Py_UCS4* data, const Parser& parser)
+        : text(text), data(data), parser(parser)
+    {
+    }
+
+    /*
+     * Convert a parsed formula to a tree of tuples.
+     *
+     * Each tuple begins with a tag identifying its formula:
+     *
+     *     ("A", term, is_variable)     a `FilterAtom`
+     *     ("L", left, logop, right)    a `Logical` formula
+     *     ("R", left, relop, right)    a `RelationalF`
+     *     ("P", formula)               a `Parens` formula
+     *     ("N", formula)               a `Not` formula
+     *     ("D", filter)                an `IsDefined`
+     *     ("F", filter)                a `FilterVF`
+     *     ("V", relop, version)        a `VersionConstraint`
+     *     ("C", relop, filter)         a `FilterConstraint`
+     *     ("K", name, formula)         a `PackageConstraint` with an
+     *                                  optional version formula
+     *     ("E", name, version)         a `PackageConstraint` with an
+     *                                  exact version
+     */
+    PyObject* convert(int64_t index) const
+    {
+        const Node& node = parser.nodes[(size_t)index];
+        /* `N` steals references and fails cleanly given NULL arguments */
+        switch (node.tag)
+        {
+        case 'A':
+            return Py_BuildValue("(sNN)",
+                                 "A",
+                                 term(node),
+                                 PyBool_FromLong(node.atom_kind == atom_variable));
+        case 'L':
+        case 'R':
+            return Py_BuildValue("(CNNN)",
+                                 node.tag,
+                                 convert(node.left),
+                                 op(node),
+                                 convert(node.right));
+        case 'V':
+            return Py_BuildValue("(sNN)", "V", op(node), span(node.begin, node.end));
+        case 'C':
+            return Py_BuildValue("(sNN)", "C", op(node), convert(node.left));
+        case 'K':
+            return Py_BuildValue("(sNN)",
+                                 "K",
+                                 span(node.op_begin, node.op_end),
+                                 node.left < 0 ? none() : convert(node.left));
+        case 'E':
+            return Py_BuildValue("(sNN)",
+                                 "E",
+                                 span(node.op_begin, node.op_end),
+                                 span(node.begin, node.end));
+        default:
+            return Py_BuildValue("(CN)", node.tag, convert(node.left));
+        }
+    }
+
+  private:
+    PyObject*      text;
+    const Py_UCS4* data;
+    const Parser&  parser;
+
+    static PyObject* none()
+    {
+        Py_IncRef(Py_None);
+        return Py_None;
+    }
+
+    PyObject* span(Py_ssize_t begin, Py_ssize_t end) const
+    {
+        return PyUnicode_Substring(text, begin, end);
+    }
+
+    PyObject* op(const Node& node) const
+    {
+        if (node.op_begin < 0)
+        {
+            return PyUnicode_FromString("&");
+        }
+        return span(node.op_begin, node.op_end);
+    }
+
+    PyObject* term(const Node& node) const
+    {
+        if (node.atom_kind == atom_bool)
+        {
+            return PyBool_FromLong(node.truth);
+        }
+        else if (node.atom_kind == atom_int)
+        {
+            std::string digits(data + node.begin, data + node.end);
+            return PyLong_FromString(digits.c_str(), NULL, 10);
+        }
+        return span(node.begin, node.end);
+    }
+};
+
+/*
+ * Get a copy of the text if it is ASCII and thus can be parsed without
+ * regard to Unicode whitespace or escapes.
+ */
+static Py_UCS4* ascii_copy(PyObject* text, Py_ssize_t& size)
+{
+    size = PyUnicode_GetLength(text);
+    if (size < 0)
+    {
+        return NULL;
+    }
+    Py_UCS4* data = PyUnicode_AsUCS4Copy(text);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < size; i++)
+    {
+        if (data[i] > 0x7F)
+        {
+            PyMem_Free(data);
+            size = -1;
+            return NULL;
+        }
+    }
+    return data;
+}
+
+static PyObject* parse(PyObject* args, bool sequence)
+{
+    int        kind = 0;
+    PyObject*  text = NULL;
+    Py_ssize_t pos  = 0;
+    if (!PyArg_ParseTuple(args, "iUn", &kind, &text, &pos))
+    {
+        return NULL;
+    }
+    Py_ssize_t size = 0;
+    Py_UCS4*   data = ascii_copy(text, size);
+    if (data == NULL)
+    {
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+        Py_IncRef(Py_None);
+        return Py_None;
+    }
+    Parser               parser(data, size);
+    std::vector<int64_t> roots;
+    bool                 failed = pos < 0 or pos > size;
+    /* The parser only touches its own copy of the text. */
+    Py_BEGIN_ALLOW_THREADS
+    do
+    {
+        if (failed)
+        {
+            break;
+        }
+        if (sequence)
+        {
+            pos = parser.lstrip(pos);
+        }
+        int64_t root = parser.parse(kind, pos);
+        failed       = root < 0 or parser.declined;
+        roots.push_back(root);
+    } while (sequence and pos < size);
+    Py_END_ALLOW_THREADS
+    PyObject* result = NULL;
+    if (failed)
+    {
+        Py_IncRef(Py_None);
+        result = Py_None;
+    }
+    else if (!sequence)
+    {
+        result = Py_BuildValue("(Nn)",
+                               Converter(text, data, parser).convert(roots[0]),
+                               pos);
+    }
+    else
+    {
+        result = PyList_New((Py_ssize_t)roots.size());
+        for (size_t i = 0; result != NULL and i < roots.size(); i++)
+        {
+            PyObject* tree = Converter(text, data, parser).convert(roots[i]);
+            if (tree == NULL)
+            {
+                Py_DecRef(result);
+                result = NULL;
+                break;
+            }
+            PyList_SetItem(result, (Py_ssize_t)i, tree);
+        }
+    }
+    PyMem_Free(data);
+    return result;
+}
+
+static PyObject* parse_formula(PyObject* self, PyObject* args)
+{
+    return parse(args, false);
+}
+
+static PyObject* parse_formulas(PyObject* self, PyObject* args)
+{
+    return parse(args, true);
+}
+
+static PyMethodDef ParseMethods[] = {
+    {"parse_formula",
+     parse_formula,  METH_VARARGS,
+     "Parse a formula of the given kind starting at a position.\n\n"
+     "Return the tree of the formula and the position after it or None "
+     "if it could not be natively parsed."},
+    {"parse_formulas",
+     parse_formulas, METH_VARARGS,
+     "Parse a whitespace-separated sequence of formulas of the given kind "
+     "from a position to the end of the text.\n\n"
+     "Return a list of trees or None if they could not be natively parsed."},
+    {NULL,           NULL,           0,            NULL}
+};
+
+static struct PyModuleDef parse_module = {PyModuleDef_HEAD_INIT,
+                                          "prism.util.opam.formula._parse",
+                                          "Library for parsing opam formulas",
+                                          -1,
+                                          ParseMethods};
+
+PyMODINIT_FUNC            PyInit__parse(void)
+{
+    PyObject* module = PyModule_Create(&parse_module);
+    if (module == NULL)
+    {
+        return NULL;
+    }
+    if (PyModule_AddIntConstant(module, "PACKAGE_FORMULA", package_formula) < 0
+        or PyModule_AddIntConstant(module, "VERSION_FORMULA", version_formula) < 0
+        or PyModule_AddIntConstant(module, "FILTER", filter_formula) < 0)
+    {
+        Py_DecRef(module);
+        return NULL;
+    }
+    return module;
+};
@@ -26,6 +26,7 @@ import enum
 import re
 from typing import (
     Any,
+    Callable,
     Dict,
     Mapping,
     Optional,
@@ -39,6 +40,8 @@ from typing import (
 from prism.util.abc_enum import ABCEnumMeta
 from prism.util.parse import Parseable, ParseError
 
+from ._parse import parse_formula
+
 # See https://opam.ocaml.org/doc/Manual.html#General-syntax
 _letter_syntax: re.Pattern = re.compile("[a-zA-Z]")
 _digit_syntax: re.Pattern = re.compile("[0-9]")
@@ -296,3 +299,50 @@ def value_to_string(v: Value) -> str:
             return "false"
     else:
         return v
+
+
+def parse_natively(
+        kind: int,
+        build: Callable[[Tuple[Any,
+                               ...]],
+                        Parseable],
+        input: str,
+        exhaustive: bool,
+        lstrip: bool,
+        pos: int) -> Optional[Union[Parseable,
+                                    Tuple[Parseable,
+                                          int]]]:
+    """
+    Parse a formula with the native parser.
+
+    Parameters
+    ----------
+    kind : int
+        The kind of formula to parse, e.g., ``_parse.PACKAGE_FORMULA``.
+    build : Callable[[Tuple[Any, ...]], Parseable]
+        A function that builds a formula from its parsed tree.
+    input, exhaustive, lstrip, pos
+        See `Parseable.parse`.
+
+    Returns
+    -------
+    Optional[Union[Parseable, Tuple[Parseable, int]]]
+        The result of `Parseable.parse` or None if the native parser
+        failed or declined to parse the `input`, in which case the
+        Python parser should be used to get either the formula or an
+        appropriate error.
+    """
+    if lstrip:
+        pos = Parseable._lstrip(input, pos)
+    parsed = parse_formula(kind, input, pos)
+    if parsed is None:
+        return None
+    tree, pos = parsed
+    if exhaustive and pos < len(input):
+        return None
+    try:
+        formula = build(tree)
+    except ParseError:
+        # a version that the Python parser would have rejected
+        return None
+    return formula if exhaustive else (formula, pos)
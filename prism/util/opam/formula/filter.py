@@ -25,13 +25,14 @@ Defines classes for parsing and expressing version constraint filters.
 import warnings
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
-from typing import Optional, Set, Tuple, Type, Union
+from typing import Any, Dict, Optional, Set, Tuple, Type, Union
 
 from prism.util.opam.formula.negate import Not
 from prism.util.opam.formula.relational import Relational
 from prism.util.opam.version import Version
 from prism.util.parse import Parseable, ParseError
 
+from ._parse import FILTER
 from .common import (
     AssignedVariables,
     LogOp,
@@ -43,6 +44,7 @@ from .common import (
     _int_syntax,
     _string_syntax,
     _varident_syntax,
+    parse_natively,
     value_to_bool,
     value_to_string,
 )
@@ -113,6 +115,34 @@ class Filter(Parseable, ABC):
         """
         ...
 
+    @classmethod
+    def parse(
+            cls,
+            input: str,
+            exhaustive: bool = True,
+            lstrip: bool = True,
+            pos: int = 0,
+            **kwargs: Dict[str,
+                           Any]) -> Union['Filter',
+                                          Tuple['Filter',
+                                                int]]:
+        """
+        Parse a filter, natively where possible.
+
+        See `Parseable.parse` for details.
+        """
+        if cls is Filter and not kwargs:
+            parsed = parse_natively(
+                FILTER,
+                _build_filter,
+                input,
+                exhaustive,
+                lstrip,
+                pos)
+            if parsed is not None:
+                return parsed
+        return super().parse(input, exhaustive, lstrip, pos, **kwargs)
+
     @classmethod
     def _chain_parse(cls, input: str, pos: int) -> Tuple['Filter', int]:
         begpos = pos
@@ -440,14 +470,12 @@ class FilterAtom(Filter):
         match = None
         group = 0
         for (regex,
-             p) in [(_bool_syntax,
-                     bool),
+             p) in [(_bool_syntax, lambda s: s == "true"),
                     (_int_syntax,
                      int),
                     (_string_syntax,
                      lambda s: str(s).encode("utf-8").decode("unicode_escape")),
-                    (_empty_string_syntax,
-                     str),
+                    (_empty_string_syntax, lambda s: ""),
                     (_varident_syntax,
                      Variable)]:
             match = regex.match(term)
@@ -465,3 +493,29 @@ class FilterAtom(Filter):
             pos += match.end()
         pos = cls._lstrip(input, pos)
         return cls(term), pos
+
+
+def _build_filter(tree: Tuple[Any, ...]) -> Filter:
+    """
+    Build a filter from a tree produced by the native parser.
+    """
+    tag = tree[0]
+    if tag == "A":
+        term = tree[1]
+        return FilterAtom(Variable(term) if tree[2] else term)
+    elif tag == "L":
+        return LogicalF(
+            _build_filter(tree[1]),
+            LogOp(tree[2]),
+            _build_filter(tree[3]))
+    elif tag == "R":
+        return RelationalF(
+            _build_filter(tree[1]),
+            RelOp(tree[2]),
+            _build_filter(tree[3]))
+    elif tag == "P":
+        return ParensF(_build_filter(tree[1]))
+    elif tag == "N":
+        return NotF(_build_filter(tree[1]))
+    else:
+        return IsDefined(_build_filter(tree[1]))
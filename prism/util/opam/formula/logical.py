@@ -25,7 +25,17 @@ Defines a generic class for conjunctive and disjunctive formulas.
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
 from functools import partialmethod
-from typing import Any, Dict, Iterator, List, Optional, Tuple, Type, Union
+from typing import (
+    Any,
+    Callable,
+    Dict,
+    Iterator,
+    List,
+    Optional,
+    Tuple,
+    Type,
+    Union,
+)
 
 from .binary import Binary
 from .common import FormulaT, LogOp
@@ -92,6 +102,22 @@ class Logical(Binary[FormulaT, LogOp], ABC):
                 *objects,
                 **kwargs)
 
+    def compile(self,
+                *args: Tuple[Any,
+                             ...],
+                **kwargs: Dict[str,
+                               Any]) -> Callable[[Any],
+                                                 bool]:
+        """
+        Compile the conjunction/disjunction of the compiled formulae.
+        """
+        left = self.left.compile(*args, **kwargs)
+        right = self.right.compile(*args, **kwargs)
+        if self.logop == LogOp.AND:
+            return lambda obj: left(obj) and right(obj)
+        else:
+            return lambda obj: left(obj) or right(obj)
+
     def simplify(
             self,
             *objects: Tuple[Any,
@@ -25,7 +25,7 @@ Defines a generic class for negations of formulas.
 import warnings
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
-from typing import Any, Dict, Generic, Tuple, Type, Union
+from typing import Any, Callable, Dict, Generic, Tuple, Type, Union
 
 from prism.util.parse import Parseable
 
@@ -54,6 +54,18 @@ class Not(Parseable, Generic[FormulaT], ABC):
         """
         return not self.formula.is_satisfied(*objects, **kwargs)
 
+    def compile(self,
+                *args: Tuple[Any,
+                             ...],
+                **kwargs: Dict[str,
+                               Any]) -> Callable[[Any],
+                                                 bool]:
+        """
+        Compile the negation of the internal formula.
+        """
+        predicate = self.formula.compile(*args, **kwargs)
+        return lambda obj: not predicate(obj)
+
     def simplify(self,
                  *objects: Tuple[Any,
                                  ...],
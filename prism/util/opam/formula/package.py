@@ -24,15 +24,29 @@ Defines classes for parsing and expressing package dependencies.
 
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
-from typing import Callable, List, Mapping, Optional, Set, Tuple, Type, Union
-
-from prism.util.opam.version import Version
+from functools import reduce
+from typing import (
+    Any,
+    Callable,
+    Dict,
+    Iterable,
+    List,
+    Mapping,
+    Optional,
+    Set,
+    Tuple,
+    Type,
+    Union,
+)
+
+from prism.util.opam.version import OCamlVersion, Version
 from prism.util.parse import Parseable, ParseError
 
-from .common import AssignedVariables, LogOp, _identchar_syntax
+from ._parse import PACKAGE_FORMULA, parse_formulas
+from .common import AssignedVariables, LogOp, _identchar_syntax, parse_natively
 from .logical import Logical
 from .parens import Parens
-from .version import VersionFormula
+from .version import VersionFormula, _build_version_formula
 
 
 class PackageFormula(Parseable, ABC):
@@ -88,6 +102,32 @@ class PackageFormula(Parseable, ABC):
         """
         ...
 
+    def compile(
+        self,
+        variables: Optional[AssignedVariables] = None
+    ) -> Callable[[Mapping[str,
+                           Version]],
+                  bool]:
+        """
+        Compile the formula into a predicate over package versions.
+
+        Variables are resolved once at compilation such that the
+        resulting predicate can be cheaply evaluated against many
+        package maps.
+
+        Parameters
+        ----------
+        variables : AssignedVariables
+            A map from formula variable names to their values.
+
+        Returns
+        -------
+        Callable[[Mapping[str, Version]], bool]
+            A function equivalent to `is_satisfied` with the given
+            `variables`.
+        """
+        return lambda packages: self.is_satisfied(packages, variables)
+
     @abstractmethod
     def is_satisfied(
             self,
@@ -112,6 +152,28 @@ class PackageFormula(Parseable, ABC):
         """
         ...
 
+    def is_satisfied_batch(
+            self,
+            packages: Iterable[Mapping[str,
+                                       Version]],
+            variables: Optional[AssignedVariables] = None) -> List[bool]:
+        """
+        Test whether each of the given package maps satisfy the formula.
+
+        Parameters
+        ----------
+        packages : Iterable[Mapping[str, Version]]
+            A sequence of maps from package names to versions.
+        variables : AssignedVariables
+            A map from formula variable names to their values.
+
+        Returns
+        -------
+        List[bool]
+            Whether each package map satisfies the formula.
+        """
+        return list(map(self.compile(variables), packages))
+
     @abstractmethod
     def map(
         self,
@@ -163,6 +225,85 @@ class PackageFormula(Parseable, ABC):
         """
         ...
 
+    @classmethod
+    def parse(
+        cls,
+        input: str,
+        exhaustive: bool = True,
+        lstrip: bool = True,
+        pos: int = 0,
+        **kwargs: Dict[str,
+                       Any]
+    ) -> Union['PackageFormula',
+               Tuple['PackageFormula',
+                     int]]:
+        """
+        Parse a package formula, natively where possible.
+
+        See `Parseable.parse` for details.
+        """
+        if cls is PackageFormula and not kwargs:
+            parsed = parse_natively(
+                PACKAGE_FORMULA,
+                _build_package_formula,
+                input,
+                exhaustive,
+                lstrip,
+                pos)
+            if parsed is not None:
+                return parsed
+        return super().parse(input, exhaustive, lstrip, pos, **kwargs)
+
+    @classmethod
+    def parse_conjunction(cls, input: str) -> 'PackageFormula':
+        """
+        Parse a sequence of package formulas as their conjunction.
+
+        Lists of package formulas in opam files, e.g., the value of a
+        ``depends`` field, separate their conjoined elements by
+        whitespace alone.
+        Since there is no reliable way to infer where the missing
+        operators belong, the formulas are parsed one at a time.
+
+        Parameters
+        ----------
+        input : str
+            A whitespace-separated sequence of package formulas.
+
+        Returns
+        -------
+        PackageFormula
+            The left-associative conjunction of the parsed formulas.
+
+        Raises
+        ------
+        ParseError
+            If the `input` does not contain any formulas or one of
+            them fails to parse.
+        """
+        formulas = None
+        trees = parse_formulas(PACKAGE_FORMULA, input, 0)
+        if trees is not None:
+            try:
+                formulas = [_build_package_formula(tree) for tree in trees]
+            except ParseError:
+                formulas = None
+        if formulas is None:
+            pos = 0
+            formulas = []
+            while pos < len(input):
+                formula, pos = PackageFormula.parse(
+                    input,
+                    exhaustive=False,
+                    pos=pos)
+                formulas.append(formula)
+        if not formulas:
+            raise ParseError(cls, input)
+        return reduce(
+            lambda left, right: LogicalPF(left, LogOp.AND, right),
+            formulas[1 :],
+            formulas[0])
+
     @classmethod
     def _chain_parse(cls, input: str, pos: int) -> Tuple['Parseable', int]:
         """
@@ -376,6 +517,42 @@ class PackageConstraint(PackageFormula):
             else:
                 return constraint.is_satisfied(version, variables)
 
+    def compile(  # noqa: D102
+        self,
+        variables: Optional[AssignedVariables] = None
+    ) -> Callable[[Mapping[str,
+                           Version]],
+                  bool]:
+        package_name = self.package_name
+        constraint = self.version_constraint
+        if isinstance(constraint, VersionFormula):
+            constraint = constraint.simplify(
+                None,
+                variables,
+                evaluate_filters=True)
+            if isinstance(constraint, bool):
+                if constraint:
+                    constraint = None
+                else:
+                    return lambda packages: True
+        if constraint is None:
+            return lambda packages: package_name in packages
+        elif isinstance(constraint, Version):
+            return lambda packages: (
+                package_name in packages and packages[package_name] ==
+                constraint)
+        satisfies = constraint.compile(variables)
+
+        def predicate(packages: Mapping[str, Version]) -> bool:
+            try:
+                version = packages[package_name]
+            except KeyError:
+                return False
+            else:
+                return satisfies(version)
+
+        return predicate
+
     def map(  # noqa: D102
         self,
         f: Callable[['PackageConstraint'],
@@ -490,3 +667,31 @@ class PackageConstraint(PackageFormula):
             pos = cls._expect(input, pos, '"', begpos)
         pos = cls._lstrip(input, pos)
         return cls(''.join(p), version_constraint), pos
+
+
+def _build_package_formula(tree: Tuple[Any, ...]) -> PackageFormula:
+    """
+    Build a package formula from a tree produced by the native parser.
+
+    Raises
+    ------
+    ParseError
+        If a version in the tree is syntactically invalid.
+    """
+    tag = tree[0]
+    if tag == "K":
+        version_constraint = tree[2]
+        if version_constraint is not None:
+            version_constraint = _build_version_formula(version_constraint)
+        return PackageConstraint(tree[1], version_constraint)
+    elif tag == "E":
+        return PackageConstraint(
+            tree[1],
+            OCamlVersion._exhaustive_parse(tree[2]))
+    elif tag == "L":
+        return LogicalPF(
+            _build_package_formula(tree[1]),
+            LogOp(tree[2]),
+            _build_package_formula(tree[3]))
+    else:
+        return ParensPF(_build_package_formula(tree[1]))
@@ -24,7 +24,7 @@ Defines a generic class for parenthetical formulas.
 
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
-from typing import Any, Dict, Generic, Tuple, Type, Union
+from typing import Any, Callable, Dict, Generic, Tuple, Type, Union
 
 from prism.util.parse import Parseable, ParseError
 
@@ -53,6 +53,17 @@ class Parens(Parseable, Generic[FormulaT], ABC):
         """
         return self.formula.is_satisfied(*objects, **kwargs)
 
+    def compile(self,
+                *args: Tuple[Any,
+                             ...],
+                **kwargs: Dict[str,
+                               Any]) -> Callable[[Any],
+                                                 bool]:
+        """
+        Compile the internal formula.
+        """
+        return self.formula.compile(*args, **kwargs)
+
     def simplify(
             self,
             *objects: Tuple[Any,
@@ -25,21 +25,33 @@ Defines classes for parsing and expressing version constraints.
 import warnings
 from abc import ABC, abstractmethod
 from dataclasses import dataclass
-from functools import partial
-from typing import Iterable, List, Optional, Set, Tuple, Type, Union
+from typing import (
+    Any,
+    Callable,
+    Dict,
+    Iterable,
+    List,
+    Optional,
+    Set,
+    Tuple,
+    Type,
+    Union,
+)
 
 from prism.util.opam.formula.negate import Not
-from prism.util.opam.version import Version
+from prism.util.opam.version import OCamlVersion, Version
 from prism.util.parse import Parseable, ParseError
 
+from ._parse import VERSION_FORMULA
 from .common import (
     AssignedVariables,
     LogOp,
     RelOp,
+    parse_natively,
     value_to_bool,
     value_to_string,
 )
-from .filter import Filter, FilterAtom
+from .filter import Filter, FilterAtom, _build_filter
 from .logical import Logical
 from .parens import Parens
 
@@ -87,6 +99,26 @@ class VersionFormula(Parseable, ABC):
         """
         ...
 
+    def compile(
+        self,
+        variables: Optional[AssignedVariables] = None) -> Callable[[Version],
+                                                                   bool]:
+        """
+        Compile the formula into a predicate over versions.
+
+        Parameters
+        ----------
+        variables : AssignedVariables
+            A map from formula variable names to their values.
+
+        Returns
+        -------
+        Callable[[Version], bool]
+            A function equivalent to `is_satisfied` with the given
+            `variables`.
+        """
+        return lambda version: self.is_satisfied(version, variables)
+
     def filter_versions(
             self,
             versions: Iterable[Version],
@@ -99,10 +131,7 @@ class VersionFormula(Parseable, ABC):
         """
         if variables is None:
             variables = {}
-        return list(
-            filter(partial(self.is_satisfied,
-                           variables=variables),
-                   versions))
+        return list(filter(self.compile(variables), versions))
 
     @abstractmethod
     def simplify(
@@ -119,6 +148,35 @@ class VersionFormula(Parseable, ABC):
         """
         ...
 
+    @classmethod
+    def parse(
+        cls,
+        input: str,
+        exhaustive: bool = True,
+        lstrip: bool = True,
+        pos: int = 0,
+        **kwargs: Dict[str,
+                       Any]
+    ) -> Union['VersionFormula',
+               Tuple['VersionFormula',
+                     int]]:
+        """
+        Parse a version formula, natively where possible.
+
+        See `Parseable.parse` for details.
+        """
+        if cls is VersionFormula and not kwargs:
+            parsed = parse_natively(
+                VERSION_FORMULA,
+                _build_version_formula,
+                input,
+                exhaustive,
+                lstrip,
+                pos)
+            if parsed is not None:
+                return parsed
+        return super().parse(input, exhaustive, lstrip, pos, **kwargs)
+
     @classmethod
     def _chain_parse(cls, input: str, pos: int) -> Tuple['VersionFormula', int]:
         begpos = pos
@@ -328,6 +386,37 @@ class VersionConstraint(VersionFormula):
         """
         return self.relop(version, self.version)
 
+    def compile(
+        self,
+        variables: Optional[AssignedVariables] = None) -> Callable[[Version],
+                                                                   bool]:
+        """
+        Compile the binary relation into a predicate over versions.
+
+        Bounds given by ``<`` or ``>=``, which depend only on the
+        ordering of versions, are checked by comparing each version's
+        `Version.sort_key` to the precomputed key of the bound.
+        """
+        relop = self.relop
+        bound = self.version
+        if relop != RelOp.LT and relop != RelOp.GEQ:
+            return lambda version: relop(version, bound)
+        bound_key = bound.sort_key
+        is_lt = relop == RelOp.LT
+        is_ocaml_bound = isinstance(bound, OCamlVersion)
+
+        def predicate(version: Version) -> bool:
+            if is_ocaml_bound and isinstance(version, OCamlVersion):
+                # OCaml versions are ordered among themselves differently
+                lt = version < bound
+            elif isinstance(version, Version):
+                lt = version.sort_key < bound_key
+            else:
+                return relop(version, bound)
+            return lt == is_lt
+
+        return predicate
+
     def simplify(
             self,
             version: Optional[Version],
@@ -491,3 +580,32 @@ class FilterConstraint(VersionFormula):
         filter, pos = Filter._chain_parse(input, pos)
         pos = cls._lstrip(input, pos)
         return cls(relop, filter), pos
+
+
+def _build_version_formula(tree: Tuple[Any, ...]) -> VersionFormula:
+    """
+    Build a version formula from a tree produced by the native parser.
+
+    Raises
+    ------
+    ParseError
+        If a version in the tree is syntactically invalid.
+    """
+    tag = tree[0]
+    if tag == "F":
+        return FilterVF(_build_filter(tree[1]))
+    elif tag == "V":
+        return VersionConstraint(
+            RelOp(tree[1]),
+            OCamlVersion._exhaustive_parse(tree[2]))
+    elif tag == "C":
+        return FilterConstraint(RelOp(tree[1]), _build_filter(tree[2]))
+    elif tag == "L":
+        return LogicalVF(
+            _build_version_formula(tree[1]),
+            LogOp(tree[2]),
+            _build_version_formula(tree[3]))
+    elif tag == "P":
+        return ParensVF(_build_version_formula(tree[1]))
+    else:
+        return NotVF(_build_version_formula(tree[1]))
@@ -29,7 +29,7 @@ import tempfile
 import typing
 import warnings
 from dataclasses import InitVar, dataclass, field, fields
-from functools import cached_property, reduce
+from functools import cached_property
 from pathlib import Path
 from subprocess import CalledProcessError, CompletedProcess
 from typing import Any, ClassVar, Dict, List, Optional, Tuple, Union
@@ -43,7 +43,7 @@ from prism.util.radpytools import PathLike, cachedmethod
 from prism.util.radpytools.dataclasses import default_field
 
 from .file import OpamFile
-from .formula import LogicalPF, LogOp, PackageConstraint, PackageFormula
+from .formula import PackageConstraint, PackageFormula
 from .version import OCamlVersion, OpamVersion, Version
 
 __all__ = ['OpamSwitch']
@@ -478,22 +478,7 @@ class OpamSwitch:
         r = self.run(f"opam show -f depends: {pkg}")
         # Dependencies returned as list of AND-conjoined formulas, but
         # the AND operator is missing.
-        # Must parse piecemeal since otherwise there is no known
-        # reliable way to infer where AND operators should be inserted
-        dep_text = r.stdout.strip()
-        pos = 0
-        formulas = []
-        while pos < len(dep_text):
-            formula, pos = PackageFormula.parse(dep_text, exhaustive=False, pos=pos)
-            formulas.append(formula)
-        formula = reduce(
-            lambda left,
-            right: LogicalPF(left,
-                             LogOp.AND,
-                             right),
-            formulas[1 :],
-            formulas[0])
-        return formula
+        return PackageFormula.parse_conjunction(r.stdout.strip())
 
     def get_installed_version(self, package_name: str) -> Optional[str]:
         """
@@ -0,0 +1,124 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for `prism.util.opam.clone`.
+"""
+import errno
+import os
+import tempfile
+import unittest
+from pathlib import Path
+from unittest import mock
+
+from prism.util.opam.clone import CloneMethod, copy_tree
+
+
+class TestCopyTree(unittest.TestCase):
+    """
+    Tests for `copy_tree`.
+    """
+
+    def setUp(self) -> None:
+        """
+        Create a directory resembling a switch.
+        """
+        self._tmpdir = tempfile.TemporaryDirectory()
+        self.tmpdir = Path(self._tmpdir.name)
+        self.src = self.tmpdir / "switch"
+        (self.src / ".opam-switch").mkdir(parents=True)
+        (self.src / "lib" / "coq").mkdir(parents=True)
+        (self.src / ".opam-switch" / "switch-state").write_text("state")
+        (self.src / "lib" / "coq" / "Init.vo").write_bytes(b"\x00vo")
+        (self.src / "lib" / "findlib.conf").write_text("conf")
+        (self.src / "bin").mkdir()
+        (self.src / "bin" / "coqc").write_text("#!/bin/sh")
+        (self.src / "bin" / "coqc").chmod(0o755)
+        (self.src / "bin" / "coqtop").symlink_to("coqc")
+
+    def tearDown(self) -> None:
+        """
+        Remove the temporary directory.
+        """
+        self._tmpdir.cleanup()
+
+    def _assert_same_tree(self, dst: Path) -> None:
+        for src_path in self.src.rglob("*"):
+            dst_path = dst / src_path.relative_to(self.src)
+            if src_path.is_symlink():
+                self.assertEqual(os.readlink(dst_path), os.readlink(src_path))
+            elif src_path.is_file():
+                self.assertEqual(dst_path.read_bytes(), src_path.read_bytes())
+                self.assertEqual(
+                    dst_path.stat().st_mode,
+                    src_path.stat().st_mode)
+            else:
+                self.assertTrue(dst_path.is_dir())
+
+    def test_copy_tree(self) -> None:
+        """
+        Verify that each method copies the tree.
+        """
+        for method in CloneMethod:
+            with self.subTest(method=method):
+                dst = self.tmpdir / method.value
+                copy_tree(self.src, dst, method)
+                self._assert_same_tree(dst)
+                # the switch state is never shared
+                (dst / ".opam-switch" / "switch-state").write_text("new")
+                self.assertEqual(
+                    (self.src / ".opam-switch" / "switch-state").read_text(),
+                    "state")
+                (dst / "lib" / "findlib.conf").write_text("new")
+                self.assertEqual(
+                    (self.src / "lib" / "findlib.conf").read_text(),
+                    "conf")
+
+    def test_hardlink(self) -> None:
+        """
+        Verify that only immutable files are hard linked.
+        """
+        dst = self.tmpdir / "clone"
+        copy_tree(self.src, dst, CloneMethod.HARDLINK)
+        self.assertTrue(
+            (dst / "lib" / "coq" / "Init.vo").samefile(
+                self.src / "lib" / "coq" / "Init.vo"))
+        self.assertFalse(
+            (dst / ".opam-switch" / "switch-state").samefile(
+                self.src / ".opam-switch" / "switch-state"))
+        self.assertFalse(
+            (dst / "lib" / "findlib.conf").samefile(
+                self.src / "lib" / "findlib.conf"))
+
+    def test_reflink_fallback(self) -> None:
+        """
+        Verify that files are copied if reflinks are not supported.
+        """
+        unsupported = OSError(errno.EOPNOTSUPP, "Operation not supported")
+        with mock.patch("fcntl.ioctl", side_effect=unsupported) as ioctl:
+            dst = self.tmpdir / "clone"
+            copy_tree(self.src, dst, CloneMethod.REFLINK)
+        # reflinks are attempted only until they are found unsupported
+        ioctl.assert_called_once()
+        self._assert_same_tree(dst)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,150 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for `prism.util.opam.file` and `prism.util.opam.cache`.
+"""
+import tempfile
+import unittest
+from pathlib import Path
+
+from prism.util.opam import PackageFormula
+from prism.util.opam._file import scan_fields
+from prism.util.opam.cache import OpamFileCache
+from prism.util.opam.file import ParsedOpamFile, _py_scan_fields
+from prism.util.parse import ParseError
+
+_OPAM_FILE = """\
+opam-version: "2.0"
+maintainer: "dev@example.com" # contact
+synopsis: "A library: with colons"
+depends: [
+  "ocaml" {>= "4.05.0" & < "4.10"}
+  "dune" {>= "2.0"} # build system
+  "coq" {>= "8.10" & < "8.16~"}
+]
+build: [
+  ["dune" "build" "-p" name "-j" jobs]
+]
+(* a block
+   comment *)
+url {
+  src: "https://example.com/a.tar.gz"
+  checksum: "md5=0123"
+}
+"""
+
+
+class TestParsedOpamFile(unittest.TestCase):
+    """
+    Test suite for `ParsedOpamFile`.
+    """
+
+    def test_scan_fields(self):
+        """
+        Verify that the fields of an opam file are split correctly.
+        """
+        expected = [
+            ('opam-version',
+             '"2.0"'),
+            ('maintainer',
+             '"dev@example.com"'),
+            ('synopsis',
+             '"A library: with colons"'),
+            (
+                'depends',
+                '[\n  "ocaml" {>= "4.05.0" & < "4.10"}\n'
+                '  "dune" {>= "2.0"}  \n'
+                '  "coq" {>= "8.10" & < "8.16~"}\n]'),
+            ('build',
+             '[\n  ["dune" "build" "-p" name "-j" jobs]\n]'),
+            (
+                'url',
+                '{\n  src: "https://example.com/a.tar.gz"\n'
+                '  checksum: "md5=0123"\n}'),
+        ]
+        self.assertEqual(_py_scan_fields(_OPAM_FILE), expected)
+        self.assertEqual(scan_fields(_OPAM_FILE), expected)
+        for text in ['',
+                     'a: "x',
+                     'a: [ "x" # ]\nb: 1',
+                     'x "label" { y: (* } *) "}" }\nz: 2',
+                     'not a field\nname :"v"\n  c: 3']:
+            with self.subTest(text=text):
+                self.assertEqual(scan_fields(text), _py_scan_fields(text))
+
+    def test_parse(self):
+        """
+        Verify that package formulas are parsed from an opam file.
+        """
+        parsed = ParsedOpamFile.parse(_OPAM_FILE)
+        self.assertEqual(parsed.fields['opam-version'], '"2.0"')
+        self.assertEqual(list(parsed.formulas), ['depends'])
+        self.assertEqual(
+            parsed.formulas['depends'],
+            PackageFormula.parse(
+                '"ocaml" {>= "4.05.0" & < "4.10"} & "dune" {>= "2.0"} & '
+                '"coq" {>= "8.10" & < "8.16~"}'))
+        self.assertEqual(ParsedOpamFile.parse('depends: []').formulas,
+                         {})
+        with self.assertRaises(ParseError):
+            ParsedOpamFile.parse('depends: [ "ocaml" {>= } ]')
+
+
+class TestOpamFileCache(unittest.TestCase):
+    """
+    Test suite for `OpamFileCache`.
+    """
+
+    def test_load(self):
+        """
+        Verify that parsed files are cached in memory and on disk.
+        """
+        expected = ParsedOpamFile.parse(_OPAM_FILE)
+        data = _OPAM_FILE.encode('utf-8')
+        digest = OpamFileCache.digest(data)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filename = Path(tmpdir) / "opam"
+            filename.write_bytes(data)
+            cache = OpamFileCache(Path(tmpdir) / "cache")
+            self.assertIsNone(cache.get(digest))
+            self.assertEqual(cache.load(filename), expected)
+            self.assertEqual(len(cache), 1)
+            self.assertIs(cache.parse(data), cache.get(digest))
+            # identical contents share an entry
+            self.assertEqual(
+                cache.load_files([filename]),
+                {
+                    str(filename): expected
+                })
+            self.assertEqual(len(cache), 1)
+            # a new cache finds the entry on disk
+            cache = OpamFileCache(Path(tmpdir) / "cache")
+            self.assertEqual(len(cache), 0)
+            self.assertEqual(cache.get(digest), expected)
+            # unparseable files are not cached
+            bad = b'depends: [ "ocaml" {>= } ]'
+            with self.assertRaises(ParseError):
+                cache.parse(bad)
+            self.assertIsNone(cache.get(OpamFileCache.digest(bad)))
+
+
+if __name__ == '__main__':
+    unittest.main()
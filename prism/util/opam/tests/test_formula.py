@@ -426,6 +426,17 @@ class TestVersionFormula(unittest.TestCase):
                         LogOp.AND,
                         VersionConstraint(RelOp.NEQ,
                                           OpamVersion.parse("8.14")))))
+        with self.subTest("literals"):
+            self.assertEqual(
+                VersionFormula.parse('false'),
+                FilterVF(FilterAtom(False)))
+            self.assertEqual(
+                VersionFormula.parse('true'),
+                FilterVF(FilterAtom(True)))
+            self.assertEqual(
+                VersionFormula.parse('!= ""'),
+                FilterConstraint(RelOp.NEQ,
+                                 FilterAtom("")))
 
     def test_str(self):
         """
@@ -602,6 +613,123 @@ class TestPackageFormula(unittest.TestCase):
                 self.variables)
             self.assertEqual(actual, expected)
 
+    def test_compile(self):
+        """
+        Verify compiled formulae agree with `is_satisfied`.
+        """
+        self.packages['dune'] = Version.parse('2.9.1')
+        self.packages['menhirLib'] = Version.parse('20181113')
+        self.packages['menhirSdk'] = Version.parse('20181113')
+        self.variables['version'] = 20181113
+        installed = [
+            self.packages,
+            {},
+            {
+                'ocaml': Version.parse('5.03.0'),
+                'dune': Version.parse('2.8.0')
+            },
+            {
+                'ocaml': OCamlVersion(4,
+                                      7,
+                                      1,
+                                      'pre'),
+                'bisect_ppx': Version.parse('3.0')
+            },
+        ]
+        formulae = self.formulae + [
+            '("ocaml" {< "4.08~"}) & "bisect_ppx"',
+            '"ocaml" {!(>= "4.07.1") | != "5.03.0"} | "dune" {= "2.8.0"}'
+        ]
+        for formula in formulae:
+            formula = PackageFormula.parse(formula)
+            for variables in [None, self.variables]:
+                expected = [
+                    formula.is_satisfied(packages,
+                                         variables) for packages in installed
+                ]
+                with self.subTest(formula=str(formula), variables=variables):
+                    compiled = formula.compile(variables)
+                    self.assertEqual(
+                        [compiled(packages) for packages in installed],
+                        expected)
+                    self.assertEqual(
+                        formula.is_satisfied_batch(installed,
+                                                   variables),
+                        expected)
+
+    def test_parse_natively(self):
+        """
+        Verify native parsing agrees with the pure Python parser.
+        """
+        formulae = self.formulae + [
+            '"ocaml" {>= "4.05.0" | (?build | !?debug)}',
+            '"a" {= version} "b" {build & !false}',
+            '"coq" {>= "8.10" & < "8.16~"} | "coq-core" {os:foo = "x"}',
+            '"pkg.1.0.2" & ("x" | "y")',
+        ]
+        for formula in formulae:
+            for kwargs in [{},
+                           {
+                               'exhaustive': False
+                           }]:
+                with self.subTest(formula=formula, kwargs=kwargs):
+                    try:
+                        expected = super(PackageFormula,
+                                         PackageFormula).parse(
+                                             formula,
+                                             **kwargs)
+                    except ParseError:
+                        with self.assertRaises(ParseError):
+                            PackageFormula.parse(formula, **kwargs)
+                        continue
+                    actual = PackageFormula.parse(formula, **kwargs)
+                    self.assertEqual(actual, expected)
+                    self.assertEqual(str(actual), str(expected))
+        # escape sequences fall back to the Python parser
+        self.assertEqual(
+            PackageFormula.parse('"a" {os = "x\\ty"}'),
+            PackageConstraint(
+                "a",
+                FilterVF(
+                    RelationalF(
+                        FilterAtom(Variable("os")),
+                        RelOp.EQ,
+                        FilterAtom("x\ty")))))
+        with self.assertRaises(ParseError):
+            PackageFormula.parse('"ocaml" {>= "4.05" &}')
+
+    def test_parse_conjunction(self):
+        """
+        Verify that whitespace-separated formulae are conjoined.
+        """
+        expected = PackageFormula.parse(
+            '"ocaml" {>= "4.05"} & "dune" & ("a" | "b")')
+        for formula in ['"ocaml" {>= "4.05"} "dune" ("a" | "b")',
+                        ' "ocaml" {>= "4.05"}\n  "dune"\n  ("a" | "b")\n']:
+            with self.subTest(formula=formula):
+                self.assertEqual(
+                    PackageFormula.parse_conjunction(formula),
+                    expected)
+        # escape sequences take the Python path
+        self.assertEqual(
+            PackageFormula.parse_conjunction(
+                '"ocaml" {>= "4.05"} "dune" ("a" | "b") '
+                '"c" {os = "x\\ty"}'),
+            LogicalPF(
+                expected,
+                LogOp.AND,
+                PackageConstraint(
+                    "c",
+                    FilterVF(
+                        RelationalF(
+                            FilterAtom(Variable("os")),
+                            RelOp.EQ,
+                            FilterAtom("x\ty"))))))
+        with self.assertRaises(ParseError):
+            PackageFormula.parse_conjunction("  ")
+        with self.assertRaises(ParseError):
+            PackageFormula.parse_conjunction('"ocaml" {>= }')
+
     def test_map(self):
         """
         Replace a version constraint with another.
@@ -24,6 +24,8 @@ Test suite for prism.util.opam.
 import unittest
 
 from prism.util.opam import OCamlVersion, OpamVersion, ParseError, Version
+from prism.util.opam._version import version_key
+from prism.util.opam.version import _py_version_key
 
 
 class TestVersion(unittest.TestCase):
@@ -125,6 +127,43 @@ class TestVersion(unittest.TestCase):
             [versions[3]])
         self.assertEqual(Version.parse('3').filter_versions(versions), [])
 
+    def test_sort_key(self):
+        """
+        Verify that sort keys compare like the keys of versions.
+        """
+        versions = [
+            '~~',
+            '~',
+            '~beta2',
+            '~beta10',
+            '0.1',
+            '1.0~beta',
+            '1.0',
+            '1.00',
+            '1.0-test',
+            '1.0_test',
+            '1.0+test',
+            '1.0.1',
+            '1.0.10',
+            '1.0.010',
+            '8.10.2+0.7.1',
+            '1' + '0' * 300,
+            '9' * 299,
+            'dev',
+            'Dev',
+            'trunk',
+            '123abc',
+        ]
+        for v in ['8.10.2~é', '8.10.2:ζ', '', '~', '0']:
+            self.assertEqual(version_key(v), _py_version_key(v))
+        versions = [OpamVersion.parse(v) for v in versions]
+        for v in versions:
+            self.assertEqual(v.sort_key, _py_version_key(str(v)))
+            for w in versions:
+                with self.subTest(v=str(v), w=str(w)):
+                    self.assertEqual(v.sort_key < w.sort_key, v.key < w.key)
+                    self.assertEqual(v.sort_key == w.sort_key, v.key == w.key)
+
     def test_init(self):
         """
         Test error checking on direct initialization (i.e., not parsed).
@@ -32,6 +32,7 @@ from importlib import import_module
 from typing import ClassVar, Iterable, List, Optional, Tuple, Union
 
 from prism.util.compare import Bottom, Top
+from prism.util.opam._version import version_key
 from prism.util.parse import Parseable, ParseError
 from prism.util.radpytools import cachedmethod
 
@@ -69,6 +70,62 @@ class VersionString(str):
             return True
 
 
+_KEY_TILDE = 0x01
+_KEY_END = 0x02
+_KEY_LETTER = 0x03
+_KEY_OTHER = 0x40
+_KEY_LONG_NUMBER = 0xFF
+"""
+Bytes of a version sort key.
+
+Within a non-digit field, '~' sorts before the end of the field, which
+sorts before letters, which sort before all other characters.
+"""
+
+_digits_re = re.compile(r"[0-9]+")
+
+
+def _py_version_key(version: str) -> bytes:
+    """
+    Get a key by which opam versions may be compared bytewise.
+
+    This is the reference implementation of `version_key`.
+    """
+    key = bytearray()
+    # alternate non-digit and digit fields like `OpamVersion.fields`
+    pos = 0
+    for match in _digits_re.finditer(version):
+        _append_nondigits(key, version[pos : match.start()])
+        digits = match.group().lstrip('0')
+        if len(digits) < _KEY_LONG_NUMBER:
+            key.append(len(digits))
+        else:
+            key.append(_KEY_LONG_NUMBER)
+            key.extend(len(digits).to_bytes(4, 'big'))
+        key.extend(digits.encode('ascii'))
+        pos = match.end()
+    if pos < len(version) or not pos:
+        _append_nondigits(key, version[pos :])
+        # pad with a zero digit field
+        key.append(0)
+    else:
+        # pad with an empty non-digit field
+        key.append(_KEY_END)
+    return bytes(key)
+
+
+def _append_nondigits(key: bytearray, field: str) -> None:
+    for c in field:
+        if c == '~':
+            key.append(_KEY_TILDE)
+        elif c.isascii() and c.isalpha():
+            key.append(_KEY_LETTER + ord(c) - ord('A'))
+        else:
+            key.append(_KEY_OTHER)
+            key.extend(ord(c).to_bytes(3, 'big'))
+    key.append(_KEY_END)
+
+
 @total_ordering
 class Version(Parseable, abc.ABC):
     """
@@ -85,7 +142,7 @@ class Version(Parseable, abc.ABC):
         if not isinstance(other, Version):
             return NotImplemented
         # TODO: pad shorter key
-        return self.key < other.key
+        return self.sort_key < other.sort_key
 
     @abstractproperty
     def key(self) -> Tuple[Union[VersionString, int]]:
@@ -100,6 +157,19 @@ class Version(Parseable, abc.ABC):
         """
         ...
 
+    @cached_property
+    def sort_key(self) -> bytes:
+        """
+        Get a key by which versions may be compared bytewise.
+
+        Returns
+        -------
+        bytes
+            A key that compares like `key` but without comparing
+            fields one at a time in Python.
+        """
+        return version_key(str(self))
+
     def filter_versions(self, versions: Iterable['Version']) -> List['Version']:
         """
         Return only the versions that are equal to this version.
@@ -341,7 +411,7 @@ class OCamlVersion(Version):
         elif isinstance(other, OCamlVersion):
             return self.fast_key == other.fast_key
         else:
-            return self.key == other.key
+            return self.sort_key == other.sort_key
 
     def __lt__(self, other: Version) -> bool:  # noqa: D105
         if not isinstance(other, Version):
@@ -349,7 +419,7 @@ class OCamlVersion(Version):
         elif isinstance(other, OCamlVersion):
             return self.fast_key < other.fast_key
         else:
-            return self.key < other.key
+            return self.sort_key < other.sort_key
 
     def __str__(self) -> str:
         """
@@ -23,7 +23,6 @@ Utility for guessing popular package versions.
 """
 
 import glob
-import re
 import tempfile
 import warnings
 from collections import Counter
@@ -35,9 +34,11 @@ from typing import Optional
 import git
 
 from prism.util.opam.api import OpamAPI
+from prism.util.opam.cache import OpamFileCache
 from prism.util.opam.formula.common import AssignedVariables
+from prism.util.opam.formula.package import LogicalPF, PackageConstraint
 from prism.util.opam.formula.version import VersionFormula
-from prism.util.opam.version import OpamVersion
+from prism.util.opam.version import OpamVersion, Version
 from prism.util.parse import ParseError
 from prism.util.radpytools import cachedmethod
 
@@ -67,6 +68,12 @@ def __background_clone():
 CLONE_PROCESS = Process(target=__background_clone)
 CLONE_PROCESS.start()
 
+# parsed opam files of the repository, which mostly do not change
+# between searches at different dates.
+# Each search reads every package of the repository in the same order,
+# so the cache must hold all of them to serve the next search.
+OPAM_FILE_CACHE = OpamFileCache(maxsize=None)
+
 
 class VersionDistribution:
     """
@@ -165,88 +172,55 @@ class VersionDistribution:
                             glob.glob(str(x / "*"))),
                         default=None) for x in all_packages))
 
-            # build a regex to find our version constraint
-            dep_regex = re.compile(
-                r'depends:\s*\[\s*(?:' + cls.single_constraint_regex(False)
-                + ')*(?:' + cls.single_constraint_regex(True).replace(
-                    r'[^\"]+',
-                    package + r"(?P<version>\.[^\"]+)?") + ')(?:'
-                + cls.single_constraint_regex(False) + ')*]',
-                flags=re.MULTILINE)
-
             count = Counter()
 
-            for package in new_packages:
+            for package_dir in new_packages:
                 try:
-                    m = dep_regex.search(
-                        (Path(str(package)) / "opam").read_text())
+                    depends = OPAM_FILE_CACHE.load(
+                        Path(str(package_dir))
+                        / "opam").formulas.get('depends')
                 except NotADirectoryError:
                     # circa 2018 some packages had different structures
                     # so we will exclude those
-                    warnings.warn(f"Skipping {package}...")
+                    warnings.warn(f"Skipping {package_dir}...")
                     continue
-                if m is not None:
-                    formula = m.group('formula')
-                    version = m.group('version')
-                    if formula is not None:
-                        formula = formula[1 :-1].strip()
-                        try:
-                            constraint = VersionFormula.parse(formula)
-                        except ParseError:
-                            warnings.warn(
-                                f"Failed to parse version formula from {formula}"
-                            )
-                        else:
-                            simplified = constraint.simplify(
-                                None,
-                                variables=variables,
-                                evaluate_filters=True)
-                            if isinstance(simplified, VersionFormula):
-                                filtered = simplified.filter_versions(
-                                    versions,
-                                    variables=variables)
-                            elif isinstance(simplified, bool):
-                                if simplified:
-                                    filtered = versions
-                                else:
-                                    filtered = []
-                            else:
-                                warnings.warn(
-                                    "Unsure how to filter with simplified "
-                                    f"constraint '{simplified}' obtained from "
-                                    f"'{constraint}'. Defaulting to True.")
+                except (ParseError, UnicodeDecodeError):
+                    warnings.warn(
+                        f"Failed to parse dependencies of {package_dir}")
+                    continue
+                if isinstance(depends, LogicalPF):
+                    dependencies = depends.to_conjunctive_list()
+                else:
+                    dependencies = [depends]
+                for dependency in dependencies:
+                    if (not isinstance(dependency,
+                                       PackageConstraint)
+                            or dependency.package_name != package):
+                        continue
+                    constraint = dependency.version_constraint
+                    if isinstance(constraint, VersionFormula):
+                        simplified = constraint.simplify(
+                            None,
+                            variables=variables,
+                            evaluate_filters=True)
+                        if isinstance(simplified, VersionFormula):
+                            filtered = simplified.filter_versions(
+                                versions,
+                                variables=variables)
+                        elif isinstance(simplified, bool):
+                            if simplified:
                                 filtered = versions
-                            count.update(filtered)
-                    elif version is not None:
-                        version = version[1 :]
-                        # version was explicitly specified.
-                        try:
-                            version = OpamVersion.parse(version)
-                        except ParseError:
-                            warnings.warn(
-                                f"Failed to parse version from {version}")
+                            else:
+                                filtered = []
                         else:
-                            count[version] += 1
+                            warnings.warn(
+                                "Unsure how to filter with simplified "
+                                f"constraint '{simplified}' obtained from "
+                                f"'{constraint}'. Defaulting to True.")
+                            filtered = versions
+                        count.update(filtered)
+                    elif isinstance(constraint, Version):
+                        # version was explicitly specified.
+                        count[OpamVersion.parse(str(constraint))] += 1
+                    break
         return count
-
-    @staticmethod
-    def single_constraint_regex(capture: bool) -> re.Pattern:
-        """
-        Get a regular expression that matches a package constraint.
-
-        Parameters
-        ----------
-        capture : bool
-            If True, then capture the version formula in the package
-            constraint as a group named ``"formula"``.
-
-        Returns
-        -------
-        re.Pattern
-            A regular expression that matches one package constraint.
-        """
-        if capture:
-            capture = "?P<formula>"
-        else:
-            capture = "?:"
-        return rf'"(?:[^\"]+)"\s*({capture}\{{[^\}}]+\}})?\s*'
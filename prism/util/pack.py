@@ -0,0 +1,263 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Append-only packs of binary records split across segment files.
+"""
+import mmap
+import os
+import re
+from pathlib import Path
+from types import TracebackType
+from typing import BinaryIO, Dict, NamedTuple, Optional, Type
+
+from prism.util.radpytools.path import PathLike
+
+
+class PackLocation(NamedTuple):
+    """
+    The location of a record within a `SegmentedPack`.
+    """
+
+    segment: int
+    """
+    The index of the segment file containing the record.
+    """
+    offset: int
+    """
+    The byte offset of the record within the segment.
+    """
+    length: int
+    """
+    The length of the record in bytes.
+    """
+
+
+class SegmentedPack:
+    """
+    An append-only store of binary records.
+
+    Records are appended to segment files that are capped in size, and
+    each record is addressed by its `PackLocation`, which the caller is
+    responsible for indexing (e.g., in a database).
+    Records are read through memory maps of the segment files, so random
+    access does not require any system calls once a segment is mapped.
+
+    Notes
+    -----
+    At most one `SegmentedPack` should append to a given directory at a
+    time, but any number may read from it.
+    """
+
+    _segment_re = re.compile(r"segment-(\d+)\.pack")
+
+    def __init__(self, directory: PathLike, max_segment_size: int = 1 << 30):
+        self.directory = Path(directory)
+        """
+        The directory containing the segment files.
+        """
+        self.max_segment_size = max_segment_size
+        """
+        The size in bytes beyond which a new segment will be started.
+        Records larger than this size are stored in their own segment.
+        """
+        self._writer: Optional[BinaryIO] = None
+        self._writer_segment = -1
+        self._maps: Dict[int,
+                         mmap.mmap] = {}
+
+    def __enter__(self) -> 'SegmentedPack':
+        """
+        Provide an entry point for the context manager.
+        """
+        return self
+
+    def __exit__(
+            self,
+            exc_type: Optional[Type[BaseException]],
+            exc_value: Optional[BaseException],
+            traceback: Optional[TracebackType]) -> None:
+        """
+        Close the pack once the context manager ends.
+        """
+        self.close()
+
+    def _get_map(self, segment: int, end: int) -> mmap.mmap:
+        """
+        Get a memory map of a segment that covers the given offset.
+        """
+        segment_map = self._maps.get(segment, None)
+        if segment_map is None or len(segment_map) < end:
+            if segment == self._writer_segment:
+                self.flush()
+            if segment_map is not None:
+                segment_map.close()
+            with open(self.segment_path(segment), "rb") as f:
+                segment_map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            self._maps[segment] = segment_map
+        return segment_map
+
+    def _last_segment(self) -> int:
+        """
+        Get the index of the last existing segment or -1 if none exist.
+        """
+        segments = [-1]
+        if self.directory.exists():
+            for p in self.directory.iterdir():
+                match = self._segment_re.fullmatch(p.name)
+                if match is not None:
+                    segments.append(int(match.group(1)))
+        return max(segments)
+
+    def append(self, data: bytes) -> PackLocation:
+        """
+        Append a record to the pack.
+
+        Parameters
+        ----------
+        data : bytes
+            The record.
+
+        Returns
+        -------
+        PackLocation
+            The location at which the record may be read.
+            Note that the record may not be durable until the pack is
+            flushed.
+        """
+        if self._writer is None:
+            self.directory.mkdir(parents=True, exist_ok=True)
+            self._writer_segment = max(self._last_segment(), 0)
+            self._writer = open(self.segment_path(self._writer_segment), "ab")
+        offset = self._writer.tell()
+        if offset > 0 and offset + len(data) > self.max_segment_size:
+            self._writer.close()
+            self._writer_segment += 1
+            self._writer = open(self.segment_path(self._writer_segment), "ab")
+            offset = 0
+        self._writer.write(data)
+        return PackLocation(self._writer_segment, offset, len(data))
+
+    def close(self) -> None:
+        """
+        Flush any appended records and release open files and maps.
+        """
+        if self._writer is not None:
+            self.flush()
+            self._writer.close()
+            self._writer = None
+            self._writer_segment = -1
+        for segment_map in self._maps.values():
+            segment_map.close()
+        self._maps.clear()
+
+    def flush(self, sync: bool = False) -> None:
+        """
+        Flush appended records to the segment files.
+
+        Parameters
+        ----------
+        sync : bool, optional
+            If True, then also force the records to be written to disk,
+            by default False.
+        """
+        if self._writer is not None:
+            self._writer.flush()
+            if sync:
+                os.fsync(self._writer.fileno())
+
+    def read(self, location: PackLocation) -> bytes:
+        """
+        Read a record from the pack.
+
+        Parameters
+        ----------
+        location : PackLocation
+            The location of the record as given by `append`.
+
+        Returns
+        -------
+        bytes
+            The record.
+
+        Raises
+        ------
+        FileNotFoundError
+            If the record's segment does not exist.
+        ValueError
+            If the location extends beyond the end of the segment.
+        """
+        segment, offset, length = location
+        if length == 0:
+            return b""
+        end = offset + length
+        segment_map = self._get_map(segment, end)
+        if len(segment_map) < end:
+            raise ValueError(
+                f"Location {location} exceeds the size of its segment")
+        return segment_map[offset : end]
+
+    def tell(self) -> PackLocation:
+        """
+        Get the location at which the next record will be appended.
+
+        Returns
+        -------
+        PackLocation
+            An empty record at the end of the last segment, which may be
+            given to `truncate` to discard the records appended after
+            it.
+        """
+        if self._writer is not None:
+            return PackLocation(self._writer_segment, self._writer.tell(), 0)
+        segment = max(self._last_segment(), 0)
+        path = self.segment_path(segment)
+        return PackLocation(
+            segment,
+            path.stat().st_size if path.exists() else 0,
+            0)
+
+    def truncate(self, location: PackLocation) -> None:
+        """
+        Discard every record appended at or after the given location.
+
+        Parameters
+        ----------
+        location : PackLocation
+            A location previously given by `tell`.
+        """
+        segment, offset, _ = location
+        if self._writer is not None:
+            self._writer.close()
+            self._writer = None
+            self._writer_segment = -1
+        for mapped in [s for s in self._maps if s >= segment]:
+            self._maps.pop(mapped).close()
+        for later in range(segment + 1, self._last_segment() + 1):
+            self.segment_path(later).unlink(missing_ok=True)
+        path = self.segment_path(segment)
+        if path.exists():
+            os.truncate(path, offset)
+
+    def segment_path(self, segment: int) -> Path:
+        """
+        Get the path to the indicated segment file.
+        """
+        return self.directory / f"segment-{segment:06d}.pack"
@@ -0,0 +1,329 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Share read-only objects between processes through shared memory.
+"""
+import hashlib
+import mmap
+import os
+import pickle
+import struct
+import threading
+import typing
+from collections import OrderedDict
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Generic, List, Optional, Tuple, TypeVar, Union
+
+_T = TypeVar('_T')
+
+_SHM_ROOT = Path("/dev/shm")
+"""
+The directory in which POSIX shared memory segments are visible.
+"""
+
+_ALIGNMENT = 64
+"""
+The alignment of out-of-band buffers within a segment.
+"""
+
+_TRAILER = struct.Struct("<QQ")
+"""
+The layout of the trailer of a segment: the number of out-of-band
+buffers followed by the size of the pickled object.
+"""
+
+_EXTENT = struct.Struct("<QQ")
+"""
+The layout of the offset and length of an out-of-band buffer.
+"""
+
+
+@dataclass(frozen=True)
+class SharedObjectHandle(Generic[_T]):
+    """
+    A cheap-to-pickle reference to an object in shared memory.
+    """
+
+    name: str
+    """
+    The name of the shared memory segment containing the object.
+    """
+    size: int
+    """
+    The number of bytes of the segment holding the pickled object.
+    """
+
+    def load(self) -> _T:
+        """
+        Get the referenced object.
+
+        Objects are unpickled at most once per process while they remain
+        in the process's cache of recently loaded objects.
+        Buffers pickled out-of-band, e.g., those of NumPy arrays, are
+        not copied but mapped read-only from the shared segment.
+        The rest of the object is unpickled into a private copy in each
+        process that loads it.
+
+        Raises
+        ------
+        FileNotFoundError
+            If the referenced segment has already been unlinked.
+        """
+        return typing.cast(_T, _cache.get(self))
+
+
+def _read_extents(view: memoryview) -> Tuple[List[Tuple[int, int]], int]:
+    """
+    Read the extents of the out-of-band buffers and the pickle size.
+    """
+    trailer_start = len(view) - _TRAILER.size
+    num_buffers, size = _TRAILER.unpack(view[trailer_start :])
+    table_start = trailer_start - num_buffers * _EXTENT.size
+    extents = [
+        _EXTENT.unpack(view[offset : offset + _EXTENT.size])
+        for offset in range(table_start, trailer_start, _EXTENT.size)
+    ]
+    return extents, size
+
+
+class _LoadedObjectCache:
+    """
+    A per-process LRU cache of objects loaded from shared memory.
+    """
+
+    def __init__(self, maxsize: int):
+        self.maxsize = maxsize
+        self._cache: OrderedDict[SharedObjectHandle, Any] = OrderedDict()
+        self._pid = os.getpid()
+
+    def get(self, handle: SharedObjectHandle) -> Any:
+        """
+        Get the object referenced by the handle, loading it if needed.
+        """
+        if self._pid != os.getpid():
+            # do not share cached objects with forked children
+            self._cache.clear()
+            self._pid = os.getpid()
+        try:
+            obj = self._cache[handle]
+        except KeyError:
+            obj = self._load(handle)
+            self._cache[handle] = obj
+            while len(self._cache) > self.maxsize:
+                self._cache.popitem(last=False)
+        else:
+            self._cache.move_to_end(handle)
+        return obj
+
+    def discard(self, name: str) -> None:
+        """
+        Drop any cached object loaded from the named segment.
+        """
+        for handle in [h for h in self._cache if h.name == name]:
+            del self._cache[handle]
+
+    @staticmethod
+    def _load(handle: SharedObjectHandle) -> Any:
+        fd = os.open(_SHM_ROOT / handle.name, os.O_RDONLY)
+        try:
+            segment = mmap.mmap(fd, 0, access=mmap.ACCESS_READ)
+        finally:
+            os.close(fd)
+        with memoryview(segment) as view:
+            extents, size = _read_extents(view)
+            # out-of-band buffers keep the mapping alive for as long as
+            # any object built on them
+            buffers = [
+                view[offset : offset + length] for offset, length in extents
+            ]
+            with view[: size] as data:
+                obj = pickle.loads(data, buffers=buffers)
+        if not buffers:
+            segment.close()
+        return obj
+
+
+_cache = _LoadedObjectCache(maxsize=3)
+"""
+The objects loaded by the current process.
+
+The cache is large enough for the states and diff of one commit pair so
+that a worker holds at most one pair's objects at a time.
+"""
+
+
+class SharedObjectStore:
+    """
+    A store of read-only objects shared between processes.
+
+    Each object is pickled once into its own named shared memory segment
+    so that other processes can receive a `SharedObjectHandle` instead
+    of a pickled copy of the object.
+    Only the out-of-band buffers of an object, e.g., NumPy arrays, are
+    shared by every process that loads it; the remainder is unpickled
+    by each process, so per-process memory still grows with the size of
+    the object's non-array parts.
+    Any process may put objects into the store, but the process that
+    created the store is responsible for removing them, e.g., via
+    `clear`.
+
+    Notes
+    -----
+    Segments are files in ``/dev/shm``.
+    Each is written in full under a temporary name before it is linked
+    under its final name, so a segment is never visible half-written.
+    """
+
+    def __init__(self, prefix: Optional[str] = None):
+        if prefix is None:
+            prefix = f"prism-{os.getpid()}"
+        self.prefix = prefix
+        """
+        A prefix common to the names of every segment in the store.
+        """
+
+    def _segment_name(self, key: str) -> str:
+        digest = hashlib.sha1(key.encode("utf-8")).hexdigest()[: 20]
+        return f"{self.prefix}-{digest}"
+
+    def get(self, key: str) -> Optional[SharedObjectHandle]:
+        """
+        Get a handle to an object already in the store, if any.
+        """
+        name = self._segment_name(key)
+        try:
+            with open(_SHM_ROOT / name, "rb") as f:
+                f.seek(-_TRAILER.size, os.SEEK_END)
+                _, size = _TRAILER.unpack(f.read(_TRAILER.size))
+        except FileNotFoundError:
+            return None
+        return SharedObjectHandle(name, size)
+
+    def put(self, key: str, obj: _T) -> SharedObjectHandle[_T]:
+        """
+        Place an object in the store.
+
+        Parameters
+        ----------
+        key : str
+            A key that uniquely identifies the object in the store.
+        obj : _T
+            A picklable object.
+
+        Returns
+        -------
+        SharedObjectHandle[_T]
+            A handle by which the object may be loaded in any process.
+            If an object has already been stored under the same key,
+            then a handle to the existing object is returned.
+        """
+        handle = self.get(key)
+        if handle is not None:
+            return handle
+        buffers: List[pickle.PickleBuffer] = []
+        data = pickle.dumps(obj, protocol=5, buffer_callback=buffers.append)
+        size = len(data)
+        name = self._segment_name(key)
+        path = _SHM_ROOT / name
+        tmp = _SHM_ROOT / f"{name}.{os.getpid()}-{threading.get_ident()}.tmp"
+        try:
+            with open(tmp, "wb") as f:
+                f.write(data)
+                table = []
+                for buffer in buffers:
+                    with buffer.raw() as raw:
+                        offset = -(-f.tell() // _ALIGNMENT) * _ALIGNMENT
+                        f.seek(offset)
+                        f.write(raw)
+                        table.append(_EXTENT.pack(offset, raw.nbytes))
+                f.write(b"".join(table))
+                f.write(_TRAILER.pack(len(buffers), size))
+            # publish the segment only once it is completely written
+            os.link(tmp, path)
+        except FileExistsError:
+            handle = self.get(key)
+            assert handle is not None
+            return handle
+        finally:
+            tmp.unlink(missing_ok=True)
+        return SharedObjectHandle(name, size)
+
+    def remove(self, handle: Union[str, SharedObjectHandle]) -> None:
+        """
+        Remove an object from the store.
+
+        Processes that have already loaded the object may continue to
+        use it.
+
+        Parameters
+        ----------
+        handle : Union[str, SharedObjectHandle]
+            A handle to the object or the key under which it was stored.
+        """
+        if isinstance(handle, str):
+            name = self._segment_name(handle)
+        else:
+            name = handle.name
+        _cache.discard(name)
+        (_SHM_ROOT / name).unlink(missing_ok=True)
+
+    def clear(self) -> None:
+        """
+        Remove every object in the store.
+        """
+        for name in self.list_segments():
+            self.remove(SharedObjectHandle(name, 0))
+
+    def list_segments(self) -> List[str]:
+        """
+        Get the names of each segment in the store.
+
+        Segments that are still being written are included.
+        """
+        if not _SHM_ROOT.exists():
+            return []
+        return sorted(
+            p.name
+            for p in _SHM_ROOT.iterdir()
+            if p.name.startswith(f"{self.prefix}-"))
+
+    @staticmethod
+    def is_supported() -> bool:
+        """
+        Return whether shared memory segments can be created.
+        """
+        return _SHM_ROOT.is_dir()
+
+
+Shareable = Union[_T, SharedObjectHandle[_T]]
+"""
+An object or a handle to an object in a `SharedObjectStore`.
+"""
+
+
+def resolve(obj: Shareable[_T]) -> _T:
+    """
+    Get the object referenced by a handle or the object itself.
+    """
+    if isinstance(obj, SharedObjectHandle):
+        return obj.load()
+    return obj
@@ -32,6 +32,7 @@ from typing import Dict, Optional, Set
 from prism.util.compare import Top
 from prism.util.opam import (
     AssignedVariables,
+    CloneMethod,
     OpamAPI,
     OpamSwitch,
     PackageFormula,
@@ -61,14 +62,23 @@ class AdaptiveSwitchManager(SwitchManager):
     variables : Optional[AssignedVariables], optional
         Optional variables that may impact the interpretation of any
         formula evaluated by the switch.
+    clone_method : CloneMethod, optional
+        How switches are cloned, by default with copy-on-write reflinks
+        where the filesystem supports them and full copies otherwise.
     """
 
-    def __init__(self, *args, max_pool_size=1000, **kwargs) -> None:
+    def __init__(
+            self,
+            *args,
+            max_pool_size=1000,
+            clone_method: CloneMethod = CloneMethod.REFLINK,
+            **kwargs) -> None:
         super().__init__(*args, **kwargs)
         self._temporary_switches: Set[OpamSwitch] = set()
         self._last_used: Dict[OpamSwitch,
                               float] = {}
         self._max_pool_size = max_pool_size
+        self._clone_method = clone_method
 
     @synchronizedmethod(semlock_name="_lock")
     def _add_managed_switch(self, switch: OpamSwitch) -> None:
@@ -102,7 +112,11 @@ class AdaptiveSwitchManager(SwitchManager):
         prefix = f"{prefix}_clone_"
         with tempfile.TemporaryDirectory(prefix=prefix, dir=switch.root) as d:
             clone_dir = Path(d)
-        clone = OpamAPI.clone_switch(switch.name, clone_dir.name, switch.root)
+        clone = OpamAPI.clone_switch(
+            switch.name,
+            clone_dir.name,
+            switch.root,
+            self._clone_method)
         return clone
 
     @synchronizedmethod(semlock_name="_lock")
@@ -180,14 +194,24 @@ class AdaptiveSwitchManager(SwitchManager):
             If it is not possible to extend an existing switch to
             satisfy the formula.
         """
-        with self._lock:
-            if (variables is None):
-                # default is no variables
-                variables = {}
+        if (variables is None):
+            # default is no variables
+            variables = {}
 
-            closest_switch = None
-            minimum_size = Top()
-            for switch in self.switches:
+        closest_switch = None
+        minimum_size = Top()
+        with self._lock:
+            satisfying = self._satisfying_switches(formula, variables)
+            # snapshot the pool so that the scan below does not block
+            # other clients
+            candidates = list(self.switches) if not satisfying else []
+        if satisfying:
+            # an existing switch needs no new packages
+            closest_switch = satisfying[0]
+            minimum_size = 0
+        else:
+            # find the switch needing the fewest new packages
+            for switch in candidates:
                 simplified = self.simplify(switch, formula, **variables)
                 if isinstance(simplified, bool):
                     if simplified:
@@ -201,9 +225,9 @@ class AdaptiveSwitchManager(SwitchManager):
                     minimum_size = simplified_size
                 if simplified_size == 0:
                     break
-            # clone the closest switch
-            if closest_switch is None:
-                raise UnsatisfiableConstraints(formula)
+        # clone the closest switch
+        if closest_switch is None:
+            raise UnsatisfiableConstraints(formula)
         if minimum_size > 0:
             # add a new switch to the persistent pool
             clone = self._clone_switch(closest_switch)
@@ -23,7 +23,7 @@ Defines the base class and interface for all switch managers.
 """
 
 from multiprocessing import RLock
-from typing import Dict, Iterable, Optional, Set, Union
+from typing import Dict, Iterable, List, Optional, Set, Union
 
 from prism.util.opam import AssignedVariables, OpamSwitch, PackageFormula
 from prism.util.radpytools import cachedmethod
@@ -33,6 +33,7 @@ from prism.util.radpytools.multiprocessing import (
 )
 
 from .exception import UnsatisfiableConstraints
+from .index import SwitchIndex
 
 
 class SwitchManager:
@@ -64,6 +65,7 @@ class SwitchManager:
         self._switches = set(initial_switches)
         self._variables = dict(variables)
         self._lock = RLock()
+        self._index = SwitchIndex()
 
     @cachedmethod
     @synchronizedmethod(semlock_name="_lock")
@@ -72,6 +74,26 @@ class SwitchManager:
             switch: OpamSwitch) -> OpamSwitch.Configuration:
         return switch.export()
 
+    @synchronizedmethod(semlock_name="_lock")
+    def _satisfying_switches(
+            self,
+            formula: PackageFormula,
+            variables: AssignedVariables) -> List[OpamSwitch]:
+        """
+        Get the managed switches that satisfy the given constraints.
+
+        The index of switches is first brought up to date with the
+        managed switches, which may have been added or removed since
+        the last query.
+        """
+        _, added = self._index.sync(self._switches)
+        for switch in added:
+            config = self._get_switch_config(switch)
+            self._index.add(switch, dict(config.installed))
+        active_variables = dict(self.variables)
+        active_variables.update(variables)
+        return self._index.satisfying(formula, active_variables)
+
     @synchronizedproperty(semlock_name="_lock")
     def switches(self) -> Set[OpamSwitch]:
         """
@@ -116,9 +138,8 @@ class SwitchManager:
         """
         if variables is None:
             variables = {}
-        for switch in self.switches:
-            if self.satisfies(switch, formula, **variables):
-                return switch
+        for switch in self._satisfying_switches(formula, variables):
+            return switch
         raise UnsatisfiableConstraints(formula)
 
     @synchronizedmethod(semlock_name="_lock")
@@ -0,0 +1,231 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Defines an index of switches by their installed packages.
+"""
+
+from typing import Dict, Iterable, List, Mapping, Optional, Set, Tuple
+
+from prism.util.opam import AssignedVariables, OpamSwitch, PackageFormula
+from prism.util.opam.formula import (
+    LogicalPF,
+    LogOp,
+    PackageConstraint,
+    ParensPF,
+)
+from prism.util.opam.version import Version
+
+Installed = Mapping[str, Optional[Version]]
+
+
+class SwitchIndex:
+    """
+    An index from installed packages to the switches that have them.
+
+    Each switch is assigned a bit, so a set of switches is an integer
+    bitset and a formula can be evaluated for every indexed switch at
+    once with bitwise operations, testing each distinct installed
+    version of each package only once.
+    """
+
+    def __init__(self) -> None:
+        self._bits: Dict[OpamSwitch,
+                         int] = {}
+        """
+        The bit assigned to each indexed switch.
+        """
+        self._switches: List[Optional[OpamSwitch]] = []
+        """
+        The switch assigned to each bit, if any.
+        """
+        self._installed: Dict[OpamSwitch,
+                              Installed] = {}
+        """
+        The packages installed in each indexed switch.
+        """
+        self._versions: Dict[str,
+                             Dict[Optional[Version],
+                                  int]] = {}
+        """
+        A map from package names and versions to the switches that
+        have them installed.
+        """
+        self._with_package: Dict[str,
+                                 int] = {}
+        """
+        A map from package names to the switches that have any version
+        installed.
+        """
+        self._all = 0
+        """
+        The set of all indexed switches.
+        """
+
+    def __contains__(self, switch: OpamSwitch) -> bool:  # noqa: D105
+        return switch in self._bits
+
+    def __iter__(self) -> Iterable[OpamSwitch]:  # noqa: D105
+        return iter(self._bits)
+
+    def __len__(self) -> int:  # noqa: D105
+        return len(self._bits)
+
+    def add(self, switch: OpamSwitch, installed: Installed) -> None:
+        """
+        Index a switch by its installed packages.
+
+        Parameters
+        ----------
+        switch : OpamSwitch
+            A switch that is not yet indexed.
+        installed : Mapping[str, Optional[Version]]
+            The packages installed in the switch and their versions.
+        """
+        try:
+            bit = 1 << self._switches.index(None)
+        except ValueError:
+            bit = 1 << len(self._switches)
+            self._switches.append(None)
+        self._switches[bit.bit_length() - 1] = switch
+        self._bits[switch] = bit
+        self._installed[switch] = dict(installed)
+        self._all |= bit
+        for package, version in installed.items():
+            versions = self._versions.setdefault(package,
+                                                 {})
+            versions[version] = versions.get(version, 0) | bit
+            self._with_package[package] = self._with_package.get(
+                package,
+                0) | bit
+
+    def remove(self, switch: OpamSwitch) -> None:
+        """
+        Remove a switch from the index.
+
+        Parameters
+        ----------
+        switch : OpamSwitch
+            An indexed switch.
+        """
+        bit = self._bits.pop(switch)
+        self._switches[bit.bit_length() - 1] = None
+        self._all &= ~bit
+        for package, version in self._installed.pop(switch).items():
+            versions = self._versions[package]
+            versions[version] &= ~bit
+            if not versions[version]:
+                del versions[version]
+            self._with_package[package] &= ~bit
+            if not self._with_package[package]:
+                del self._with_package[package]
+                del self._versions[package]
+
+    def sync(
+            self,
+            switches: Set[OpamSwitch]) -> Tuple[List[OpamSwitch],
+                                                List[OpamSwitch]]:
+        """
+        Remove indexed switches that are not in the given set.
+
+        Parameters
+        ----------
+        switches : Set[OpamSwitch]
+            The switches that should be indexed.
+
+        Returns
+        -------
+        List[OpamSwitch]
+            The switches that were removed from the index.
+        List[OpamSwitch]
+            The given switches that are not yet indexed.
+        """
+        removed = [s for s in self._bits if s not in switches]
+        for switch in removed:
+            self.remove(switch)
+        return removed, [s for s in switches if s not in self._bits]
+
+    def satisfying(
+            self,
+            formula: PackageFormula,
+            variables: Optional[AssignedVariables] = None) -> List[OpamSwitch]:
+        """
+        Get the indexed switches that satisfy a formula.
+
+        Parameters
+        ----------
+        formula : PackageFormula
+            A formula expressing required packages and their version
+            constraints.
+        variables : Optional[AssignedVariables], optional
+            Variables that may impact the interpretation of the
+            formula.
+
+        Returns
+        -------
+        List[OpamSwitch]
+            Each switch whose installed packages satisfy `formula`
+            according to `PackageFormula.is_satisfied`, in the order in
+            which the switches were indexed.
+        """
+        bits = self._evaluate(formula, variables)
+        switches = []
+        while bits:
+            lowest = bits & -bits
+            switches.append(self._switches[lowest.bit_length() - 1])
+            bits ^= lowest
+        return switches
+
+    def _evaluate(
+            self,
+            formula: PackageFormula,
+            variables: Optional[AssignedVariables]) -> int:
+        """
+        Get the set of indexed switches that satisfy a formula.
+        """
+        if isinstance(formula, PackageConstraint):
+            package = formula.package_name
+            satisfies = formula.compile(variables)
+            bits = 0
+            for version, switches in self._versions.get(package, {}).items():
+                if satisfies({
+                        package: version
+                }):
+                    bits |= switches
+            if satisfies({}):
+                # the constraint is vacuous, e.g., due to a filter
+                bits |= self._all & ~self._with_package.get(package, 0)
+            return bits
+        elif isinstance(formula, LogicalPF):
+            left = self._evaluate(formula.left, variables)
+            if formula.logop == LogOp.AND:
+                return left & self._evaluate(formula.right, variables)
+            else:
+                return left | self._evaluate(formula.right, variables)
+        elif isinstance(formula, ParensPF):
+            return self._evaluate(formula.formula, variables)
+        else:
+            # unknown formulas are tested against each switch
+            satisfies = formula.compile(variables)
+            bits = 0
+            for switch, bit in self._bits.items():
+                if satisfies(self._installed[switch]):
+                    bits |= bit
+            return bits
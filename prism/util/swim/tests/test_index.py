@@ -0,0 +1,140 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Test suite for `prism.util.swim.index`.
+"""
+
+import unittest
+from types import SimpleNamespace
+from unittest import mock
+
+from prism.util.opam import OpamVersion, PackageFormula
+from prism.util.swim import SwitchManager, UnsatisfiableConstraints
+from prism.util.swim.index import SwitchIndex
+
+
+class TestSwitchIndex(unittest.TestCase):
+    """
+    Tests for `SwitchIndex`.
+    """
+
+    installed = {
+        "a":
+            {
+                "coq": OpamVersion.parse("8.10.2"),
+                "ocaml": OpamVersion.parse("4.07.1")
+            },
+        "b":
+            {
+                "coq": OpamVersion.parse("8.15.2"),
+                "ocaml": OpamVersion.parse("4.14.1"),
+                "coq-mathcomp-ssreflect": OpamVersion.parse("1.15.0")
+            },
+        "c": {
+            "ocaml": OpamVersion.parse("4.14.1")
+        },
+    }
+    formulas = [
+        '"coq"',
+        '"coq" {= "8.10.2"}',
+        '"coq" {>= "8.11" & < "8.16"}',
+        '"coq" {< "8.11"} | "coq-mathcomp-ssreflect"',
+        '"ocaml" {>= "4.08"} & ("coq" | "coq-mathcomp-ssreflect")',
+        '"coq" {!= "8.10.2"}',
+        '"coq" {with-test}',
+        '"coq" {build & >= "8.11"}',
+        '"coq-elpi"',
+    ]
+
+    def setUp(self) -> None:
+        """
+        Index the switches.
+        """
+        self.index = SwitchIndex()
+        for switch, installed in self.installed.items():
+            self.index.add(switch, installed)
+
+    def test_satisfying(self) -> None:
+        """
+        Verify that the index agrees with `PackageFormula.is_satisfied`.
+        """
+        for formula in self.formulas:
+            formula = PackageFormula.parse(formula)
+            for variables in [{},
+                              {
+                                  "with-test": True,
+                                  "build": False
+                              }]:
+                with self.subTest(formula=str(formula), variables=variables):
+                    self.assertEqual(
+                        self.index.satisfying(formula,
+                                              variables),
+                        [
+                            s for s, installed in self.installed.items()
+                            if formula.is_satisfied(installed, variables)
+                        ])
+
+    def test_sync(self) -> None:
+        """
+        Verify that switches can be removed and added again.
+        """
+        formula = PackageFormula.parse('"ocaml" {>= "4.08"}')
+        removed, added = self.index.sync({"a", "c", "d"})
+        self.assertEqual(removed, ["b"])
+        self.assertEqual(added, ["d"])
+        self.assertNotIn("b", self.index)
+        self.assertEqual(self.index.satisfying(formula), ["c"])
+        self.assertEqual(
+            self.index.satisfying(
+                PackageFormula.parse('"coq-mathcomp-ssreflect"')),
+            [])
+        # the freed bit is reused
+        self.index.add("d", self.installed["b"])
+        self.assertEqual(len(self.index), 3)
+        self.assertEqual(self.index.satisfying(formula), ["d", "c"])
+
+
+class TestSwitchManager(unittest.TestCase):
+    """
+    Tests for indexed switch selection in `SwitchManager`.
+    """
+
+    def test_get_switch(self) -> None:
+        """
+        Verify that switches are selected through the index.
+        """
+        manager = SwitchManager(TestSwitchIndex.installed)
+        with mock.patch.object(SwitchManager,
+                               "_get_switch_config",
+                               lambda _, switch: SimpleNamespace(installed=list(
+                                   TestSwitchIndex.installed[switch].items()))):
+            self.assertEqual(
+                manager.get_switch(PackageFormula.parse('"coq" {< "8.11"}')),
+                "a")
+            with self.assertRaises(UnsatisfiableConstraints):
+                manager.get_switch(PackageFormula.parse('"coq-elpi"'))
+            manager.switches.remove("a")
+            with self.assertRaises(UnsatisfiableConstraints):
+                manager.get_switch(PackageFormula.parse('"coq" {< "8.11"}'))
+
+
+if __name__ == '__main__':
+    unittest.main()
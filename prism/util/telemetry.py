@@ -0,0 +1,396 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Timing and throughput telemetry that can be aggregated across processes.
+"""
+import json
+import math
+import os
+import threading
+import time
+from contextlib import contextmanager
+from dataclasses import dataclass, field
+from functools import wraps
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterator, Optional, TypeVar
+
+from prism.util.io import atomic_write
+from prism.util.radpytools.path import PathLike
+
+_F = TypeVar('_F', bound=Callable[..., Any])
+
+_BUCKETS_PER_OCTAVE = 8
+"""
+The number of histogram buckets per doubling of duration.
+
+Quantiles are thus estimated to within a relative error of about 9%.
+"""
+
+_MIN_SECONDS = 1e-9
+"""
+The smallest distinguishable duration.
+"""
+
+QUANTILES = (0.5, 0.95, 0.99)
+"""
+The quantiles reported for each stage.
+"""
+
+
+@dataclass
+class StageStatistics:
+    """
+    Mergeable statistics of the spans of one stage of a pipeline.
+
+    Durations are counted in a histogram of logarithmically spaced
+    buckets so that statistics gathered by different processes can be
+    merged exactly.
+    """
+
+    count: int = 0
+    """
+    The number of observed spans.
+    """
+    total_seconds: float = 0.0
+    """
+    The total duration of observed spans.
+    """
+    max_seconds: float = 0.0
+    """
+    The longest duration of an observed span.
+    """
+    total_bytes: int = 0
+    """
+    The total number of bytes processed by observed spans.
+    """
+    buckets: Dict[int, int] = field(default_factory=dict)
+    """
+    A map from bucket indices to the number of spans in each bucket.
+    """
+
+    def merge(self, other: 'StageStatistics') -> None:
+        """
+        Add the spans observed by another set of statistics.
+        """
+        self.count += other.count
+        self.total_seconds += other.total_seconds
+        self.max_seconds = max(self.max_seconds, other.max_seconds)
+        self.total_bytes += other.total_bytes
+        for bucket, count in other.buckets.items():
+            self.buckets[bucket] = self.buckets.get(bucket, 0) + count
+
+    def observe(self, seconds: float, nbytes: int = 0) -> None:
+        """
+        Record a span of the given duration and size.
+        """
+        bucket = math.floor(
+            math.log2(max(seconds,
+                          _MIN_SECONDS)) * _BUCKETS_PER_OCTAVE)
+        self.count += 1
+        self.total_seconds += seconds
+        self.max_seconds = max(self.max_seconds, seconds)
+        self.total_bytes += nbytes
+        self.buckets[bucket] = self.buckets.get(bucket, 0) + 1
+
+    def quantile(self, q: float) -> float:
+        """
+        Estimate a quantile of the observed durations.
+
+        Parameters
+        ----------
+        q : float
+            A number between 0 and 1.
+
+        Returns
+        -------
+        float
+            The upper bound of the bucket containing the quantile or
+            zero if no spans have been observed.
+        """
+        if self.count == 0:
+            return 0.0
+        rank = max(math.ceil(q * self.count), 1)
+        seen = 0
+        for bucket in sorted(self.buckets):
+            seen += self.buckets[bucket]
+            if seen >= rank:
+                break
+        upper = 2**((bucket + 1) / _BUCKETS_PER_OCTAVE)
+        return min(upper, self.max_seconds)
+
+    def asdict(self) -> Dict[str, float]:
+        """
+        Summarize the statistics as a flat dictionary.
+        """
+        summary = {
+            "count": self.count,
+            "total_seconds": self.total_seconds,
+            "mean_seconds": self.total_seconds / max(self.count,
+                                                     1),
+            "max_seconds": self.max_seconds,
+            "total_bytes": self.total_bytes,
+        }
+        for q in QUANTILES:
+            summary[f"p{round(q * 100)}_seconds"] = self.quantile(q)
+        return summary
+
+
+@dataclass
+class Span:
+    """
+    A mutable handle to a span in progress.
+    """
+
+    stage: str
+    """
+    The name of the stage to which the span belongs.
+    """
+    nbytes: int = 0
+    """
+    The number of bytes processed during the span.
+
+    This may be set before the span ends once the size is known.
+    """
+
+
+class Telemetry:
+    """
+    A thread-safe collection of statistics for named pipeline stages.
+
+    Statistics may be drained and sent to other processes (e.g., through
+    a queue), where they can be merged into an aggregate collection.
+    """
+
+    def __init__(self) -> None:
+        self.stages: Dict[str,
+                          StageStatistics] = {}
+        """
+        A map from stage names to their statistics.
+        """
+        self._lock = threading.Lock()
+
+    def __bool__(self) -> bool:
+        """
+        Return whether any spans have been observed.
+        """
+        return bool(self.stages)
+
+    def __getstate__(self) -> Dict[str, Any]:
+        """
+        Get the state of the telemetry without its lock for pickling.
+        """
+        with self._lock:
+            return {
+                "stages": dict(self.stages)
+            }
+
+    def __setstate__(self, state: Dict[str, Any]) -> None:
+        """
+        Restore the telemetry from a pickled state.
+        """
+        self.stages = state["stages"]
+        self._lock = threading.Lock()
+
+    def drain(self) -> 'Telemetry':
+        """
+        Remove and return all statistics observed so far.
+        """
+        drained = Telemetry()
+        with self._lock:
+            drained.stages, self.stages = self.stages, {}
+        return drained
+
+    def merge(self, other: 'Telemetry') -> None:
+        """
+        Add the spans observed by another collection of statistics.
+        """
+        with self._lock:
+            for stage, stats in other.stages.items():
+                self.stages.setdefault(stage, StageStatistics()).merge(stats)
+
+    def observe(self, stage: str, seconds: float, nbytes: int = 0) -> None:
+        """
+        Record a span of the given stage.
+
+        Parameters
+        ----------
+        stage : str
+            The name of the stage.
+        seconds : float
+            The duration of the span.
+        nbytes : int, optional
+            The number of bytes processed during the span, by default 0.
+        """
+        with self._lock:
+            self.stages.setdefault(stage,
+                                   StageStatistics()).observe(seconds,
+                                                              nbytes)
+
+    @contextmanager
+    def span(self, stage: str, nbytes: int = 0) -> Iterator[Span]:
+        """
+        Time the enclosed block as a span of the given stage.
+
+        Spans are recorded whether or not the block raises an exception.
+
+        Parameters
+        ----------
+        stage : str
+            The name of the stage.
+        nbytes : int, optional
+            The number of bytes processed during the span, by default 0.
+            The size may also be set on the yielded `Span` later.
+
+        Yields
+        ------
+        Span
+            A handle to the span in progress.
+        """
+        span = Span(stage, nbytes)
+        start = time.perf_counter()
+        try:
+            yield span
+        finally:
+            self.observe(stage, time.perf_counter() - start, span.nbytes)
+
+    def reset(self) -> None:
+        """
+        Discard all statistics observed so far.
+        """
+        with self._lock:
+            self.stages = {}
+
+    def summary(self) -> str:
+        """
+        Summarize the median and tail duration of each stage in a line.
+        """
+        with self._lock:
+            stages = dict(self.stages)
+        return " | ".join(
+            f"{stage}: {stats.count} @ p50 {stats.quantile(0.5):.3g}s"
+            f" p99 {stats.quantile(0.99):.3g}s"
+            for stage, stats in stages.items())
+
+    def to_json(self) -> Dict[str, Dict[str, float]]:
+        """
+        Summarize the statistics of each stage as a dictionary.
+        """
+        with self._lock:
+            stages = dict(self.stages)
+        return {
+            stage: stats.asdict() for stage, stats in stages.items()
+        }
+
+    def to_prometheus(self, prefix: str = "prism") -> str:
+        """
+        Summarize the statistics in the Prometheus text exposition format.
+
+        Parameters
+        ----------
+        prefix : str, optional
+            A prefix for the name of each metric, by default "prism".
+
+        Returns
+        -------
+        str
+            A summary metric of the duration of each stage's spans and
+            a counter of the bytes processed by each stage.
+        """
+        with self._lock:
+            stages = dict(self.stages)
+        seconds = f"{prefix}_stage_seconds"
+        nbytes = f"{prefix}_stage_bytes_total"
+        lines = [
+            f"# HELP {seconds} Duration of pipeline stage spans.",
+            f"# TYPE {seconds} summary"
+        ]
+        for stage, stats in stages.items():
+            label = f'stage="{stage}"'
+            for q in QUANTILES:
+                lines.append(
+                    f'{seconds}{{{label},quantile="{q}"}}'
+                    f" {stats.quantile(q):.9g}")
+            lines.append(f"{seconds}_sum{{{label}}} {stats.total_seconds:.9g}")
+            lines.append(f"{seconds}_count{{{label}}} {stats.count}")
+        lines.extend(
+            [
+                f"# HELP {nbytes} Bytes processed by pipeline stages.",
+                f"# TYPE {nbytes} counter"
+            ])
+        for stage, stats in stages.items():
+            lines.append(f'{nbytes}{{stage="{stage}"}} {stats.total_bytes}')
+        return "\n".join(lines) + "\n"
+
+    def dump(self, path: PathLike) -> None:
+        """
+        Atomically export the statistics to a file.
+
+        Parameters
+        ----------
+        path : PathLike
+            The path to the file.
+            If the file has a ``.prom`` suffix, then the Prometheus text
+            format is written.
+            Otherwise, JSON is written.
+        """
+        path = Path(path)
+        if path.suffix == ".prom":
+            text = self.to_prometheus()
+        else:
+            text = json.dumps(self.to_json(), indent=2)
+        atomic_write(path, text)
+
+
+telemetry = Telemetry()
+"""
+The telemetry of the current process.
+"""
+
+# a forked child may inherit the lock while held by another thread
+os.register_at_fork(
+    after_in_child=lambda: setattr(telemetry, "_lock", threading.Lock()))
+
+
+def timed(stage: str,
+          collector: Optional[Telemetry] = None) -> Callable[[_F],
+                                                             _F]:
+    """
+    Time each call of the decorated function as a span of a stage.
+
+    Parameters
+    ----------
+    stage : str
+        The name of the stage.
+    collector : Optional[Telemetry], optional
+        The collection in which to record spans, by default the
+        telemetry of the current process.
+    """
+
+    def decorator(f: _F) -> _F:
+
+        @wraps(f)
+        def wrapper(*args, **kwargs):
+            with (telemetry if collector is None else collector).span(stage):
+                return f(*args, **kwargs)
+
+        return wrapper  # type: ignore
+
+    return decorator
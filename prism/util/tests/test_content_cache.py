@@ -0,0 +1,90 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.content_cache module.
+"""
+
+import tempfile
+import unittest
+from pathlib import Path
+
+from prism.util.content_cache import ContentCache
+
+
+class TestContentCache(unittest.TestCase):
+    """
+    Tests for `ContentCache`.
+    """
+
+    def test_get_or_compute(self):
+        """
+        Verify that values are cached in memory and on disk.
+        """
+        digest = ContentCache.digest(b"abc")
+        self.assertEqual(digest, ContentCache.digest(b"abc"))
+        self.assertNotEqual(digest, ContentCache.digest(b"abd"))
+        with tempfile.TemporaryDirectory() as tmpdir:
+            cache_dir = Path(tmpdir) / "cache"
+            cache = ContentCache(cache_dir)
+            self.assertIsNone(cache.get(digest))
+            value = cache.get_or_compute(digest, lambda: ["abc"])
+            self.assertEqual(value, ["abc"])
+            self.assertEqual(len(cache), 1)
+            self.assertIs(cache.get(digest), value)
+            self.assertIs(cache.get_or_compute(digest, list), value)
+            # a new cache finds the value on disk
+            cache = ContentCache(cache_dir)
+            self.assertEqual(len(cache), 0)
+            self.assertEqual(cache.get(digest), ["abc"])
+            # failed computations are not cached
+            other = ContentCache.digest(b"abd")
+            with self.assertRaises(ValueError):
+                cache.get_or_compute(other, lambda: int("abd"))
+            self.assertIsNone(cache.get(other))
+            # corrupt or outdated values on disk are cache misses
+            cache._value_path(digest).write_bytes(b"\x80")
+            self.assertIsNone(ContentCache(cache_dir).get(digest))
+            cache = ContentCache(cache_dir)
+            cache.version += 1
+            self.assertIsNone(cache.get(digest))
+            self.assertEqual(cache.get_or_compute(digest, list), [])
+
+    def test_maxsize(self):
+        """
+        Verify that the least recently used values are evicted.
+        """
+        cache = ContentCache(maxsize=2)
+        digests = [ContentCache.digest(bytes([i])) for i in range(3)]
+        first = cache.get_or_compute(digests[0], lambda: [0])
+        cache.get_or_compute(digests[1], lambda: [1])
+        self.assertIs(cache.get(digests[0]), first)
+        cache.get_or_compute(digests[2], lambda: [2])
+        self.assertEqual(len(cache), 2)
+        self.assertIs(cache.get(digests[0]), first)
+        self.assertIsNone(cache.get(digests[1]))
+        cache = ContentCache(maxsize=None)
+        for i, digest in enumerate(digests):
+            cache.get_or_compute(digest, lambda: [i])
+        self.assertEqual(len(cache), 3)
+
+
+if __name__ == '__main__':
+    unittest.main()
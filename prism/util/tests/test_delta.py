@@ -0,0 +1,148 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.delta module.
+"""
+
+import random
+import unittest
+
+from prism.util.delta import (
+    _py_apply_str_delta,
+    _py_common_affix_lengths,
+    _py_pack_value,
+    _py_unpack_value,
+    apply_str_delta,
+    common_affix_lengths,
+    compute_str_delta,
+    pack_value,
+    unpack_value,
+)
+
+
+class TestDelta(unittest.TestCase):
+    """
+    Tests for string deltas and packed values.
+    """
+
+    def test_str_delta(self) -> None:
+        """
+        Verify that deltas round-trip with both implementations.
+        """
+        rng = random.Random(0)
+        alphabet = "ab c\n(λ)"
+        pairs = [
+            ("",
+             ""),
+            ("",
+             "λ x"),
+            ("Lemma foo : x = x.",
+             "Lemma foo' : x = y."),
+            ("Proof. intros. auto. Qed.",
+             "Proof. auto. Qed.")
+        ]
+        for _ in range(200):
+            a = ''.join(rng.choices(alphabet, k=rng.randrange(30)))
+            b = ''.join(rng.choices(alphabet, k=rng.randrange(30)))
+            pairs.append((a, b))
+        for a, b in pairs:
+            self.assertEqual(
+                common_affix_lengths(a,
+                                     b),
+                _py_common_affix_lengths(a,
+                                         b))
+            delta = compute_str_delta(a, b)
+            self.assertEqual(apply_str_delta(a, delta), b)
+            self.assertEqual(_py_apply_str_delta(a, delta), b)
+        # localized changes yield small deltas
+        a = "x" * 10000
+        b = a[: 5000] + "y" + a[5000 :]
+        self.assertLess(len(compute_str_delta(a, b)), 16)
+        # large changed regions are aligned coarsely or replaced
+        for n in [100, 1000]:
+            a = ''.join(rng.choices(alphabet, k=n * 10)) + "  "
+            b = ''.join(rng.choices(alphabet, k=n * 10)) + " \n"
+            delta = compute_str_delta(a, b)
+            self.assertEqual(apply_str_delta(a, delta), b)
+            self.assertEqual(_py_apply_str_delta(a, delta), b)
+
+    def test_malformed_str_delta(self) -> None:
+        """
+        Verify that malformed deltas are rejected.
+        """
+        for delta in [b"\x80", b"\x08", b"\x06a", b"\x03", b""]:
+            with self.subTest(delta=delta):
+                with self.assertRaises(ValueError):
+                    apply_str_delta("a", delta)
+                with self.assertRaises(ValueError):
+                    _py_apply_str_delta("a", delta)
+
+    def test_pack_value(self) -> None:
+        """
+        Verify that packed values round-trip.
+        """
+        value = {
+            'a': [None,
+                  True,
+                  False,
+                  0,
+                  -300,
+                  2**70,
+                  1.5],
+            1: {
+                'λ': b"\x00\xff"
+            },
+            'tuple': (1,
+                      '')
+        }
+        value['ints'] = [-2**63 - 1, -2**63, 2**63 - 1, 2**64, -2**200]
+        expected = dict(value)
+        expected['tuple'] = [1, '']
+        packed = pack_value(value)
+        self.assertEqual(packed, _py_pack_value(value))
+        self.assertEqual(unpack_value(packed), expected)
+        self.assertEqual(_py_unpack_value(packed), expected)
+        cyclic = []
+        cyclic.append(cyclic)
+        for pack, unpack in [(pack_value, unpack_value),
+                             (_py_pack_value, _py_unpack_value)]:
+            with self.subTest(pack=pack):
+                with self.assertRaises(TypeError):
+                    pack({1,
+                          2})
+                with self.assertRaises(RecursionError):
+                    pack(cyclic)
+                for truncated in [b"",
+                                  b"\x03\x80",
+                                  b"\x05\x00",
+                                  b"\x08\x02\x00"]:
+                    with self.assertRaises(ValueError):
+                        unpack(truncated)
+                with self.assertRaises(ValueError):
+                    unpack(pack("abc")[:-1])
+                with self.assertRaises(ValueError):
+                    unpack(pack(1) + b"\x00")
+                with self.assertRaises(ValueError):
+                    unpack(b"\x0a")
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,171 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.git_objects module.
+"""
+import pickle
+import tempfile
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import git
+
+from prism.util.git_objects import GitObjectReader
+
+
+class TestGitObjectReader(unittest.TestCase):
+    """
+    Tests for `GitObjectReader`.
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        """
+        Create a repository with packed and loose objects and refs.
+        """
+        cls.tmpdir = tempfile.TemporaryDirectory()
+        cls.path = Path(cls.tmpdir.name)
+        repo = git.Repo.init(cls.path)
+        with repo.config_writer() as config:
+            config.set_value("user", "name", "Tester")
+            config.set_value("user", "email", "tester@example.com")
+        (cls.path / "d" / "e").mkdir(parents=True)
+        for i in range(3):
+            (cls.path / "a.v").write_text(f"Definition a := {i}.\n")
+            (cls.path / "d" / "e" / "b.v").write_text("Definition b := 0.\n")
+            (cls.path / "c.txt").write_text(f"{i}\n")
+            repo.git.add("-A")
+            repo.git.commit("-m", f"commit {i}")
+        cls.main = repo.active_branch.name
+        repo.git.tag("-a", "v1", "-m", "tag", "HEAD~1")
+        repo.git.checkout("-b", "side", "HEAD~2")
+        (cls.path / "d" / "z.v").write_text("Definition z := 0.\n")
+        repo.git.rm("-r", "d/e")
+        repo.git.add("-A")
+        repo.git.commit("-m", "side")
+        repo.git.checkout(cls.main)
+        repo.git.gc()
+        # add loose objects and refs after packing
+        (cls.path / "new.v").write_text("Definition new := 0.\n")
+        repo.git.add("-A")
+        repo.git.commit("-m", "loose")
+        repo.git.tag("light")
+        cls.repo = repo
+        cls.reader = GitObjectReader(cls.path)
+
+    @classmethod
+    def tearDownClass(cls):
+        """
+        Remove the repository.
+        """
+        cls.repo.close()
+        cls.tmpdir.cleanup()
+
+    def test_resolve(self):
+        """
+        Verify that revisions resolve to the same commits as with git.
+        """
+        for rev in ["HEAD",
+                    self.main,
+                    "side",
+                    "v1",
+                    "light",
+                    "refs/heads/side"]:
+            self.assertEqual(
+                self.reader.resolve(rev),
+                self.repo.commit(rev).hexsha)
+        sha = self.repo.commit("side").hexsha
+        self.assertEqual(self.reader.resolve(sha[: 8]), sha)
+        with self.assertRaises(ValueError):
+            self.reader.resolve("missing")
+
+    def test_iter_commits(self):
+        """
+        Verify that all commits are found as with ``git log --all``.
+        """
+        expected = self.repo.git.log("--all", "--format=%H %ct").splitlines()
+        actual = [
+            f"{c.hexsha} {c.committed_date}"
+            for c in self.reader.iter_commits()
+        ]
+        self.assertEqual(sorted(actual), sorted(expected))
+        self.assertEqual(
+            {c.hexsha for c in self.reader.iter_commits(["side"])},
+            {c.hexsha for c in self.repo.iter_commits("side")})
+
+    def test_files(self):
+        """
+        Verify that files are listed and read without checkouts.
+        """
+        head = self.repo.head.commit.hexsha
+        for rev in [self.main, "side", "v1"]:
+            self.assertEqual(
+                sorted(self.reader.list_files(rev)),
+                sorted(self.repo.git.ls_tree("-r",
+                                             "--name-only",
+                                             rev).split()))
+        self.assertEqual(
+            self.reader.read_file("v1",
+                                  "a.v"),
+            b"Definition a := 1.\n")
+        self.assertEqual(
+            self.reader.read_file("side",
+                                  Path("d") / "z.v"),
+            b"Definition z := 0.\n")
+        for path in ["d/e/b.v", "d", "d/z.v/x"]:
+            with self.assertRaises(FileNotFoundError):
+                self.reader.read_file("side", path)
+        self.assertEqual(self.repo.head.commit.hexsha, head)
+
+    def test_changed_files(self):
+        """
+        Verify that changed files match ``git diff --name-only``.
+        """
+        for a, b in [(self.main, "side"), ("v1", self.main), ("side", "light")]:
+            self.assertEqual(
+                self.reader.changed_files(a,
+                                          b),
+                set(
+                    self.repo.git.diff("--no-renames",
+                                       "--name-only",
+                                       a,
+                                       b).split()))
+        self.assertEqual(self.reader.changed_files("v1", "v1"), set())
+
+    def test_concurrent(self):
+        """
+        Verify that a reader may be shared by threads and pickled.
+        """
+        reader = pickle.loads(pickle.dumps(self.reader))
+        revs = [self.main, "side", "v1"] * 10
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            contents = list(
+                executor.map(lambda rev: reader.read_file(rev, "a.v"),
+                             revs))
+        self.assertEqual(
+            contents,
+            [self.reader.read_file(rev,
+                                   "a.v") for rev in revs])
+
+
+if __name__ == '__main__':
+    unittest.main()
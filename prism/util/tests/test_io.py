@@ -27,7 +27,7 @@ import unittest
 from dataclasses import dataclass
 from pathlib import Path
 
-from prism.util.io import atomic_write
+from prism.util.io import atomic_write, dumps
 from prism.util.path import append_suffix
 from prism.util.serialize import Serializable
 
@@ -88,6 +88,21 @@ class TestAtomicWrite(unittest.TestCase):
             self.assertTrue(append_suffix(test_filename, '.gz').exists())
             self.assertFalse(test_filename.exists())
 
+    def test_atomic_write_bytes(self):
+        """
+        Verify pre-serialized objects get written correctly.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            test_object = ExampleSerializable(123, "abc")
+            test_filename = Path(tmpdir) / "test.json"
+            atomic_write(
+                append_suffix(test_filename,
+                              '.gz'),
+                dumps(test_object,
+                      use_gzip_compression=True))
+            actual_file_contents = ExampleSerializable.load(test_filename)
+            self.assertEqual(test_object, actual_file_contents)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,106 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.pack module.
+"""
+
+import tempfile
+import unittest
+
+from prism.util.pack import PackLocation, SegmentedPack
+
+
+class TestSegmentedPack(unittest.TestCase):
+    """
+    Tests for `SegmentedPack`.
+    """
+
+    def test_append_read(self) -> None:
+        """
+        Verify that appended records can be read back.
+        """
+        records = [bytes([i]) * (i * 10) for i in range(10)]
+        with tempfile.TemporaryDirectory() as tmpdir:
+            with SegmentedPack(tmpdir, max_segment_size=100) as pack:
+                locations = [pack.append(r) for r in records]
+                # records can be read before the pack is flushed
+                self.assertEqual([pack.read(loc) for loc in locations], records)
+                # segments are capped in size unless a record is larger
+                self.assertEqual(
+                    locations[: 4],
+                    [
+                        PackLocation(0,
+                                     0,
+                                     0),
+                        PackLocation(0,
+                                     0,
+                                     10),
+                        PackLocation(0,
+                                     10,
+                                     20),
+                        PackLocation(0,
+                                     30,
+                                     30)
+                    ])
+                self.assertEqual(locations[-1], PackLocation(5, 0, 90))
+            # records persist and appending resumes at the last segment
+            with SegmentedPack(tmpdir, max_segment_size=100) as pack:
+                self.assertEqual([pack.read(loc) for loc in locations], records)
+                self.assertEqual(pack.append(b"a"), PackLocation(5, 90, 1))
+                self.assertEqual(pack.read(locations[-1]), records[-1])
+
+    def test_truncate(self) -> None:
+        """
+        Verify that records appended after a location can be discarded.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            with SegmentedPack(tmpdir, max_segment_size=100) as pack:
+                self.assertEqual(pack.tell(), PackLocation(0, 0, 0))
+                kept = pack.append(b"a" * 60)
+                mark = pack.tell()
+                self.assertEqual(mark, PackLocation(0, 60, 0))
+                pack.append(b"b" * 30)
+                discarded = pack.append(b"c" * 50)
+                self.assertEqual(discarded.segment, 1)
+                self.assertEqual(pack.read(discarded), b"c" * 50)
+                pack.truncate(mark)
+                self.assertEqual(pack.tell(), mark)
+                self.assertFalse(pack.segment_path(1).exists())
+                self.assertEqual(pack.read(kept), b"a" * 60)
+                self.assertEqual(pack.append(b"d"), PackLocation(0, 60, 1))
+            with SegmentedPack(tmpdir, max_segment_size=100) as pack:
+                self.assertEqual(pack.tell(), PackLocation(0, 61, 0))
+
+    def test_read_out_of_bounds(self) -> None:
+        """
+        Verify that reading beyond the end of a segment fails.
+        """
+        with tempfile.TemporaryDirectory() as tmpdir:
+            with SegmentedPack(tmpdir) as pack:
+                pack.append(b"abc")
+                with self.assertRaises(ValueError):
+                    pack.read(PackLocation(0, 2, 2))
+                with self.assertRaises(FileNotFoundError):
+                    pack.read(PackLocation(1, 0, 1))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,165 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.shared_memory module.
+"""
+
+import mmap
+import multiprocessing as mp
+import os
+import pickle
+import unittest
+from dataclasses import dataclass
+from typing import List
+
+import numpy as np
+
+from prism.util.shared_memory import (
+    _SHM_ROOT,
+    SharedObjectHandle,
+    SharedObjectStore,
+    _read_extents,
+    resolve,
+)
+
+
+@dataclass
+class ExampleState:
+    """
+    A stand-in for a large read-only object.
+    """
+
+    name: str
+    values: List[int]
+
+
+def _load_in_child(handle: SharedObjectHandle, queue: mp.Queue) -> None:
+    queue.put(handle.load())
+
+
+class TestSharedObjectStore(unittest.TestCase):
+    """
+    Tests for `SharedObjectStore`.
+    """
+
+    def setUp(self) -> None:
+        """
+        Create an empty store.
+        """
+        self.store = SharedObjectStore(f"prism-test-{os.getpid()}")
+        self.state = ExampleState("a", list(range(1000)))
+
+    def tearDown(self) -> None:
+        """
+        Remove any objects left in the store.
+        """
+        self.store.clear()
+
+    def test_put_load(self) -> None:
+        """
+        Verify that stored objects can be loaded through handles.
+        """
+        handle = self.store.put("state", self.state)
+        self.assertEqual(handle.load(), self.state)
+        self.assertEqual(resolve(handle), self.state)
+        self.assertEqual(resolve(self.state), self.state)
+        # handles are much cheaper to send than the objects themselves
+        self.assertLess(
+            len(pickle.dumps(handle)),
+            len(pickle.dumps(self.state)))
+        # storing under the same key yields the same handle
+        self.assertEqual(self.store.put("state", self.state), handle)
+        self.assertEqual(self.store.get("state"), handle)
+        self.assertIsNone(self.store.get("other"))
+
+    def test_load_in_other_process(self) -> None:
+        """
+        Verify that stored objects can be loaded in other processes.
+        """
+        handle = self.store.put("state", self.state)
+        queue: mp.Queue = mp.Queue()
+        process = mp.Process(target=_load_in_child, args=(handle, queue))
+        process.start()
+        loaded = queue.get(timeout=30)
+        process.join()
+        self.assertEqual(loaded, self.state)
+
+    def test_zero_copy(self) -> None:
+        """
+        Verify that out-of-band buffers are mapped rather than copied.
+        """
+        values = np.arange(1000, dtype=np.int64)
+        handle = self.store.put("array",
+                                {
+                                    "values": values,
+                                    "name": "a"
+                                })
+        # only the completed segment is visible
+        self.assertEqual(len(self.store.list_segments()), 1)
+        # the array is not part of the pickle stream
+        self.assertLess(handle.size, values.nbytes)
+        loaded = handle.load()
+        self.assertEqual(loaded["name"], "a")
+        np.testing.assert_array_equal(loaded["values"], values)
+        self.assertFalse(loaded["values"].flags.owndata)
+        self.assertFalse(loaded["values"].flags.writeable)
+        # loaded objects outlive the removal of their segment
+        self.store.remove(handle)
+        np.testing.assert_array_equal(loaded["values"], values)
+
+    def test_shared_buffers(self) -> None:
+        """
+        Verify that loaded arrays are views of the shared segment.
+        """
+        values = np.arange(100, dtype=np.int64)
+        handle = self.store.put("shared",
+                                {
+                                    "values": values
+                                })
+        loaded = handle.load()["values"]
+        # write through a separate mapping of the segment
+        with open(_SHM_ROOT / handle.name, "r+b") as f:
+            with mmap.mmap(f.fileno(), 0) as segment:
+                with memoryview(segment) as view:
+                    extents, _ = _read_extents(view)
+                self.assertEqual(extents, [(extents[0][0], values.nbytes)])
+                offset = extents[0][0]
+                segment[offset : offset + 8] = np.int64(-1).tobytes()
+        self.assertEqual(loaded[0], -1)
+        np.testing.assert_array_equal(loaded[1 :], values[1 :])
+
+    def test_remove_clear(self) -> None:
+        """
+        Verify that objects can be removed from the store.
+        """
+        handle = self.store.put("state", self.state)
+        self.store.put("other", self.state)
+        self.assertEqual(len(self.store.list_segments()), 2)
+        self.store.remove("state")
+        self.assertEqual(len(self.store.list_segments()), 1)
+        with self.assertRaises(FileNotFoundError):
+            handle.load()
+        self.store.clear()
+        self.assertEqual(self.store.list_segments(), [])
+
+
+if __name__ == '__main__':
+    unittest.main()
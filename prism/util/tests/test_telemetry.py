@@ -0,0 +1,117 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Tests for the util.telemetry module.
+"""
+
+import json
+import pickle
+import tempfile
+import unittest
+from pathlib import Path
+
+from prism.util.telemetry import StageStatistics, Telemetry, timed
+
+
+class TestTelemetry(unittest.TestCase):
+    """
+    Tests for `Telemetry`.
+    """
+
+    def test_quantiles(self) -> None:
+        """
+        Verify that quantiles are estimated within the bucket precision.
+        """
+        stats = StageStatistics()
+        for i in range(1, 101):
+            stats.observe(i / 100, nbytes=i)
+        self.assertEqual(stats.count, 100)
+        self.assertEqual(stats.total_bytes, 5050)
+        self.assertAlmostEqual(stats.total_seconds, 50.5)
+        for q in [0.5, 0.95, 0.99]:
+            self.assertGreaterEqual(stats.quantile(q), q)
+            self.assertLessEqual(stats.quantile(q), q * 1.1)
+        self.assertEqual(stats.quantile(1.0), 1.0)
+        self.assertEqual(StageStatistics().quantile(0.5), 0.0)
+
+    def test_drain_merge(self) -> None:
+        """
+        Verify that drained statistics can be pickled and merged.
+        """
+        worker = Telemetry()
+        with worker.span("load") as span:
+            span.nbytes = 10
+        worker.observe("load", 0.5, 5)
+        worker.observe("write", 0.25)
+        drained = pickle.loads(pickle.dumps(worker.drain()))
+        self.assertFalse(worker)
+        parent = Telemetry()
+        parent.observe("load", 1.0)
+        parent.merge(drained)
+        parent.merge(drained)
+        summary = parent.to_json()
+        self.assertEqual(summary["load"]["count"], 5)
+        self.assertEqual(summary["load"]["total_bytes"], 30)
+        self.assertEqual(summary["load"]["max_seconds"], 1.0)
+        self.assertEqual(summary["write"]["count"], 2)
+        self.assertIn("load: 5", parent.summary())
+
+    def test_timed(self) -> None:
+        """
+        Verify that decorated functions are timed even if they raise.
+        """
+        collector = Telemetry()
+
+        @timed("stage", collector)
+        def f(x: int) -> int:
+            if x < 0:
+                raise ValueError()
+            return x
+
+        self.assertEqual(f(1), 1)
+        with self.assertRaises(ValueError):
+            f(-1)
+        self.assertEqual(collector.stages["stage"].count, 2)
+
+    def test_dump(self) -> None:
+        """
+        Verify that statistics can be exported as JSON or Prometheus text.
+        """
+        collector = Telemetry()
+        collector.observe("load", 0.5, 100)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            json_file = Path(tmpdir) / "telemetry.json"
+            collector.dump(json_file)
+            with open(json_file, "r") as f:
+                self.assertEqual(json.load(f), collector.to_json())
+            prom_file = Path(tmpdir) / "telemetry.prom"
+            collector.dump(prom_file)
+            with open(prom_file, "r") as f:
+                lines = f.read().splitlines()
+        self.assertIn(
+            'prism_stage_seconds{stage="load",quantile="0.5"} 0.5',
+            lines)
+        self.assertIn('prism_stage_seconds_count{stage="load"} 1', lines)
+        self.assertIn('prism_stage_bytes_total{stage="load"} 100', lines)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -21,10 +21,13 @@
 """
 Filter repair examples in a given directory according to tags.
 
-Repair examples are identified as ``.git.json`` files by recursively
-scanning the given directory. The name of each filtered example will be
-returned on a new line. Instead, one may optionally count the number of
-filtered examples.
+If the given directory contains a repair instance database, then its
+records identify the repair examples, which are read from the
+database's pack (or loose files, for older databases).
+Otherwise, repair examples are identified as ``.git.json`` files by
+recursively scanning the given directory.
+The name of each filtered example will be returned on a new line.
+Instead, one may optionally count the number of filtered examples.
 """
 
 import argparse
@@ -36,7 +39,7 @@ from contextlib import contextmanager
 from functools import partial
 from io import TextIOWrapper
 from pathlib import Path
-from typing import Any, Final, Generator, TextIO
+from typing import Any, Callable, Final, Generator, TextIO
 
 import tqdm
 from seutil import io
@@ -44,6 +47,8 @@ from tqdm.contrib.concurrent import process_map
 
 # for faster deserialization
 import prism.util.io  # noqa: F401
+from prism.data.repair.mining import RepairInstanceDB
+from prism.util.io import loads
 from prism.util.path import with_suffixes
 from prism.util.radpytools import unzip
 from prism.util.radpytools.path import PathLike
@@ -74,20 +79,94 @@ def fopen(
             f.close()
 
 
-def get_diffs(filepath: Path, example: dict) -> tuple[str, str]:
+_process_local_dbs: dict[tuple[Path,
+                               int],
+                         RepairInstanceDB] = {}
+"""
+Database connections reused within each process.
+"""
+
+
+def get_db(directory: Path) -> RepairInstanceDB:
     """
-    Get the diffs representing the error and repair.
+    Get a connection to a repair instance database in this process.
+
+    The process ID is part of the key so that forked workers never use
+    a connection inherited from their parent.
     """
+    key = (directory, os.getpid())
+    db = _process_local_dbs.get(key)
+    if db is None:
+        db = _process_local_dbs[key] = RepairInstanceDB(directory)
+    return db
+
+
+def load_example(db_directory: Path | None, filepath: Path) -> dict:
+    """
+    Load a Git-based repair instance without deserializing it.
+
+    Parameters
+    ----------
+    db_directory : Path | None
+        The directory of the repair instance database containing the
+        example or None if the example is a loose file.
+    filepath : Path
+        The path to the example relative to `db_directory` or the path
+        to the loose file.
+    """
+    if db_directory is not None:
+        data = get_db(db_directory).read_file(filepath)
+        return typing.cast(dict[str, Any], loads(data))
+    return typing.cast(dict[str, Any], io.load(filepath))
+
+
+def get_full_example_loader(db_directory: Path | None,
+                            filepath: Path) -> Callable[[],
+                                                        Any]:
+    """
+    Get a function that loads the full repair instance, if it exists.
+
+    The function returns None if the full repair instance cannot be
+    found.
+    """
+    from prism.data.repair.instance import ProjectCommitDataRepairInstance
     full_filepath = with_suffixes(filepath, UNCOMPRESSED_REPAIR_SUFFIX)
+    if db_directory is not None:
+
+        def load_packed() -> Any:
+            db = get_db(db_directory)
+            record = db.get_record_from_file_name(str(full_filepath))
+            if record is None:
+                return None
+            try:
+                return db.load_repair_instance(record)
+            except FileNotFoundError:
+                return None
+
+        return load_packed
+
+    def load_loose() -> Any:
+        if full_filepath.exists() or with_suffixes(
+                full_filepath,
+                COMPRESSED_REPAIR_SUFFIX).exists():
+            return ProjectCommitDataRepairInstance.load(full_filepath)
+        return None
+
+    return load_loose
+
+
+def get_diffs(example: dict,
+              load_full_example: Callable[[],
+                                          Any]) -> tuple[str,
+                                                         str]:
+    """
+    Get the diffs representing the error and repair.
+    """
     error_diff = example['error']['change']['diff']['text']
     if isinstance(example['repaired_state_or_diff'],
                   dict) and 'diff' in example['repaired_state_or_diff']:
         repair_diff = example['repaired_state_or_diff']['diff']['text']
-    elif full_filepath.exists() or with_suffixes(
-            full_filepath,
-            COMPRESSED_REPAIR_SUFFIX).exists():
-        from prism.data.repair.instance import ProjectCommitDataRepairInstance
-        full_example = ProjectCommitDataRepairInstance.load(full_filepath)
+    elif (full_example := load_full_example()) is not None:
         repair_diff = full_example.repaired_git_diff.text
     else:
         repair_diff = (
@@ -99,6 +178,7 @@ def get_diffs(filepath: Path, example: dict) -> tuple[str, str]:
 def filter_repair_instance_file(
         tags_filter: set[str],
         verbose: bool,
+        db_directory: Path | None,
         filepath: Path) -> tuple[bool,
                                  str | None,
                                  str | None]:
@@ -112,8 +192,12 @@ def filter_repair_instance_file(
     verbose : bool
         Whether to return the formatted diffs that show the error and
         repair.
+    db_directory : Path | None
+        The directory of the repair instance database containing the
+        file or None if the file is not indexed by a database.
     filepath : Path
-        The path to a Git-based repair instance file.
+        The path to a Git-based repair instance file, relative to
+        `db_directory` if given.
 
     Returns
     -------
@@ -135,7 +219,7 @@ def filter_repair_instance_file(
     if tags_filter:
         # Avoid overhead of GitRepairInstance
         # deserialization
-        example = typing.cast(dict[str, Any], io.load(filepath))
+        example = load_example(db_directory, filepath)
         tags = set(example['error']['tags'])
         if tags.intersection(tags_filter):
             passes_filter = True
@@ -143,10 +227,13 @@ def filter_repair_instance_file(
         passes_filter = True
     if passes_filter and verbose:
         if example is None:
-            example = typing.cast(dict[str, Any], io.load(filepath))
+            example = load_example(db_directory, filepath)
         if tags is None:
             tags = set(example['error']['tags'])
-        error_diff, repair_diff = get_diffs(filepath, example)
+        error_diff, repair_diff = get_diffs(
+            example,
+            get_full_example_loader(db_directory,
+                                    filepath))
         diff = '\n'.join(
             [
                 "Introduction of error:",
@@ -209,15 +296,33 @@ if __name__ == '__main__':
     output_file: Path | None = args.output
 
     candidates: list[Path] = []
-    for (subdir, _, filenames) in os.walk(directory):
-        for filename in tqdm.tqdm(
-                filenames,
-                desc=f"Scanning for repair instance files in {subdir}",
-                position=1):
-            filepath = Path(subdir) / filename
-            if filepath.suffixes[-2 :] == REPAIR_SUFFIX:
-                candidates.append(filepath)
-    filter_file = partial(filter_repair_instance_file, tags_filter, verbose)
+    db_directory: Path | None = None
+    # a database's index is named as in RepairInstanceDB.db_location
+    if (directory / ".sqlite3").exists():
+        db_directory = directory
+        # close the connection before forking workers, which open their
+        # own
+        with RepairInstanceDB(db_directory) as db:
+            for record in tqdm.tqdm(db.get_records_iter(),
+                                    desc="Reading repair instance records"):
+                if record.file_name is not None:
+                    candidates.append(
+                        RepairInstanceDB.get_compressed_file_name(
+                            record.file_name))
+    else:
+        for (subdir, _, filenames) in os.walk(directory):
+            for filename in tqdm.tqdm(
+                    filenames,
+                    desc=f"Scanning for repair instance files in {subdir}",
+                    position=1):
+                filepath = Path(subdir) / filename
+                if filepath.suffixes[-2 :] == REPAIR_SUFFIX:
+                    candidates.append(filepath)
+    filter_file = partial(
+        filter_repair_instance_file,
+        tags_filter,
+        verbose,
+        db_directory)
     filter_results = process_map(
         filter_file,
         candidates,
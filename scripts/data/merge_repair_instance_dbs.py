@@ -47,8 +47,12 @@ if __name__ == "__main__":
         parser.error("Not enough repair instance databases. Need at least two.")
     databases = [RepairInstanceDB(d) for d in directories]
     try:
-        RepairInstanceDB.union(args.output, *databases)
+        # repair instances are copied into the merged database's pack
+        merged = RepairInstanceDB.union(args.output, *databases)
     except Exception:
         for db in databases:
             db.__exit__(*sys.exc_info())
         raise
+    merged.__exit__(None, None, None)
+    for db in databases:
+        db.__exit__(None, None, None)
@@ -76,6 +76,8 @@ def _process_config(config: Dict[str,
             config["repair_instance_db_directory"])
     if "metadata_storage_file" in config:
         config["metadata_storage_file"] = Path(config["metadata_storage_file"])
+    if "telemetry_file" in config:
+        config["telemetry_file"] = Path(config["telemetry_file"])
     if "prepare_pairs" in config:
         config["prepare_pairs"] = prepare_pairs_map.get(
             config["prepare_pairs"],
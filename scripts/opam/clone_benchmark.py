@@ -0,0 +1,126 @@
+#
+# Copyright (c) 2023 Radiance Technologies, Inc.
+#
+# This file is part of PRISM
+# (see https://github.com/orgs/Radiance-Technologies/prism).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program. If not, see
+# <http://www.gnu.org/licenses/>.
+#
+"""
+Benchmark the latency of cloning a switch with each `CloneMethod`.
+
+If no switch is given, then a synthetic switch of many small files is
+cloned instead.
+"""
+import argparse
+import statistics
+import tempfile
+import time
+from pathlib import Path
+from typing import Callable, List, Optional
+
+from prism.util.opam import CloneMethod, OpamAPI, OpamSwitch
+from prism.util.opam.clone import copy_tree
+
+
+def make_synthetic_switch(path: Path, num_files: int, file_size: int) -> None:
+    """
+    Create a directory resembling a switch with installed libraries.
+    """
+    (path / ".opam-switch").mkdir(parents=True)
+    (path / ".opam-switch" / "switch-state").write_text("installed: []")
+    contents = b"\x00" * file_size
+    for i in range(num_files):
+        lib = path / "lib" / f"pkg{i % 100}"
+        lib.mkdir(parents=True, exist_ok=True)
+        (lib / f"file{i}.vo").write_bytes(contents)
+
+
+def time_clones(clone: Callable[[int], None], trials: int) -> List[float]:
+    """
+    Time repeated clones.
+    """
+    timings = []
+    for i in range(trials):
+        start = time.perf_counter()
+        clone(i)
+        timings.append(time.perf_counter() - start)
+    return timings
+
+
+def main(
+        switch_name: Optional[str],
+        opam_root: Optional[str],
+        trials: int,
+        num_files: int,
+        file_size: int) -> None:
+    """
+    Report the clone latency of each method.
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        tmp = Path(tmpdir)
+        if switch_name is None:
+            src = tmp / "switch"
+            make_synthetic_switch(src, num_files, file_size)
+        for method in CloneMethod:
+
+            def clone(i: int) -> None:
+                if switch_name is None:
+                    copy_tree(src, tmp / f"{method.value}_{i}", method)
+                else:
+                    clone = OpamAPI.clone_switch(
+                        switch_name,
+                        f"{tmp.name}_{method.value}_{i}",
+                        opam_root,
+                        method)
+                    OpamAPI.remove_switch(clone)
+
+            timings = time_clones(clone, trials)
+            print(
+                f"{method.value:>8}: "
+                f"mean {statistics.mean(timings):.3f}s, "
+                f"min {min(timings):.3f}s over {trials} clones")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "--switch",
+        default=None,
+        help="The name of an existing switch to clone.")
+    parser.add_argument(
+        "--root",
+        default=None,
+        help="The opam root of the switch.")
+    parser.add_argument(
+        "--trials",
+        type=int,
+        default=5,
+        help="The number of clones per method.")
+    parser.add_argument(
+        "--num-files",
+        type=int,
+        default=20000,
+        help="The number of files in a synthetic switch.")
+    parser.add_argument(
+        "--file-size",
+        type=int,
+        default=64 * 1024,
+        help="The size in bytes of each file in a synthetic switch.")
+    args = parser.parse_args()
+    if args.switch is not None:
+        # validate that the switch exists and find its root
+        args.root = OpamSwitch(args.switch, args.root).root
+    main(args.switch, args.root, args.trials, args.num_files, args.file_size)
@@ -47,8 +47,100 @@ setup(
         Extension(
             "prism.language.sexp._parse",
             sources=[str(Path("prism") / "language" / "sexp" / "_parse.cpp")],
+            extra_compile_args=extra_compile_args + ["-std=c++17"],
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.language.gallina._offsets",
+            sources=[
+                str(Path("prism") / "language" / "gallina" / "_offsets.cpp")
+            ],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.language.gallina._sertok",
+            sources=[
+                str(Path("prism") / "language" / "gallina" / "_sertok.cpp")
+            ],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.language.heuristic._lexer",
+            sources=[
+                str(Path("prism") / "language" / "heuristic" / "_lexer.cpp")
+            ],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.language.heuristic._str_with_location",
+            sources=[
+                str(
+                    Path("prism") / "language" / "heuristic"
+                    / "_str_with_location.cpp")
+            ],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.interface.coq._ident",
+            sources=[str(Path("prism") / "interface" / "coq" / "_ident.cpp")],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.interface.coq._unicode",
+            sources=[str(Path("prism") / "interface" / "coq" / "_unicode.cpp")],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.util.opam._version",
+            sources=[str(Path("prism") / "util" / "opam" / "_version.cpp")],
             extra_compile_args=extra_compile_args,
             define_macros=define_macros,
             undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.util.opam._file",
+            sources=[str(Path("prism") / "util" / "opam" / "_file.cpp")],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.util.opam.formula._parse",
+            sources=[
+                str(Path("prism") / "util" / "opam" / "formula" / "_parse.cpp")
+            ],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.util._delta",
+            sources=[str(Path("prism") / "util" / "_delta.cpp")],
+            extra_compile_args=extra_compile_args,
+            define_macros=define_macros,
+            undef_macros=undef_macros,
+            py_limited_api=py_limited_api),
+        Extension(
+            "prism.util.build_tools._strace",
+            sources=[
+                str(Path("prism") / "util" / "build_tools" / "_strace.cpp")
+            ],
+            extra_compile_args=extra_compile_args + ["-pthread"],
+            extra_link_args=["-pthread"],
+            define_macros=define_macros,
+            undef_macros=undef_macros,
             py_limited_api=py_limited_api)
     ])